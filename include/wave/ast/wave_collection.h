@@ -301,6 +301,20 @@ wave_path * wave_collection_get_repetition_path (const wave_collection * c);
  */
 int wave_collection_get_repetition_times (const wave_collection * c);
 
+/**
+ * \brief Get the iterator of a constant repetition.
+ * \param c Collection.
+ * \return Variable coordinate standing for the iteration number.
+ * \relatesalso wave_collection
+ * \warning \c c must be not \c NULL.
+ * \pre wave_collection_compute_indexes() must have been called.
+ * \note It is up to the user to free the resulting wave_coordinate.
+ *
+ * The elements of the repeated list are stored in the tab of the parent of
+ * the repetition, at coordinates depending on this iterator.
+ */
+wave_coordinate * wave_collection_get_repetition_iterator (const wave_collection * c);
+
 /**
  * \brief Get the next collection.
  * \param c Collection.
@@ -373,6 +387,16 @@ wave_coordinate * wave_collection_get_coordinate (const wave_collection * c);
  */
 wave_coordinate * wave_collection_get_length (const wave_collection * c);
 
+/**
+ * \brief Get the type of the atom held by the collection at runtime.
+ * \param c Collection
+ * \return Type, or #WAVE_ATOM_UNKNOWN if it is not known at compile time.
+ * \relatesalso wave_collection
+ * \warning \c c must be not \c NULL.
+ * \sa wave_collection_compute_types()
+ */
+wave_atom_type wave_collection_get_inferred_type (const wave_collection * c);
+
 /**
  * \brief Get the collection's last successor.
  * \param c Collection
@@ -399,6 +423,9 @@ wave_coordinate * wave_collection_get_list_length (const wave_collection * c);
  * \warning \c c must be not \c NULL.
  * \note It is up to the user to free the resulting wave_int_list.
  * \return Full indexes.
+ *
+ * Repetitions are skipped, since their elements are stored in the tab of
+ * their parent.
  */
 wave_int_list * wave_collection_get_full_indexes (const wave_collection * c);
 
@@ -409,6 +436,7 @@ wave_int_list * wave_collection_get_full_indexes (const wave_collection * c);
  * \warning \c c must be not \c NULL.
  * \retval true if the collection contains a path.
  * \retval false otherwise.
+ * \note Repetitions depending on a path contain a path.
  */
 bool wave_collection_contains_path (const wave_collection * c);
 
@@ -516,10 +544,11 @@ void wave_collection_set_repetition_path (wave_collection * c, wave_path * p);
 /**
  * \brief Set a sequential constant repetition.
  * \param c Collection.
+ * \param list Repeated list.
  * \param times Times.
  * \relatesalso wave_collection
  */
-void wave_collection_set_repetition_seq_times (wave_collection * c, int times);
+void wave_collection_set_repetition_seq_times (wave_collection * c, wave_collection * list, int times);
 
 /**
  * \brief Set a sequential repetition with a path
@@ -532,10 +561,11 @@ void wave_collection_set_repetition_seq_path (wave_collection * c, wave_collecti
 /**
  * \brief Set a parallel constant repetition.
  * \param c Collection.
+ * \param list Repeated list.
  * \param times Times.
  * \relatesalso wave_collection
  */
-void wave_collection_set_repetition_par_times (wave_collection * c, int times);
+void wave_collection_set_repetition_par_times (wave_collection * c, wave_collection * list, int times);
 /**
  * \brief Set a parallel repetition with a path.
  * \param c Collection.
@@ -583,6 +613,20 @@ void wave_collection_compute_indexes (wave_collection * c);
  */
 void wave_collection_compute_length_and_coords (wave_collection * c);
 
+/**
+ * \brief Compute the types of the atoms held by the collections at runtime.
+ * \param c Collection.
+ * \relatesalso wave_collection
+ * \warning \c c must be not \c NULL.
+ *
+ * The types of the literals are propagated through the operators, following
+ * the rules of wave_data_unary() and wave_data_binary(), and through the
+ * sequential collections whose value is given by a cut. Paths must already be
+ * replaced: the remaining ones, as well as the collections, have no known
+ * type.
+ */
+void wave_collection_compute_types (wave_collection * c);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Interaction with paths.
 ////////////////////////////////////////////////////////////////////////////////
@@ -655,6 +699,11 @@ const wave_collection* wave_collection_get_collection_pointed(const wave_collect
  * \brief Expand repetitions that depend on paths.
  * \param c Collection.
  * \relatesalso wave_collection
+ *
+ * Constant repetitions are expanded too, unless they are long enough and only
+ * repeat literals and unary or binary operators: these are kept and generated
+ * as loops. Every repetition of a phrase containing paths is expanded, so that
+ * the paths can be followed.
  */
 void wave_collection_unroll_path(wave_collection* c);
 
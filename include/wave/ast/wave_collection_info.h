@@ -37,6 +37,7 @@
 
 #include "wave/ast/wave_int_list.h"
 #include "wave/ast/wave_coordinate.h"
+#include "wave/ast/wave_atom.h"
 
 /**
  * \defgroup wave_collection_info_group Wave Collection Info
@@ -53,6 +54,10 @@
  *
  * Collection info are used to annotate the nodes of the AST.
  *
+ * The type is the type of the atom held by the element at runtime, when it is
+ * known at compile time, and #WAVE_ATOM_UNKNOWN otherwise. It is never
+ * #WAVE_ATOM_OPERATOR nor #WAVE_ATOM_PATH.
+ *
  * # Collection info creation and destruction
  * A collection info can be dynamically created using wave_collection_info_alloc()
  * and must be destroyed with wave_collection_info_free().
@@ -61,17 +66,20 @@
  * - wave_collection_info_get_index()
  * - wave_collection_info_get_coordinate()
  * - wave_collection_info_get_length()
+ * - wave_collection_info_get_type()
  *
  * # Content modification
  * - wave_collection_info_set_index()
  * - wave_collection_info_set_coordinate()
  * - wave_collection_info_set_length()
+ * - wave_collection_info_set_type()
  */
 typedef struct wave_collection_info
 {
     int _index;                         /**<- Index. */
     wave_coordinate * _coordinate;      /**<- Coordinate. */
     wave_coordinate * _length;          /**<- Length. */
+    wave_atom_type _type;               /**<- Type. */
 } wave_collection_info;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -128,6 +136,14 @@ wave_coordinate * wave_collection_info_get_coordinate (const wave_collection_inf
  */
 wave_coordinate * wave_collection_info_get_length (const wave_collection_info * info);
 
+/**
+ * \brief Get the type.
+ * \param info Info.
+ * \return Type.
+ * \relatesalso wave_collection_info
+ */
+wave_atom_type wave_collection_info_get_type (const wave_collection_info * info);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Setters.
 ////////////////////////////////////////////////////////////////////////////////
@@ -156,6 +172,14 @@ void wave_collection_info_set_coordinate (wave_collection_info * info, wave_coor
  */
 void wave_collection_info_set_length (wave_collection_info * info, wave_coordinate * l);
 
+/**
+ * \brief Set the type.
+ * \param info Info.
+ * \param t Type.
+ * \relatesalso wave_collection_info
+ */
+void wave_collection_info_set_type (wave_collection_info * info, wave_atom_type t);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Printing.
 ////////////////////////////////////////////////////////////////////////////////
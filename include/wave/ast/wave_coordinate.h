@@ -104,6 +104,11 @@ typedef enum wave_coordinate_type
  *
  * \c 3's index list would be 1,1.
  *
+ * The iteration number of a constant repetition is such a variable: the
+ * elements of the repeated list have coordinates depending on it, see
+ * wave_collection_get_repetition_iterator(). A variable is printed as the
+ * identifier of the generated code, \c wave_var_1_1 for the index list above.
+ *
  * ### Sums and products
  * Sum and products of coordinates represent sum and products that cannot be
  * computed yet because at least one of the operands is “variable”. These
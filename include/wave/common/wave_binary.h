@@ -0,0 +1,190 @@
+/**
+ * \file wave_binary.h
+ * \brief Wave binary format.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __WAVE_BINARY_H__
+#define __WAVE_BINARY_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "wave/common/wave_data.h"
+
+/**
+ * \defgroup wave_binary_group Wave Binary Format
+ * \ingroup lib_wave_group
+ *
+ * The binary format stores a wave_data tree in three parts:
+ * - a header (wave_binary_header), starting with #WAVE_BINARY_MAGIC;
+ * - a node table (wave_binary_node), in breadth-first order, so that the
+ *   elements of each collection are contiguous and come after it;
+ * - a payload, holding the characters of the strings and the values of the
+ *   unboxed collections, each one aligned on 8 bytes.
+ *
+ * Integers are stored in the byte order of the machine which wrote them,
+ * which is recorded in the header.
+ *
+ * Decoding only allocates the nodes: the strings and unboxed collections
+ * point directly into the decoded memory, which is typically a mapped file.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Enums, Structs, Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \ingroup wave_binary_group
+ * \brief Magic string starting the binary format.
+ */
+#define WAVE_BINARY_MAGIC "WAVEBIN1"
+
+/**
+ * \ingroup wave_binary_group
+ * \brief Size of #WAVE_BINARY_MAGIC, without the trailing \c '\0'.
+ */
+#define WAVE_BINARY_MAGIC_SIZE 8
+
+/**
+ * \ingroup wave_binary_group
+ * \brief Types of the nodes.
+ *
+ * These values are part of the format and must not change.
+ */
+typedef enum wave_binary_tag
+{
+    WAVE_BINARY_INT = 1,        /**< wave_int value. */
+    WAVE_BINARY_FLOAT = 2,      /**< wave_float value. */
+    WAVE_BINARY_CHAR = 3,       /**< wave_char value. */
+    WAVE_BINARY_STRING = 4,     /**< String in the payload. */
+    WAVE_BINARY_BOOL = 5,       /**< wave_bool value. */
+    WAVE_BINARY_SEQ = 6,        /**< Sequential collection of nodes. */
+    WAVE_BINARY_PAR = 7,        /**< Parallel collection of nodes. */
+    WAVE_BINARY_PAR_INT = 8,    /**< Unboxed wave_int values in the payload. */
+    WAVE_BINARY_PAR_FLOAT = 9,  /**< Unboxed wave_float values in the payload. */
+    WAVE_BINARY_PAR_BOOL = 10,  /**< Bitset of wave_bool values in the payload. */
+} wave_binary_tag;
+
+/**
+ * \ingroup wave_binary_group
+ * \brief Header of the binary format.
+ */
+typedef struct wave_binary_header
+{
+    char _magic[WAVE_BINARY_MAGIC_SIZE];    /**< #WAVE_BINARY_MAGIC. */
+    uint32_t _byte_order;                   /**< \c 0x01020304, in the byte order of the writer. */
+    uint32_t _version;                      /**< Version of the format. */
+    uint64_t _node_count;                   /**< Number of nodes. */
+    uint64_t _payload_size;                 /**< Size of the payload, in bytes. */
+} wave_binary_header;
+
+/**
+ * \ingroup wave_binary_group
+ * \brief Node of the binary format.
+ *
+ * Tag                      | _first                    | _size
+ * ------------------------ | ------------------------- | -----------------
+ * #WAVE_BINARY_INT         | Value                     | 0
+ * #WAVE_BINARY_FLOAT       | Bits of the value         | 0
+ * #WAVE_BINARY_CHAR        | Value                     | 0
+ * #WAVE_BINARY_BOOL        | Value                     | 0
+ * #WAVE_BINARY_STRING      | Offset in the payload     | Length
+ * #WAVE_BINARY_SEQ         | Index of the first node   | Number of nodes
+ * #WAVE_BINARY_PAR         | Index of the first node   | Number of nodes
+ * #WAVE_BINARY_PAR_INT     | Offset in the payload     | Number of values
+ * #WAVE_BINARY_PAR_FLOAT   | Offset in the payload     | Number of values
+ * #WAVE_BINARY_PAR_BOOL    | Offset in the payload     | Number of values
+ *
+ * The bitsets are stored as whole 64 bits words, in the format of the bitset
+ * kernels (see wave_kernels_group).
+ */
+typedef struct wave_binary_node
+{
+    uint32_t _tag;                          /**< wave_binary_tag. */
+    uint32_t _reserved;                     /**< Reserved, 0. */
+    uint64_t _first;                        /**< Value, offset or index. */
+    uint64_t _size;                         /**< Size. */
+} wave_binary_node;
+
+////////////////////////////////////////////////////////////////////////////////
+// Writing.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Write a data in the binary format.
+ * \param stream Stream.
+ * \param data Data of interest.
+ * \retval true on success.
+ * \retval false otherwise.
+ * \relatesalso wave_data
+ * \warning \c stream and \c data must be not \c NULL.
+ */
+bool wave_data_write_binary (FILE * stream, const wave_data * data);
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the total size of a data in the binary format from its header.
+ * \param buffer Memory starting with a header.
+ * \param size Size of the memory.
+ * \return The size in bytes, or 0 if the header is not valid.
+ */
+size_t wave_binary_size (const void * buffer, size_t size);
+
+/**
+ * \brief Decode a data in the binary format.
+ * \param buffer Memory starting with a header.
+ * \param size Size of the memory.
+ * \param data Storage for the data.
+ * \return The size of the decoded data in bytes, or 0 if it is not valid.
+ * \relatesalso wave_data
+ *
+ * The nodes are allocated in the garbage collector. The strings and unboxed
+ * collections point into \c buffer when it is suitably aligned, thus
+ * \c buffer must stay valid and unmodified as long as \c data is used.
+ */
+size_t wave_data_from_binary (const void * buffer, size_t size, wave_data * data);
+
+/**
+ * \brief Map a file in the binary format.
+ * \param path Path of the file.
+ * \param data Storage for the data.
+ * \retval true on success.
+ * \retval false otherwise.
+ * \relatesalso wave_data
+ *
+ * The first data of the file is decoded without copying its strings and
+ * unboxed collections. The file stays mapped until the end of the program.
+ */
+bool wave_data_map_binary (const char * path, wave_data * data);
+
+#endif /* __WAVE_BINARY_H__ */
@@ -31,6 +31,8 @@
 #ifndef __WAVE_DATA_H__
 #define __WAVE_DATA_H__
 
+#include <stdint.h>
+
 #include "sysexits.h"
 
 #include "wave/common/wave_types.h"
@@ -48,6 +50,13 @@
 /**
  * \defgroup wave_data_group Wave Data
  * \ingroup lib_wave_group
+ *
+ * Operations on parallel collections are mapped on the elements with OpenMP.
+ * Collections smaller than two grains are processed sequentially; larger ones
+ * are split into tasks of at least one grain, and nested collections add their
+ * tasks to the running team instead of opening nested teams. The grain is read
+ * once from the \c WAVE_PAR_GRAIN environment variable (default: 256
+ * elements). Unboxed collections are processed by chunks of 4096 elements.
  */
 ////////////////////////////////////////////////////////////////////////////////
 // Enums, Structs, Typedefs.
@@ -67,36 +76,131 @@ typedef enum wave_data_type
     WAVE_DATA_BOOL,             /**< A boolean value */
     WAVE_DATA_SEQ,              /**< A sequential collection. */
     WAVE_DATA_PAR,              /**< A parallel collection. */
+    WAVE_DATA_PAR_INT,          /**< A parallel collection of unboxed integers. */
+    WAVE_DATA_PAR_FLOAT,        /**< A parallel collection of unboxed floating point values. */
+    WAVE_DATA_PAR_BOOL,         /**< A parallel collection of booleans, packed as a bitset. */
     WAVE_DATA_OPERATOR,         /**< An operator */
     WAVE_DATA_UNKNOWN,          /**< Used when no type is set yet */
 } wave_data_type;
 
+/**
+ * \ingroup wave_data_group
+ * \brief Flags of a wave_data.
+ */
+typedef enum wave_data_flag
+{
+    WAVE_DATA_FLAG_NONE = 0,                /**< No flag. */
+    WAVE_DATA_FLAG_SMALL_STRING = 1 << 0,   /**< The string is stored in the data itself. */
+    WAVE_DATA_FLAG_STRING_BUFFER = 1 << 1,  /**< The string is the beginning of a string buffer. */
+    WAVE_DATA_FLAG_OWNED = 1 << 2,          /**< The unboxed collection is referenced by this data only. */
+    WAVE_DATA_FLAG_LAST_USE = 1 << 3,       /**< The data is not read after the current operation. */
+} wave_data_flag;
+
+/**
+ * \ingroup wave_data_group
+ * \brief Maximal length of the strings stored in the data itself.
+ */
+#define WAVE_DATA_SMALL_STRING_MAX 11
+
+/**
+ * \ingroup wave_data_group
+ * \brief Maximal number of elements of a collection stored in a wave_data.
+ *
+ * This is also the maximal length of the strings stored in a
+ * wave_string_buffer.
+ */
+#define WAVE_DATA_SIZE_MAX UINT32_MAX
+
+/**
+ * \ingroup wave_data_group
+ * \brief Growable storage of the strings built by concatenation.
+ *
+ * The strings of a buffer all start at its first character: each one is a
+ * prefix of the next one. Thus, appending to the longest string of a buffer
+ * does not copy it.
+ */
+typedef struct wave_string_buffer
+{
+    size_t _used;               /**< Length of the longest string of the buffer. */
+    size_t _capacity;           /**< Maximal length of the strings of the buffer. */
+    wave_char _chars[];         /**< The characters. */
+} wave_string_buffer;
+
 /**
  * \brief Storage of wave data.
  * \ingroup wave_data_group
  * \sa wave_types_group
  *
  * wave_data is used in Wave programs to store a program's data.
+ *
+ * Parallel collections whose elements are all integers (resp. all floating
+ * point values) may be stored unboxed, as a contiguous \c wave_int (resp.
+ * \c wave_float) tab tagged with #WAVE_DATA_PAR_INT (resp.
+ * #WAVE_DATA_PAR_FLOAT). Parallel collections of booleans may be stored as
+ * bitsets tagged with #WAVE_DATA_PAR_BOOL, in the format of the bitset kernels
+ * of wave_kernels_group: comparisons of unboxed collections give such bitsets.
+ * Such collections behave exactly like #WAVE_DATA_PAR collections of atoms.
+ *
+ * Strings of at most #WAVE_DATA_SMALL_STRING_MAX characters may be stored in
+ * the data itself, flagged with #WAVE_DATA_FLAG_SMALL_STRING, instead of being
+ * allocated.
+ *
+ * The results of concatenations longer than #WAVE_DATA_SMALL_STRING_MAX are
+ * stored in a wave_string_buffer, flagged with #WAVE_DATA_FLAG_STRING_BUFFER,
+ * so that building a string by repeated concatenations takes linear time.
+ * Such strings are only null terminated while they are the longest string of
+ * their buffer.
+ *
+ * wave_data_get_string() and wave_data_get_characters() give access to all
+ * the kinds of strings.
+ *
+ * The unboxed collections computed by wave_data_unary() and wave_data_binary()
+ * are flagged with #WAVE_DATA_FLAG_OWNED. Copying such a data shares its tab,
+ * so the flag must be cleared on both copies. When the generated code knows an
+ * operand is not read anymore, it flags it with #WAVE_DATA_FLAG_LAST_USE: an
+ * operand carrying both flags gives its tab to the result of an element-wise
+ * operation, which is then computed in place.
+ *
+ * A wave_data takes 16 bytes: a union of 12 bytes, whose sizes are stored on
+ * 32 bits, followed by the type and the flags. The union is packed, so that the
+ * pointers it holds need no padding; they are still aligned, since wave_data
+ * is aligned on 8 bytes. The data do not know their parent collection: the
+ * navigation keeps track of the collections it goes through.
  */
 typedef struct wave_data
 {
-    wave_data_type _type;                  /**< The type of the current data. */
-    union
+    union __attribute__ ((packed))
     {
         wave_int _int;                     /**< The stored integer value. */
         wave_float _float;                 /**< The stored floating point value.*/
         wave_char _char;                   /**< The stored character value. */
         wave_string _string;               /**< The stored string value. */
+        wave_char _small_string[WAVE_DATA_SMALL_STRING_MAX + 1]; /**< The stored small string value. */
+        struct __attribute__ ((packed))
+        {
+            wave_string_buffer * _buffer;  /**< The buffer holding the characters. */
+            uint32_t _length;              /**< The length of the string. */
+        } _buffered;                       /**< The stored string, when it lies in a buffer. */
         wave_bool _bool;                   /**< The stored boolean value. */
-        struct
+        struct __attribute__ ((packed))
         {
             struct wave_data * _tab;       /**< The stored collection. */
-            size_t _size;                  /**< The size of the stored collection. */
+            uint32_t _size;                /**< The size of the stored collection. */
         } _collection;                     /**< The stored collection and its size. */
+        struct __attribute__ ((packed))
+        {
+            union
+            {
+                wave_int * _ints;          /**< The stored integer values. */
+                wave_float * _floats;      /**< The stored floating point values. */
+                uint64_t * _bits;          /**< The stored boolean values, as a bitset. */
+            } _tab;                        /**< The contiguous storage of the values. */
+            uint32_t _size;                /**< The size of the stored collection. */
+        } _packed;                         /**< The stored unboxed collection and its size. */
     } _content;                            /**< The union to store multiple data values */
-    size_t _index;                         /**< THe index. */
-    struct wave_data * _up;                /**< The upper wave_data */
-} wave_data;
+    uint8_t _type;                         /**< The wave_data_type of the current data. */
+    uint8_t _flags;                        /**< The wave_data_flag values of the current data. */
+} __attribute__ ((aligned (8))) wave_data;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Getters.
@@ -144,9 +248,26 @@ wave_char wave_data_get_char (const wave_data * data);
  * \return The string value.
  * \warning \c data must be not \c NULL.
  * \relatesalso wave_data
+ *
+ * Small strings are returned in place: the result is only valid as long as
+ * the data is not modified. wave_char values, as well as the strings of a
+ * buffer which are not its longest one, are copied in the garbage collector.
  */
 wave_string wave_data_get_string (const wave_data * data);
 
+/**
+ * \brief Get the characters of the string value stored within the data of interest.
+ * \param data Data of interest.
+ * \param length Storage for the length of the string.
+ * \return The characters, which are not necessarily null terminated.
+ * \warning \c data must be not \c NULL.
+ * \warning \c data must hold a string.
+ * \relatesalso wave_data
+ *
+ * Contrary to wave_data_get_string(), the characters are never copied.
+ */
+const wave_char * wave_data_get_characters (const wave_data * data, size_t * length);
+
 /**
  * \brief Get the boolean value stored within the data of interest.
  * \param data Data of interest.
@@ -156,6 +277,16 @@ wave_string wave_data_get_string (const wave_data * data);
  */
 wave_bool wave_data_get_bool (const wave_data * data);
 
+/**
+ * \brief Get the number of elements of the parallel collection stored within the data of interest.
+ * \param data Data of interest.
+ * \return The size of the collection.
+ * \warning \c data must be not \c NULL.
+ * \warning \c data must hold a parallel collection, either boxed or unboxed.
+ * \relatesalso wave_data
+ */
+size_t wave_data_get_par_size (const wave_data * data);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Properties.
 ////////////////////////////////////////////////////////////////////////////////
@@ -170,6 +301,26 @@ wave_bool wave_data_get_bool (const wave_data * data);
  */
 wave_bool wave_data_is_atom (const wave_data * data);
 
+/**
+ * \brief Determine whether the data holds a parallel collection.
+ * \param data Data of interest.
+ * \retval true if the data holds a parallel collection, either boxed or unboxed.
+ * \retval false otherwise.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ */
+wave_bool wave_data_is_par (const wave_data * data);
+
+/**
+ * \brief Determine whether the data holds a string stored in the data itself.
+ * \param data Data of interest.
+ * \retval true if the data holds a small string.
+ * \retval false otherwise.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ */
+wave_bool wave_data_is_small_string (const wave_data * data);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Setters.
 ////////////////////////////////////////////////////////////////////////////////
@@ -219,6 +370,56 @@ void wave_data_set_bool (wave_data * data, wave_bool b);
  */
 void wave_data_set_string (wave_data * data, wave_string s);
 
+/**
+ * \brief Store a copy of a string value inside a data.
+ * \param data Storage.
+ * \param s Characters of the string, not necessarily null terminated.
+ * \param length Number of characters.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ *
+ * Strings of at most #WAVE_DATA_SMALL_STRING_MAX characters are stored in
+ * the data itself, the others are copied in the garbage collector.
+ */
+void wave_data_set_string_copy (wave_data * data, const_wave_string s, size_t length);
+
+/**
+ * \brief Store an unboxed parallel collection of integers inside a data.
+ * \param data Storage.
+ * \param tab Contiguous integer values.
+ * \param size Number of values.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ * \warning \c tab is not copied: it must outlive \c data.
+ * \pre size <= #WAVE_DATA_SIZE_MAX
+ */
+void wave_data_set_par_int (wave_data * data, wave_int * tab, size_t size);
+
+/**
+ * \brief Store an unboxed parallel collection of floating point values inside a data.
+ * \param data Storage.
+ * \param tab Contiguous floating point values.
+ * \param size Number of values.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ * \warning \c tab is not copied: it must outlive \c data.
+ * \pre size <= #WAVE_DATA_SIZE_MAX
+ */
+void wave_data_set_par_float (wave_data * data, wave_float * tab, size_t size);
+
+/**
+ * \brief Store a parallel collection of booleans, packed as a bitset, inside a data.
+ * \param data Storage.
+ * \param bits Bitset, of WAVE_KERNELS_WORDS (size) words.
+ * \param size Number of values.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ * \warning \c bits is not copied: it must outlive \c data.
+ * \pre size <= #WAVE_DATA_SIZE_MAX
+ * \pre The bits past the last value are cleared.
+ */
+void wave_data_set_par_bool (wave_data * data, uint64_t * bits, size_t size);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Operations.
 ////////////////////////////////////////////////////////////////////////////////
@@ -230,6 +431,8 @@ void wave_data_set_string (wave_data * data, wave_string s);
  * \param op Operation.
  * \relatesalso wave_data
  * \warning \c operand and \c result must be not \c NULL.
+ * \warning The tab of an operand flagged with both #WAVE_DATA_FLAG_OWNED and
+ * #WAVE_DATA_FLAG_LAST_USE may be overwritten by the result.
  */
 void wave_data_unary (const wave_data * operand, wave_data * result, wave_operator op);
 
@@ -241,9 +444,87 @@ void wave_data_unary (const wave_data * operand, wave_data * result, wave_operat
  * \param op Operation.
  * \relatesalso wave_data
  * \warning \c left, \c right and \c result must be not \c NULL.
+ * \warning The tab of an operand flagged with both #WAVE_DATA_FLAG_OWNED and
+ * #WAVE_DATA_FLAG_LAST_USE may be overwritten by the result.
  */
 void wave_data_binary (const wave_data * left, const wave_data * right, wave_data * result, wave_operator op);
 
+/**
+ * \brief Compute the result of a binary operation on an atom and a parallel collection.
+ * \param left Left operand supplied to the operation.
+ * \param right Right operand supplied to the operation.
+ * \param result Storage for the result.
+ * \param op Operation.
+ * \relatesalso wave_data
+ * \warning \c left, \c right and \c result must be not \c NULL.
+ *
+ * The atom is combined with each element of the collection, without building a
+ * collection of copies of the atom; unboxed collections are given to the
+ * broadcast kernels. This gives the same result as wave_data_binary(), which
+ * is called when the operands are not an atom and a parallel collection.
+ */
+void wave_data_broadcast (const wave_data * left, const wave_data * right, wave_data * result, wave_operator op);
+
+/**
+ * \brief Determine whether an unary operation can be computed on an operand.
+ * \param operand Operand.
+ * \param op Operation.
+ * \retval true if wave_data_unary() computes the operation.
+ * \retval false if wave_data_unary() reports an error.
+ * \relatesalso wave_data
+ * \warning \c operand must be not \c NULL.
+ */
+bool wave_data_unary_is_defined (const wave_data * operand, wave_operator op);
+
+/**
+ * \brief Determine whether a binary operation can be computed on two operands.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param op Operation.
+ * \retval true if wave_data_binary() computes the operation.
+ * \retval false if wave_data_binary() reports an error, or if the operation
+ * divides an integer by zero.
+ * \relatesalso wave_data
+ * \warning \c left and \c right must be not \c NULL.
+ *
+ * The operands of parallel collections are checked element by element.
+ */
+bool wave_data_binary_is_defined (const wave_data * left, const wave_data * right, wave_operator op);
+
+////////////////////////////////////////////////////////////////////////////////
+// Memory.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Copy a data, sharing its contents.
+ * \param destination Storage for the copy.
+ * \param source Data to copy.
+ * \relatesalso wave_data
+ * \warning \c destination and \c source must be not \c NULL.
+ *
+ * #WAVE_DATA_FLAG_OWNED is cleared on both data, since they reference the same
+ * tab: neither of them may be updated in place anymore.
+ */
+void wave_data_share (wave_data * destination, wave_data * source);
+
+/**
+ * \brief Free the garbage allocated since a checkpoint, except the data still in use.
+ * \param mark Checkpoint.
+ * \param roots Tabs of data still in use.
+ * \param sizes Sizes of the tabs.
+ * \param count Number of tabs.
+ * \relatesalso wave_data
+ * \warning This function must be called outside of parallel regions.
+ *
+ * The strings and collections reachable from the roots which were allocated
+ * since \c mark are copied before wave_garbage_release_to() is called, and the
+ * roots are updated to point to the copies. Thus, a loop can free the
+ * temporaries of each iteration while keeping the values it carries to the
+ * next one. The copies are owned by the GC as if allocated after \c mark, so
+ * that the next release frees them too.
+ */
+void wave_data_release_to (wave_garbage_checkpoint mark, wave_data * const roots[], const size_t sizes[], size_t count);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Printing.
 ////////////////////////////////////////////////////////////////////////////////
@@ -257,4 +538,16 @@ void wave_data_binary (const wave_data * left, const wave_data * right, wave_dat
  */
 void wave_data_fprint (FILE * stream, const wave_data * data);
 
+/**
+ * \brief Print a data to the standard output.
+ * \param data Data of interest.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ *
+ * The data is printed as text followed by a newline with wave_output_print(),
+ * unless the environment variable \c WAVE_IO_FORMAT is set to \c binary, in
+ * which case it is written with wave_data_write_binary().
+ */
+void wave_data_print (const wave_data * data);
+
 #endif /* __WAVE_DATA_H__ */
@@ -39,6 +39,62 @@
 // Struct, Typedef.
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * \brief Memory chunk of a garbage collector.
+ * \ingroup lib_wave_group
+ *
+ * Chunks are large blocks in which wave_garbage_alloc() carves the requested
+ * memory by simply bumping an offset.
+ */
+typedef struct wave_garbage_chunk
+{
+    struct wave_garbage_chunk * _next;  /**< Next chunk. */
+    size_t _size;                       /**< Size of the data, in bytes. */
+    size_t _used;                       /**< Used bytes. */
+    unsigned char _data[] __attribute__ ((aligned (16))); /**< Data. */
+} wave_garbage_chunk;
+
+/**
+ * \brief Maximal number of nested checkpoints.
+ * \ingroup lib_wave_group
+ * \sa wave_garbage_mark()
+ */
+#define WAVE_GARBAGE_MARKS_MAX 16
+
+/**
+ * \brief Checkpoint of the garbage collectors.
+ * \ingroup lib_wave_group
+ * \sa wave_garbage_mark()
+ */
+typedef size_t wave_garbage_checkpoint;
+
+/**
+ * \brief State of a garbage collector at a checkpoint.
+ * \ingroup lib_wave_group
+ */
+typedef struct wave_garbage_state
+{
+    wave_garbage_chunk * _chunk;  /**< Current chunk. */
+    size_t _used;                 /**< Used bytes of the current chunk. */
+    wave_garbage_chunk * _large;  /**< Last large chunk. */
+    size_t _count;                /**< Count of registered pointers. */
+} wave_garbage_state;
+
+/**
+ * \brief Statistics of the garbage collectors.
+ * \ingroup lib_wave_group
+ * \sa wave_garbage_get_stats()
+ */
+typedef struct wave_garbage_stats
+{
+    size_t _bytes;                /**< Bytes allocated by wave_garbage_alloc(). */
+    size_t _objects;              /**< Objects allocated or registered. */
+    size_t _peak;                 /**< Peak count of registered pointers, summed over the threads. */
+    size_t _threads;              /**< Number of threads which allocated or registered objects. */
+    size_t _cleans;               /**< Number of calls to wave_garbage_clean(). */
+    double _clean_time;           /**< Time spent in wave_garbage_clean(), in seconds. */
+} wave_garbage_stats;
+
 /**
  * \brief Basic garbage collector.
  * \ingroup lib_wave_group
@@ -59,12 +115,39 @@
  * Thus, it is advised to call:
  * - wave_garbage_clean(): during the lifetime of the program.
  * - wave_garbage_destroy(): at the end of the program.
+ *
+ * wave_garbage_alloc() does not call malloc() for each object: the memory is
+ * taken from large chunks, each new chunk being twice as large as the previous
+ * one. wave_garbage_clean() only keeps the largest chunk, so that the cost of
+ * a clean depends on the number of chunks and registered pointers, not on the
+ * number of allocated objects.
+ *
+ * The memory allocated since a checkpoint taken by wave_garbage_mark() can be
+ * freed early with wave_garbage_release_to(), which is meant for the
+ * temporaries of the iterations of a loop.
+ *
+ * Each thread registers its memory in its own collector, so that allocating
+ * takes no lock. The collectors of all the threads are linked together and
+ * cleaned at once. Thus, wave_garbage_clean(), wave_garbage_destroy(),
+ * wave_garbage_mark() and wave_garbage_release_to() must not be called while
+ * other threads allocate, ie. they must be called outside of parallel regions.
  */
 typedef struct wave_garbage_collector
 {
     size_t _size;                 /**< Current size of the GC. */
     size_t _count;                /**< Count of currently registered pointers. */
     void ** _pointers;            /**< Registered pointers. */
+    wave_garbage_chunk * _chunks; /**< Chunks, the current one first. */
+    wave_garbage_chunk * _large;  /**< Chunks dedicated to large allocations. */
+    wave_garbage_chunk * _spare;  /**< Chunk kept by wave_garbage_release_to(). */
+    size_t _sorted_from;          /**< First registered pointer sorted by wave_garbage_is_released(). */
+    size_t _sorted_to;            /**< End of the registered pointers sorted by wave_garbage_is_released(). */
+    wave_garbage_state _marks[WAVE_GARBAGE_MARKS_MAX]; /**< States at the checkpoints. */
+    size_t _id;                   /**< Rank of the collector in the creation order. */
+    size_t _bytes;                /**< Bytes allocated since the statistics were reset. */
+    size_t _objects;              /**< Objects allocated or registered since the statistics were reset. */
+    size_t _peak;                 /**< Peak count of registered pointers since the statistics were reset. */
+    struct wave_garbage_collector * _next; /**< Collector of another thread. */
 } wave_garbage_collector;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -76,15 +159,10 @@ typedef struct wave_garbage_collector
  * \param size Size requested.
  * \return A pointer to the new memory or \c NULL in case of failure.
  * \note This function may set \c errno to \c ENOMEM.
- * \warning Do not free this memory ! It will be freed on a call to
- * wave_garbage_clean() or wave_garbage_destroy().
+ * \warning Do not free nor realloc this memory ! It will be freed on a call
+ * to wave_garbage_clean() or wave_garbage_destroy().
  *
- * The two following examples are equivalent:
- *     // First version.
- *     void * pointer = wave_garbage_alloc (size);
- *     // Second version.
- *     void * pointer = malloc (size);
- *     wave_garbage_register (pointer);
+ * The memory is aligned on 16 bytes.
  */
 void * wave_garbage_alloc (size_t size);
 
@@ -100,6 +178,116 @@ void * wave_garbage_alloc (size_t size);
  */
 void wave_garbage_register (void * pointer);
 
+/**
+ * \brief Allocate memory which is not registered yet.
+ * \param size Size.
+ * \return A pointer to the new memory or \c NULL in case of failure.
+ *
+ * The memory is not freed by wave_garbage_release_to() until it is given to
+ * the GC by wave_garbage_attach(), so that data can be moved to it before the
+ * temporaries are released. The memory is aligned on 16 bytes.
+ */
+void * wave_garbage_alloc_detached (size_t size);
+
+/**
+ * \brief Give memory allocated by wave_garbage_alloc_detached() to the GC.
+ * \param pointer Pointer returned by wave_garbage_alloc_detached().
+ * \warning Do not free this memory ! It will be freed on a call to
+ * wave_garbage_clean() or wave_garbage_destroy().
+ *
+ * The memory is owned as if it had just been allocated by wave_garbage_alloc():
+ * it is freed by a release to a checkpoint taken before this call, and
+ * wave_garbage_is_released() holds for any pointer inside it.
+ */
+void wave_garbage_attach (void * pointer);
+
+////////////////////////////////////////////////////////////////////////////////
+// Checkpoints.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Take a checkpoint of the garbage collectors.
+ * \return The checkpoint.
+ *
+ * Checkpoints are nested: taking a checkpoint after releasing to an older one
+ * replaces the checkpoints taken in between. wave_garbage_clean() and
+ * wave_garbage_destroy() drop all the checkpoints.
+ *
+ * Beyond #WAVE_GARBAGE_MARKS_MAX nested checkpoints, the returned checkpoint
+ * is ignored by wave_garbage_release_to().
+ */
+wave_garbage_checkpoint wave_garbage_mark (void);
+
+/**
+ * \brief Free the memory allocated or registered since a checkpoint.
+ * \param mark Checkpoint.
+ *
+ * The checkpoint stays valid, so that a loop can release its temporaries at
+ * the end of each iteration. The checkpoints taken after \c mark are dropped.
+ */
+void wave_garbage_release_to (wave_garbage_checkpoint mark);
+
+/**
+ * \brief Register a pointer in the GC so that it survives a checkpoint.
+ * \param mark Checkpoint.
+ * \param pointer Pointer to register.
+ * \pre The calling thread registered nothing since \c mark, eg.
+ * wave_garbage_release_to() was just called with \c mark.
+ *
+ * The pointer is registered as if it had been registered before \c mark, so
+ * that it is not freed by wave_garbage_release_to(). If the precondition does
+ * not hold, the pointer is not registered at all.
+ */
+void wave_garbage_retain (wave_garbage_checkpoint mark, void * pointer);
+
+/**
+ * \brief Determine whether a pointer would be freed by wave_garbage_release_to().
+ * \param mark Checkpoint.
+ * \param pointer Pointer.
+ * \retval true if \c pointer was allocated or registered since \c mark.
+ * \retval false otherwise.
+ */
+bool wave_garbage_is_released (wave_garbage_checkpoint mark, const void * pointer);
+
+////////////////////////////////////////////////////////////////////////////////
+// Statistics.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the statistics of the garbage collectors.
+ * \param stats Storage for the statistics.
+ *
+ * The statistics cover all the threads since the last call to
+ * wave_garbage_reset_stats().
+ */
+void wave_garbage_get_stats (wave_garbage_stats * stats);
+
+/**
+ * \brief Reset the statistics of the garbage collectors.
+ */
+void wave_garbage_reset_stats (void);
+
+/**
+ * \brief Print the statistics of the garbage collectors to a stream.
+ * \param stream Stream.
+ * \param label Label of the statistics.
+ *
+ * A summary is printed, followed by the allocations of each thread.
+ */
+void wave_garbage_fprint_stats (FILE * stream, const char * label);
+
+/**
+ * \brief Report the statistics if the user asked for them.
+ * \param label Label of the statistics.
+ *
+ * When the \c WAVE_RUNTIME_STATS environment variable is set to a value other
+ * than \c 0, the statistics are printed to \c stderr, then reset. Otherwise,
+ * nothing is done.
+ *
+ * Compiled Wave programs call this function after each phrase.
+ */
+void wave_garbage_report_stats (const char * label);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cleaning, destroying.
 ////////////////////////////////////////////////////////////////////////////////
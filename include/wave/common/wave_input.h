@@ -0,0 +1,129 @@
+/**
+ * \file wave_input.h
+ * \brief Wave input reader.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __WAVE_INPUT_H__
+#define __WAVE_INPUT_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "wave/common/wave_data.h"
+
+/**
+ * \defgroup wave_input_group Wave Input
+ * \ingroup lib_wave_group
+ *
+ * The input of a Wave program is a text made of Wave literals separated by
+ * blanks: integers, floating point values, booleans, characters, strings and
+ * collections such as `(1;2;3)` or `("a"||("b";'c'))`. This is the format
+ * of wave_data_fprint().
+ *
+ * The input is read from the file named by the \c WAVE_INPUT environment
+ * variable, or from the standard input if it is not set. Regular files are
+ * mapped in memory; other files are read by large blocks. The values are
+ * parsed in a single pass and stored in the garbage collector: parallel
+ * collections of integers only (resp. floating point values only) are stored
+ * unboxed.
+ *
+ * Values written with wave_data_write_binary() are recognized by their magic
+ * number and may be mixed with the text values. When the input is mapped, the
+ * strings and unboxed collections of these values point into the mapping and
+ * remain valid until wave_input_close() is called.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Opening, closing.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Open the input.
+ * \param path Path of the file, or \c NULL or \c "-" for the standard input.
+ * \retval true if the input could be opened.
+ * \retval false otherwise.
+ *
+ * The previous input, if any, is closed. It is not necessary to call this
+ * function: the input is opened on the first read.
+ */
+bool wave_input_open (const char * path);
+
+/**
+ * \brief Open an input held in memory.
+ * \param buffer Contents of the input.
+ * \param size Size of the contents, in bytes.
+ *
+ * The previous input, if any, is closed. The input is read as if it were a
+ * mapped file: \c buffer must stay valid and unmodified until
+ * wave_input_close() is called.
+ */
+void wave_input_open_memory (const void * buffer, size_t size);
+
+/**
+ * \brief Close the input.
+ */
+void wave_input_close (void);
+
+/**
+ * \brief Limit the number of elements of the collections of the input.
+ * \param max Maximal number of elements, at most #WAVE_DATA_SIZE_MAX.
+ *
+ * Reading a larger collection is an error, detected before its extra elements
+ * are stored, so that the memory used by an untrusted input is bounded. The
+ * limit is #WAVE_DATA_SIZE_MAX by default.
+ */
+void wave_input_set_collection_max (size_t max);
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Read the next value of the input.
+ * \param data Storage for the value.
+ * \retval true if a value was read.
+ * \retval false at the end of the input.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ *
+ * The program exits if the input is malformed.
+ */
+bool wave_input_next (wave_data * data);
+
+/**
+ * \brief Read the next value of the input for the \c read operator.
+ * \param data Storage for the value.
+ * \relatesalso wave_data
+ * \warning \c data must be not \c NULL.
+ *
+ * The program exits if the input is malformed or if there is no value left.
+ */
+void wave_input_read (wave_data * data);
+
+#endif /* __WAVE_INPUT_H__ */
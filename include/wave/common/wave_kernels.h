@@ -0,0 +1,440 @@
+/**
+ * \file wave_kernels.h
+ * \brief Wave element-wise kernels.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __WAVE_KERNELS_H__
+#define __WAVE_KERNELS_H__
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wave/common/wave_types.h"
+#include "wave/common/wave_operator.h"
+
+/**
+ * \defgroup wave_kernels_group Wave Kernels
+ * \ingroup lib_wave_group
+ *
+ * The kernels apply an operation to whole contiguous tabs of wave_int or
+ * wave_float values. They give exactly the same results as the element-wise
+ * wave_int_* and wave_float_* functions, except for the sine, cosine,
+ * logarithm and exponential of wave_float values: the vector instruction sets
+ * compute them with polynomial approximations which are at most 1 ULP away from
+ * the C library. The tab of the results may be the tab of an operand, so that
+ * operations can be computed in place.
+ *
+ * The broadcast kernels combine a single value with each element of a tab. The
+ * value is read once, and the results are the same as with a tab holding as
+ * many copies of the value.
+ *
+ * The bitset kernels store wave_bool values as bits: the value of index \c i is
+ * the bit <tt>i % WAVE_KERNELS_WORD_BITS</tt> of the word
+ * <tt>i / WAVE_KERNELS_WORD_BITS</tt>. They write whole words, and the bits past
+ * the last value are always cleared.
+ *
+ * The instruction set is chosen at runtime, according to the capabilities of
+ * the processor: SSE2, AVX2 or AVX-512 on x86 processors, plain scalar code
+ * otherwise.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \ingroup wave_kernels_group
+ * \brief Number of wave_bool values in a word of a bitset.
+ */
+#define WAVE_KERNELS_WORD_BITS 64
+
+/**
+ * \ingroup wave_kernels_group
+ * \brief Number of words of a bitset.
+ * \param size Number of wave_bool values.
+ */
+#define WAVE_KERNELS_WORDS(size) (((size) + WAVE_KERNELS_WORD_BITS - 1) / WAVE_KERNELS_WORD_BITS)
+
+////////////////////////////////////////////////////////////////////////////////
+// Enums, Structs, Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \ingroup wave_kernels_group
+ * \brief Instruction sets of the kernels.
+ */
+typedef enum wave_kernels_level
+{
+    WAVE_KERNELS_SCALAR = 0,    /**< Scalar code. */
+    WAVE_KERNELS_SSE2,          /**< 128 bits vectors. */
+    WAVE_KERNELS_AVX2,          /**< 256 bits vectors. */
+    WAVE_KERNELS_AVX512,        /**< 512 bits vectors. */
+    WAVE_KERNELS_UNKNOWN,       /**< Used when no level is chosen yet. */
+} wave_kernels_level;
+
+////////////////////////////////////////////////////////////////////////////////
+// Instruction set selection.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the best instruction set supported by the processor.
+ * \return Level.
+ * \relatesalso wave_kernels_level
+ */
+wave_kernels_level wave_kernels_get_best_level (void);
+
+/**
+ * \brief Get the instruction set currently used by the kernels.
+ * \return Level.
+ * \relatesalso wave_kernels_level
+ */
+wave_kernels_level wave_kernels_get_level (void);
+
+/**
+ * \brief Force the instruction set used by the kernels.
+ * \param level Level.
+ * \relatesalso wave_kernels_level
+ *
+ * Levels which are not supported by the processor are replaced by the best
+ * supported level.
+ */
+void wave_kernels_set_level (wave_kernels_level level);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Determine whether an unary operation on wave_int values has a kernel.
+ * \param op Operation.
+ * \retval true if wave_kernels_int_unary() accepts the operation.
+ * \retval false otherwise.
+ */
+bool wave_kernels_has_int_unary (wave_operator op);
+
+/**
+ * \brief Determine whether an unary operation on wave_float values has a kernel.
+ * \param op Operation.
+ * \retval true if wave_kernels_float_unary() accepts the operation.
+ * \retval false otherwise.
+ */
+bool wave_kernels_has_float_unary (wave_operator op);
+
+/**
+ * \brief Determine whether a binary operation on wave_int values has a kernel.
+ * \param op Operation.
+ * \retval true if wave_kernels_int_binary() or wave_kernels_int_test() accepts the operation.
+ * \retval false otherwise.
+ */
+bool wave_kernels_has_int_binary (wave_operator op);
+
+/**
+ * \brief Determine whether a binary operation on wave_float values has a kernel.
+ * \param op Operation.
+ * \retval true if wave_kernels_float_binary() or wave_kernels_float_test() accepts the operation.
+ * \retval false otherwise.
+ */
+bool wave_kernels_has_float_binary (wave_operator op);
+
+/**
+ * \brief Determine whether a binary operation on wave_bool values has a kernel.
+ * \param op Operation.
+ * \retval true if wave_kernels_bool_binary() accepts the operation.
+ * \retval false otherwise.
+ */
+bool wave_kernels_has_bool_binary (wave_operator op);
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Apply an unary operation to a tab of wave_int values.
+ * \param op Operation.
+ * \param operand Operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_int_unary (op)
+ */
+void wave_kernels_int_unary (wave_operator op, const wave_int * operand, wave_int * result, size_t size);
+
+/**
+ * \brief Apply an unary operation to a tab of wave_float values.
+ * \param op Operation.
+ * \param operand Operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_float_unary (op)
+ */
+void wave_kernels_float_unary (wave_operator op, const wave_float * operand, wave_float * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to two tabs of wave_int values.
+ * \param op Operation.
+ * \param left Left operands.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_int_binary (op) and \c op is not a test.
+ */
+void wave_kernels_int_binary (wave_operator op, const wave_int * left, const wave_int * right, wave_int * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to two tabs of wave_float values.
+ * \param op Operation.
+ * \param left Left operands.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_float_binary (op) and \c op is not a test.
+ */
+void wave_kernels_float_binary (wave_operator op, const wave_float * left, const wave_float * right, wave_float * result, size_t size);
+
+/**
+ * \brief Apply a test to two tabs of wave_int values.
+ * \param op Test.
+ * \param left Left operands.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_int_test (wave_operator op, const wave_int * left, const wave_int * right, wave_bool * result, size_t size);
+
+/**
+ * \brief Apply a test to two tabs of wave_float values.
+ * \param op Test.
+ * \param left Left operands.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_float_test (wave_operator op, const wave_float * left, const wave_float * right, wave_bool * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to a wave_int value and each value of a tab.
+ * \param op Operation.
+ * \param left Left operand.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_int_binary (op) and \c op is not a test.
+ */
+void wave_kernels_int_broadcast_left (wave_operator op, wave_int left, const wave_int * right, wave_int * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to each value of a tab and a wave_int value.
+ * \param op Operation.
+ * \param left Left operands.
+ * \param right Right operand.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_int_binary (op) and \c op is not a test.
+ */
+void wave_kernels_int_broadcast_right (wave_operator op, const wave_int * left, wave_int right, wave_int * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to a wave_float value and each value of a tab.
+ * \param op Operation.
+ * \param left Left operand.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_float_binary (op) and \c op is not a test.
+ */
+void wave_kernels_float_broadcast_left (wave_operator op, wave_float left, const wave_float * right, wave_float * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to each value of a tab and a wave_float value.
+ * \param op Operation.
+ * \param left Left operands.
+ * \param right Right operand.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_float_binary (op) and \c op is not a test.
+ */
+void wave_kernels_float_broadcast_right (wave_operator op, const wave_float * left, wave_float right, wave_float * result, size_t size);
+
+/**
+ * \brief Apply a test to a wave_int value and each value of a tab.
+ * \param op Test.
+ * \param left Left operand.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_int_test_broadcast_left (wave_operator op, wave_int left, const wave_int * right, wave_bool * result, size_t size);
+
+/**
+ * \brief Apply a test to each value of a tab and a wave_int value.
+ * \param op Test.
+ * \param left Left operands.
+ * \param right Right operand.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_int_test_broadcast_right (wave_operator op, const wave_int * left, wave_int right, wave_bool * result, size_t size);
+
+/**
+ * \brief Apply a test to a wave_float value and each value of a tab.
+ * \param op Test.
+ * \param left Left operand.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_float_test_broadcast_left (wave_operator op, wave_float left, const wave_float * right, wave_bool * result, size_t size);
+
+/**
+ * \brief Apply a test to each value of a tab and a wave_float value.
+ * \param op Test.
+ * \param left Left operands.
+ * \param right Right operand.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_float_test_broadcast_right (wave_operator op, const wave_float * left, wave_float right, wave_bool * result, size_t size);
+
+////////////////////////////////////////////////////////////////////////////////
+// Bitset kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Apply a test to two tabs of wave_int values, into a bitset.
+ * \param op Test.
+ * \param left Left operands.
+ * \param right Right operands.
+ * \param result Storage for the results, of WAVE_KERNELS_WORDS (size) words.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_int_test_bits (wave_operator op, const wave_int * left, const wave_int * right, uint64_t * result, size_t size);
+
+/**
+ * \brief Apply a test to two tabs of wave_float values, into a bitset.
+ * \param op Test.
+ * \param left Left operands.
+ * \param right Right operands.
+ * \param result Storage for the results, of WAVE_KERNELS_WORDS (size) words.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_float_test_bits (wave_operator op, const wave_float * left, const wave_float * right, uint64_t * result, size_t size);
+
+/**
+ * \brief Apply a test to a wave_int value and each value of a tab, into a bitset.
+ * \param op Test.
+ * \param left Left operand.
+ * \param right Right operands.
+ * \param result Storage for the results, of WAVE_KERNELS_WORDS (size) words.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_int_test_bits_broadcast_left (wave_operator op, wave_int left, const wave_int * right, uint64_t * result, size_t size);
+
+/**
+ * \brief Apply a test to each value of a tab and a wave_int value, into a bitset.
+ * \param op Test.
+ * \param left Left operands.
+ * \param right Right operand.
+ * \param result Storage for the results, of WAVE_KERNELS_WORDS (size) words.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_int_test_bits_broadcast_right (wave_operator op, const wave_int * left, wave_int right, uint64_t * result, size_t size);
+
+/**
+ * \brief Apply a test to a wave_float value and each value of a tab, into a bitset.
+ * \param op Test.
+ * \param left Left operand.
+ * \param right Right operands.
+ * \param result Storage for the results, of WAVE_KERNELS_WORDS (size) words.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_float_test_bits_broadcast_left (wave_operator op, wave_float left, const wave_float * right, uint64_t * result, size_t size);
+
+/**
+ * \brief Apply a test to each value of a tab and a wave_float value, into a bitset.
+ * \param op Test.
+ * \param left Left operands.
+ * \param right Right operand.
+ * \param result Storage for the results, of WAVE_KERNELS_WORDS (size) words.
+ * \param size Number of elements.
+ * \pre wave_operator_is_test (op)
+ */
+void wave_kernels_float_test_bits_broadcast_right (wave_operator op, const wave_float * left, wave_float right, uint64_t * result, size_t size);
+
+/**
+ * \brief Negate each value of a bitset.
+ * \param operand Operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ */
+void wave_kernels_bool_not (const uint64_t * operand, uint64_t * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to two bitsets.
+ * \param op Operation.
+ * \param left Left operands.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_bool_binary (op)
+ */
+void wave_kernels_bool_binary (wave_operator op, const uint64_t * left, const uint64_t * right, uint64_t * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to a wave_bool value and each value of a bitset.
+ * \param op Operation.
+ * \param left Left operand.
+ * \param right Right operands.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_bool_binary (op)
+ */
+void wave_kernels_bool_broadcast_left (wave_operator op, wave_bool left, const uint64_t * right, uint64_t * result, size_t size);
+
+/**
+ * \brief Apply a binary operation to each value of a bitset and a wave_bool value.
+ * \param op Operation.
+ * \param left Left operands.
+ * \param right Right operand.
+ * \param result Storage for the results.
+ * \param size Number of elements.
+ * \pre wave_kernels_has_bool_binary (op)
+ */
+void wave_kernels_bool_broadcast_right (wave_operator op, const uint64_t * left, wave_bool right, uint64_t * result, size_t size);
+
+#endif /* __WAVE_KERNELS_H__ */
@@ -0,0 +1,172 @@
+/**
+ * \file wave_output.h
+ * \brief Wave output engine.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __WAVE_OUTPUT_H__
+#define __WAVE_OUTPUT_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "wave/common/wave_types.h"
+#include "wave/common/wave_data.h"
+
+/**
+ * \defgroup wave_output_group Wave Output
+ * \ingroup lib_wave_group
+ *
+ * The output engine formats the data as text into byte buffers with
+ * wave_int_to_chars() and wave_float_to_chars(), and writes the buffers with
+ * \c writev.
+ *
+ * A single buffer holds the standard output of all the threads. It is
+ * written when it is full, when the program exits, or after each value when
+ * the standard output is a terminal. Inside parallel regions, the threads
+ * append their values to it in turn, in a critical section: the values are
+ * never mixed, and keep the order in which they are printed.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Enums, Structs, Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \ingroup wave_output_group
+ * \brief Output buffer.
+ *
+ * Buffers which have a file descriptor are written to it when they are full,
+ * the others grow as needed.
+ */
+typedef struct wave_output_buffer
+{
+    char * _data;       /**< Bytes. */
+    size_t _size;       /**< Size of the storage. */
+    size_t _used;       /**< Number of bytes used. */
+    int _fd;            /**< File descriptor, or -1. */
+} wave_output_buffer;
+
+////////////////////////////////////////////////////////////////////////////////
+// Buffers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a buffer.
+ * \param buffer Buffer.
+ * \param fd File descriptor to which the buffer is written when it is full, or -1.
+ * \relatesalso wave_output_buffer
+ */
+void wave_output_buffer_init (wave_output_buffer * buffer, int fd);
+
+/**
+ * \brief Free the storage of a buffer.
+ * \param buffer Buffer.
+ * \relatesalso wave_output_buffer
+ * \note The bytes are not written.
+ */
+void wave_output_buffer_free (wave_output_buffer * buffer);
+
+/**
+ * \brief Append bytes to a buffer.
+ * \param buffer Buffer.
+ * \param bytes Bytes.
+ * \param size Number of bytes.
+ * \relatesalso wave_output_buffer
+ */
+void wave_output_buffer_append (wave_output_buffer * buffer, const char * bytes, size_t size);
+
+/**
+ * \brief Append a wave_int to a buffer.
+ * \param buffer Buffer.
+ * \param i Value.
+ * \relatesalso wave_output_buffer
+ *
+ * The text is the one of wave_int_to_chars().
+ */
+void wave_output_buffer_append_int (wave_output_buffer * buffer, wave_int i);
+
+/**
+ * \brief Append a wave_float to a buffer.
+ * \param buffer Buffer.
+ * \param f Value.
+ * \relatesalso wave_output_buffer
+ *
+ * The text is the one of wave_float_to_chars(), with six decimals.
+ */
+void wave_output_buffer_append_float (wave_output_buffer * buffer, wave_float f);
+
+/**
+ * \brief Append a data to a buffer.
+ * \param buffer Buffer.
+ * \param data Data of interest.
+ * \relatesalso wave_output_buffer
+ *
+ * The text is the same as the one of wave_data_fprint().
+ */
+void wave_output_buffer_append_data (wave_output_buffer * buffer, const wave_data * data);
+
+/**
+ * \brief Write the content of a buffer to its file descriptor and empty it.
+ * \param buffer Buffer.
+ * \relatesalso wave_output_buffer
+ * \pre The buffer has a file descriptor.
+ */
+void wave_output_buffer_flush (wave_output_buffer * buffer);
+
+////////////////////////////////////////////////////////////////////////////////
+// Writing.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Write the content of several buffers to a file descriptor.
+ * \param fd File descriptor.
+ * \param buffers Buffers, written in order.
+ * \param count Number of buffers.
+ *
+ * The buffers are written with as few system calls as possible, and are not
+ * emptied. The program exits in case of failure.
+ */
+void wave_output_write (int fd, const wave_output_buffer buffers[], size_t count);
+
+/**
+ * \brief Print a data and a newline to the standard output.
+ * \param data Data of interest.
+ *
+ * The text goes to the standard output buffer. Outside of parallel regions,
+ * the large collections are instead formatted by chunks on all the threads,
+ * and the chunks are written in order: the text is the same.
+ */
+void wave_output_print (const wave_data * data);
+
+/**
+ * \brief Write the standard output buffer.
+ */
+void wave_output_flush (void);
+
+#endif /* __WAVE_OUTPUT_H__ */
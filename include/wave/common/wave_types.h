@@ -231,6 +231,12 @@ typedef int wave_int;
  */
 typedef double wave_float;
 
+/**
+ * \brief Tolerance of the wave_float comparisons.
+ * \relatesalso wave_float
+ */
+#define WAVE_FLOAT_EPSILON 1.0e-5
+
 /**
  * \class wave_char
  * \ingroup wave_types_group
@@ -508,6 +514,18 @@ wave_int wave_int_from_wave_float (wave_float f);
  */
 wave_int wave_int_from_string (const char * str);
 
+/**
+ * \brief Convert the initial portion of a null terminated string to a wave_int.
+ * \param str A null terminated string.
+ * \param end Storage for the end of the converted portion, or \c NULL.
+ * \return The converted value, or 0 if there are no digits.
+ * \relatesalso wave_int
+ *
+ * Like \c atoi, leading blanks and a sign are accepted, and the values out
+ * of range wrap around. \c end is set to \c str if there are no digits.
+ */
+wave_int wave_int_parse (const char * str, const char ** end);
+
 /**
  * \brief The \c unary \c plus operation.
  * \param a A wave_int.
@@ -734,6 +752,23 @@ wave_bool wave_int_lesser (wave_int a, wave_int b);
  */
 wave_char wave_int_chr (wave_int i);
 
+/**
+ * \brief Maximal number of characters written by wave_int_to_chars().
+ * \relatesalso wave_int
+ */
+#define WAVE_INT_CHARS_MAX 12
+
+/**
+ * \brief Write a wave_int in decimal.
+ * \param buffer Storage for the characters, of at least #WAVE_INT_CHARS_MAX characters.
+ * \param i Value.
+ * \return Number of characters written, without any trailing \c '\0'.
+ * \relatesalso wave_int
+ *
+ * The digits are produced two at a time.
+ */
+size_t wave_int_to_chars (char * buffer, wave_int i);
+
 /**
  * \brief Print a wave_int to a stream.
  * \param stream Stream.
@@ -967,11 +1002,61 @@ wave_bool wave_float_lesser (wave_float a, wave_float b);
  */
 wave_float wave_float_from_string (const char * str);
 
+/**
+ * \brief Convert the initial portion of a null terminated string to a wave_float.
+ * \param str A null terminated string.
+ * \param end Storage for the end of the converted portion, or \c NULL.
+ * \return The converted value.
+ * \relatesalso wave_float
+ *
+ * The result is the same as the one of \c strtod, which is only called when
+ * the value can not be computed with a single exact operation: more than 19
+ * significant digits, decimal exponent beyond 22, infinite values, NaN and
+ * hexadecimal values.
+ */
+wave_float wave_float_parse (const char * str, const char ** end);
+
+/**
+ * \brief Maximal number of characters written by wave_float_to_chars() and wave_float_to_chars_shortest().
+ * \relatesalso wave_float
+ */
+#define WAVE_FLOAT_CHARS_MAX 320
+
+/**
+ * \brief Write a wave_float in decimal, with six decimals.
+ * \param buffer Storage for the characters, of at least #WAVE_FLOAT_CHARS_MAX characters.
+ * \param f Value.
+ * \return Number of characters written, without any trailing \c '\0'.
+ * \relatesalso wave_float
+ *
+ * The text is the same as the one of \c printf ("%f"), which is only called
+ * for the infinite values, NaN, and the values whose binary expansion is too
+ * long.
+ */
+size_t wave_float_to_chars (char * buffer, wave_float f);
+
+/**
+ * \brief Write the shortest decimal text which reads back as a wave_float.
+ * \param buffer Storage for the characters, of at least #WAVE_FLOAT_CHARS_MAX characters.
+ * \param f Value.
+ * \return Number of characters written, without any trailing \c '\0'.
+ * \relatesalso wave_float
+ *
+ * The digits are computed with the Grisu2 algorithm: they always read back as
+ * \c f, and are the shortest ones except in rare cases, mostly when a shorter
+ * text lies exactly halfway between two values: 1e23 is written
+ * \c 9.999999999999999e22. The text always holds a \c '.' or an exponent, such as \c 0.1,
+ * \c 100.0 or \c 1.5e-7.
+ */
+size_t wave_float_to_chars_shortest (char * buffer, wave_float f);
+
 /**
  * \brief Print a wave_float to a stream.
  * \param stream Stream.
  * \param f Value.
  * \relatesalso wave_float
+ *
+ * The text is the one of wave_float_to_chars_shortest().
  */
 void wave_float_fprint (FILE * stream, wave_float f);
 
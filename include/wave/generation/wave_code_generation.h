@@ -38,9 +38,11 @@
 #include "wave/common/wave_types.h"
 #include "wave/ast/wave_phrase.h"
 #include "wave/generation/wave_headers.h"
+#include "wave/generation/wave_emitter.h"
 #include "wave/generation/wave_generation_common.h"
 #include "wave/generation/wave_generation_atom.h"
 #include "wave/generation/wave_generation_curly.h"
+#include "wave/generation/wave_generation_fold.h"
 
 /**
  * \brief Generate C source code giving a wave AST.
@@ -54,13 +56,12 @@ void wave_code_generation_generate (FILE * output_file, const wave_phrase * phra
 
 /**
  * \brief Generate C source code giving a collection.
- * \param code_file The file where the C code will be written.
- * \param alloc_file File for allocations.
+ * \param emitter The emitter where the C code will be written.
  * \param collection The collection to translate into C code.
- * \pre code_file and collection must not be NULL.
+ * \pre emitter and collection must not be NULL.
  * \relatesalso wave_collection
  * \note  Collections in phrases must have already been indexed.
  */
-void wave_code_generation_collection (FILE * const code_file, FILE * const alloc_file, const wave_collection * collection);
+void wave_code_generation_collection (wave_emitter * emitter, const wave_collection * collection);
 
 #endif // ( __WAVE_CODE_GENERATION_H )
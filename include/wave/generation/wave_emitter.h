@@ -0,0 +1,131 @@
+/**
+ * \file wave_emitter.h
+ * \brief Wave code generation, emitter.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __WAVE_EMITTER_H__
+#define __WAVE_EMITTER_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+/**
+ * \defgroup wave_emitter_group Wave Emitter
+ *
+ * The emitter holds the generated C code in memory until it is complete.
+ *
+ * The code of a phrase is written to two sections: the allocations of the
+ * tabs, which are discovered while generating the code but must come first,
+ * and the code itself. Once a phrase is complete, both sections are appended
+ * to the program, which is written to the output at once.
+ *
+ * Each section is a stream backed by a growable buffer, so that the
+ * generation functions print to it like to any file.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Enums, Structs, Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \ingroup wave_emitter_group
+ * \brief Sections of an emitter.
+ */
+typedef enum wave_emitter_section
+{
+    WAVE_EMITTER_PROGRAM = 0,   /**< Headers and complete functions. */
+    WAVE_EMITTER_ALLOCATIONS,   /**< Allocations of the current phrase. */
+    WAVE_EMITTER_CODE,          /**< Code of the current phrase. */
+    WAVE_EMITTER_SECTION_COUNT, /**< Number of sections. */
+} wave_emitter_section;
+
+/**
+ * \ingroup wave_emitter_group
+ * \brief Emitter.
+ */
+typedef struct wave_emitter
+{
+    FILE * _streams[WAVE_EMITTER_SECTION_COUNT];    /**< Streams of the sections. */
+    char * _buffers[WAVE_EMITTER_SECTION_COUNT];    /**< Buffers behind the streams. */
+    size_t _sizes[WAVE_EMITTER_SECTION_COUNT];      /**< Sizes of the buffers. */
+} wave_emitter;
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization, cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize an emitter.
+ * \param emitter Emitter.
+ * \relatesalso wave_emitter
+ * \note Exits the program if memory is lacking.
+ */
+void wave_emitter_init (wave_emitter * emitter);
+
+/**
+ * \brief Free the buffers of an emitter.
+ * \param emitter Emitter.
+ * \relatesalso wave_emitter
+ * \note The code is not written.
+ */
+void wave_emitter_clean (wave_emitter * emitter);
+
+////////////////////////////////////////////////////////////////////////////////
+// Emitting.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the stream of a section.
+ * \param emitter Emitter.
+ * \param section Section.
+ * \return Stream.
+ * \relatesalso wave_emitter
+ */
+FILE * wave_emitter_stream (wave_emitter * emitter, wave_emitter_section section);
+
+/**
+ * \brief Append the current phrase to the program.
+ * \param emitter Emitter.
+ * \relatesalso wave_emitter
+ *
+ * The allocations are appended, then the code. Both sections are emptied.
+ */
+void wave_emitter_end_phrase (wave_emitter * emitter);
+
+/**
+ * \brief Write the program to a stream.
+ * \param emitter Emitter.
+ * \param stream Stream.
+ * \retval true on success.
+ * \retval false otherwise.
+ * \relatesalso wave_emitter
+ */
+bool wave_emitter_write (wave_emitter * emitter, FILE * stream);
+
+#endif /* __WAVE_EMITTER_H__ */
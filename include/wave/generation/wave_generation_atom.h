@@ -34,15 +34,15 @@
 #include "wave/ast/wave_atom.h"
 #include "wave/ast/wave_collection.h"
 #include "wave/generation/wave_generation_operators.h"
+#include "wave/generation/wave_emitter.h"
 
 /**
  * \brief Generate C source code giving an atom.
- * \param code_file The file where the C code will be written.
- * \param alloc_file File for allocations.
+ * \param emitter The emitter where the C code will be written.
  * \param collection The atom to translate into C code.
- * \pre code_file and collection must not be NULL.
+ * \pre emitter and collection must not be NULL.
  * \relatesalso wave_collection
  */
-void wave_code_generation_atom(FILE* code_file, FILE * alloc_file, const wave_collection* collection);
+void wave_code_generation_atom(wave_emitter * emitter, const wave_collection* collection);
 
 #endif /* __WAVE_GENERATION_ATOM_H__ */
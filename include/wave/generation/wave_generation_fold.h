@@ -0,0 +1,92 @@
+/**
+ * \file wave_generation_fold.h
+ * \brief Wave code generation, constant folding.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __WAVE_GENERATION_FOLD_H__
+#define __WAVE_GENERATION_FOLD_H__
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "wave/common/wave_data.h"
+#include "wave/ast/wave_collection.h"
+#include "wave/generation/wave_generation_common.h"
+
+/**
+ * \brief Prepare the folding of the constants of a phrase.
+ * \param phrase The collection of the phrase.
+ * \pre phrase must not be NULL.
+ * \relatesalso wave_collection
+ *
+ * The collections are folded unless the phrase contains paths, which may
+ * address their elements.
+ */
+void wave_code_generation_prepare_fold (const wave_collection * phrase);
+
+/**
+ * \brief Compute the values of the elements of a list known at compile time.
+ * \param list The first element of the list.
+ * \return The values of the elements, in order, or \c NULL if no value is
+ * computed. Unknown values have the type #WAVE_DATA_UNKNOWN.
+ * \pre list must not be NULL.
+ * \relatesalso wave_collection
+ *
+ * The values are computed by wave_data_unary() and wave_data_binary() when the
+ * \c WAVE2C_FOLD_BUDGET environment variable is a positive number: the value of
+ * each element may take at most this number of atoms to compute. Nothing is
+ * computed in repeated and cyclic collections.
+ *
+ * The values are released by wave_code_generation_clean_fold().
+ */
+wave_data * wave_code_generation_fold_list (const wave_collection * list);
+
+/**
+ * \brief Generate C source code giving the value of a collection computed at
+ * compile time.
+ * \param code_file The file where the C code will be written.
+ * \param alloc_file File for allocations.
+ * \param collection The collection.
+ * \param value Value of the collection given by
+ * wave_code_generation_fold_list().
+ * \retval true if the code was generated.
+ * \retval false if the collection must be generated as usual.
+ * \pre code_file, alloc_file, collection and value must not be NULL.
+ * \relatesalso wave_collection
+ *
+ * Operators and collections containing operators are folded: the value is
+ * stored in static tabs, initialized with the precomputed data.
+ */
+bool wave_code_generation_fold_collection (FILE * code_file, FILE * alloc_file, const wave_collection * collection, const wave_data * value);
+
+/**
+ * \brief Release the values computed for a phrase.
+ */
+void wave_code_generation_clean_fold (void);
+
+#endif /* __WAVE_GENERATION_FOLD_H__ */
@@ -39,6 +39,45 @@
 #include "wave/ast/wave_collection.h"
 #include "wave/generation/wave_generation_common.h"
 
+/**
+ * \brief Prepare the generation of the operators of a phrase.
+ * \param phrase The collection of the phrase.
+ * \pre phrase must not be NULL.
+ * \relatesalso wave_collection
+ *
+ * Operators whose operands are not read anymore let wave_data_unary() and
+ * wave_data_binary() compute their results in place, unless the phrase
+ * contains paths.
+ */
+void wave_code_generation_prepare_operators (const wave_collection * phrase);
+
+/**
+ * \brief Determine whether an element is stored in a local variable.
+ * \param collection The element.
+ * \retval true if the element is an integer or a floating point value only
+ * read by operators on known types, and never addressed by a path.
+ * \retval false otherwise.
+ * \pre collection must not be NULL.
+ * \relatesalso wave_collection
+ *
+ * Such elements are stored in a \c wave_int or \c wave_float local variable
+ * instead of the tab of their collection, so that the C compiler may keep them
+ * in registers.
+ */
+bool wave_code_generation_is_scalar (const wave_collection * collection);
+
+/**
+ * \brief Generate the beginning of the declaration of the local variable of an
+ * element.
+ * \param code_file The file where the C code will be written.
+ * \param collection The element.
+ * \pre wave_code_generation_is_scalar() holds for the element.
+ * \relatesalso wave_collection
+ *
+ * The initializer must follow, after an equal sign.
+ */
+void wave_code_generation_fprint_scalar_declaration (FILE * code_file, const wave_collection * collection);
+
 /**
  * \brief Generate C source code giving an operator atom.
  * \param code_file The file where the C code will be written.
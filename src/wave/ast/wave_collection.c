@@ -153,6 +153,7 @@ static inline void _copy_repetition (const wave_collection * const original, wav
 {
     copy->_inner._repetition = original->_inner._repetition;
     copy->_inner._repetition._list = wave_collection_copy (original->_inner._repetition._list);
+    _wave_collection_set_parent (copy->_inner._repetition._list, copy);
     if (wave_collection_get_repetition_type (original) == WAVE_COLLECTION_REPETITION_PATH)
         copy->_inner._repetition._description._path = wave_path_copy (original->_inner._repetition._description._path);
 }
@@ -180,11 +181,13 @@ void * wave_collection_copy (const wave_collection * c)
     {
         copy = wave_collection_alloc ();
         _copy_current (c, copy);
+        wave_collection * last = copy;
         for (wave_collection * current = wave_collection_get_next (c); current != NULL; current = wave_collection_get_next (current))
         {
             wave_collection * current_copy = wave_collection_alloc ();
             _copy_current (current, current_copy);
-            wave_collection_add_collection (copy, current_copy);
+            wave_collection_add_collection (last, current_copy);
+            last = current_copy;
         }
     }
     return copy;
@@ -263,6 +266,16 @@ int wave_collection_get_repetition_times (const wave_collection * const c)
     return c->_inner._repetition._description._times;
 }
 
+wave_coordinate * wave_collection_get_repetition_iterator (const wave_collection * const c)
+{
+    wave_int_list * indexes = wave_collection_get_full_indexes (c);
+    wave_int_list_push_back (indexes, wave_collection_info_get_index (wave_collection_get_info (c)));
+    wave_coordinate * iterator = wave_coordinate_alloc ();
+    wave_coordinate_set_list (iterator, indexes);
+
+    return iterator;
+}
+
 wave_collection * wave_collection_get_next (const wave_collection * const c)
 {
     return c->_next_collection;
@@ -312,6 +325,12 @@ wave_coordinate * wave_collection_get_length (const wave_collection * c)
     return wave_collection_info_get_length (info);
 }
 
+wave_atom_type wave_collection_get_inferred_type (const wave_collection * c)
+{
+    wave_collection_info * info = wave_collection_get_info (c);
+    return wave_collection_info_get_type (info);
+}
+
 wave_collection * wave_collection_get_last (wave_collection * c)
 {
     wave_collection * last = c;
@@ -345,8 +364,12 @@ wave_int_list * wave_collection_get_full_indexes (const wave_collection * c)
     wave_int_list * list = wave_int_list_alloc ();
     for (const wave_collection * current = c; current != NULL; current = wave_collection_get_parent (current))
     {
-        wave_collection_info * info = wave_collection_get_info (current);
-        wave_int_list_push_front (list, wave_collection_info_get_index (info));
+        wave_collection_type t = wave_collection_get_type (current);
+        if (t != WAVE_COLLECTION_REP_SEQ && t != WAVE_COLLECTION_REP_PAR)
+        {
+            wave_collection_info * info = wave_collection_get_info (current);
+            wave_int_list_push_front (list, wave_collection_info_get_index (info));
+        }
     }
 
     return list;
@@ -368,6 +391,11 @@ bool wave_collection_contains_path (const wave_collection * c)
                 wave_atom_type t = wave_atom_get_type (wave_collection_get_atom (current));
                 contains = t == WAVE_ATOM_PATH;
             }
+            else if ((ct == WAVE_COLLECTION_REP_SEQ || ct == WAVE_COLLECTION_REP_PAR)
+                && wave_collection_get_repetition_type (current) == WAVE_COLLECTION_REPETITION_PATH)
+            {
+                contains = true;
+            }
             else if (ct != WAVE_COLLECTION_UNKNOWN)
             {
                 wave_collection * list = wave_collection_get_list (current);
@@ -459,24 +487,33 @@ void wave_collection_set_repetition_path (wave_collection * const c, wave_path *
     c->_inner._repetition._description._path = p;
 }
 
+/* Appends copies of a list to itself, so that it is repeated ``times`` times.
+ * Each copy is made from the previous one, which ends the list.
+ */
 static void _duplicate_list (wave_collection * list, int times)
 {
-    int copy_number = times - 1;
-    wave_collection * copies[copy_number];
-    for (int i = 0; i < copy_number; ++i)
-        copies[i] = wave_collection_copy (list);
-    for (int i = 0; i < copy_number; ++i)
-        wave_collection_add_collection (list, copies[i]);
+    wave_collection * copied = list;
+    for (int i = 1; i < times; ++i)
+    {
+        wave_collection * last = wave_collection_get_last (copied);
+        wave_collection * copy = wave_collection_copy (copied);
+        last->_next_collection = copy;
+        copy->_previous_collection = last;
+        _wave_collection_set_parent (copy, last->_parent_collection);
+        copied = copy;
+    }
 }
 
-void wave_collection_set_repetition_seq_times (wave_collection * c, int times)
+void wave_collection_set_repetition_seq_times (wave_collection * c, wave_collection * list, int times)
 {
-    _duplicate_list (c, times);
+    wave_collection_set_repetition_seq_list (c, list);
+    wave_collection_set_repetition_times (c, times);
 }
 
-void wave_collection_set_repetition_par_times (wave_collection * c, int times)
+void wave_collection_set_repetition_par_times (wave_collection * c, wave_collection * list, int times)
 {
-    _duplicate_list (c, times);
+    wave_collection_set_repetition_par_list (c, list);
+    wave_collection_set_repetition_times (c, times);
 }
 
 void wave_collection_set_repetition_seq_path (wave_collection * c, wave_collection * list, wave_path * p)
@@ -577,6 +614,28 @@ static inline void _wave_collection_set_coords (wave_collection * c)
     wave_collection_info_set_coordinate (info, coord);
 }
 
+/* The elements of a constant repetition are stored in the tab of its parent,
+ * from the coordinate of the repetition: an element is found after the
+ * previous iterations, at its coordinate within the repeated list.
+ */
+static inline void _wave_collection_set_repetition_coords (wave_collection * c)
+{
+    wave_collection * list = wave_collection_get_repetition_list (c);
+    wave_coordinate * length_sum = _wave_collection_sum_list_lengths (list);
+    for (wave_collection * current = list; current != NULL; current = wave_collection_get_next (current))
+    {
+        wave_coordinate * previous_iterations = wave_coordinate_alloc ();
+        wave_coordinate_set_times (previous_iterations, wave_collection_get_repetition_iterator (c), wave_coordinate_copy (length_sum));
+        wave_coordinate * offset = wave_coordinate_alloc ();
+        wave_coordinate_set_plus (offset, wave_coordinate_copy (wave_collection_get_coordinate (c)), wave_collection_get_coordinate (current));
+        wave_coordinate * coord = wave_coordinate_alloc ();
+        wave_coordinate_set_plus (coord, previous_iterations, offset);
+
+        wave_collection_info_set_coordinate (wave_collection_get_info (current), coord);
+    }
+    wave_coordinate_free (length_sum);
+}
+
 static inline void _wave_collection_compute_current (wave_collection * c)
 {
     wave_collection_type t = wave_collection_get_type (c);
@@ -590,6 +649,10 @@ static inline void _wave_collection_compute_current (wave_collection * c)
 
     _wave_collection_set_length (c);
     _wave_collection_set_coords (c);
+
+    if ((t == WAVE_COLLECTION_REP_SEQ || t == WAVE_COLLECTION_REP_PAR)
+        && wave_collection_get_repetition_type (c) == WAVE_COLLECTION_REPETITION_CONSTANT)
+        _wave_collection_set_repetition_coords (c);
 }
 
 void wave_collection_compute_length_and_coords (wave_collection * c)
@@ -598,6 +661,168 @@ void wave_collection_compute_length_and_coords (wave_collection * c)
         _wave_collection_compute_current (current);
 }
 
+static inline bool _is_number (wave_atom_type t)
+{
+    return t == WAVE_ATOM_LITERAL_INT || t == WAVE_ATOM_LITERAL_FLOAT;
+}
+
+static inline bool _is_text (wave_atom_type t)
+{
+    return t == WAVE_ATOM_LITERAL_CHAR || t == WAVE_ATOM_LITERAL_STRING;
+}
+
+/* Type of the result of an unary operation, following wave_data_unary(). */
+static wave_atom_type _unary_type (wave_operator op, wave_atom_type t)
+{
+    wave_atom_type result = WAVE_ATOM_UNKNOWN;
+    bool is_numeric = op != WAVE_OP_UNARY_NOT && op != WAVE_OP_UNARY_CHR && op != WAVE_OP_UNARY_CODE;
+
+    if (t == WAVE_ATOM_LITERAL_INT)
+    {
+        if (op == WAVE_OP_UNARY_PLUS || op == WAVE_OP_UNARY_MINUS
+            || op == WAVE_OP_UNARY_INCREMENT || op == WAVE_OP_UNARY_DECREMENT)
+            result = WAVE_ATOM_LITERAL_INT;
+        else if (op == WAVE_OP_UNARY_CHR)
+            result = WAVE_ATOM_LITERAL_CHAR;
+        else if (is_numeric)
+            result = WAVE_ATOM_LITERAL_FLOAT;
+    }
+    else if (t == WAVE_ATOM_LITERAL_FLOAT && is_numeric)
+        result = WAVE_ATOM_LITERAL_FLOAT;
+    else if (t == WAVE_ATOM_LITERAL_CHAR && op == WAVE_OP_UNARY_CODE)
+        result = WAVE_ATOM_LITERAL_INT;
+    else if (t == WAVE_ATOM_LITERAL_BOOL && op == WAVE_OP_UNARY_NOT)
+        result = WAVE_ATOM_LITERAL_BOOL;
+
+    return result;
+}
+
+/* Type of the result of a binary operation on atoms, following
+ * wave_data_binary(). The ``get`` operation is only defined on a string and an
+ * integer.
+ */
+static wave_atom_type _binary_type (wave_operator op, wave_atom_type left, wave_atom_type right)
+{
+    wave_atom_type result = WAVE_ATOM_UNKNOWN;
+    bool numbers = _is_number (left) && _is_number (right);
+    bool texts = _is_text (left) && _is_text (right);
+    bool bools = left == WAVE_ATOM_LITERAL_BOOL && right == WAVE_ATOM_LITERAL_BOOL;
+
+    if (op == WAVE_OP_BINARY_GET)
+    {
+        if (left == WAVE_ATOM_LITERAL_STRING && right == WAVE_ATOM_LITERAL_INT)
+            result = WAVE_ATOM_LITERAL_CHAR;
+    }
+    else if (wave_operator_is_test (op))
+    {
+        if (numbers || texts || bools)
+            result = WAVE_ATOM_LITERAL_BOOL;
+    }
+    else if (op == WAVE_OP_BINARY_AND || op == WAVE_OP_BINARY_OR)
+    {
+        if (bools)
+            result = WAVE_ATOM_LITERAL_BOOL;
+    }
+    else if (numbers)
+        result = left == WAVE_ATOM_LITERAL_INT && right == WAVE_ATOM_LITERAL_INT ? WAVE_ATOM_LITERAL_INT : WAVE_ATOM_LITERAL_FLOAT;
+    else if (texts)
+    {
+        if (op == WAVE_OP_BINARY_PLUS)
+            result = WAVE_ATOM_LITERAL_STRING;
+        else if (op == WAVE_OP_BINARY_MIN || op == WAVE_OP_BINARY_MAX)
+            result = left == WAVE_ATOM_LITERAL_CHAR && right == WAVE_ATOM_LITERAL_CHAR ? WAVE_ATOM_LITERAL_CHAR : WAVE_ATOM_LITERAL_STRING;
+    }
+
+    return result;
+}
+
+/* Type of the n-th previous collection, if any. */
+static wave_atom_type _previous_type (const wave_collection * c, int n)
+{
+    for (int i = 0; i < n && c != NULL; ++i)
+        c = wave_collection_get_previous (c);
+
+    return c != NULL ? wave_collection_get_inferred_type (c) : WAVE_ATOM_UNKNOWN;
+}
+
+static inline bool _is_operator (const wave_collection * const c, wave_operator op)
+{
+    return wave_collection_get_type (c) == WAVE_COLLECTION_ATOM
+        && wave_atom_get_type (wave_collection_get_atom (c)) == WAVE_ATOM_OPERATOR
+        && wave_atom_get_operator (wave_collection_get_atom (c)) == op;
+}
+
+/* Type of an operator, whose operands are the previous collections. */
+static wave_atom_type _operator_type (const wave_collection * const c)
+{
+    wave_operator op = wave_atom_get_operator (wave_collection_get_atom (c));
+    wave_atom_type t = WAVE_ATOM_UNKNOWN;
+
+    if (wave_operator_is_unary (op))
+        t = _unary_type (op, _previous_type (c, 1));
+    else if (wave_operator_is_binary (op))
+        t = _binary_type (op, _previous_type (c, 2), _previous_type (c, 1));
+    else if (op == WAVE_OP_SPECIFIC_ATOM && wave_collection_has_previous (c))
+        t = WAVE_ATOM_LITERAL_BOOL;
+    else if (op == WAVE_OP_SPECIFIC_PRINT || op == WAVE_OP_SPECIFIC_STOP)
+        t = _previous_type (c, 1);
+
+    return t;
+}
+
+/* Type of a sequential collection: the value of a sequential collection
+ * ending with a cut is replaced by the element preceding the cut, or by the
+ * element preceding one of its stops.
+ */
+static wave_atom_type _seq_type (const wave_collection * const c)
+{
+    const wave_collection * last = wave_collection_get_list (c);
+    while (last != NULL && wave_collection_has_next (last))
+        last = wave_collection_get_next (last);
+
+    wave_atom_type t = WAVE_ATOM_UNKNOWN;
+    if (last != NULL && _is_operator (last, WAVE_OP_SPECIFIC_CUT))
+    {
+        t = _previous_type (last, 1);
+        for (const wave_collection * e = wave_collection_get_list (c); e != last; e = wave_collection_get_next (e))
+            if (_is_operator (e, WAVE_OP_SPECIFIC_STOP) && _previous_type (e, 1) != t)
+                t = WAVE_ATOM_UNKNOWN;
+    }
+
+    return t;
+}
+
+static wave_atom_type _collection_type (const wave_collection * const c)
+{
+    wave_collection_type collection_type = wave_collection_get_type (c);
+    wave_atom_type t = WAVE_ATOM_UNKNOWN;
+
+    if (collection_type == WAVE_COLLECTION_ATOM)
+    {
+        wave_atom_type atom_type = wave_atom_get_type (wave_collection_get_atom (c));
+        if (atom_type == WAVE_ATOM_OPERATOR)
+            t = _operator_type (c);
+        else if (atom_type != WAVE_ATOM_PATH)
+            t = atom_type;
+    }
+    else if (collection_type == WAVE_COLLECTION_SEQ)
+        t = _seq_type (c);
+
+    return t;
+}
+
+void wave_collection_compute_types (wave_collection * c)
+{
+    for (wave_collection * current = c; current != NULL; current = wave_collection_get_next (current))
+    {
+        wave_collection_type t = wave_collection_get_type (current);
+        if (t != WAVE_COLLECTION_ATOM && t!= WAVE_COLLECTION_UNKNOWN)
+            wave_collection_compute_types (wave_collection_get_list (current));
+
+        wave_collection_info_set_type (wave_collection_get_info (current), _collection_type (current));
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Interaction with paths.
 ////////////////////////////////////////////////////////////////////////////////
@@ -799,6 +1024,29 @@ bool wave_collection_path_is_valid (wave_collection * c, const wave_path * p)
     return wave_collection_get_collection_pointed (c, p) != NULL;
 }
 
+/* Replaces a repetition by ``times`` copies of a list. */
+static void _replace_with_copies (wave_collection * c, const wave_collection * list, int times)
+{
+    wave_collection * next = wave_collection_get_next (c);
+    wave_collection * previous = wave_collection_get_previous (c);
+    wave_collection * first = next;
+
+    if (times > 0)
+    {
+        first = wave_collection_copy (list);
+        _wave_collection_set_parent (first, wave_collection_get_parent (c));
+        _duplicate_list (first, times);
+        wave_collection_add_collection (first, next);
+    }
+
+    previous->_next_collection = first;
+    if (first != NULL)
+        first->_previous_collection = previous;
+
+    c->_next_collection = NULL;
+    wave_collection_free (c);
+}
+
 static void copy_collection_path_time(wave_collection* c){
     wave_collection* collection_to_copy = wave_collection_get_list (c);
     wave_collection_unroll_path( collection_to_copy );
@@ -812,36 +1060,82 @@ static void copy_collection_path_time(wave_collection* c){
         fprintf(stderr, "The path did not contain any record.\n");
         exit(1);
     }
-///*
-    wave_collection* parent = wave_collection_get_parent (c);
-    wave_collection * copy = wave_collection_copy (collection_to_copy);
-    _wave_collection_set_parent (copy, parent);
 
-    _duplicate_list (copy, size);
+    _replace_with_copies (c, collection_to_copy, size);
+}
 
-    wave_collection* next = wave_collection_get_next (c);
-    wave_collection_add_collection (copy, next);
+/* Constant repetitions of at most this number of elements are expanded, so
+ * that the types and the values of their elements are known at compile time.
+ */
+#define _UNROLL_MAX_LENGTH 64
 
-    wave_collection* previous = wave_collection_get_previous (c);
-    previous->_next_collection = copy;
-    copy->_previous_collection = previous;
+/* Checks whether a constant repetition is generated as a loop. The repeated
+ * list must only contain literals, and unary or binary operators which read
+ * the elements of the previous iteration.
+ */
+static bool _is_loop (const wave_collection * c)
+{
+    bool is_loop = true;
+    long long int length = 0;
+    for (const wave_collection * current = wave_collection_get_repetition_list (c); is_loop && current != NULL; current = wave_collection_get_next (current))
+    {
+        is_loop = wave_collection_get_type (current) == WAVE_COLLECTION_ATOM;
+        if (is_loop)
+        {
+            const wave_atom * a = wave_collection_get_atom (current);
+            wave_atom_type t = wave_atom_get_type (a);
+            is_loop = t != WAVE_ATOM_PATH && t != WAVE_ATOM_UNKNOWN
+                && (t != WAVE_ATOM_OPERATOR || wave_operator_is_unary (wave_atom_get_operator (a))
+                    || wave_operator_is_binary (wave_atom_get_operator (a)));
+        }
+        ++length;
+    }
 
-    c->_next_collection = NULL;
-    wave_collection_free(c);
-//    */
+    return is_loop && length * wave_collection_get_repetition_times (c) > _UNROLL_MAX_LENGTH;
+}
+
+/* Expands the constant repetitions of a list, but the loops if ``keep_loops``
+ * is set. The repeated lists are expanded before being copied.
+ */
+static void _unroll_constant (wave_collection * c, bool keep_loops)
+{
+    wave_queue * q = wave_queue_alloc ();
+    _add_list_to_queue (c, q);
+    while (! wave_queue_is_empty (q))
+    {
+        wave_collection * current = wave_queue_pop (q);
+        wave_collection_type type = wave_collection_get_type (current);
+        if ((type == WAVE_COLLECTION_REP_SEQ || type == WAVE_COLLECTION_REP_PAR)
+            && wave_collection_get_repetition_type (current) == WAVE_COLLECTION_REPETITION_CONSTANT)
+        {
+            if (! keep_loops || ! _is_loop (current))
+            {
+                wave_collection * list = wave_collection_get_repetition_list (current);
+                _unroll_constant (list, keep_loops);
+                _replace_with_copies (current, list, wave_collection_get_repetition_times (current));
+            }
+        }
+        else if (type != WAVE_COLLECTION_ATOM && type != WAVE_COLLECTION_UNKNOWN)
+            _add_list_to_queue (wave_collection_get_list (current), q);
+    }
+    wave_queue_free (q);
 }
 
 void wave_collection_unroll_path(wave_collection* c)
 {
     if (c != NULL)
     {
+        /* The paths are followed in the expanded phrase. */
+        _unroll_constant (c, ! wave_collection_contains_path (c));
+
         wave_queue * q = wave_queue_alloc ();
         wave_queue_push (q, c);
         while (! wave_queue_is_empty (q))
         {
             wave_collection * current = wave_queue_pop (q);
             wave_collection_type type = wave_collection_get_type (current);
-            if (type == WAVE_COLLECTION_REP_SEQ || type == WAVE_COLLECTION_REP_PAR)
+            if ((type == WAVE_COLLECTION_REP_SEQ || type == WAVE_COLLECTION_REP_PAR)
+                && wave_collection_get_repetition_type (current) == WAVE_COLLECTION_REPETITION_PATH)
                 copy_collection_path_time (current);
             else if (type != WAVE_COLLECTION_ATOM && type != WAVE_COLLECTION_UNKNOWN)
                 _add_list_to_queue (wave_collection_get_list (current), q);
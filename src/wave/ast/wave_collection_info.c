@@ -38,7 +38,7 @@ void * wave_collection_info_alloc (void)
 {
     wave_collection_info * i = malloc (sizeof * i);
     if (i != NULL)
-        * i = (wave_collection_info) { ._index = 0, ._coordinate = NULL, ._length = NULL, };
+        * i = (wave_collection_info) { ._index = 0, ._coordinate = NULL, ._length = NULL, ._type = WAVE_ATOM_UNKNOWN, };
     return i;
 }
 
@@ -84,6 +84,11 @@ wave_coordinate * wave_collection_info_get_length (const wave_collection_info *
     return info->_length;
 }
 
+wave_atom_type wave_collection_info_get_type (const wave_collection_info * info)
+{
+    return info->_type;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Setters.
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,6 +108,11 @@ void wave_collection_info_set_length (wave_collection_info * info, wave_coordina
     info->_length = l;
 }
 
+void wave_collection_info_set_type (wave_collection_info * info, wave_atom_type t)
+{
+    info->_type = t;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Printing.
 ////////////////////////////////////////////////////////////////////////////////
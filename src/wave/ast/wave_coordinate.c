@@ -137,12 +137,11 @@ static inline void _wave_coordinate_constant_fprint (FILE * stream, const wave_c
     fprintf (stream, "%d", wave_coordinate_get_constant (c));
 }
 
+/* Variables are printed as the C identifiers of the generated code. */
 static inline void _wave_coordinate_var_fprint (FILE * stream, const wave_coordinate * c)
 {
-    fprintf (stream, "var");
-    wave_int_list * list = wave_coordinate_get_list (c);
-    for (wave_int_list_element * e = list->_first; e != NULL; e = e->_next_element)
-        fprintf (stream, "%d", e->_content);
+    fprintf (stream, "wave_var");
+    wave_int_list_code_fprint (stream, wave_coordinate_get_list (c));
 }
 
 /* Symbols used in printing. */
@@ -153,11 +152,11 @@ static const char _closing_parenthesis =')';
 
 static inline void _wave_coordinate_times_fprint (FILE * stream, const wave_coordinate * c)
 {
-    fprintf (stream, "%c", _opening_parenthesis);
+    fprintf (stream, "%c%c", _opening_parenthesis, _opening_parenthesis);
     wave_coordinate_fprint (stream, wave_coordinate_get_left (c));
-    fprintf (stream, "%c %c %c", _opening_parenthesis, _times_symbol, _closing_parenthesis);
+    fprintf (stream, "%c %c %c", _closing_parenthesis, _times_symbol, _opening_parenthesis);
     wave_coordinate_fprint (stream, wave_coordinate_get_right (c));
-    fprintf (stream, "%c", _closing_parenthesis);
+    fprintf (stream, "%c%c", _closing_parenthesis, _closing_parenthesis);
 }
 
 static inline void _wave_coordinate_plus_fprint (FILE * stream, const wave_coordinate * c)
@@ -194,13 +193,12 @@ void wave_coordinate_clean (wave_coordinate * const c)
     {
         wave_queue * q = wave_queue_alloc ();
         _queue_binary (q, c);
-        wave_queue_push (q, c);
         while (! wave_queue_is_empty (q))
         {
             wave_coordinate * current = wave_queue_pop (q);
             if (_is_binary (current))
                 _queue_binary (q, current);
-            else if (c->_type == WAVE_COORD_VAR)
+            else if (current->_type == WAVE_COORD_VAR)
                 _wave_coordinate_free_var (current);
             free (current);
         }
@@ -0,0 +1,435 @@
+/**
+ * \file wave_binary.c
+ * \brief Wave binary format.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "wave/common/wave_binary.h"
+#include "wave/common/wave_kernels.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Byte order marker.
+ */
+static const uint32_t _WAVE_BINARY_BYTE_ORDER = 0x01020304;
+
+/**
+ * \brief Version of the format.
+ */
+static const uint32_t _WAVE_BINARY_VERSION = 1;
+
+/**
+ * \brief Alignment of the payload items.
+ */
+static const uint64_t _WAVE_BINARY_ALIGN = 8;
+
+/**
+ * \brief Tags of the data types.
+ */
+static const wave_binary_tag _binary_tags[WAVE_DATA_UNKNOWN + 1] =
+{
+    [WAVE_DATA_INT] = WAVE_BINARY_INT,
+    [WAVE_DATA_FLOAT] = WAVE_BINARY_FLOAT,
+    [WAVE_DATA_CHAR] = WAVE_BINARY_CHAR,
+    [WAVE_DATA_STRING] = WAVE_BINARY_STRING,
+    [WAVE_DATA_BOOL] = WAVE_BINARY_BOOL,
+    [WAVE_DATA_SEQ] = WAVE_BINARY_SEQ,
+    [WAVE_DATA_PAR] = WAVE_BINARY_PAR,
+    [WAVE_DATA_PAR_INT] = WAVE_BINARY_PAR_INT,
+    [WAVE_DATA_PAR_FLOAT] = WAVE_BINARY_PAR_FLOAT,
+    [WAVE_DATA_PAR_BOOL] = WAVE_BINARY_PAR_BOOL,
+};
+
+/**
+ * \brief Round a size up to the alignment of the payload items.
+ * \param size Size.
+ */
+static inline uint64_t _pad (uint64_t size)
+{
+    return (size + _WAVE_BINARY_ALIGN - 1) & ~ (_WAVE_BINARY_ALIGN - 1);
+}
+
+/**
+ * \brief List the nodes of a data in breadth-first order.
+ * \param data Data of interest.
+ * \param count Storage for the number of nodes.
+ * \return The nodes, or \c NULL in case of failure.
+ */
+static const wave_data ** _breadth_first_order (const wave_data * const data, size_t * const count)
+{
+    size_t size = 64;
+    const wave_data ** order = malloc (size * sizeof * order);
+    if (order == NULL)
+        return NULL;
+
+    order[0] = data;
+    * count = 1;
+    for (size_t i = 0; i < * count; ++i)
+    {
+        const wave_data * d = order[i];
+        wave_data_type t = wave_data_get_type (d);
+        if (_binary_tags[t] == 0)
+        {
+            free (order);
+            return NULL;
+        }
+
+        if (t == WAVE_DATA_SEQ || t == WAVE_DATA_PAR)
+        {
+            size_t children = d->_content._collection._size;
+            if (* count + children > size)
+            {
+                while (* count + children > size)
+                    size *= 2;
+                const wave_data ** new_order = realloc (order, size * sizeof * new_order);
+                if (new_order == NULL)
+                {
+                    free (order);
+                    return NULL;
+                }
+                order = new_order;
+            }
+            for (size_t j = 0; j < children; ++j)
+                order[(* count)++] = & d->_content._collection._tab[j];
+        }
+    }
+
+    return order;
+}
+
+/**
+ * \brief Fill a node of the table.
+ * \param node Node.
+ * \param data Data of the node.
+ * \param payload Size of the payload so far, updated.
+ * \param next_child Index of the next child node, updated.
+ */
+static void _fill_node (wave_binary_node * const node, const wave_data * const data, uint64_t * const payload, uint64_t * const next_child)
+{
+    wave_data_type t = wave_data_get_type (data);
+    * node = (wave_binary_node) { ._tag = _binary_tags[t], ._reserved = 0, ._first = 0, ._size = 0 };
+
+    switch (t)
+    {
+        case WAVE_DATA_INT:
+            node->_first = (uint64_t) (int64_t) data->_content._int;
+            break;
+        case WAVE_DATA_FLOAT:
+            memcpy (& node->_first, & data->_content._float, sizeof data->_content._float);
+            break;
+        case WAVE_DATA_CHAR:
+            node->_first = (unsigned char) data->_content._char;
+            break;
+        case WAVE_DATA_BOOL:
+            node->_first = data->_content._bool ? 1 : 0;
+            break;
+        case WAVE_DATA_STRING:
+        {
+            size_t length;
+            wave_data_get_characters (data, & length);
+            node->_first = * payload;
+            node->_size = length;
+            * payload += _pad (node->_size + 1);
+            break;
+        }
+        case WAVE_DATA_SEQ:
+        case WAVE_DATA_PAR:
+            node->_first = * next_child;
+            node->_size = data->_content._collection._size;
+            * next_child += node->_size;
+            break;
+        case WAVE_DATA_PAR_INT:
+            node->_first = * payload;
+            node->_size = data->_content._packed._size;
+            * payload += _pad (node->_size * sizeof (wave_int));
+            break;
+        case WAVE_DATA_PAR_FLOAT:
+            node->_first = * payload;
+            node->_size = data->_content._packed._size;
+            * payload += _pad (node->_size * sizeof (wave_float));
+            break;
+        case WAVE_DATA_PAR_BOOL:
+            node->_first = * payload;
+            node->_size = data->_content._packed._size;
+            * payload += WAVE_KERNELS_WORDS (node->_size) * sizeof (uint64_t);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief Write a payload item followed by its padding.
+ * \param stream Stream.
+ * \param item Item.
+ * \param size Size of the item.
+ * \retval true on success.
+ * \retval false otherwise.
+ */
+static bool _write_item (FILE * const stream, const void * const item, uint64_t size)
+{
+    static const unsigned char padding[8] = { 0 };
+    uint64_t padding_size = _pad (size) - size;
+    return fwrite (item, 1, size, stream) == size
+        && fwrite (padding, 1, padding_size, stream) == padding_size;
+}
+
+/**
+ * \brief Decode a node.
+ * \param node Node.
+ * \param index Index of the node.
+ * \param nodes Decoded nodes.
+ * \param count Number of nodes.
+ * \param payload Payload.
+ * \param payload_size Size of the payload.
+ * \retval true if the node is valid.
+ * \retval false otherwise.
+ */
+static bool _decode_node (const wave_binary_node * const node, uint64_t index, wave_data * const nodes, uint64_t count, const unsigned char * const payload, uint64_t payload_size)
+{
+    wave_data * const data = & nodes[index];
+
+    switch (node->_tag)
+    {
+        case WAVE_BINARY_INT:
+            wave_data_set_int (data, (wave_int) (int64_t) node->_first);
+            return true;
+        case WAVE_BINARY_FLOAT:
+        {
+            wave_float f;
+            memcpy (& f, & node->_first, sizeof f);
+            wave_data_set_float (data, f);
+            return true;
+        }
+        case WAVE_BINARY_CHAR:
+            wave_data_set_char (data, (wave_char) node->_first);
+            return true;
+        case WAVE_BINARY_BOOL:
+            wave_data_set_bool (data, node->_first != 0);
+            return true;
+        case WAVE_BINARY_STRING:
+            if (node->_first > payload_size || node->_size >= payload_size - node->_first
+                || payload[node->_first + node->_size] != '\0')
+                return false;
+            wave_data_set_string (data, (wave_string) (payload + node->_first));
+            return true;
+        case WAVE_BINARY_SEQ:
+        case WAVE_BINARY_PAR:
+            /* Children always come after their parent: the tree can not loop. */
+            if (node->_first <= index || node->_first > count || node->_size == 0 || node->_size > count - node->_first
+                || node->_size > WAVE_DATA_SIZE_MAX)
+                return false;
+            data->_type = node->_tag == WAVE_BINARY_SEQ ? WAVE_DATA_SEQ : WAVE_DATA_PAR;
+            data->_flags = WAVE_DATA_FLAG_NONE;
+            data->_content._collection._tab = nodes + node->_first;
+            data->_content._collection._size = (uint32_t) node->_size;
+            return true;
+        case WAVE_BINARY_PAR_INT:
+            if (node->_first > payload_size || node->_first % _WAVE_BINARY_ALIGN != 0
+                || node->_size > (payload_size - node->_first) / sizeof (wave_int) || node->_size > WAVE_DATA_SIZE_MAX)
+                return false;
+            wave_data_set_par_int (data, (wave_int *) (uintptr_t) (payload + node->_first), node->_size);
+            return true;
+        case WAVE_BINARY_PAR_FLOAT:
+            if (node->_first > payload_size || node->_first % _WAVE_BINARY_ALIGN != 0
+                || node->_size > (payload_size - node->_first) / sizeof (wave_float) || node->_size > WAVE_DATA_SIZE_MAX)
+                return false;
+            wave_data_set_par_float (data, (wave_float *) (uintptr_t) (payload + node->_first), node->_size);
+            return true;
+        case WAVE_BINARY_PAR_BOOL:
+        {
+            if (node->_first > payload_size || node->_first % _WAVE_BINARY_ALIGN != 0
+                || node->_size > WAVE_DATA_SIZE_MAX
+                || WAVE_KERNELS_WORDS (node->_size) > (payload_size - node->_first) / sizeof (uint64_t))
+                return false;
+            uint64_t * bits = (uint64_t *) (uintptr_t) (payload + node->_first);
+            /* The bits past the last value must be cleared. */
+            uint64_t used = node->_size % WAVE_KERNELS_WORD_BITS;
+            if (used != 0 && bits[node->_size / WAVE_KERNELS_WORD_BITS] >> used != 0)
+                return false;
+            wave_data_set_par_bool (data, bits, node->_size);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writing.
+////////////////////////////////////////////////////////////////////////////////
+
+bool wave_data_write_binary (FILE * const stream, const wave_data * const data)
+{
+    size_t count;
+    const wave_data ** order = _breadth_first_order (data, & count);
+    if (order == NULL)
+        return false;
+
+    wave_binary_node * nodes = malloc (count * sizeof * nodes);
+    if (nodes == NULL)
+    {
+        free (order);
+        return false;
+    }
+
+    uint64_t payload = 0;
+    uint64_t next_child = 1;
+    for (size_t i = 0; i < count; ++i)
+        _fill_node (& nodes[i], order[i], & payload, & next_child);
+
+    wave_binary_header header =
+    {
+        ._byte_order = _WAVE_BINARY_BYTE_ORDER,
+        ._version = _WAVE_BINARY_VERSION,
+        ._node_count = count,
+        ._payload_size = payload,
+    };
+    memcpy (header._magic, WAVE_BINARY_MAGIC, WAVE_BINARY_MAGIC_SIZE);
+
+    bool success = fwrite (& header, sizeof header, 1, stream) == 1
+        && fwrite (nodes, sizeof * nodes, count, stream) == count;
+
+    /* The payload items are written in the order of the nodes. */
+    for (size_t i = 0; i < count && success; ++i)
+    {
+        const wave_data * d = order[i];
+        switch (nodes[i]._tag)
+        {
+            case WAVE_BINARY_STRING:
+                success = _write_item (stream, wave_data_get_string (d), nodes[i]._size + 1);
+                break;
+            case WAVE_BINARY_PAR_INT:
+                success = _write_item (stream, d->_content._packed._tab._ints, nodes[i]._size * sizeof (wave_int));
+                break;
+            case WAVE_BINARY_PAR_FLOAT:
+                success = _write_item (stream, d->_content._packed._tab._floats, nodes[i]._size * sizeof (wave_float));
+                break;
+            case WAVE_BINARY_PAR_BOOL:
+                success = _write_item (stream, d->_content._packed._tab._bits, WAVE_KERNELS_WORDS (nodes[i]._size) * sizeof (uint64_t));
+                break;
+            default:
+                break;
+        }
+    }
+
+    free (nodes);
+    free (order);
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading.
+////////////////////////////////////////////////////////////////////////////////
+
+size_t wave_binary_size (const void * const buffer, size_t size)
+{
+    wave_binary_header header;
+    if (size < sizeof header)
+        return 0;
+    memcpy (& header, buffer, sizeof header);
+
+    if (memcmp (header._magic, WAVE_BINARY_MAGIC, WAVE_BINARY_MAGIC_SIZE) != 0
+        || header._byte_order != _WAVE_BINARY_BYTE_ORDER
+        || header._version != _WAVE_BINARY_VERSION
+        || header._node_count == 0
+        || header._node_count > (SIZE_MAX - sizeof header) / sizeof (wave_binary_node)
+        || header._payload_size > SIZE_MAX - sizeof header - header._node_count * sizeof (wave_binary_node))
+        return 0;
+
+    return sizeof header + header._node_count * sizeof (wave_binary_node) + header._payload_size;
+}
+
+size_t wave_data_from_binary (const void * const buffer, size_t size, wave_data * const data)
+{
+    size_t total = wave_binary_size (buffer, size);
+    if (total == 0 || total > size)
+        return 0;
+
+    wave_binary_header header;
+    memcpy (& header, buffer, sizeof header);
+    const unsigned char * node_bytes = (const unsigned char *) buffer + sizeof header;
+    const unsigned char * payload = node_bytes + header._node_count * sizeof (wave_binary_node);
+
+    /* Unboxed values can only be used in place when they are aligned. */
+    if ((uintptr_t) payload % _WAVE_BINARY_ALIGN != 0)
+    {
+        unsigned char * copy = wave_garbage_alloc (header._payload_size);
+        if (copy == NULL)
+            return 0;
+        memcpy (copy, payload, header._payload_size);
+        payload = copy;
+    }
+
+    wave_data * nodes = wave_garbage_alloc (header._node_count * sizeof * nodes);
+    if (nodes == NULL)
+        return 0;
+
+    for (uint64_t i = 0; i < header._node_count; ++i)
+    {
+        wave_binary_node node;
+        memcpy (& node, node_bytes + i * sizeof node, sizeof node);
+        if (! _decode_node (& node, i, nodes, header._node_count, payload, header._payload_size))
+            return 0;
+    }
+
+    * data = nodes[0];
+    return total;
+}
+
+bool wave_data_map_binary (const char * const path, wave_data * const data)
+{
+    int fd = open (path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat status;
+    void * map = MAP_FAILED;
+    if (fstat (fd, & status) == 0 && status.st_size > 0)
+        map = mmap (NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+
+    if (map == MAP_FAILED)
+        return false;
+
+    if (wave_data_from_binary (map, (size_t) status.st_size, data) == 0)
+    {
+        munmap (map, (size_t) status.st_size);
+        return false;
+    }
+
+    return true;
+}
@@ -29,6 +29,13 @@
  * SOFTWARE.
  */
 #include "wave/common/wave_data.h"
+#include "wave/common/wave_kernels.h"
+#include "wave/common/wave_binary.h"
+#include "wave/common/wave_output.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <omp.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Static utilities for getters.
@@ -48,6 +55,104 @@ static inline wave_string _char_data_to_string (const wave_data * const data)
     return s;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for string buffers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Minimal length of the strings whose buffer is kept across the iterations of a loop.
+ */
+#define _STRING_RETAIN_MIN 1024
+
+/**
+ * \brief Get the size of a string buffer, in bytes.
+ * \param capacity Capacity of the buffer.
+ */
+static inline size_t _string_buffer_size (size_t capacity)
+{
+    return sizeof (wave_string_buffer) + (capacity + 1) * sizeof (wave_char);
+}
+
+/**
+ * \brief Initialize a string buffer with the concatenation of two strings.
+ * \param memory Storage of at least _string_buffer_size (capacity) bytes.
+ * \param capacity Capacity of the buffer.
+ * \param a Left string.
+ * \param length_a Length of the left string.
+ * \param b Right string.
+ * \param length_b Length of the right string.
+ * \return The buffer.
+ * \pre length_a + length_b <= capacity
+ */
+static wave_string_buffer * _string_buffer_init (void * const memory, size_t capacity, const wave_char * a, size_t length_a, const wave_char * b, size_t length_b)
+{
+    wave_string_buffer * buffer = memory;
+    buffer->_used = length_a + length_b;
+    buffer->_capacity = capacity;
+    memcpy (buffer->_chars, a, length_a * sizeof (wave_char));
+    memcpy (buffer->_chars + length_a, b, length_b * sizeof (wave_char));
+    buffer->_chars[buffer->_used] = '\0';
+    return buffer;
+}
+
+/**
+ * \brief Determine whether a data holds a string lying in a buffer.
+ * \param data Data of interest.
+ */
+static inline bool _is_buffered (const wave_data * const data)
+{
+    return data->_type == WAVE_DATA_STRING && (data->_flags & WAVE_DATA_FLAG_STRING_BUFFER) != 0;
+}
+
+/**
+ * \brief Store a string lying in a buffer inside a data.
+ * \param data Storage.
+ * \param buffer Buffer.
+ * \param length Length of the string.
+ * \pre length <= #WAVE_DATA_SIZE_MAX
+ */
+static inline void _set_buffered (wave_data * const data, wave_string_buffer * const buffer, size_t length)
+{
+    data->_type = WAVE_DATA_STRING;
+    data->_flags = WAVE_DATA_FLAG_STRING_BUFFER;
+    data->_content._buffered._buffer = buffer;
+    data->_content._buffered._length = (uint32_t) length;
+}
+
+/**
+ * \brief Append characters to a string without copying it, if possible.
+ * \param left String.
+ * \param b Characters to append.
+ * \param length_b Number of characters.
+ * \param result Storage for the result, which may be \c left.
+ * \retval true if the characters were appended.
+ * \retval false otherwise.
+ *
+ * Only the longest string of a buffer can be extended, provided the buffer
+ * has enough room. Appending overwrites the null character of the string, so
+ * it is not done inside parallel regions, where another thread might be
+ * reading it.
+ */
+static bool _string_buffer_append (const wave_data * const left, const wave_char * b, size_t length_b, wave_data * const result)
+{
+    bool appended = false;
+    if (_is_buffered (left) && ! omp_in_parallel ())
+    {
+        wave_string_buffer * const buffer = left->_content._buffered._buffer;
+        size_t length = left->_content._buffered._length;
+        if (length == buffer->_used && buffer->_capacity - length >= length_b && WAVE_DATA_SIZE_MAX - length >= length_b)
+        {
+            /* The appended characters may come from the buffer itself. */
+            memmove (buffer->_chars + length, b, length_b * sizeof (wave_char));
+            buffer->_used = length + length_b;
+            buffer->_chars[buffer->_used] = '\0';
+            _set_buffered (result, buffer, buffer->_used);
+            appended = true;
+        }
+    }
+    return appended;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Static utilities for operations.
 ////////////////////////////////////////////////////////////////////////////////
@@ -63,6 +168,28 @@ static inline bool _is_constant (wave_data_type t)
     return t <= WAVE_DATA_BOOL;
 }
 
+/**
+ * \brief Determine whether a data holds an unboxed parallel collection.
+ * \param t Type of the data.
+ * \retval true if the data holds an unboxed parallel collection.
+ * \retval false otherwise.
+ */
+static inline bool _is_packed (wave_data_type t)
+{
+    return t == WAVE_DATA_PAR_INT || t == WAVE_DATA_PAR_FLOAT || t == WAVE_DATA_PAR_BOOL;
+}
+
+/**
+ * \brief Determine whether a data holds a parallel collection.
+ * \param t Type of the data.
+ * \retval true if the data holds a parallel collection, either boxed or unboxed.
+ * \retval false otherwise.
+ */
+static inline bool _is_par (wave_data_type t)
+{
+    return t == WAVE_DATA_PAR || _is_packed (t);
+}
+
 /**
  * \brief Print an error on type errors (ie. the types of the operands do not fit the
  * operator).
@@ -91,116 +218,309 @@ static inline void _operator_type_error (const wave_data * const left, const wav
 // Static utilities for operations checking.
 ////////////////////////////////////////////////////////////////////////////////
 
+/** \cond Doxygen ignore. */
+#define _UNARY_NUMERIC_DEFINED \
+    [WAVE_OP_UNARY_PLUS] = true, [WAVE_OP_UNARY_MINUS] = true, \
+    [WAVE_OP_UNARY_INCREMENT] = true, [WAVE_OP_UNARY_DECREMENT] = true, \
+    [WAVE_OP_UNARY_SQRT] = true, [WAVE_OP_UNARY_SIN] = true, \
+    [WAVE_OP_UNARY_COS] = true, [WAVE_OP_UNARY_LOG] = true, \
+    [WAVE_OP_UNARY_EXP] = true, [WAVE_OP_UNARY_CEIL] = true, \
+    [WAVE_OP_UNARY_FLOOR] = true
+/** \endcond Doxygen ignore. */
+
 /**
- * \brief Tab of valid operations for wave_int values.
+ * \brief Matrix of valid unary operations, indexed by operand type and operation.
  */
-static const wave_operator _int_defined [] =
+static const bool _unary_defined [WAVE_DATA_UNKNOWN + 1][WAVE_OP_UNKNOWN + 1] =
 {
-    WAVE_OP_UNARY_PLUS, WAVE_OP_UNARY_MINUS, WAVE_OP_UNARY_INCREMENT,
-    WAVE_OP_UNARY_DECREMENT, WAVE_OP_UNARY_SQRT, WAVE_OP_UNARY_SIN,
-    WAVE_OP_UNARY_COS, WAVE_OP_UNARY_LOG, WAVE_OP_UNARY_EXP, WAVE_OP_UNARY_CEIL,
-    WAVE_OP_UNARY_FLOOR, WAVE_OP_UNARY_CHR,
-    WAVE_OP_BINARY_PLUS, WAVE_OP_BINARY_MINUS,
-    WAVE_OP_BINARY_MIN, WAVE_OP_BINARY_MAX, WAVE_OP_BINARY_TIMES,
-    WAVE_OP_BINARY_DIVIDE, WAVE_OP_BINARY_MOD, WAVE_OP_BINARY_EQUALS,
-    WAVE_OP_BINARY_DIFFERS, WAVE_OP_BINARY_LESSER_OR_EQUALS,
-    WAVE_OP_BINARY_GREATER_OR_EQUALS, WAVE_OP_BINARY_GREATER,
-    WAVE_OP_BINARY_LESSER,
-    WAVE_OP_UNKNOWN,
+    [WAVE_DATA_INT] = { _UNARY_NUMERIC_DEFINED, [WAVE_OP_UNARY_CHR] = true },
+    [WAVE_DATA_FLOAT] = { _UNARY_NUMERIC_DEFINED },
+    [WAVE_DATA_CHAR] = { [WAVE_OP_UNARY_CODE] = true },
+    [WAVE_DATA_BOOL] = { [WAVE_OP_UNARY_NOT] = true },
 };
 
+/** \cond Doxygen ignore. */
+#undef _UNARY_NUMERIC_DEFINED
+/** \endcond Doxygen ignore. */
+
 /**
- * \brief Tab of valid operations for wave_float values.
+ * \brief Determine whether an unary operation is defined on a type.
+ * \param t Data type.
+ * \param op Operation.
  */
-static const wave_operator _float_defined [] =
+static inline bool _is_unary_defined (wave_data_type t, wave_operator op)
 {
-    WAVE_OP_UNARY_PLUS, WAVE_OP_UNARY_MINUS, WAVE_OP_UNARY_INCREMENT,
-    WAVE_OP_UNARY_DECREMENT, WAVE_OP_UNARY_SQRT, WAVE_OP_UNARY_SIN,
-    WAVE_OP_UNARY_COS, WAVE_OP_UNARY_LOG, WAVE_OP_UNARY_EXP, WAVE_OP_UNARY_CEIL,
-    WAVE_OP_UNARY_FLOOR, WAVE_OP_BINARY_PLUS, WAVE_OP_BINARY_MINUS,
-    WAVE_OP_BINARY_MIN, WAVE_OP_BINARY_MAX, WAVE_OP_BINARY_TIMES,
-    WAVE_OP_BINARY_DIVIDE, WAVE_OP_BINARY_MOD, WAVE_OP_BINARY_EQUALS,
-    WAVE_OP_BINARY_DIFFERS, WAVE_OP_BINARY_LESSER_OR_EQUALS,
-    WAVE_OP_BINARY_GREATER_OR_EQUALS, WAVE_OP_BINARY_GREATER,
-    WAVE_OP_BINARY_LESSER,
-    WAVE_OP_UNKNOWN,
-};
+    return _unary_defined[t][op];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for unboxed collections.
+////////////////////////////////////////////////////////////////////////////////
 
 /**
- * \brief Tab of valid operations for wave_char values.
+ * \brief Get the type of the elements of an unboxed collection.
+ * \param t Type of the unboxed collection.
+ * \return Type of the elements.
  */
-static const wave_operator _char_defined [] =
+static inline wave_data_type _packed_element_type (wave_data_type t)
 {
-    WAVE_OP_UNARY_CODE,
-    WAVE_OP_BINARY_PLUS, WAVE_OP_BINARY_MIN, WAVE_OP_BINARY_MAX,
-    WAVE_OP_BINARY_EQUALS, WAVE_OP_BINARY_DIFFERS,
-    WAVE_OP_BINARY_LESSER_OR_EQUALS, WAVE_OP_BINARY_GREATER_OR_EQUALS,
-    WAVE_OP_BINARY_GREATER, WAVE_OP_BINARY_LESSER,
-    WAVE_OP_UNKNOWN,
-};
+    wave_data_type element_type;
+    if (t == WAVE_DATA_PAR_INT)
+        element_type = WAVE_DATA_INT;
+    else if (t == WAVE_DATA_PAR_FLOAT)
+        element_type = WAVE_DATA_FLOAT;
+    else
+        element_type = WAVE_DATA_BOOL;
+
+    return element_type;
+}
 
 /**
- * \brief Tab of valid operations for wave_string values.
+ * \brief Get an element of an unboxed collection as a floating point value.
+ * \param data Data holding the unboxed collection.
+ * \param i Index of the element.
+ * \return The element, converted to a wave_float if need be.
  */
-static const wave_operator _string_defined [] =
+static inline wave_float _packed_float_at (const wave_data * const data, size_t i)
 {
-    WAVE_OP_BINARY_PLUS, WAVE_OP_BINARY_MIN, WAVE_OP_BINARY_MAX,
-    WAVE_OP_BINARY_EQUALS, WAVE_OP_BINARY_DIFFERS,
-    WAVE_OP_BINARY_LESSER_OR_EQUALS, WAVE_OP_BINARY_GREATER_OR_EQUALS,
-    WAVE_OP_BINARY_GREATER, WAVE_OP_BINARY_LESSER,
-    WAVE_OP_UNKNOWN,
-};
+    wave_float f;
+    if (data->_type == WAVE_DATA_PAR_INT)
+        f = wave_float_from_wave_int (data->_content._packed._tab._ints[i]);
+    else
+        f = data->_content._packed._tab._floats[i];
+
+    return f;
+}
 
 /**
- * \brief Tab of valid operations for wave_bool values.
+ * \brief Get an element of a bitset.
+ * \param data Data holding the bitset.
+ * \param i Index of the element.
+ * \return The element.
  */
-static const wave_operator _bool_defined [] =
+static inline wave_bool _packed_bool_at (const wave_data * const data, size_t i)
 {
-    WAVE_OP_UNARY_NOT, WAVE_OP_BINARY_AND, WAVE_OP_BINARY_OR,
-    WAVE_OP_BINARY_EQUALS, WAVE_OP_BINARY_DIFFERS, WAVE_OP_BINARY_LESSER,
-    WAVE_OP_BINARY_GREATER, WAVE_OP_BINARY_LESSER_OR_EQUALS,
-    WAVE_OP_BINARY_GREATER_OR_EQUALS,
-    WAVE_OP_UNKNOWN,
-};
+    const uint64_t word = data->_content._packed._tab._bits[i / WAVE_KERNELS_WORD_BITS];
+    return (word >> (i % WAVE_KERNELS_WORD_BITS) & 1) != 0;
+}
 
 /**
- * \brief Tab of tabs of valid operations.
+ * \brief Get an element of a parallel collection, either boxed or unboxed.
+ * \param collection Data holding the parallel collection.
+ * \param i Index of the element.
+ * \param storage Storage used to box the element of an unboxed collection.
+ * \return The element.
  */
-static const wave_operator * _defined_operators [] =
+static inline const wave_data * _par_element (const wave_data * const collection, size_t i, wave_data * const storage)
 {
-    [WAVE_DATA_INT] = _int_defined,
-    [WAVE_DATA_FLOAT] = _float_defined,
-    [WAVE_DATA_CHAR] = _char_defined,
-    [WAVE_DATA_STRING] = _string_defined,
-    [WAVE_DATA_BOOL] = _bool_defined,
-    NULL,
-};
+    const wave_data * element = storage;
+    if (collection->_type == WAVE_DATA_PAR_INT)
+        wave_data_set_int (storage, collection->_content._packed._tab._ints[i]);
+    else if (collection->_type == WAVE_DATA_PAR_FLOAT)
+        wave_data_set_float (storage, collection->_content._packed._tab._floats[i]);
+    else if (collection->_type == WAVE_DATA_PAR_BOOL)
+        wave_data_set_bool (storage, _packed_bool_at (collection, i));
+    else
+        element = & collection->_content._collection._tab[i];
+
+    return element;
+}
 
 /**
- * \brief Scan through a WAVE_OP_UNKNOWN terminated tab and search an operation.
- * \param tab Tab.
- * \param op Operation.
+ * \brief Determine whether the tab of an operand can store the result.
+ * \param operand Operand.
+ * \param type Type of the result.
+ *
+ * The tab is only reused when no other data references it and the operand is
+ * not read after the operation.
+ */
+static inline bool _is_reusable (const wave_data * const operand, wave_data_type type)
+{
+    const uint8_t flags = WAVE_DATA_FLAG_OWNED | WAVE_DATA_FLAG_LAST_USE;
+    return operand->_type == type && (operand->_flags & flags) == flags;
+}
+
+/**
+ * \brief Prepare the storage of an unboxed collection of integers.
+ * \param result Storage for the collection.
+ * \param size Size of the collection.
+ * \param left Operand whose tab may be reused.
+ * \param right Other operand whose tab may be reused, or \c NULL.
+ * \return The tab of the collection.
+ *
+ * The kernels and the element-wise loops read the i-th element of the operands
+ * before writing the i-th element of the result, so the result may take the
+ * tab of an operand.
  */
-static bool _is_defined_tab (const wave_operator tab [], wave_operator op)
+static inline wave_int * _alloc_par_int (wave_data * const result, size_t size, const wave_data * const left, const wave_data * const right)
 {
-    bool found = false;
-    for (unsigned int i = 0; ! found && tab[i] != WAVE_OP_UNKNOWN; ++i)
-        if (tab[i] == op)
-            found = true;
+    wave_int * tab;
+    if (_is_reusable (left, WAVE_DATA_PAR_INT))
+        tab = left->_content._packed._tab._ints;
+    else if (right != NULL && _is_reusable (right, WAVE_DATA_PAR_INT))
+        tab = right->_content._packed._tab._ints;
+    else
+        tab = wave_garbage_alloc (size * sizeof (wave_int));
 
-    return found;
+    wave_data_set_par_int (result, tab, size);
+    result->_flags = WAVE_DATA_FLAG_OWNED;
+    return tab;
 }
 
 /**
- * \brief Scan through the correct WAVE_OP_UNKNOWN terminated tab and search an operation.
- * \param t Data type.
- * \param op Operation.
+ * \brief Prepare the storage of an unboxed collection of floating point values.
+ * \param result Storage for the collection.
+ * \param size Size of the collection.
+ * \param left Operand whose tab may be reused.
+ * \param right Other operand whose tab may be reused, or \c NULL.
+ * \return The tab of the collection.
+ * \sa _alloc_par_int()
+ */
+static inline wave_float * _alloc_par_float (wave_data * const result, size_t size, const wave_data * const left, const wave_data * const right)
+{
+    wave_float * tab;
+    if (_is_reusable (left, WAVE_DATA_PAR_FLOAT))
+        tab = left->_content._packed._tab._floats;
+    else if (right != NULL && _is_reusable (right, WAVE_DATA_PAR_FLOAT))
+        tab = right->_content._packed._tab._floats;
+    else
+        tab = wave_garbage_alloc (size * sizeof (wave_float));
+
+    wave_data_set_par_float (result, tab, size);
+    result->_flags = WAVE_DATA_FLAG_OWNED;
+    return tab;
+}
+
+/**
+ * \brief Prepare the storage of a bitset.
+ * \param result Storage for the collection.
+ * \param size Size of the collection.
+ * \param left Operand whose bitset may be reused.
+ * \param right Other operand whose bitset may be reused, or \c NULL.
+ * \return The bitset of the collection.
+ * \sa _alloc_par_int()
+ *
+ * The tabs of integers and floating point values are never reused: the chunks
+ * of a bitset are smaller than the chunks of the tab they are computed from.
+ */
+static inline uint64_t * _alloc_par_bool (wave_data * const result, size_t size, const wave_data * const left, const wave_data * const right)
+{
+    uint64_t * bits;
+    if (_is_reusable (left, WAVE_DATA_PAR_BOOL))
+        bits = left->_content._packed._tab._bits;
+    else if (right != NULL && _is_reusable (right, WAVE_DATA_PAR_BOOL))
+        bits = right->_content._packed._tab._bits;
+    else
+        bits = wave_garbage_alloc (WAVE_KERNELS_WORDS (size) * sizeof (uint64_t));
+
+    wave_data_set_par_bool (result, bits, size);
+    result->_flags = WAVE_DATA_FLAG_OWNED;
+    return bits;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for parallel loops.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of elements given at once to a kernel.
+ *
+ * Unboxed collections are split into chunks of this size, and the chunks are
+ * processed in parallel. It is a multiple of WAVE_KERNELS_WORD_BITS, so that
+ * the chunks of a bitset start on whole words.
+ */
+#define _KERNEL_CHUNK 4096
+
+/**
+ * \brief Default grain of the parallel loops on boxed collections.
+ */
+#define _DEFAULT_PAR_GRAIN 256
+
+/**
+ * \brief Grain of the parallel loops on boxed collections.
+ *
+ * Zero until the first parallel loop reads it.
+ */
+static size_t _par_grain = 0;
+
+/**
+ * \brief Get the grain of the parallel loops on boxed collections.
+ * \return Minimal number of elements handled by a task.
+ *
+ * The grain is read once from the \c WAVE_PAR_GRAIN environment variable, and
+ * defaults to #_DEFAULT_PAR_GRAIN.
+ */
+static size_t _parallel_grain (void)
+{
+    size_t grain = __atomic_load_n (& _par_grain, __ATOMIC_RELAXED);
+    if (grain == 0)
+    {
+        const char * const env = getenv ("WAVE_PAR_GRAIN");
+        unsigned long long int value = env != NULL ? strtoull (env, NULL, 10) : 0;
+        grain = value > 0 ? (size_t) value : _DEFAULT_PAR_GRAIN;
+        __atomic_store_n (& _par_grain, grain, __ATOMIC_RELAXED);
+    }
+    return grain;
+}
+
+/**
+ * \brief Get the number of chunks of an unboxed collection.
+ * \param size Size of the collection.
+ * \return Number of chunks.
+ */
+static inline size_t _chunk_count (size_t size)
+{
+    return (size + _KERNEL_CHUNK - 1) / _KERNEL_CHUNK;
+}
+
+/**
+ * \brief Get the size of a chunk of an unboxed collection.
+ * \param chunk Index of the chunk.
+ * \param size Size of the collection.
+ * \return Number of elements of the chunk.
  */
-static bool _is_defined (wave_data_type t, wave_operator op)
+static inline size_t _chunk_size (long long int chunk, size_t size)
 {
-    return _is_defined_tab (_defined_operators[t], op);
+    size_t remaining = size - (size_t) chunk * _KERNEL_CHUNK;
+    return remaining < _KERNEL_CHUNK ? remaining : _KERNEL_CHUNK;
 }
 
+/** \cond Doxygen ignore. */
+/*
+ * Run the loop body for `i` in [0, count), `i` being a `long long int` since
+ * OpenMP requires signed integers.
+ * - Loops shorter than two grains run sequentially.
+ * - Inside a parallel region (ie. for nested collections), the loop is split
+ *   into tasks of the current team instead of opening a nested team.
+ * - Otherwise, a team is opened and the loop is split into tasks, so that
+ *   nested collections add their tasks to the same team.
+ */
+#define _parallel_for(i, count, grain, ...) \
+    { \
+        const long long int loop_count = (long long int) (count); \
+        const long long int loop_grain = (long long int) (grain); \
+        if (loop_count < 2 * loop_grain || (! omp_in_parallel () && omp_get_max_threads () < 2)) \
+        { \
+            for (long long int i = 0; i < loop_count; ++i) \
+                __VA_ARGS__ \
+        } \
+        else if (omp_in_parallel ()) \
+        { \
+            _Pragma ("omp taskloop grainsize (loop_grain)") \
+            for (long long int i = 0; i < loop_count; ++i) \
+                __VA_ARGS__ \
+        } \
+        else \
+        { \
+            _Pragma ("omp parallel") \
+            _Pragma ("omp single") \
+            _Pragma ("omp taskloop grainsize (loop_grain)") \
+            for (long long int i = 0; i < loop_count; ++i) \
+                __VA_ARGS__ \
+        } \
+    }
+/** \endcond Doxygen ignore. */
+
 ////////////////////////////////////////////////////////////////////////////////
 // Static utilities for unary operations.
 ////////////////////////////////////////////////////////////////////////////////
@@ -248,23 +568,104 @@ static wave_float (* const _unary_int_to_float []) (wave_int) =
     [WAVE_OP_UNARY_FLOOR] = wave_int_floor,
 };
 
+/**
+ * \brief Determine whether an unary operation on a wave_int gives a wave_int.
+ * \param op Operation.
+ */
+static inline bool _is_unary_int_to_int (wave_operator op)
+{
+    return op == WAVE_OP_UNARY_PLUS || op == WAVE_OP_UNARY_MINUS
+        || op == WAVE_OP_UNARY_INCREMENT || op == WAVE_OP_UNARY_DECREMENT;
+}
+
 /**
  * \brief Map an unary operation on a parallel collection.
  */
 static void _map_unary (const wave_data * const operand, wave_data * const result, wave_operator op)
 {
-    size_t size = operand->_content._collection._size;
+    wave_data source = * operand;
+    size_t size = wave_data_get_par_size (& source);
 
     /* Prepare the destination storage for the result. */
     result->_type = WAVE_DATA_PAR;
+    result->_flags = WAVE_DATA_FLAG_NONE;
     result->_content._collection._tab = wave_garbage_alloc (size * sizeof (wave_data));
-    result->_content._collection._size = size;
+    result->_content._collection._size = (uint32_t) size;
+    wave_data * const tab_result = result->_content._collection._tab;
+
+    _parallel_for (i, size, _parallel_grain (),
+        {
+            wave_data element;
+            wave_data_unary (_par_element (& source, (size_t) i, & element), & tab_result[i], op);
+        })
+}
+
+/**
+ * \brief Map an unary operation on an unboxed parallel collection.
+ *
+ * The result is unboxed whenever the operation gives integers, floating point
+ * values or booleans.
+ */
+static void _map_unary_packed (const wave_data * const operand, wave_data * const result, wave_operator op)
+{
+    /* Reminder: _operator_type_error() exits the program. */
+    if (! _is_unary_defined (_packed_element_type (operand->_type), op))
+        _operator_type_error (operand, NULL, op);
+
+    size_t size = operand->_content._packed._size;
 
-    /* OpenMP requires *signed* integers ?! */
-    long long int ll_size = (long long int) size;
-    #pragma omp parallel for
-        for (long long int i = 0; i < ll_size; ++i)
-            wave_data_unary (& operand->_content._collection._tab[i], & result->_content._collection._tab[i], op);
+    if (operand->_type == WAVE_DATA_PAR_BOOL)
+    {
+        /* Reminder: `not` is the only operation on booleans. */
+        const uint64_t * const bits = operand->_content._packed._tab._bits;
+        uint64_t * const bits_result = _alloc_par_bool (result, size, operand, NULL);
+        _parallel_for (c, _chunk_count (size), 1,
+            {
+                size_t word = (size_t) c * _KERNEL_CHUNK / WAVE_KERNELS_WORD_BITS;
+                wave_kernels_bool_not (bits + word, bits_result + word, _chunk_size (c, size));
+            })
+    }
+    else if (operand->_type == WAVE_DATA_PAR_FLOAT)
+    {
+        const wave_float * const tab = operand->_content._packed._tab._floats;
+        wave_float * const tab_result = _alloc_par_float (result, size, operand, NULL);
+        if (wave_kernels_has_float_unary (op))
+            _parallel_for (c, _chunk_count (size), 1,
+                wave_kernels_float_unary (op, tab + c * _KERNEL_CHUNK, tab_result + c * _KERNEL_CHUNK, _chunk_size (c, size));)
+        else
+            _parallel_for (i, size, _KERNEL_CHUNK,
+                tab_result[i] = _unary_float_to_float[op] (tab[i]);)
+    }
+    else if (_is_unary_int_to_int (op))
+    {
+        const wave_int * const tab = operand->_content._packed._tab._ints;
+        wave_int * const tab_result = _alloc_par_int (result, size, operand, NULL);
+        _parallel_for (c, _chunk_count (size), 1,
+            wave_kernels_int_unary (op, tab + c * _KERNEL_CHUNK, tab_result + c * _KERNEL_CHUNK, _chunk_size (c, size));)
+    }
+    else if (op == WAVE_OP_UNARY_CHR)
+        /* Characters are not unboxed. */
+        _map_unary (operand, result, op);
+    else
+    {
+        /* The integers are never reused to store floating point values. */
+        const wave_int * const tab = operand->_content._packed._tab._ints;
+        wave_float * const tab_result = _alloc_par_float (result, size, operand, NULL);
+        if (wave_kernels_has_float_unary (op))
+            /* Each chunk is converted, then the operation is computed in place. */
+            _parallel_for (c, _chunk_count (size), 1,
+                {
+                    const wave_int * const source = tab + c * _KERNEL_CHUNK;
+                    wave_float * const chunk = tab_result + c * _KERNEL_CHUNK;
+                    const size_t chunk_size = _chunk_size (c, size);
+                    for (size_t j = 0; j < chunk_size; ++j)
+                        chunk[j] = wave_float_from_wave_int (source[j]);
+                    wave_kernels_float_unary (op, chunk, chunk, chunk_size);
+                })
+        else
+            _parallel_for (i, size, _KERNEL_CHUNK,
+                tab_result[i] = _unary_int_to_float[op] (tab[i]);)
+    }
 }
 
 /**
@@ -277,14 +678,13 @@ static void _map_unary (const wave_data * const operand, wave_data * const resul
 static inline void _unary_constant (wave_data_type operand_type, const wave_data * const operand, wave_data * const result, wave_operator op)
 {
     /* Reminder: _operator_type_error() exits the program. */
-    if (! _is_defined (operand_type, op))
+    if (! _is_unary_defined (operand_type, op))
         _operator_type_error (operand, NULL, op);
 
     if (operand_type == WAVE_DATA_INT)
     {
         wave_int int_value = wave_data_get_int (operand);
-        if (op == WAVE_OP_UNARY_PLUS || op == WAVE_OP_UNARY_MINUS
-            || op == WAVE_OP_UNARY_INCREMENT || op == WAVE_OP_UNARY_DECREMENT)
+        if (_is_unary_int_to_int (op))
             wave_data_set_int (result, _unary_int_to_int[op] (int_value));
         else if (op == WAVE_OP_UNARY_CHR)
             wave_data_set_char (result, wave_int_chr (int_value));
@@ -380,27 +780,84 @@ static wave_bool (* const _binary_char_to_bool []) (wave_char, wave_char) =
 };
 
 /**
- * \brief Tab of binary `(wave_string, wave_string) -> wave_string` functions.
+ * \brief Get the characters of a wave_char or wave_string data, without allocating.
+ * \param data Data of interest.
+ * \param storage Storage for the characters of a wave_char.
+ * \param length Storage for the length.
+ * \return The characters, not necessarily null terminated.
  */
-static wave_string (* const _binary_string []) (const_wave_string, const_wave_string) =
+static inline const_wave_string _string_view (const wave_data * const data, wave_char storage[2], size_t * const length)
 {
-    [WAVE_OP_BINARY_PLUS] = wave_string_binary_plus,
-    [WAVE_OP_BINARY_MIN] = wave_string_min,
-    [WAVE_OP_BINARY_MAX] = wave_string_max,
-};
+    const_wave_string s;
+    if (wave_data_get_type (data) == WAVE_DATA_CHAR)
+    {
+        storage[0] = data->_content._char;
+        storage[1] = '\0';
+        s = storage;
+        * length = wave_string_length (s);
+    }
+    else
+        s = wave_data_get_characters (data, length);
+
+    return s;
+}
 
 /**
- * \brief Tab of binary `(wave_string, wave_string) -> wave_bool` functions.
+ * \brief Compare two strings, like wave_string_compare().
+ * \param a Left string.
+ * \param length_a Length of the left string.
+ * \param b Right string.
+ * \param length_b Length of the right string.
+ * \return A negative value, zero or a positive value if \c a is respectively lesser than, equal to or greater than \c b.
  */
-static wave_bool (* const _binary_string_to_bool []) (const_wave_string, const_wave_string) =
+static int _string_compare (const wave_char * a, size_t length_a, const wave_char * b, size_t length_b)
 {
-    [WAVE_OP_BINARY_EQUALS] = wave_string_equals,
-    [WAVE_OP_BINARY_DIFFERS] = wave_string_differs,
-    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = wave_string_lesser_or_equals,
-    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = wave_string_greater_or_equals,
-    [WAVE_OP_BINARY_GREATER] = wave_string_greater,
-    [WAVE_OP_BINARY_LESSER] = wave_string_lesser,
-};
+    int comparison = memcmp (a, b, (length_a < length_b ? length_a : length_b) * sizeof (wave_char));
+    if (comparison == 0)
+        comparison = (length_a > length_b) - (length_a < length_b);
+    return comparison;
+}
+
+/**
+ * \brief Store the concatenation of two strings inside a data.
+ * \param data Storage, which may be one of the operands.
+ * \param a Left string.
+ * \param length_a Length of the left string.
+ * \param b Right string.
+ * \param length_b Length of the right string.
+ * \param grow Whether the result is likely to be extended, in which case the
+ * buffer is given twice the room it needs.
+ *
+ * Small results are stored in the data itself, the others in a new buffer
+ * allocated in the garbage collector.
+ */
+static void _set_string_plus (wave_data * const data, const wave_char * a, size_t length_a, const wave_char * b, size_t length_b, bool grow)
+{
+    size_t length = length_a + length_b;
+    if (length <= WAVE_DATA_SMALL_STRING_MAX)
+    {
+        /* The operands may be stored in the data itself. */
+        wave_char small[WAVE_DATA_SMALL_STRING_MAX + 1];
+        memcpy (small, a, length_a * sizeof (wave_char));
+        memcpy (small + length_a, b, length_b * sizeof (wave_char));
+        wave_data_set_string_copy (data, small, length);
+    }
+    else if (length > WAVE_DATA_SIZE_MAX)
+    {
+        /* Too long for a buffer. */
+        wave_string s = wave_garbage_alloc ((length + 1) * sizeof (wave_char));
+        memcpy (s, a, length_a * sizeof (wave_char));
+        memcpy (s + length_a, b, length_b * sizeof (wave_char));
+        s[length] = '\0';
+        wave_data_set_string (data, s);
+    }
+    else
+    {
+        size_t capacity = grow ? 2 * length : length;
+        wave_string_buffer * buffer = wave_garbage_alloc (_string_buffer_size (capacity));
+        _set_buffered (data, _string_buffer_init (buffer, capacity, a, length_a, b, length_b), length);
+    }
+}
 
 /**
  * \brief Tab of binary `(wave_bool, wave_bool) -> wave_bool` functions.
@@ -409,8 +866,21 @@ static wave_bool (* const _binary_bool []) (wave_bool, wave_bool) =
 {
     [WAVE_OP_BINARY_AND] = wave_bool_and,
     [WAVE_OP_BINARY_OR] = wave_bool_or,
+    [WAVE_OP_BINARY_EQUALS] = wave_bool_equals,
+    [WAVE_OP_BINARY_DIFFERS] = wave_bool_differs,
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = wave_bool_lesser_or_equals,
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = wave_bool_greater_or_equals,
+    [WAVE_OP_BINARY_GREATER] = wave_bool_greater,
+    [WAVE_OP_BINARY_LESSER] = wave_bool_lesser,
 };
 
+/**
+ * \brief Handler of a binary operation.
+ *
+ * Handlers are only called on operands whose types fit the operation.
+ */
+typedef void (* _binary_handler) (const wave_data *, const wave_data *, wave_data *, wave_operator);
+
 /**
  * \brief Compute the result of a binary operation on wave_bool values.
  * \param left Left operand.
@@ -418,7 +888,7 @@ static wave_bool (* const _binary_bool []) (wave_bool, wave_bool) =
  * \param result Storage for the result.
  * \param op Operation.
  */
-static inline void _set_binary_both_bool (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _set_binary_bool (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
     wave_bool left_value = wave_data_get_bool (left);
     wave_bool right_value = wave_data_get_bool (right);
@@ -426,330 +896,878 @@ static inline void _set_binary_both_bool (const wave_data * const left, const wa
 }
 
 /**
- * \brief Compute the result of a binary operation on wave_int values.
+ * \brief Compute the result of an arithmetic operation on wave_int values.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
  * \param op Operation.
  */
-static inline void _set_binary_both_int (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _set_binary_int (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
     wave_int left_value = wave_data_get_int (left);
     wave_int right_value = wave_data_get_int (right);
-    if (wave_operator_is_test (op))
-        wave_data_set_bool (result, _binary_int_to_bool[op] (left_value, right_value));
-    else
-        wave_data_set_int (result, _binary_int[op] (left_value, right_value));
+    wave_data_set_int (result, _binary_int[op] (left_value, right_value));
+}
+
+/**
+ * \brief Compute the result of a test on wave_int values.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param result Storage for the result.
+ * \param op Test.
+ */
+static void _set_test_int (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+{
+    wave_int left_value = wave_data_get_int (left);
+    wave_int right_value = wave_data_get_int (right);
+    wave_data_set_bool (result, _binary_int_to_bool[op] (left_value, right_value));
 }
 
 /**
- * \brief Compute the result of a binary operation on wave_float values.
+ * \brief Compute the result of an arithmetic operation on wave_float values.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
  * \param op Operation.
+ *
+ * wave_int operands are converted to wave_float values.
  */
-static inline void _set_binary_both_float (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _set_binary_float (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
     wave_float left_value = wave_data_get_float (left);
     wave_float right_value = wave_data_get_float (right);
-    if (wave_operator_is_test (op))
-        wave_data_set_bool (result, _binary_float_to_bool[op] (left_value, right_value));
-    else
-        wave_data_set_float (result, _binary_float[op] (left_value, right_value));
+    wave_data_set_float (result, _binary_float[op] (left_value, right_value));
 }
 
 /**
- * \brief Compute the result of a binary operation on wave_char values.
+ * \brief Compute the result of a test on wave_float values.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
- * \param op Operation.
+ * \param op Test.
+ *
+ * wave_int operands are converted to wave_float values.
  */
-static inline void _set_binary_both_char (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _set_test_float (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
-    wave_char left_value = wave_data_get_char (left);
-    wave_char right_value = wave_data_get_char (right);
-    if (wave_operator_is_test (op))
-        wave_data_set_bool (result, _binary_char_to_bool[op] (left_value, right_value));
-    else if (op == WAVE_OP_BINARY_PLUS)
-    {
-        /* `plus` on wave_char returns a dynaically allocated wave_string ! */
-        wave_data_set_string (result, wave_char_binary_plus (left_value, right_value));
-        wave_garbage_register (result->_content._string);
-    }
-    else
-        wave_data_set_char (result, _binary_char[op] (left_value, right_value));
+    wave_float left_value = wave_data_get_float (left);
+    wave_float right_value = wave_data_get_float (right);
+    wave_data_set_bool (result, _binary_float_to_bool[op] (left_value, right_value));
 }
 
 /**
- * \brief Compute the result of a binary operation on wave_string values.
+ * \brief Compute the result of `min` or `max` on wave_char values.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
  * \param op Operation.
  */
-static inline void _set_binary_both_string (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _set_binary_char (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
-    wave_string left_value = wave_data_get_string (left);
-    wave_string right_value = wave_data_get_string (right);
-    if (wave_operator_is_test (op))
-        wave_data_set_bool (result, _binary_string_to_bool[op] (left_value, right_value));
-    else
-    {
-        /* Beware: binary operations on wave_string values return dynamically
-         * allocated wave_string values.
-         */
-        wave_data_set_string (result, _binary_string[op] (left_value, right_value));
-        wave_garbage_register (result->_content._string);
-    }
+    wave_char left_value = wave_data_get_char (left);
+    wave_char right_value = wave_data_get_char (right);
+    wave_data_set_char (result, _binary_char[op] (left_value, right_value));
 }
 
-/* Tab of functions for binary operations in cases where both operands are of
- * the same type.
+/**
+ * \brief Compute the concatenation of wave_char values.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param result Storage for the result.
+ * \param op Operation.
  */
-static void (* _set_binary_same_types []) (const wave_data *, const wave_data *, wave_data *, wave_operator) =
+static void _set_plus_char (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
-    [WAVE_DATA_BOOL] = _set_binary_both_bool,
-    [WAVE_DATA_INT] = _set_binary_both_int,
-    [WAVE_DATA_FLOAT] = _set_binary_both_float,
-    [WAVE_DATA_CHAR] = _set_binary_both_char,
-    [WAVE_DATA_STRING] = _set_binary_both_string,
-    [WAVE_DATA_SEQ] = NULL,
-    [WAVE_DATA_PAR] = NULL,
-    [WAVE_DATA_OPERATOR] = NULL,
-    [WAVE_DATA_UNKNOWN] = NULL,
-};
-
-/* Operations on mixed operands are accepted for:
- * - wave_int / wave_float
- * - wave_char / wave_string
- */
+    (void) op;
+    wave_char s[2] = { wave_data_get_char (left), wave_data_get_char (right) };
+    wave_data_set_string_copy (result, s, 2);
+}
 
 /**
- * \brief Compute a binary operation on mixed wave_int / wave_float values.
+ * \brief Compute the result of a test on wave_char values.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
- * \param op Operation.
+ * \param op Test.
  */
-static void _set_binary_int_float (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _set_test_char (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
-    wave_float left_value = wave_data_get_float (left);
-    wave_float right_value = wave_data_get_float (right);
-    if (wave_operator_is_test (op))
-        wave_data_set_bool (result, _binary_float_to_bool[op] (left_value, right_value));
-    else
-        wave_data_set_float (result, _binary_float[op] (left_value, right_value));
+    wave_char left_value = wave_data_get_char (left);
+    wave_char right_value = wave_data_get_char (right);
+    wave_data_set_bool (result, _binary_char_to_bool[op] (left_value, right_value));
 }
 
 /**
- * \brief Compute a binary operation on mixed wave_char / wave_string values.
+ * \brief Compute the result of a binary operation on wave_string values.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
  * \param op Operation.
+ *
+ * wave_char operands are converted to wave_string values. The results are
+ * new strings, even for \c min and \c max, except when a concatenation
+ * extends its left operand in place.
  */
-static void _set_binary_char_string (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _set_binary_string (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
-    wave_string left_value = wave_data_get_string (left);
-    wave_string right_value = wave_data_get_string (right);
-    if (wave_operator_is_test (op))
-        wave_data_set_bool (result, _binary_string[op] (left_value, right_value));
+    wave_char left_storage[2], right_storage[2];
+    size_t left_length, right_length;
+    const_wave_string left_value = _string_view (left, left_storage, & left_length);
+    const_wave_string right_value = _string_view (right, right_storage, & right_length);
+
+    if (op == WAVE_OP_BINARY_PLUS)
+    {
+        if (! _string_buffer_append (left, right_value, right_length, result))
+            _set_string_plus (result, left_value, left_length, right_value, right_length, _is_buffered (left));
+    }
     else
     {
-        wave_data_set_string (result, _binary_string[op] (left_value, right_value));
-        wave_garbage_register (result->_content._string);
+        int comparison = _string_compare (left_value, left_length, right_value, right_length);
+        bool left_chosen = op == WAVE_OP_BINARY_MIN ? comparison < 0 : comparison > 0;
+        if (left_chosen)
+            _set_string_plus (result, left_value, left_length, "", 0, false);
+        else
+            _set_string_plus (result, right_value, right_length, "", 0, false);
     }
 }
 
 /**
- * \brief Map a binary operation on two parallel collections.
+ * \brief Compute the result of a test on wave_string values.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
- * \param op Operation.
+ * \param op Test.
+ *
+ * wave_char operands are converted to wave_string values.
  */
-static void _map_binary (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _set_test_string (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
-    size_t size = left->_content._collection._size;
+    wave_char left_storage[2], right_storage[2];
+    size_t left_length, right_length;
+    const_wave_string left_value = _string_view (left, left_storage, & left_length);
+    const_wave_string right_value = _string_view (right, right_storage, & right_length);
+    int comparison = _string_compare (left_value, left_length, right_value, right_length);
+    wave_data_set_bool (result, _binary_int_to_bool[op] (comparison, 0));
+}
 
-    /* Prepare the destination storage for the result. */
-    result->_type = WAVE_DATA_PAR;
-    result->_content._collection._tab = wave_garbage_alloc (size * sizeof (wave_data));
-    result->_content._collection._size = size;
+static void _binary_operation_parallels (const wave_data * left, const wave_data * right, wave_data * result, wave_operator op);
+static void _binary_operation_broadcast (const wave_data * left, const wave_data * right, wave_data * result, wave_operator op);
 
+/** \cond Doxygen ignore. */
+#define _ARITHMETIC(handler) \
+    [WAVE_OP_BINARY_PLUS] = handler, [WAVE_OP_BINARY_MINUS] = handler, \
+    [WAVE_OP_BINARY_MIN] = handler, [WAVE_OP_BINARY_MAX] = handler, \
+    [WAVE_OP_BINARY_TIMES] = handler, [WAVE_OP_BINARY_DIVIDE] = handler, \
+    [WAVE_OP_BINARY_MOD] = handler
+
+#define _TESTS(handler) \
+    [WAVE_OP_BINARY_EQUALS] = handler, [WAVE_OP_BINARY_DIFFERS] = handler, \
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = handler, \
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = handler, \
+    [WAVE_OP_BINARY_GREATER] = handler, [WAVE_OP_BINARY_LESSER] = handler
+
+#define _LOGIC(handler) \
+    [WAVE_OP_BINARY_AND] = handler, [WAVE_OP_BINARY_OR] = handler
+
+#define _NUMBERS { _ARITHMETIC (_set_binary_float), _TESTS (_set_test_float) }
+
+#define _STRINGS \
+    { \
+        [WAVE_OP_BINARY_PLUS] = _set_binary_string, \
+        [WAVE_OP_BINARY_MIN] = _set_binary_string, \
+        [WAVE_OP_BINARY_MAX] = _set_binary_string, \
+        _TESTS (_set_test_string), \
+    }
+
+#define _PARALLELS \
+    { \
+        _ARITHMETIC (_binary_operation_parallels), \
+        _TESTS (_binary_operation_parallels), \
+        _LOGIC (_binary_operation_parallels), \
+    }
+
+#define _BROADCASTS \
+    { \
+        _ARITHMETIC (_binary_operation_broadcast), \
+        _TESTS (_binary_operation_broadcast), \
+        _LOGIC (_binary_operation_broadcast), \
+    }
+
+#define _ATOM_BROADCASTS \
+    [WAVE_DATA_PAR] = _BROADCASTS, \
+    [WAVE_DATA_PAR_INT] = _BROADCASTS, \
+    [WAVE_DATA_PAR_FLOAT] = _BROADCASTS, \
+    [WAVE_DATA_PAR_BOOL] = _BROADCASTS
+
+#define _PAR_BROADCASTS \
+    [WAVE_DATA_INT] = _BROADCASTS, \
+    [WAVE_DATA_FLOAT] = _BROADCASTS, \
+    [WAVE_DATA_CHAR] = _BROADCASTS, \
+    [WAVE_DATA_STRING] = _BROADCASTS, \
+    [WAVE_DATA_BOOL] = _BROADCASTS
+/** \endcond Doxygen ignore. */
+
+/**
+ * \brief Matrix of binary operation handlers, indexed by left operand type,
+ * right operand type and operation.
+ *
+ * Empty entries denote operations which are not defined on the types.
+ *
+ * Mixed operands are accepted for:
+ * - wave_int / wave_float, computed on wave_float values;
+ * - wave_char / wave_string, computed on wave_string values;
+ * - any two parallel collections, either boxed or unboxed;
+ * - an atom and a parallel collection, the atom being combined with each
+ *   element of the collection.
+ */
+static const _binary_handler _binary_handlers [WAVE_DATA_UNKNOWN + 1][WAVE_DATA_UNKNOWN + 1][WAVE_OP_UNKNOWN + 1] =
+{
+    [WAVE_DATA_INT] =
+    {
+        [WAVE_DATA_INT] = { _ARITHMETIC (_set_binary_int), _TESTS (_set_test_int) },
+        [WAVE_DATA_FLOAT] = _NUMBERS,
+        _ATOM_BROADCASTS,
+    },
+    [WAVE_DATA_FLOAT] =
+    {
+        [WAVE_DATA_INT] = _NUMBERS,
+        [WAVE_DATA_FLOAT] = _NUMBERS,
+        _ATOM_BROADCASTS,
+    },
+    [WAVE_DATA_CHAR] =
+    {
+        [WAVE_DATA_CHAR] =
+        {
+            [WAVE_OP_BINARY_PLUS] = _set_plus_char,
+            [WAVE_OP_BINARY_MIN] = _set_binary_char,
+            [WAVE_OP_BINARY_MAX] = _set_binary_char,
+            _TESTS (_set_test_char),
+        },
+        [WAVE_DATA_STRING] = _STRINGS,
+        _ATOM_BROADCASTS,
+    },
+    [WAVE_DATA_STRING] =
+    {
+        [WAVE_DATA_CHAR] = _STRINGS,
+        [WAVE_DATA_STRING] = _STRINGS,
+        _ATOM_BROADCASTS,
+    },
+    [WAVE_DATA_BOOL] =
+    {
+        [WAVE_DATA_BOOL] = { _LOGIC (_set_binary_bool), _TESTS (_set_binary_bool) },
+        _ATOM_BROADCASTS,
+    },
+    [WAVE_DATA_PAR] =
+    {
+        [WAVE_DATA_PAR] = _PARALLELS,
+        [WAVE_DATA_PAR_INT] = _PARALLELS,
+        [WAVE_DATA_PAR_FLOAT] = _PARALLELS,
+        [WAVE_DATA_PAR_BOOL] = _PARALLELS,
+        _PAR_BROADCASTS,
+    },
+    [WAVE_DATA_PAR_INT] =
+    {
+        [WAVE_DATA_PAR] = _PARALLELS,
+        [WAVE_DATA_PAR_INT] = _PARALLELS,
+        [WAVE_DATA_PAR_FLOAT] = _PARALLELS,
+        [WAVE_DATA_PAR_BOOL] = _PARALLELS,
+        _PAR_BROADCASTS,
+    },
+    [WAVE_DATA_PAR_FLOAT] =
+    {
+        [WAVE_DATA_PAR] = _PARALLELS,
+        [WAVE_DATA_PAR_INT] = _PARALLELS,
+        [WAVE_DATA_PAR_FLOAT] = _PARALLELS,
+        [WAVE_DATA_PAR_BOOL] = _PARALLELS,
+        _PAR_BROADCASTS,
+    },
+    [WAVE_DATA_PAR_BOOL] =
+    {
+        [WAVE_DATA_PAR] = _PARALLELS,
+        [WAVE_DATA_PAR_INT] = _PARALLELS,
+        [WAVE_DATA_PAR_FLOAT] = _PARALLELS,
+        [WAVE_DATA_PAR_BOOL] = _PARALLELS,
+        _PAR_BROADCASTS,
+    },
+};
+
+/** \cond Doxygen ignore. */
+#undef _PAR_BROADCASTS
+#undef _ATOM_BROADCASTS
+#undef _BROADCASTS
+#undef _PARALLELS
+#undef _STRINGS
+#undef _NUMBERS
+#undef _LOGIC
+#undef _TESTS
+#undef _ARITHMETIC
+/** \endcond Doxygen ignore. */
+
+/**
+ * \brief Determine whether a binary operation is defined on two types.
+ * \param left_type Type of the left operand.
+ * \param right_type Type of the right operand.
+ * \param op Operation.
+ */
+static inline bool _is_binary_defined (wave_data_type left_type, wave_data_type right_type, wave_operator op)
+{
+    return _binary_handlers[left_type][right_type][op] != NULL;
+}
+
+/**
+ * \brief Map a binary operation on two parallel collections.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param result Storage for the result.
+ * \param op Operation.
+ */
+static void _map_binary (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+{
     /* Variables for easier processing. */
-    const wave_data * const tab_left = left->_content._collection._tab;
-    const wave_data * const tab_right = right->_content._collection._tab;
+    wave_data source_left = * left;
+    wave_data source_right = * right;
+    size_t size = wave_data_get_par_size (& source_left);
+
+    /* Prepare the destination storage for the result. */
+    result->_type = WAVE_DATA_PAR;
+    result->_flags = WAVE_DATA_FLAG_NONE;
+    result->_content._collection._tab = wave_garbage_alloc (size * sizeof (wave_data));
+    result->_content._collection._size = (uint32_t) size;
     wave_data * const tab_result = result->_content._collection._tab;
 
-    /* OpenMP requires *signed* integers ?! */
-    long long int ll_size = (long long int) size;
-    #pragma omp parallel for
-        for (long long int i = 0; i < ll_size; ++i)
-            wave_data_binary (& tab_left[i], & tab_right[i], & tab_result[i], op);
+    _parallel_for (i, size, _parallel_grain (),
+        {
+            wave_data element_left;
+            wave_data element_right;
+            wave_data_binary (_par_element (& source_left, (size_t) i, & element_left),
+                _par_element (& source_right, (size_t) i, & element_right), & tab_result[i], op);
+        })
 }
 
 /**
- * \brief Compute a binary operation on constants.
- * \param left_type Type of the left operand.
- * \param right_type Type of the right operand.
+ * \brief Map a test on two unboxed parallel collections of the same type.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
- * \param op Operator.
+ * \param op Test, or logical operation on booleans.
+ *
+ * The results are stored as a bitset.
+ */
+static void _map_test_packed (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+{
+    size_t size = left->_content._packed._size;
+    uint64_t * const bits_result = _alloc_par_bool (result, size, left, right);
+
+    _parallel_for (c, _chunk_count (size), 1,
+        {
+            size_t start = (size_t) c * _KERNEL_CHUNK;
+            uint64_t * const bits = bits_result + start / WAVE_KERNELS_WORD_BITS;
+            size_t chunk_size = _chunk_size (c, size);
+
+            if (left->_type == WAVE_DATA_PAR_INT)
+                wave_kernels_int_test_bits (op, left->_content._packed._tab._ints + start,
+                    right->_content._packed._tab._ints + start, bits, chunk_size);
+            else if (left->_type == WAVE_DATA_PAR_FLOAT)
+                wave_kernels_float_test_bits (op, left->_content._packed._tab._floats + start,
+                    right->_content._packed._tab._floats + start, bits, chunk_size);
+            else
+                wave_kernels_bool_binary (op, left->_content._packed._tab._bits + start / WAVE_KERNELS_WORD_BITS,
+                    right->_content._packed._tab._bits + start / WAVE_KERNELS_WORD_BITS, bits, chunk_size);
+        })
+}
+
+/**
+ * \brief Map a binary operation on two unboxed parallel collections.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param result Storage for the result.
+ * \param op Operation.
+ *
+ * The result is unboxed, except for tests on integers and floating point values
+ * mixed together, whose results are boxed booleans.
  */
-static inline void _binary_operation_constants (wave_data_type left_type, wave_data_type right_type, const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _map_binary_packed (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
     /* Reminder: _operator_type_error() exits the program. */
-    if (! _is_defined (left_type, op) || ! _is_defined (right_type, op))
+    if (! _is_binary_defined (_packed_element_type (left->_type), _packed_element_type (right->_type), op))
         _operator_type_error (left, right, op);
 
-    if (left_type == right_type)
-        _set_binary_same_types[left_type] (left, right, result, op);
-    else if ((left_type == WAVE_DATA_FLOAT && right_type == WAVE_DATA_INT) || (left_type == WAVE_DATA_INT && right_type == WAVE_DATA_FLOAT))
-        _set_binary_int_float (left, right, result, op);
-    else if ((left_type == WAVE_DATA_CHAR && right_type == WAVE_DATA_STRING) || (left_type == WAVE_DATA_STRING && right_type == WAVE_DATA_CHAR))
-        _set_binary_char_string (left, right, result, op);
+    wave_data source_left = * left;
+    wave_data source_right = * right;
+    size_t size = source_left._content._packed._size;
+
+    if (source_left._type == WAVE_DATA_PAR_BOOL)
+        /* Both operands are booleans, and the operation is a test or a logical operation. */
+        _map_test_packed (& source_left, & source_right, result, op);
+    else if (wave_operator_is_test (op) && source_left._type == source_right._type)
+        _map_test_packed (& source_left, & source_right, result, op);
+    else if (wave_operator_is_test (op))
+        _map_binary (& source_left, & source_right, result, op);
+    else if (source_left._type == WAVE_DATA_PAR_INT && source_right._type == WAVE_DATA_PAR_INT)
+    {
+        const wave_int * const tab_left = source_left._content._packed._tab._ints;
+        const wave_int * const tab_right = source_right._content._packed._tab._ints;
+        wave_int * const tab_result = _alloc_par_int (result, size, & source_left, & source_right);
+        _parallel_for (c, _chunk_count (size), 1,
+            wave_kernels_int_binary (op, tab_left + c * _KERNEL_CHUNK, tab_right + c * _KERNEL_CHUNK,
+                tab_result + c * _KERNEL_CHUNK, _chunk_size (c, size));)
+    }
+    else if (source_left._type == WAVE_DATA_PAR_FLOAT && source_right._type == WAVE_DATA_PAR_FLOAT)
+    {
+        const wave_float * const tab_left = source_left._content._packed._tab._floats;
+        const wave_float * const tab_right = source_right._content._packed._tab._floats;
+        wave_float * const tab_result = _alloc_par_float (result, size, & source_left, & source_right);
+        _parallel_for (c, _chunk_count (size), 1,
+            wave_kernels_float_binary (op, tab_left + c * _KERNEL_CHUNK, tab_right + c * _KERNEL_CHUNK,
+                tab_result + c * _KERNEL_CHUNK, _chunk_size (c, size));)
+    }
+    else
+    {
+        wave_float * const tab_result = _alloc_par_float (result, size, & source_left, & source_right);
+        _parallel_for (i, size, _KERNEL_CHUNK,
+            tab_result[i] = _binary_float[op] (_packed_float_at (& source_left, (size_t) i), _packed_float_at (& source_right, (size_t) i));)
+    }
+}
+
+/**
+ * \brief Map a binary operation on an atom and the elements of a parallel collection.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param result Storage for the result.
+ * \param op Operation.
+ * \pre Exactly one of the operands is a parallel collection.
+ *
+ * The atom is combined with each element of the collection, keeping its side.
+ */
+static void _map_broadcast (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+{
+    wave_data source_left = * left;
+    wave_data source_right = * right;
+    bool left_is_par = _is_par (source_left._type);
+    const wave_data * const collection = left_is_par ? & source_left : & source_right;
+    size_t size = wave_data_get_par_size (collection);
+
+    /* Prepare the destination storage for the result. */
+    result->_type = WAVE_DATA_PAR;
+    result->_flags = WAVE_DATA_FLAG_NONE;
+    result->_content._collection._tab = wave_garbage_alloc (size * sizeof (wave_data));
+    result->_content._collection._size = (uint32_t) size;
+    wave_data * const tab_result = result->_content._collection._tab;
+
+    _parallel_for (i, size, _parallel_grain (),
+        {
+            wave_data storage;
+            const wave_data * const element = _par_element (collection, (size_t) i, & storage);
+            wave_data_binary (left_is_par ? element : & source_left, left_is_par ? & source_right : element, & tab_result[i], op);
+        })
+}
+
+/**
+ * \brief Map a test on an atom and the elements of an unboxed parallel collection of the same type.
+ * \param atom The atom.
+ * \param collection The collection.
+ * \param result Storage for the result.
+ * \param op Test, or logical operation on booleans.
+ * \param atom_is_left Whether the atom is the left operand.
+ *
+ * The results are stored as a bitset.
+ */
+static void _map_test_broadcast_packed (const wave_data * const atom, const wave_data * const collection, wave_data * const result, wave_operator op, bool atom_is_left)
+{
+    size_t size = collection->_content._packed._size;
+    uint64_t * const bits_result = _alloc_par_bool (result, size, collection, NULL);
+
+    _parallel_for (c, _chunk_count (size), 1,
+        {
+            size_t start = (size_t) c * _KERNEL_CHUNK;
+            uint64_t * const bits = bits_result + start / WAVE_KERNELS_WORD_BITS;
+            size_t chunk_size = _chunk_size (c, size);
+
+            if (collection->_type == WAVE_DATA_PAR_INT && atom_is_left)
+                wave_kernels_int_test_bits_broadcast_left (op, atom->_content._int, collection->_content._packed._tab._ints + start, bits, chunk_size);
+            else if (collection->_type == WAVE_DATA_PAR_INT)
+                wave_kernels_int_test_bits_broadcast_right (op, collection->_content._packed._tab._ints + start, atom->_content._int, bits, chunk_size);
+            else if (collection->_type == WAVE_DATA_PAR_FLOAT && atom_is_left)
+                wave_kernels_float_test_bits_broadcast_left (op, atom->_content._float, collection->_content._packed._tab._floats + start, bits, chunk_size);
+            else if (collection->_type == WAVE_DATA_PAR_FLOAT)
+                wave_kernels_float_test_bits_broadcast_right (op, collection->_content._packed._tab._floats + start, atom->_content._float, bits, chunk_size);
+            else if (atom_is_left)
+                wave_kernels_bool_broadcast_left (op, atom->_content._bool, collection->_content._packed._tab._bits + start / WAVE_KERNELS_WORD_BITS, bits, chunk_size);
+            else
+                wave_kernels_bool_broadcast_right (op, collection->_content._packed._tab._bits + start / WAVE_KERNELS_WORD_BITS, atom->_content._bool, bits, chunk_size);
+        })
+}
+
+/**
+ * \brief Map a binary operation on an atom and the elements of an unboxed parallel collection.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param result Storage for the result.
+ * \param op Operation.
+ * \pre Exactly one of the operands is an unboxed parallel collection.
+ *
+ * The atom is read once and given to the broadcast kernels. As for
+ * _map_binary_packed(), the result is unboxed, except for tests on integers and
+ * floating point values mixed together.
+ */
+static void _map_broadcast_packed (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+{
+    bool left_is_par = _is_packed (left->_type);
+    wave_data collection = left_is_par ? * left : * right;
+    wave_data atom = left_is_par ? * right : * left;
+    wave_data_type element_type = _packed_element_type (collection._type);
+
+    /* Reminder: _operator_type_error() exits the program. */
+    if (! _is_binary_defined (left_is_par ? element_type : atom._type, left_is_par ? atom._type : element_type, op))
+        _operator_type_error (left, right, op);
+
+    size_t size = collection._content._packed._size;
+
+    if (element_type == WAVE_DATA_BOOL)
+        /* The atom is a boolean, and the operation is a test or a logical operation. */
+        _map_test_broadcast_packed (& atom, & collection, result, op, ! left_is_par);
+    else if (wave_operator_is_test (op) && atom._type == element_type)
+        _map_test_broadcast_packed (& atom, & collection, result, op, ! left_is_par);
+    else if (wave_operator_is_test (op))
+        _map_broadcast (left, right, result, op);
+    else if (atom._type == WAVE_DATA_INT && element_type == WAVE_DATA_INT)
+    {
+        const wave_int * const tab = collection._content._packed._tab._ints;
+        wave_int * const tab_result = _alloc_par_int (result, size, & collection, NULL);
+        _parallel_for (c, _chunk_count (size), 1,
+            {
+                size_t start = (size_t) c * _KERNEL_CHUNK;
+                if (left_is_par)
+                    wave_kernels_int_broadcast_right (op, tab + start, atom._content._int, tab_result + start, _chunk_size (c, size));
+                else
+                    wave_kernels_int_broadcast_left (op, atom._content._int, tab + start, tab_result + start, _chunk_size (c, size));
+            })
+    }
+    else if (element_type == WAVE_DATA_FLOAT)
+    {
+        const wave_float * const tab = collection._content._packed._tab._floats;
+        wave_float value = wave_data_get_float (& atom);
+        wave_float * const tab_result = _alloc_par_float (result, size, & collection, NULL);
+        _parallel_for (c, _chunk_count (size), 1,
+            {
+                size_t start = (size_t) c * _KERNEL_CHUNK;
+                if (left_is_par)
+                    wave_kernels_float_broadcast_right (op, tab + start, value, tab_result + start, _chunk_size (c, size));
+                else
+                    wave_kernels_float_broadcast_left (op, value, tab + start, tab_result + start, _chunk_size (c, size));
+            })
+    }
+    else
+    {
+        /* Integer elements and a floating point atom. */
+        wave_float value = atom._content._float;
+        wave_float * const tab_result = _alloc_par_float (result, size, & collection, NULL);
+        _parallel_for (i, size, _KERNEL_CHUNK,
+            {
+                wave_float element = _packed_float_at (& collection, (size_t) i);
+                tab_result[i] = left_is_par ? _binary_float[op] (element, value) : _binary_float[op] (value, element);
+            })
+    }
 }
 
+/** \cond Doxygen ignore. */
+#undef _parallel_for
+/** \endcond Doxygen ignore. */
+
 /**
  * \brief Compute a binary operation on parallel collections.
- * \param left_type Type of the left operand.
- * \param right_type Type of the right operand.
  * \param left Left operand.
  * \param right Right operand.
  * \param result Storage for the result.
  * \param op Operator.
  */
-static inline void _binary_operation_parallels (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+static void _binary_operation_parallels (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
-    size_t left_size = left->_content._collection._size;
-    size_t right_size = right->_content._collection._size;
+    size_t left_size = wave_data_get_par_size (left);
+    size_t right_size = wave_data_get_par_size (right);
 
-    if (left_size == right_size)
+    if (left_size == right_size && _is_packed (left->_type) && _is_packed (right->_type))
+        _map_binary_packed (left, right, result, op);
+    else if (left_size == right_size)
         _map_binary (left, right, result, op);
     else
         _operator_type_error (left, right, op);
         /* Reminder: _operator_type_error() exits the program. */
 }
 
+/**
+ * \brief Compute a binary operation on an atom and a parallel collection.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param result Storage for the result.
+ * \param op Operator.
+ */
+static void _binary_operation_broadcast (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+{
+    if (_is_packed (left->_type) || _is_packed (right->_type))
+        _map_broadcast_packed (left, right, result, op);
+    else
+        _map_broadcast (left, right, result, op);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-// Static utilities for printing.
+// Static utilities for operations checking on values.
 ////////////////////////////////////////////////////////////////////////////////
-/** \cond Doxygen ignore. */
 
 /**
- * \brief Macro to save the hassle to write the simple printers.
- * \param data_type Data type.
+ * \brief Determine whether an integer division is defined.
+ * \param a Dividend.
+ * \param b Divisor.
  */
-#define _def_data_printer_simple(data_type) \
-    static void _data_ ## data_type ## _fprint (FILE * const stream, const wave_data * const data) \
-    { \
-        wave_ ## data_type ## _fprint (stream, data->_content._ ## data_type); \
-    }
+static inline bool _is_int_division_defined (wave_int a, wave_int b)
+{
+    return b != 0 && ! (a == WAVE_INT_MIN && b == -1);
+}
 
-/* Create:
- * - _data_int_fprint
- * - _data_float_fprint
- * - _data_bool_fprint
+/**
+ * \brief Determine whether a floating point value converts to a wave_int.
+ * \param f Value.
  */
-_def_data_printer_simple (int)
-_def_data_printer_simple (float)
-_def_data_printer_simple (bool)
+static inline bool _is_int_convertible (wave_float f)
+{
+    return f > (wave_float) WAVE_INT_MIN - 1 && f < (wave_float) WAVE_INT_MAX + 1;
+}
 
-#undef _def_data_printer_simple
+/**
+ * \brief Get a number as a floating point value.
+ * \param data Integer or floating point value.
+ */
+static inline wave_float _number_as_float (const wave_data * const data)
+{
+    return data->_type == WAVE_DATA_INT ? wave_float_from_wave_int (data->_content._int) : data->_content._float;
+}
 
 /**
- * \brief Macro to save the hassle to write the char / string printers.
- * \param data_type Data type.
- * \param delimiter Delimiter (most likely single or double quotes).
+ * \brief Determine whether a defined operation on two constants divides by zero.
+ * \param left Left operand.
+ * \param right Right operand.
+ * \param op Operation.
+ * \retval true if the operation is an integer division by zero or overflows.
+ * \retval false otherwise.
+ *
+ * wave_float_mod() computes on the values converted to wave_int.
  */
-#define _def_data_printer_char_string(data_type, delimiter) \
-    static void _data_ ## data_type ## _fprint (FILE * const stream, const wave_data * const data) \
-    { \
-        fprintf (stream, "%c", delimiter); \
-        wave_ ## data_type ## _fprint (stream, data->_content._ ## data_type); \
-        fprintf (stream, "%c", delimiter); \
+static bool _is_division_error (const wave_data * const left, const wave_data * const right, wave_operator op)
+{
+    bool is_int = left->_type == WAVE_DATA_INT && right->_type == WAVE_DATA_INT;
+    bool is_number = (left->_type == WAVE_DATA_INT || left->_type == WAVE_DATA_FLOAT)
+        && (right->_type == WAVE_DATA_INT || right->_type == WAVE_DATA_FLOAT);
+    bool is_error = false;
+
+    if (is_int && (op == WAVE_OP_BINARY_DIVIDE || op == WAVE_OP_BINARY_MOD))
+        is_error = ! _is_int_division_defined (left->_content._int, right->_content._int);
+    else if (is_number && op == WAVE_OP_BINARY_MOD)
+    {
+        wave_float a = _number_as_float (left);
+        wave_float b = _number_as_float (right);
+        is_error = ! _is_int_convertible (a) || ! _is_int_convertible (b)
+            || ! _is_int_division_defined (wave_int_from_wave_float (a), wave_int_from_wave_float (b));
     }
-/*
- * The function will print the data's content while surrounding it with
- * the `delimiter` string.
- */
 
-/* Create:
- * - _data_char_fprint
- * - _data_string_fprint
- */
-_def_data_printer_char_string (char, '\'')
-_def_data_printer_char_string (string, '\"')
+    return is_error;
+}
 
-#undef _def_data_printer_char_string
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for memory.
+////////////////////////////////////////////////////////////////////////////////
 
-/** \endcond Doxygen ignore. */
+/**
+ * \brief Predicate telling whether a memory block must be copied.
+ */
+typedef bool (* _moved_predicate) (const void * pointer, const void * context);
 
 /**
- * \brief Print a collection to a stream.
- * \param stream Stream.
- * \param data Data holding the collection of interest.
- * \param separator Delimiter.
- *
- * \c separator will be used to separate the elements of the collection.
+ * \brief Determine whether a block was allocated since a checkpoint.
+ * \param pointer Block.
+ * \param context Pointer to the checkpoint.
  */
-static void _data_collection_fprint (FILE * const stream, const wave_data * const data, const char * const separator)
+static bool _moved_since_mark (const void * const pointer, const void * const context)
 {
-    fprintf (stream, "(");
-    size_t size = data->_content._collection._size;
+    return wave_garbage_is_released (* (const wave_garbage_checkpoint *) context, pointer);
+}
 
-    /* Print all elements of the collection, except the last one.
-     * (In order to correctly print the separator: the last element does not
-     * need a trailing separator.)
-     */
-    for (size_t i = 0; i < size - 1; ++i)
+/**
+ * \brief Round a size up to 16 bytes.
+ * \param size Size.
+ */
+static inline size_t _carry_align (size_t size)
+{
+    return (size + 15) & ~ (size_t) 15;
+}
+
+/**
+ * \brief Get the size of the blocks reachable from a tab which must be copied.
+ * \param tab Tab.
+ * \param size Size of the tab.
+ * \param moved Predicate.
+ * \param context Context of the predicate.
+ * \return Size in bytes.
+ */
+static size_t _carry_size (const wave_data * const tab, size_t size, _moved_predicate moved, const void * const context)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < size; ++i)
     {
-        wave_data_fprint (stream, & data->_content._collection._tab[i]);
-        fprintf (stream, "%s", separator);
+        const wave_data * const data = & tab[i];
+        switch (data->_type)
+        {
+            case WAVE_DATA_STRING:
+                if (_is_buffered (data))
+                {
+                    if (moved (data->_content._buffered._buffer, context))
+                        total += _carry_align (_string_buffer_size (data->_content._buffered._length));
+                }
+                else if (! wave_data_is_small_string (data) && moved (data->_content._string, context))
+                    total += _carry_align ((wave_string_length (data->_content._string) + 1) * sizeof (wave_char));
+                break;
+            case WAVE_DATA_SEQ:
+            case WAVE_DATA_PAR:
+                if (moved (data->_content._collection._tab, context))
+                    total += _carry_align (data->_content._collection._size * sizeof (wave_data));
+                total += _carry_size (data->_content._collection._tab, data->_content._collection._size, moved, context);
+                break;
+            case WAVE_DATA_PAR_INT:
+                if (moved (data->_content._packed._tab._ints, context))
+                    total += _carry_align (data->_content._packed._size * sizeof (wave_int));
+                break;
+            case WAVE_DATA_PAR_FLOAT:
+                if (moved (data->_content._packed._tab._floats, context))
+                    total += _carry_align (data->_content._packed._size * sizeof (wave_float));
+                break;
+            case WAVE_DATA_PAR_BOOL:
+                if (moved (data->_content._packed._tab._bits, context))
+                    total += _carry_align (WAVE_KERNELS_WORDS (data->_content._packed._size) * sizeof (uint64_t));
+                break;
+            default:
+                break;
+        }
     }
-    /* Print the last element. */
-    wave_data_fprint (stream, & data->_content._collection._tab[size - 1]);
-
-    fprintf (stream, ")");
+    return total;
 }
 
 /**
- * \brief Print a sequential collection to a stream.
- * \param stream Stream.
- * \param data Data holding the collection of interest.
+ * \brief Copy a block to a storage.
+ * \param storage Storage, updated to its next free byte.
+ * \param block Block.
+ * \param size Size of the block.
+ * \return The copy.
  */
-static void _data_seq_fprint (FILE * const stream, const wave_data * const data)
+static inline void * _carry_block (unsigned char ** const storage, const void * const block, size_t size)
 {
-    _data_collection_fprint (stream, data, ";");
+    void * copy = * storage;
+    memcpy (copy, block, size);
+    * storage += _carry_align (size);
+    return copy;
 }
 
 /**
- * \brief Print a parallel collection to a stream.
- * \param stream Stream.
- * \param data Data holding the collection of interest.
+ * \brief String buffers to keep once the temporaries are released.
  */
-static void _data_par_fprint (FILE * const stream, const wave_data * const data)
+typedef struct _carry_retained
 {
-    _data_collection_fprint (stream, data, "||");
+    void ** _buffers;   /**< The buffers, allocated with malloc(). */
+    size_t _count;      /**< Number of buffers. */
+    size_t _size;       /**< Size of the list. */
+} _carry_retained;
+
+/**
+ * \brief Copy the string buffer of a data.
+ * \param data Data, updated to point to the copy.
+ * \param storage Storage, updated to its next free byte.
+ * \param retained Buffers to keep, or \c NULL.
+ *
+ * A long string is likely to be extended by the next iteration of the loop:
+ * instead of being copied at each iteration, it is given a buffer of its own
+ * with twice the room it needs, which is kept by the garbage collector when the
+ * temporaries are released. Other strings are copied to the storage.
+ */
+static void _carry_string_buffer (wave_data * const data, unsigned char ** const storage, _carry_retained * const retained)
+{
+    size_t length = data->_content._buffered._length;
+    const wave_char * chars = data->_content._buffered._buffer->_chars;
+    wave_string_buffer * copy = NULL;
+
+    if (retained != NULL && length >= _STRING_RETAIN_MIN)
+    {
+        if (retained->_count >= retained->_size)
+        {
+            size_t new_size = retained->_size == 0 ? 8 : 2 * retained->_size;
+            void ** new_buffers = realloc (retained->_buffers, new_size * sizeof * new_buffers);
+            if (new_buffers != NULL)
+            {
+                retained->_buffers = new_buffers;
+                retained->_size = new_size;
+            }
+        }
+        if (retained->_count < retained->_size && (copy = malloc (_string_buffer_size (2 * length))) != NULL)
+        {
+            retained->_buffers[retained->_count++] = copy;
+            _string_buffer_init (copy, 2 * length, chars, length, "", 0);
+        }
+    }
+
+    if (copy == NULL)
+    {
+        copy = _string_buffer_init (* storage, length, chars, length, "", 0);
+        * storage += _carry_align (_string_buffer_size (length));
+    }
+
+    data->_content._buffered._buffer = copy;
 }
 
-/* Tab of functions used to print a data depending on its type. */
-static void (* const _data_print_functions []) (FILE *, const wave_data *) =
+/**
+ * \brief Copy the blocks reachable from a tab which must be copied.
+ * \param tab Tab, updated to point to the copies.
+ * \param size Size of the tab.
+ * \param moved Predicate.
+ * \param context Context of the predicate.
+ * \param storage Storage, updated to its next free byte.
+ * \param retained String buffers to keep, or \c NULL to copy all of them to the storage.
+ */
+static void _carry_copy (wave_data * const tab, size_t size, _moved_predicate moved, const void * const context, unsigned char ** const storage, _carry_retained * const retained)
 {
-    [WAVE_DATA_INT] = _data_int_fprint,
-    [WAVE_DATA_FLOAT] = _data_float_fprint,
-    [WAVE_DATA_CHAR] = _data_char_fprint,
-    [WAVE_DATA_STRING] = _data_string_fprint,
-    [WAVE_DATA_BOOL] = _data_bool_fprint,
-    [WAVE_DATA_SEQ] = _data_seq_fprint,
-    [WAVE_DATA_PAR] = _data_par_fprint,
-    [WAVE_DATA_OPERATOR] = NULL,
-    [WAVE_DATA_UNKNOWN] = NULL,
-};
+    for (size_t i = 0; i < size; ++i)
+    {
+        wave_data * const data = & tab[i];
+        switch (data->_type)
+        {
+            case WAVE_DATA_STRING:
+                if (_is_buffered (data))
+                {
+                    if (moved (data->_content._buffered._buffer, context))
+                        _carry_string_buffer (data, storage, retained);
+                }
+                else if (! wave_data_is_small_string (data) && moved (data->_content._string, context))
+                    data->_content._string = _carry_block (storage, data->_content._string, (wave_string_length (data->_content._string) + 1) * sizeof (wave_char));
+                break;
+            case WAVE_DATA_SEQ:
+            case WAVE_DATA_PAR:
+                if (moved (data->_content._collection._tab, context))
+                    data->_content._collection._tab = _carry_block (storage, data->_content._collection._tab, data->_content._collection._size * sizeof (wave_data));
+                _carry_copy (data->_content._collection._tab, data->_content._collection._size, moved, context, storage, retained);
+                break;
+            case WAVE_DATA_PAR_INT:
+                if (moved (data->_content._packed._tab._ints, context))
+                    data->_content._packed._tab._ints = _carry_block (storage, data->_content._packed._tab._ints, data->_content._packed._size * sizeof (wave_int));
+                break;
+            case WAVE_DATA_PAR_FLOAT:
+                if (moved (data->_content._packed._tab._floats, context))
+                    data->_content._packed._tab._floats = _carry_block (storage, data->_content._packed._tab._floats, data->_content._packed._size * sizeof (wave_float));
+                break;
+            case WAVE_DATA_PAR_BOOL:
+                if (moved (data->_content._packed._tab._bits, context))
+                    data->_content._packed._tab._bits = _carry_block (storage, data->_content._packed._tab._bits, WAVE_KERNELS_WORDS (data->_content._packed._size) * sizeof (uint64_t));
+                break;
+            default:
+                break;
+        }
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // Getters.
@@ -792,12 +1810,56 @@ wave_string wave_data_get_string (const wave_data * const data)
     wave_string s;
     if (wave_data_get_type (data) == WAVE_DATA_CHAR)
         s = _char_data_to_string (data);
+    else if (wave_data_is_small_string (data))
+        s = (wave_string) data->_content._small_string;
+    else if (_is_buffered (data))
+    {
+        wave_string_buffer * const buffer = data->_content._buffered._buffer;
+        size_t length = data->_content._buffered._length;
+        if (length == buffer->_used)
+            s = buffer->_chars;
+        else
+        {
+            /* The string is not null terminated. */
+            s = wave_garbage_alloc ((length + 1) * sizeof (wave_char));
+            memcpy (s, buffer->_chars, length * sizeof (wave_char));
+            s[length] = '\0';
+        }
+    }
     else
         s = data->_content._string;
 
     return s;
 }
 
+const wave_char * wave_data_get_characters (const wave_data * const data, size_t * const length)
+{
+    const wave_char * s;
+    if (_is_buffered (data))
+    {
+        s = data->_content._buffered._buffer->_chars;
+        * length = data->_content._buffered._length;
+    }
+    else
+    {
+        s = wave_data_get_string (data);
+        * length = wave_string_length (s);
+    }
+
+    return s;
+}
+
+size_t wave_data_get_par_size (const wave_data * const data)
+{
+    size_t size;
+    if (_is_packed (wave_data_get_type (data)))
+        size = data->_content._packed._size;
+    else
+        size = data->_content._collection._size;
+
+    return size;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Properties.
 ////////////////////////////////////////////////////////////////////////////////
@@ -807,6 +1869,16 @@ wave_bool wave_data_is_atom (const wave_data * data)
     return data->_type <= WAVE_DATA_BOOL;
 }
 
+wave_bool wave_data_is_par (const wave_data * data)
+{
+    return _is_par (data->_type);
+}
+
+wave_bool wave_data_is_small_string (const wave_data * const data)
+{
+    return data->_type == WAVE_DATA_STRING && (data->_flags & WAVE_DATA_FLAG_SMALL_STRING) != 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Setters.
 ////////////////////////////////////////////////////////////////////////////////
@@ -814,33 +1886,80 @@ wave_bool wave_data_is_atom (const wave_data * data)
 void wave_data_set_int (wave_data * const data, wave_int i)
 {
     data->_type = WAVE_DATA_INT;
+    data->_flags = WAVE_DATA_FLAG_NONE;
     data->_content._int = i;
 }
 
 void wave_data_set_float (wave_data * const data, wave_float f)
 {
     data->_type = WAVE_DATA_FLOAT;
+    data->_flags = WAVE_DATA_FLAG_NONE;
     data->_content._float = f;
 }
 
 void wave_data_set_char (wave_data * const data, wave_char c)
 {
     data->_type = WAVE_DATA_CHAR;
+    data->_flags = WAVE_DATA_FLAG_NONE;
     data->_content._char = c;
 }
 
 void wave_data_set_bool (wave_data * const data, wave_bool b)
 {
     data->_type = WAVE_DATA_BOOL;
+    data->_flags = WAVE_DATA_FLAG_NONE;
     data->_content._bool = b;
 }
 
 void wave_data_set_string (wave_data * const data, wave_string s)
 {
     data->_type = WAVE_DATA_STRING;
+    data->_flags = WAVE_DATA_FLAG_NONE;
     data->_content._string = s;
 }
 
+void wave_data_set_string_copy (wave_data * const data, const_wave_string s, size_t length)
+{
+    if (length <= WAVE_DATA_SMALL_STRING_MAX)
+    {
+        data->_type = WAVE_DATA_STRING;
+        data->_flags = WAVE_DATA_FLAG_SMALL_STRING;
+        memmove (data->_content._small_string, s, length * sizeof (wave_char));
+        data->_content._small_string[length] = '\0';
+    }
+    else
+    {
+        wave_string copy = wave_garbage_alloc ((length + 1) * sizeof (wave_char));
+        memcpy (copy, s, length * sizeof (wave_char));
+        copy[length] = '\0';
+        wave_data_set_string (data, copy);
+    }
+}
+
+void wave_data_set_par_int (wave_data * const data, wave_int * const tab, size_t size)
+{
+    data->_type = WAVE_DATA_PAR_INT;
+    data->_flags = WAVE_DATA_FLAG_NONE;
+    data->_content._packed._tab._ints = tab;
+    data->_content._packed._size = (uint32_t) size;
+}
+
+void wave_data_set_par_float (wave_data * const data, wave_float * const tab, size_t size)
+{
+    data->_type = WAVE_DATA_PAR_FLOAT;
+    data->_flags = WAVE_DATA_FLAG_NONE;
+    data->_content._packed._tab._floats = tab;
+    data->_content._packed._size = (uint32_t) size;
+}
+
+void wave_data_set_par_bool (wave_data * const data, uint64_t * const bits, size_t size)
+{
+    data->_type = WAVE_DATA_PAR_BOOL;
+    data->_flags = WAVE_DATA_FLAG_NONE;
+    data->_content._packed._tab._bits = bits;
+    data->_content._packed._size = (uint32_t) size;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Operations.
 ////////////////////////////////////////////////////////////////////////////////
@@ -854,6 +1973,8 @@ void wave_data_unary (const wave_data * const operand, wave_data * const result,
             _unary_constant (t, operand, result, op);
         else if (t == WAVE_DATA_PAR)
             _map_unary (operand, result, op);
+        else if (_is_packed (t))
+            _map_unary_packed (operand, result, op);
         else
             _operator_type_error (operand, NULL, op);
             /* Reminder: _operator_type_error() exits the program. */
@@ -864,24 +1985,160 @@ void wave_data_unary (const wave_data * const operand, wave_data * const result,
 
 void wave_data_binary (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
 {
-    wave_data_type left_type = wave_data_get_type (left);
-    wave_data_type right_type = wave_data_get_type (right);
-    if (_is_constant (left_type) && _is_constant (right_type))
-        _binary_operation_constants (left_type, right_type, left, right, result, op);
-    else if (left_type == WAVE_DATA_PAR && right_type == WAVE_DATA_PAR)
-        _binary_operation_parallels (left, right, result, op);
+    _binary_handler handler = _binary_handlers[wave_data_get_type (left)][wave_data_get_type (right)][op];
+    if (handler != NULL)
+        handler (left, right, result, op);
     else
         _operator_type_error (left, right, op);
         /* Reminder: _operator_type_error() exits the program. */
 }
 
+void wave_data_broadcast (const wave_data * const left, const wave_data * const right, wave_data * const result, wave_operator op)
+{
+    wave_data_type left_type = wave_data_get_type (left);
+    wave_data_type right_type = wave_data_get_type (right);
+    bool is_broadcast = (_is_constant (left_type) && _is_par (right_type)) || (_is_par (left_type) && _is_constant (right_type));
+    if (is_broadcast && _is_binary_defined (left_type, right_type, op))
+        _binary_operation_broadcast (left, right, result, op);
+    else
+        wave_data_binary (left, right, result, op);
+}
+
+bool wave_data_unary_is_defined (const wave_data * const operand, wave_operator op)
+{
+    wave_data_type t = wave_data_get_type (operand);
+    bool defined = op == WAVE_OP_SPECIFIC_ATOM;
+
+    if (! defined && _is_constant (t))
+        defined = _is_unary_defined (t, op);
+    else if (! defined && _is_packed (t))
+        defined = _is_unary_defined (_packed_element_type (t), op);
+    else if (! defined && t == WAVE_DATA_PAR)
+    {
+        defined = true;
+        for (size_t i = 0; defined && i < operand->_content._collection._size; ++i)
+            defined = wave_data_unary_is_defined (& operand->_content._collection._tab[i], op);
+    }
+
+    return defined;
+}
+
+bool wave_data_binary_is_defined (const wave_data * const left, const wave_data * const right, wave_operator op)
+{
+    wave_data_type left_type = wave_data_get_type (left);
+    wave_data_type right_type = wave_data_get_type (right);
+    bool defined = _is_binary_defined (left_type, right_type, op);
+
+    if (defined && _is_constant (left_type) && _is_constant (right_type))
+        defined = ! _is_division_error (left, right, op);
+    else if (defined && _is_par (left_type) && _is_par (right_type))
+    {
+        size_t size = wave_data_get_par_size (left);
+        defined = size == wave_data_get_par_size (right);
+        for (size_t i = 0; defined && i < size; ++i)
+        {
+            wave_data left_element, right_element;
+            defined = wave_data_binary_is_defined (_par_element (left, i, & left_element), _par_element (right, i, & right_element), op);
+        }
+    }
+    else if (defined)
+    {
+        /* The atom is combined with each element of the collection. */
+        const wave_data * const collection = _is_par (left_type) ? left : right;
+        size_t size = wave_data_get_par_size (collection);
+        for (size_t i = 0; defined && i < size; ++i)
+        {
+            wave_data storage;
+            const wave_data * const element = _par_element (collection, i, & storage);
+            defined = collection == left
+                ? wave_data_binary_is_defined (element, right, op)
+                : wave_data_binary_is_defined (left, element, op);
+        }
+    }
+
+    return defined;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Memory.
+////////////////////////////////////////////////////////////////////////////////
+
+void wave_data_share (wave_data * const destination, wave_data * const source)
+{
+    source->_flags &= (uint8_t) ~ WAVE_DATA_FLAG_OWNED;
+    * destination = * source;
+}
+
+void wave_data_release_to (wave_garbage_checkpoint mark, wave_data * const roots[], const size_t sizes[], size_t count)
+{
+    /* The carried blocks are moved out of the garbage collector, to a buffer
+     * given back to it once the temporaries are released: the next release
+     * frees the buffer, after having moved the blocks still carried.
+     */
+    size_t size = 0;
+    for (size_t i = 0; i < count; ++i)
+        size += _carry_size (roots[i], sizes[i], _moved_since_mark, & mark);
+
+    if (size == 0)
+        wave_garbage_release_to (mark);
+    else
+    {
+        unsigned char * buffer = wave_garbage_alloc_detached (size);
+        if (buffer != NULL)
+        {
+            _carry_retained retained = { ._buffers = NULL, ._count = 0, ._size = 0 };
+            unsigned char * storage = buffer;
+            for (size_t i = 0; i < count; ++i)
+                _carry_copy (roots[i], sizes[i], _moved_since_mark, & mark, & storage, & retained);
+
+            wave_garbage_release_to (mark);
+
+            for (size_t i = 0; i < retained._count; ++i)
+                wave_garbage_retain (mark, retained._buffers[i]);
+            free (retained._buffers);
+
+            wave_garbage_attach (buffer);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Printing.
 ////////////////////////////////////////////////////////////////////////////////
 
 void wave_data_fprint (FILE * const stream, const wave_data * const data)
 {
-    wave_data_type t = wave_data_get_type (data);
-    if (t < WAVE_DATA_UNKNOWN && _data_print_functions[t] != NULL)
-        _data_print_functions[t] (stream, data);
+    wave_output_buffer buffer;
+    wave_output_buffer_init (& buffer, -1);
+    wave_output_buffer_append_data (& buffer, data);
+    fwrite (buffer._data, 1, buffer._used, stream);
+    wave_output_buffer_free (& buffer);
+}
+
+/**
+ * \brief Whether the data is printed in the binary format.
+ *
+ * Negative until \c WAVE_IO_FORMAT is read.
+ */
+static int _WAVE_IO_BINARY = -1;
+
+void wave_data_print (const wave_data * const data)
+{
+    if (_WAVE_IO_BINARY < 0)
+    {
+        const char * value = getenv ("WAVE_IO_FORMAT");
+        _WAVE_IO_BINARY = value != NULL && strcmp (value, "binary") == 0;
+    }
+
+    if (_WAVE_IO_BINARY)
+    {
+        wave_output_flush ();
+        if (! wave_data_write_binary (stdout, data) || fflush (stdout) != 0)
+        {
+            fprintf (stderr, "Error: could not write binary data.\n");
+            exit (EX_IOERR);
+        }
+    }
+    else
+        wave_output_print (data);
 }
@@ -30,44 +30,396 @@
  */
 #include "wave/common/wave_garbage.h"
 
+#include <stddef.h>
+#include <stdint.h>
+#include <omp.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 // Static utilities.
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
- * \brief Arbitrary step.
+ * \brief Initial size of the pointers list, in pointers.
+ */
+static const size_t _WAVE_GC_SIZE_STEP = 64;
+
+/**
+ * \brief Size of the first chunk, in bytes.
+ */
+static const size_t _WAVE_GC_CHUNK_MIN = 64 * 1024;
+
+/**
+ * \brief Maximal size of a regular chunk, in bytes.
+ */
+static const size_t _WAVE_GC_CHUNK_MAX = 16 * 1024 * 1024;
+
+/**
+ * \brief Alignment of the allocated memory, in bytes.
+ */
+static const size_t _WAVE_GC_ALIGN = 16;
+
+/**
+ * \brief List of the garbage collectors of all the threads.
+ */
+static wave_garbage_collector * _WAVE_GC_LIST = NULL;
+
+/**
+ * \brief Garbage collector of the current thread.
+ */
+static __thread wave_garbage_collector * _WAVE_GC = NULL;
+
+/**
+ * \brief Number of checkpoints currently taken.
+ */
+static size_t _WAVE_GC_DEPTH = 0;
+
+/**
+ * \brief Number of garbage collectors created.
+ */
+static size_t _WAVE_GC_COUNT = 0;
+
+/**
+ * \brief Number of calls to wave_garbage_clean() since the statistics were reset.
  */
-static const size_t _WAVE_GC_SIZE_STEP = 128;
+static size_t _WAVE_GC_CLEANS = 0;
 
 /**
- * \brief The garbage collector.
+ * \brief Time spent in wave_garbage_clean() since the statistics were reset.
  */
-static struct wave_garbage_collector _WAVE_GC =
+static double _WAVE_GC_CLEAN_TIME = 0.0;
+
+/**
+ * \brief Whether the statistics are reported: 1 if so, 0 if not, -1 if unknown yet.
+ */
+static int _WAVE_GC_REPORT = -1;
+
+/**
+ * \brief Get the garbage collector of the current thread.
+ * \return The garbage collector, or \c NULL in case of failure.
+ *
+ * The collector is created and linked to the list on the first call of each
+ * thread: this is the only time a lock is taken. All the states of a new
+ * collector are empty, since it allocated nothing before the checkpoints.
+ */
+static inline wave_garbage_collector * _local_gc (void)
 {
-    ._size = 0, ._count = 0, ._pointers = NULL,
-};
+    if (_WAVE_GC == NULL)
+    {
+        wave_garbage_collector * gc = malloc (sizeof * gc);
+        if (gc != NULL)
+        {
+            * gc = (wave_garbage_collector)
+            {
+                ._size = 0,
+                ._count = 0,
+                ._pointers = NULL,
+                ._chunks = NULL,
+                ._large = NULL,
+                ._spare = NULL,
+                ._sorted_from = 0,
+                ._sorted_to = 0,
+                ._bytes = 0,
+                ._objects = 0,
+                ._peak = 0,
+                ._next = NULL,
+            };
+            #pragma omp critical (wave_garbage)
+            {
+                gc->_id = _WAVE_GC_COUNT++;
+                gc->_next = _WAVE_GC_LIST;
+                _WAVE_GC_LIST = gc;
+            }
+            _WAVE_GC = gc;
+        }
+    }
+    return _WAVE_GC;
+}
 
 /**
- * \brief Reset the garbage collector.
+ * \brief Get the first garbage collector of the list.
  */
-static inline void _reset_gc (void)
+static inline wave_garbage_collector * _first_gc (void)
 {
-    _WAVE_GC._size = 0;
-    _WAVE_GC._count = 0;
-    _WAVE_GC._pointers = NULL;
+    wave_garbage_collector * gc;
+    #pragma omp critical (wave_garbage)
+        gc = _WAVE_GC_LIST;
+    return gc;
 }
 
 /**
- * \brief Grow the garbage collector.
+ * \brief Grow the pointers list of a garbage collector.
+ * \param gc Garbage collector.
+ *
+ * The list doubles its size, so that registering is amortized constant time.
  */
-static inline void _grow_gc (void)
+static inline void _grow_gc (wave_garbage_collector * const gc)
 {
-    size_t new_size = _WAVE_GC._size + _WAVE_GC_SIZE_STEP;
-    void * new_list = realloc (_WAVE_GC._pointers, new_size);
+    size_t new_size = gc->_size == 0 ? _WAVE_GC_SIZE_STEP : 2 * gc->_size;
+    void ** new_list = realloc (gc->_pointers, new_size * sizeof * new_list);
     if (new_list != NULL)
     {
-        _WAVE_GC._pointers = new_list;
-        _WAVE_GC._size = new_size;
+        gc->_pointers = new_list;
+        gc->_size = new_size;
+    }
+}
+
+/**
+ * \brief Round a size up to the alignment.
+ * \param size Size.
+ */
+static inline size_t _align (size_t size)
+{
+    return (size + _WAVE_GC_ALIGN - 1) & ~ (_WAVE_GC_ALIGN - 1);
+}
+
+/**
+ * \brief Create a chunk.
+ * \param size Size of the data, in bytes.
+ * \param next Next chunk.
+ * \return The chunk, or \c NULL in case of failure.
+ */
+static inline wave_garbage_chunk * _chunk_alloc (size_t size, wave_garbage_chunk * const next)
+{
+    wave_garbage_chunk * chunk = malloc (sizeof * chunk + size);
+    if (chunk != NULL)
+        * chunk = (wave_garbage_chunk) { ._next = next, ._size = size, ._used = 0 };
+    return chunk;
+}
+
+/**
+ * \brief Free a list of chunks.
+ * \param chunk First chunk.
+ */
+static inline void _chunk_free_list (wave_garbage_chunk * chunk)
+{
+    while (chunk != NULL)
+    {
+        wave_garbage_chunk * next = chunk->_next;
+        free (chunk);
+        chunk = next;
+    }
+}
+
+/**
+ * \brief Allocate memory in a chunk of a garbage collector.
+ * \param gc Garbage collector.
+ * \param size Size, already aligned.
+ * \return The memory, or \c NULL in case of failure.
+ *
+ * When the current chunk is full, the spare chunk or a new one twice as large
+ * is pushed in front of it. Requests larger than a quarter of the current chunk get their own
+ * chunk, so that they do not waste the end of the current one.
+ */
+static void * _chunk_take (wave_garbage_collector * const gc, size_t size)
+{
+    wave_garbage_chunk * chunk = gc->_chunks;
+
+    if (chunk == NULL || chunk->_size - chunk->_used < size)
+    {
+        if (size > (chunk == NULL ? _WAVE_GC_CHUNK_MIN : chunk->_size) / 4)
+        {
+            chunk = _chunk_alloc (size, gc->_large);
+            if (chunk == NULL)
+                return NULL;
+            gc->_large = chunk;
+            chunk->_used = size;
+            return chunk->_data;
+        }
+
+        if (gc->_spare != NULL && gc->_spare->_size >= size)
+        {
+            chunk = gc->_spare;
+            gc->_spare = NULL;
+            * chunk = (wave_garbage_chunk) { ._next = gc->_chunks, ._size = chunk->_size, ._used = 0 };
+        }
+        else
+        {
+            size_t new_size = chunk == NULL ? _WAVE_GC_CHUNK_MIN : 2 * chunk->_size;
+            if (new_size > _WAVE_GC_CHUNK_MAX)
+                new_size = _WAVE_GC_CHUNK_MAX;
+
+            chunk = _chunk_alloc (new_size, gc->_chunks);
+            if (chunk == NULL)
+                return NULL;
+        }
+        gc->_chunks = chunk;
+    }
+
+    void * memory = chunk->_data + chunk->_used;
+    chunk->_used += size;
+    return memory;
+}
+
+/**
+ * \brief Keep a chunk as the spare chunk of a garbage collector.
+ * \param gc Garbage collector.
+ * \param chunk Chunk.
+ *
+ * Only the largest chunk is kept, the other one is freed.
+ */
+static inline void _keep_spare (wave_garbage_collector * const gc, wave_garbage_chunk * const chunk)
+{
+    if (gc->_spare == NULL || gc->_spare->_size < chunk->_size)
+    {
+        free (gc->_spare);
+        gc->_spare = chunk;
+    }
+    else
+        free (chunk);
+}
+
+/**
+ * \brief Get the current state of a garbage collector.
+ * \param gc Garbage collector.
+ */
+static inline wave_garbage_state _state_gc (const wave_garbage_collector * const gc)
+{
+    return (wave_garbage_state)
+    {
+        ._chunk = gc->_chunks,
+        ._used = gc->_chunks != NULL ? gc->_chunks->_used : 0,
+        ._large = gc->_large,
+        ._count = gc->_count,
+    };
+}
+
+/**
+ * \brief Forget which registered pointers are sorted.
+ * \param gc Garbage collector.
+ *
+ * The pointers registered after a release replace the sorted ones, so the
+ * same bounds do not mean the same pointers anymore.
+ */
+static inline void _forget_sorted (wave_garbage_collector * const gc)
+{
+    gc->_sorted_from = 0;
+    gc->_sorted_to = 0;
+}
+
+/**
+ * \brief Bring a garbage collector back to a previous state.
+ * \param gc Garbage collector.
+ * \param state State.
+ *
+ * The chunks pushed since the state are freed, except the largest one which is
+ * kept as the spare chunk.
+ */
+static void _release_gc (wave_garbage_collector * const gc, const wave_garbage_state * const state)
+{
+    for (size_t i = state->_count; i < gc->_count; ++i)
+        free (gc->_pointers[i]);
+    gc->_count = state->_count;
+    _forget_sorted (gc);
+
+    while (gc->_large != state->_large)
+    {
+        wave_garbage_chunk * next = gc->_large->_next;
+        free (gc->_large);
+        gc->_large = next;
+    }
+
+    while (gc->_chunks != state->_chunk)
+    {
+        wave_garbage_chunk * next = gc->_chunks->_next;
+        _keep_spare (gc, gc->_chunks);
+        gc->_chunks = next;
+    }
+
+    if (gc->_chunks != NULL)
+        gc->_chunks->_used = state->_used;
+}
+
+/**
+ * \brief Determine whether a pointer lies inside the used part of a chunk.
+ * \param chunk Chunk.
+ * \param from First used byte of interest.
+ * \param pointer Pointer.
+ */
+static inline bool _chunk_contains (const wave_garbage_chunk * const chunk, size_t from, const void * const pointer)
+{
+    uintptr_t address = (uintptr_t) pointer;
+    uintptr_t data = (uintptr_t) chunk->_data;
+    return address >= data + from && address < data + chunk->_used;
+}
+
+/**
+ * \brief Compare two pointers for qsort() and bsearch().
+ * \param a Pointer to the first pointer.
+ * \param b Pointer to the second pointer.
+ */
+static int _pointer_compare (const void * a, const void * b)
+{
+    uintptr_t pa = (uintptr_t) * (void * const *) a;
+    uintptr_t pb = (uintptr_t) * (void * const *) b;
+    return (pa > pb) - (pa < pb);
+}
+
+/**
+ * \brief Determine whether a pointer was allocated by a garbage collector since a state.
+ * \param gc Garbage collector.
+ * \param state State.
+ * \param pointer Pointer.
+ *
+ * The pointers registered since the state are sorted on the first call, so
+ * that the following calls only need a binary search.
+ */
+static bool _is_released_gc (wave_garbage_collector * const gc, const wave_garbage_state * const state, const void * const pointer)
+{
+    for (const wave_garbage_chunk * c = gc->_chunks; c != NULL; c = c->_next)
+    {
+        if (c == state->_chunk)
+        {
+            if (_chunk_contains (c, state->_used, pointer))
+                return true;
+            break;
+        }
+        if (_chunk_contains (c, 0, pointer))
+            return true;
+    }
+
+    for (const wave_garbage_chunk * c = gc->_large; c != state->_large; c = c->_next)
+        if (_chunk_contains (c, 0, pointer))
+            return true;
+
+    if (state->_count < gc->_count)
+    {
+        if (gc->_sorted_from != state->_count || gc->_sorted_to != gc->_count)
+        {
+            qsort (gc->_pointers + state->_count, gc->_count - state->_count, sizeof * gc->_pointers, _pointer_compare);
+            gc->_sorted_from = state->_count;
+            gc->_sorted_to = gc->_count;
+        }
+        if (bsearch (& pointer, gc->_pointers + state->_count, gc->_count - state->_count, sizeof * gc->_pointers, _pointer_compare) != NULL)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * \brief Free the memory registered in a garbage collector.
+ * \param gc Garbage collector.
+ *
+ * Only the current chunk, which is the largest one, is kept and rewound.
+ */
+static inline void _clean_gc (wave_garbage_collector * const gc)
+{
+    for (size_t i = 0; i < gc->_count; ++i)
+        free (gc->_pointers[i]);
+    gc->_count = 0;
+    _forget_sorted (gc);
+
+    _chunk_free_list (gc->_large);
+    gc->_large = NULL;
+
+    free (gc->_spare);
+    gc->_spare = NULL;
+
+    if (gc->_chunks != NULL)
+    {
+        _chunk_free_list (gc->_chunks->_next);
+        gc->_chunks->_next = NULL;
+        gc->_chunks->_used = 0;
     }
 }
 
@@ -77,39 +429,194 @@ static inline void _grow_gc (void)
 
 void * wave_garbage_alloc (size_t size)
 {
-    void * new_memory = malloc (size);
-    wave_garbage_register (new_memory);
+    void * new_memory = NULL;
+    wave_garbage_collector * const gc = _local_gc ();
+    if (gc != NULL)
+    {
+        new_memory = _chunk_take (gc, _align (size == 0 ? 1 : size));
+        gc->_bytes += size;
+        gc->_objects++;
+    }
     return new_memory;
 }
 
 void wave_garbage_register (void * pointer)
 {
-    #pragma omp critical
+    wave_garbage_collector * const gc = _local_gc ();
+    if (gc != NULL)
+    {
+        if (gc->_count >= gc->_size)
+            _grow_gc (gc);
+        if (gc->_count < gc->_size)
+            gc->_pointers[gc->_count++] = pointer;
+        gc->_objects++;
+        if (gc->_count > gc->_peak)
+            gc->_peak = gc->_count;
+    }
+}
+
+void * wave_garbage_alloc_detached (size_t size)
+{
+    wave_garbage_chunk * chunk = _chunk_alloc (_align (size == 0 ? 1 : size), NULL);
+    if (chunk == NULL)
+        return NULL;
+
+    chunk->_used = chunk->_size;
+    return chunk->_data;
+}
+
+void wave_garbage_attach (void * pointer)
+{
+    wave_garbage_chunk * const chunk = (wave_garbage_chunk *) ((unsigned char *) pointer - offsetof (wave_garbage_chunk, _data));
+    wave_garbage_collector * const gc = _local_gc ();
+    if (gc != NULL)
     {
-        if (_WAVE_GC._count >= _WAVE_GC._size)
-            _grow_gc ();
-        _WAVE_GC._pointers[_WAVE_GC._count] = pointer;
-        _WAVE_GC._count++;
+        /* The chunk is a large one, pushed after every checkpoint. */
+        chunk->_next = gc->_large;
+        gc->_large = chunk;
+        gc->_bytes += chunk->_size;
+        gc->_objects++;
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Cleaning, destroying.
+// Checkpoints.
 ////////////////////////////////////////////////////////////////////////////////
 
-void wave_garbage_clean (void)
+wave_garbage_checkpoint wave_garbage_mark (void)
 {
-    #pragma omp critical
+    if (_WAVE_GC_DEPTH >= WAVE_GARBAGE_MARKS_MAX)
+        return WAVE_GARBAGE_MARKS_MAX;
+
+    for (wave_garbage_collector * gc = _first_gc (); gc != NULL; gc = gc->_next)
+        gc->_marks[_WAVE_GC_DEPTH] = _state_gc (gc);
+    return _WAVE_GC_DEPTH++;
+}
+
+void wave_garbage_release_to (wave_garbage_checkpoint mark)
+{
+    if (mark < _WAVE_GC_DEPTH)
+    {
+        for (wave_garbage_collector * gc = _first_gc (); gc != NULL; gc = gc->_next)
+            _release_gc (gc, & gc->_marks[mark]);
+        _WAVE_GC_DEPTH = mark + 1;
+    }
+}
+
+void wave_garbage_retain (wave_garbage_checkpoint mark, void * pointer)
+{
+    wave_garbage_collector * const gc = _local_gc ();
+    if (gc != NULL && mark < _WAVE_GC_DEPTH && gc->_marks[mark]._count == gc->_count)
+    {
+        size_t count = gc->_count;
+        wave_garbage_register (pointer);
+        if (gc->_count > count)
+            for (size_t m = mark; m < _WAVE_GC_DEPTH; ++m)
+                if (gc->_marks[m]._count == count)
+                    gc->_marks[m]._count = gc->_count;
+    }
+}
+
+bool wave_garbage_is_released (wave_garbage_checkpoint mark, const void * pointer)
+{
+    bool released = false;
+    if (mark < _WAVE_GC_DEPTH)
+        for (wave_garbage_collector * gc = _first_gc (); gc != NULL && ! released; gc = gc->_next)
+            released = _is_released_gc (gc, & gc->_marks[mark], pointer);
+    return released;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Statistics.
+////////////////////////////////////////////////////////////////////////////////
+
+void wave_garbage_get_stats (wave_garbage_stats * const stats)
+{
+    * stats = (wave_garbage_stats)
+    {
+        ._bytes = 0,
+        ._objects = 0,
+        ._peak = 0,
+        ._threads = 0,
+        ._cleans = _WAVE_GC_CLEANS,
+        ._clean_time = _WAVE_GC_CLEAN_TIME,
+    };
+
+    for (const wave_garbage_collector * gc = _first_gc (); gc != NULL; gc = gc->_next)
+    {
+        stats->_bytes += gc->_bytes;
+        stats->_objects += gc->_objects;
+        stats->_peak += gc->_peak;
+        if (gc->_objects > 0)
+            stats->_threads++;
+    }
+}
+
+void wave_garbage_reset_stats (void)
+{
+    for (wave_garbage_collector * gc = _first_gc (); gc != NULL; gc = gc->_next)
+    {
+        gc->_bytes = 0;
+        gc->_objects = 0;
+        gc->_peak = gc->_count;
+    }
+    _WAVE_GC_CLEANS = 0;
+    _WAVE_GC_CLEAN_TIME = 0.0;
+}
+
+void wave_garbage_fprint_stats (FILE * const stream, const char * const label)
+{
+    wave_garbage_stats stats;
+    wave_garbage_get_stats (& stats);
+
+    fprintf (stream, "%s: %zu bytes, %zu objects, peak %zu registered pointers, %zu cleans in %.6f s, %zu threads\n",
+        label, stats._bytes, stats._objects, stats._peak, stats._cleans, stats._clean_time, stats._threads);
+
+    for (const wave_garbage_collector * gc = _first_gc (); gc != NULL; gc = gc->_next)
+        if (gc->_objects > 0)
+            fprintf (stream, "%s: thread %zu: %zu bytes, %zu objects, peak %zu registered pointers\n",
+                label, gc->_id, gc->_bytes, gc->_objects, gc->_peak);
+}
+
+void wave_garbage_report_stats (const char * const label)
+{
+    if (_WAVE_GC_REPORT < 0)
+    {
+        const char * value = getenv ("WAVE_RUNTIME_STATS");
+        _WAVE_GC_REPORT = value != NULL && value[0] != '\0' && (value[0] != '0' || value[1] != '\0');
+    }
+
+    if (_WAVE_GC_REPORT)
     {
-        for (size_t i = 0; i < _WAVE_GC._count; ++i)
-            free (_WAVE_GC._pointers[i]);
-        _WAVE_GC._count = 0;
+        wave_garbage_fprint_stats (stderr, label);
+        wave_garbage_reset_stats ();
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Cleaning, destroying.
+////////////////////////////////////////////////////////////////////////////////
+
+void wave_garbage_clean (void)
+{
+    double start = omp_get_wtime ();
+    for (wave_garbage_collector * gc = _first_gc (); gc != NULL; gc = gc->_next)
+        _clean_gc (gc);
+    _WAVE_GC_DEPTH = 0;
+    _WAVE_GC_CLEANS++;
+    _WAVE_GC_CLEAN_TIME += omp_get_wtime () - start;
+}
+
 void wave_garbage_destroy (void)
 {
-    wave_garbage_clean ();
-    free (_WAVE_GC._pointers);
-    _reset_gc ();
+    for (wave_garbage_collector * gc = _first_gc (); gc != NULL; gc = gc->_next)
+    {
+        _clean_gc (gc);
+        _chunk_free_list (gc->_chunks);
+        gc->_chunks = NULL;
+        free (gc->_pointers);
+        gc->_pointers = NULL;
+        gc->_size = 0;
+    }
+    _WAVE_GC_DEPTH = 0;
 }
@@ -0,0 +1,740 @@
+/**
+ * \file wave_input.c
+ * \brief Wave input reader.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "wave/common/wave_input.h"
+#include "wave/common/wave_binary.h"
+
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sysexits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Enums, Structs, Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Storage of the elements of a collection being read.
+ */
+typedef enum _input_mode
+{
+    _INPUT_INTS,                    /**< The elements are all wave_int values. */
+    _INPUT_FLOATS,                  /**< The elements are all wave_float values. */
+    _INPUT_BOXED,                   /**< The elements are wave_data values. */
+} _input_mode;
+
+/**
+ * \brief Unboxed number.
+ */
+typedef union _input_number
+{
+    wave_int _int;                  /**< Integer value. */
+    wave_float _float;              /**< Floating point value. */
+} _input_number;
+
+/**
+ * \brief Input reader.
+ */
+typedef struct _wave_input
+{
+    bool _open;                     /**< Whether the input is open. */
+    bool _mapped;                   /**< Whether the input is mapped in memory. */
+    bool _eof;                      /**< Whether the end of the file was reached. */
+    int _fd;                        /**< File descriptor. */
+    const unsigned char * _base;    /**< Beginning of the current block. */
+    const unsigned char * _position;/**< Current position. */
+    const unsigned char * _end;     /**< End of the current block. */
+    size_t _offset;                 /**< Offset of the current block in the input. */
+    size_t _mapped_size;            /**< Size of the mapping. */
+    unsigned char * _buffer;        /**< Buffer for the blocks. */
+    wave_data * _elements;          /**< Boxed elements of the collections being read. */
+    size_t _elements_size;          /**< Size of the boxed elements stack. */
+    size_t _elements_count;         /**< Count of boxed elements. */
+    _input_number * _numbers;       /**< Unboxed elements of the collection being read. */
+    size_t _numbers_size;           /**< Size of the unboxed elements stack. */
+    size_t _numbers_count;          /**< Count of unboxed elements. */
+    char * _scratch;                /**< Storage for the strings being read. */
+    size_t _scratch_size;           /**< Size of the string storage. */
+} _wave_input;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Size of the blocks read from files which can not be mapped.
+ */
+static const size_t _WAVE_INPUT_BLOCK = 1 << 20;
+
+/**
+ * \brief Maximal length of a number.
+ */
+#define _WAVE_INPUT_NUMBER_MAX 512
+
+/**
+ * \brief Input of the program.
+ */
+static _wave_input _WAVE_INPUT = { ._open = false, ._fd = -1 };
+
+/**
+ * \brief Maximal number of elements of a collection.
+ */
+static size_t _WAVE_INPUT_COLLECTION_MAX = WAVE_DATA_SIZE_MAX;
+
+/**
+ * \brief Print an error about the input and exit.
+ * \param in Input.
+ * \param message Message.
+ */
+static void _input_error (const _wave_input * const in, const char * const message)
+{
+    size_t offset = in->_offset + (size_t) (in->_position - in->_base);
+    fprintf (stderr, "Error: bad input at byte %zu: %s.\n", offset, message);
+    exit (EX_DATAERR);
+}
+
+/**
+ * \brief Print an error about the memory and exit.
+ */
+static void _memory_error (void)
+{
+    fprintf (stderr, "Error: not enough memory to read the input.\n");
+    exit (EX_OSERR);
+}
+
+/**
+ * \brief Grow a stack.
+ * \param stack Stack.
+ * \param size Size of the stack, in elements.
+ * \param element_size Size of an element.
+ */
+static void _grow (void ** const stack, size_t * const size, size_t element_size)
+{
+    size_t new_size = * size == 0 ? 1024 : 2 * * size;
+    void * new_stack = realloc (* stack, new_size * element_size);
+    if (new_stack == NULL)
+        _memory_error ();
+    * stack = new_stack;
+    * size = new_size;
+}
+
+/**
+ * \brief Read the next block of a file which is not mapped.
+ * \param in Input.
+ * \retval true if new data is available.
+ * \retval false at the end of the input.
+ */
+static bool _refill (_wave_input * const in)
+{
+    if (in->_mapped || in->_eof)
+        return false;
+
+    ssize_t count;
+    do
+        count = read (in->_fd, in->_buffer, _WAVE_INPUT_BLOCK);
+    while (count < 0 && errno == EINTR);
+
+    if (count < 0)
+    {
+        fprintf (stderr, "Error: cannot read the input: %s.\n", strerror (errno));
+        exit (EX_IOERR);
+    }
+
+    in->_offset += (size_t) (in->_end - in->_base);
+    in->_base = in->_buffer;
+    in->_position = in->_buffer;
+    in->_end = in->_buffer + count;
+    in->_eof = count == 0;
+    return count > 0;
+}
+
+/**
+ * \brief Get the current character.
+ * \param in Input.
+ * \return The character, or \c EOF at the end of the input.
+ */
+static inline int _peek (_wave_input * const in)
+{
+    if (in->_position == in->_end && ! _refill (in))
+        return EOF;
+    return * in->_position;
+}
+
+/**
+ * \brief Go to the next character.
+ * \param in Input.
+ * \pre _peek() did not return \c EOF.
+ */
+static inline void _advance (_wave_input * const in)
+{
+    in->_position++;
+}
+
+/**
+ * \brief Skip a character which must be present.
+ * \param in Input.
+ * \param c Character.
+ * \param message Error message.
+ */
+static inline void _expect (_wave_input * const in, int c, const char * const message)
+{
+    if (_peek (in) != c)
+        _input_error (in, message);
+    _advance (in);
+}
+
+/**
+ * \brief Skip the blanks.
+ * \param in Input.
+ */
+static inline void _skip_blanks (_wave_input * const in)
+{
+    int c;
+    while ((c = _peek (in)) != EOF && isspace (c))
+        _advance (in);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for parsing.
+////////////////////////////////////////////////////////////////////////////////
+
+static void _read_value (_wave_input * in, wave_data * data);
+
+/**
+ * \brief Read a number.
+ * \param in Input.
+ * \param number Storage for the number.
+ * \retval true if the number is a wave_float.
+ * \retval false if the number is a wave_int.
+ */
+static bool _read_number (_wave_input * const in, _input_number * const number)
+{
+    char token[_WAVE_INPUT_NUMBER_MAX];
+    size_t length = 0;
+    bool is_float = false;
+    bool negative = false;
+    unsigned int value = 0;
+    int c = _peek (in);
+
+    if (c == '-')
+    {
+        negative = true;
+        token[length++] = '-';
+        _advance (in);
+        c = _peek (in);
+    }
+
+    /* Integers are computed on the fly, floating point values are converted
+     * once the whole token is known.
+     */
+    for (; c != EOF && length < _WAVE_INPUT_NUMBER_MAX - 1; c = _peek (in))
+    {
+        if (isdigit (c))
+            value = value * 10 + (unsigned int) (c - '0');
+        else if (c == '.' || c == 'e' || c == 'E'
+            || ((c == '-' || c == '+') && length > 0 && (token[length - 1] == 'e' || token[length - 1] == 'E')))
+            is_float = true;
+        else
+            break;
+        token[length++] = (char) c;
+        _advance (in);
+    }
+    token[length] = '\0';
+
+    if (length == (negative ? 1u : 0u) || length == _WAVE_INPUT_NUMBER_MAX - 1)
+        _input_error (in, "bad number");
+
+    if (is_float)
+    {
+        const char * end;
+        number->_float = wave_float_parse (token, & end);
+        if (* end != '\0')
+            _input_error (in, "bad floating point value");
+    }
+    else
+        number->_int = (wave_int) (negative ? - value : value);
+
+    return is_float;
+}
+
+/**
+ * \brief Read a string.
+ * \param in Input.
+ * \param data Storage for the string.
+ */
+static void _read_string (_wave_input * const in, wave_data * const data)
+{
+    size_t length = 0;
+    int c;
+
+    _advance (in);
+    while ((c = _peek (in)) != '"')
+    {
+        if (c == EOF)
+            _input_error (in, "unterminated string");
+        if (length >= in->_scratch_size)
+            _grow ((void **) & in->_scratch, & in->_scratch_size, sizeof * in->_scratch);
+        in->_scratch[length++] = (char) c;
+        _advance (in);
+    }
+    _advance (in);
+
+    wave_data_set_string_copy (data, length > 0 ? in->_scratch : "", length);
+}
+
+/**
+ * \brief Read a boolean.
+ * \param in Input.
+ * \return The boolean.
+ */
+static wave_bool _read_bool (_wave_input * const in)
+{
+    char word[8];
+    size_t length = 0;
+    int c;
+
+    while ((c = _peek (in)) != EOF && isalpha (c) && length < sizeof word - 1)
+    {
+        word[length++] = (char) c;
+        _advance (in);
+    }
+    word[length] = '\0';
+
+    if (strcmp (word, "true") == 0)
+        return true;
+    if (strcmp (word, "false") != 0)
+        _input_error (in, "unknown word");
+    return false;
+}
+
+/**
+ * \brief Push a boxed element.
+ * \param in Input.
+ * \param data Element.
+ */
+static inline void _push_element (_wave_input * const in, const wave_data * const data)
+{
+    if (in->_elements_count >= in->_elements_size)
+        _grow ((void **) & in->_elements, & in->_elements_size, sizeof * in->_elements);
+    in->_elements[in->_elements_count++] = * data;
+}
+
+/**
+ * \brief Push an unboxed element.
+ * \param in Input.
+ * \param number Element.
+ */
+static inline void _push_number (_wave_input * const in, _input_number number)
+{
+    if (in->_numbers_count >= in->_numbers_size)
+        _grow ((void **) & in->_numbers, & in->_numbers_size, sizeof * in->_numbers);
+    in->_numbers[in->_numbers_count++] = number;
+}
+
+/**
+ * \brief Box the unboxed elements of the current collection.
+ * \param in Input.
+ * \param mode Current storage of the elements.
+ * \param base First unboxed element of the collection.
+ */
+static void _box_numbers (_wave_input * const in, _input_mode mode, size_t base)
+{
+    for (size_t i = base; i < in->_numbers_count; ++i)
+    {
+        wave_data data;
+        if (mode == _INPUT_INTS)
+            wave_data_set_int (& data, in->_numbers[i]._int);
+        else
+            wave_data_set_float (& data, in->_numbers[i]._float);
+        _push_element (in, & data);
+    }
+    in->_numbers_count = base;
+}
+
+/**
+ * \brief Store the elements of a collection in the garbage collector.
+ * \param in Input.
+ * \param data Storage for the collection.
+ * \param type Type of the collection.
+ * \param mode Storage of the elements.
+ * \param elements_base First boxed element of the collection.
+ * \param numbers_base First unboxed element of the collection.
+ */
+static void _store_collection (_wave_input * const in, wave_data * const data, wave_data_type type, _input_mode mode, size_t elements_base, size_t numbers_base)
+{
+    if (mode != _INPUT_BOXED && type == WAVE_DATA_PAR)
+    {
+        size_t size = in->_numbers_count - numbers_base;
+        if (mode == _INPUT_INTS)
+        {
+            wave_int * tab = wave_garbage_alloc (size * sizeof * tab);
+            if (tab == NULL)
+                _memory_error ();
+            for (size_t i = 0; i < size; ++i)
+                tab[i] = in->_numbers[numbers_base + i]._int;
+            wave_data_set_par_int (data, tab, size);
+        }
+        else
+        {
+            wave_float * tab = wave_garbage_alloc (size * sizeof * tab);
+            if (tab == NULL)
+                _memory_error ();
+            for (size_t i = 0; i < size; ++i)
+                tab[i] = in->_numbers[numbers_base + i]._float;
+            wave_data_set_par_float (data, tab, size);
+        }
+        in->_numbers_count = numbers_base;
+    }
+    else
+    {
+        if (mode != _INPUT_BOXED)
+            _box_numbers (in, mode, numbers_base);
+
+        size_t size = in->_elements_count - elements_base;
+        wave_data * tab = wave_garbage_alloc (size * sizeof * tab);
+        if (tab == NULL)
+            _memory_error ();
+        memcpy (tab, in->_elements + elements_base, size * sizeof * tab);
+        data->_type = type;
+        data->_flags = WAVE_DATA_FLAG_NONE;
+        data->_content._collection._tab = tab;
+        data->_content._collection._size = (uint32_t) size;
+        in->_elements_count = elements_base;
+    }
+}
+
+/**
+ * \brief Read a collection.
+ * \param in Input.
+ * \param data Storage for the collection.
+ *
+ * The elements are stacked until the closing parenthesis is found, then
+ * copied at once in the garbage collector. Numbers are stacked unboxed as long
+ * as the collection only contains numbers of the same type.
+ */
+static void _read_collection (_wave_input * const in, wave_data * const data)
+{
+    size_t elements_base = in->_elements_count;
+    size_t numbers_base = in->_numbers_count;
+    wave_data_type type = WAVE_DATA_SEQ;
+    bool separated = false;
+    bool first = true;
+    _input_mode mode = _INPUT_BOXED;
+
+    _advance (in);
+    for (;;)
+    {
+        _skip_blanks (in);
+        int c = _peek (in);
+        if (isdigit (c) || c == '-' || c == '.')
+        {
+            _input_number number;
+            _input_mode number_mode = _read_number (in, & number) ? _INPUT_FLOATS : _INPUT_INTS;
+            if (first)
+                mode = number_mode;
+
+            if (mode == number_mode)
+                _push_number (in, number);
+            else
+            {
+                wave_data element;
+                if (number_mode == _INPUT_INTS)
+                    wave_data_set_int (& element, number._int);
+                else
+                    wave_data_set_float (& element, number._float);
+                if (mode != _INPUT_BOXED)
+                    _box_numbers (in, mode, numbers_base);
+                mode = _INPUT_BOXED;
+                _push_element (in, & element);
+            }
+        }
+        else
+        {
+            if (mode != _INPUT_BOXED)
+                _box_numbers (in, mode, numbers_base);
+            mode = _INPUT_BOXED;
+
+            wave_data element;
+            _read_value (in, & element);
+            _push_element (in, & element);
+        }
+        first = false;
+
+        /* The elements are either boxed or unboxed: their counts add up. */
+        if ((in->_elements_count - elements_base) + (in->_numbers_count - numbers_base) > _WAVE_INPUT_COLLECTION_MAX)
+            _input_error (in, "too many elements in a collection");
+
+        _skip_blanks (in);
+        c = _peek (in);
+        if (c == ')')
+        {
+            _advance (in);
+            break;
+        }
+
+        wave_data_type separator_type = WAVE_DATA_SEQ;
+        if (c == '|')
+        {
+            _advance (in);
+            _expect (in, '|', "expected \"||\"");
+            separator_type = WAVE_DATA_PAR;
+        }
+        else if (c == ';')
+            _advance (in);
+        else
+            _input_error (in, "expected \";\", \"||\" or \")\"");
+
+        if (separated && separator_type != type)
+            _input_error (in, "mixed separators in a collection");
+        type = separator_type;
+        separated = true;
+    }
+
+    _store_collection (in, data, type, mode, elements_base, numbers_base);
+}
+
+/**
+ * \brief Copy bytes from the input.
+ * \param in Input.
+ * \param destination Storage for the bytes.
+ * \param size Number of bytes.
+ */
+static void _copy_bytes (_wave_input * const in, unsigned char * destination, size_t size)
+{
+    while (size > 0)
+    {
+        if (_peek (in) == EOF)
+            _input_error (in, "truncated binary value");
+        size_t available = (size_t) (in->_end - in->_position);
+        size_t count = available < size ? available : size;
+        memcpy (destination, in->_position, count);
+        in->_position += count;
+        destination += count;
+        size -= count;
+    }
+}
+
+/**
+ * \brief Read a value in the binary format.
+ * \param in Input.
+ * \param data Storage for the value.
+ *
+ * Mapped values are decoded in place, the others are first copied in the
+ * garbage collector.
+ */
+static void _read_binary (_wave_input * const in, wave_data * const data)
+{
+    if (in->_mapped)
+    {
+        size_t size = wave_data_from_binary (in->_position, (size_t) (in->_end - in->_position), data);
+        if (size == 0)
+            _input_error (in, "bad binary value");
+        in->_position += size;
+        return;
+    }
+
+    wave_binary_header header;
+    _copy_bytes (in, (unsigned char *) & header, sizeof header);
+    size_t size = wave_binary_size (& header, sizeof header);
+    if (size == 0)
+        _input_error (in, "bad binary header");
+
+    unsigned char * buffer = wave_garbage_alloc (size);
+    if (buffer == NULL)
+        _memory_error ();
+    memcpy (buffer, & header, sizeof header);
+    _copy_bytes (in, buffer + sizeof header, size - sizeof header);
+
+    if (wave_data_from_binary (buffer, size, data) == 0)
+        _input_error (in, "bad binary value");
+}
+
+/**
+ * \brief Read a value.
+ * \param in Input.
+ * \param data Storage for the value.
+ */
+static void _read_value (_wave_input * const in, wave_data * const data)
+{
+    _skip_blanks (in);
+    int c = _peek (in);
+
+    if (c == '(')
+        _read_collection (in, data);
+    else if (c == '"')
+        _read_string (in, data);
+    else if (c == '\'')
+    {
+        _advance (in);
+        c = _peek (in);
+        if (c == EOF)
+            _input_error (in, "unterminated character");
+        _advance (in);
+        _expect (in, '\'', "unterminated character");
+        wave_data_set_char (data, (wave_char) c);
+    }
+    else if (isdigit (c) || c == '-' || c == '.')
+    {
+        _input_number number;
+        if (_read_number (in, & number))
+            wave_data_set_float (data, number._float);
+        else
+            wave_data_set_int (data, number._int);
+    }
+    else if (c == WAVE_BINARY_MAGIC[0])
+        _read_binary (in, data);
+    else if (isalpha (c))
+        wave_data_set_bool (data, _read_bool (in));
+    else if (c == EOF)
+        _input_error (in, "unexpected end of input");
+    else
+        _input_error (in, "unexpected character");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Opening, closing.
+////////////////////////////////////////////////////////////////////////////////
+
+bool wave_input_open (const char * const path)
+{
+    _wave_input * const in = & _WAVE_INPUT;
+    wave_input_close ();
+
+    bool is_stdin = path == NULL || strcmp (path, "-") == 0;
+    int fd = is_stdin ? STDIN_FILENO : open (path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    * in = (_wave_input) { ._open = true, ._fd = fd };
+
+    /* Regular files are mapped, the others are read by blocks. */
+    struct stat status;
+    if (fstat (fd, & status) == 0 && S_ISREG (status.st_mode) && status.st_size > 0)
+    {
+        void * map = mmap (NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            madvise (map, (size_t) status.st_size, MADV_SEQUENTIAL);
+            in->_mapped = true;
+            in->_mapped_size = (size_t) status.st_size;
+            in->_base = map;
+            in->_position = map;
+            in->_end = in->_base + in->_mapped_size;
+        }
+    }
+
+    if (! in->_mapped)
+    {
+        in->_buffer = malloc (_WAVE_INPUT_BLOCK);
+        if (in->_buffer == NULL)
+        {
+            wave_input_close ();
+            return false;
+        }
+        in->_base = in->_buffer;
+        in->_position = in->_buffer;
+        in->_end = in->_buffer;
+    }
+
+    return true;
+}
+
+void wave_input_open_memory (const void * const buffer, size_t size)
+{
+    _wave_input * const in = & _WAVE_INPUT;
+    wave_input_close ();
+
+    /* Without a file, the memory is not unmapped when the input is closed. */
+    * in = (_wave_input) { ._open = true, ._mapped = true, ._fd = -1 };
+    in->_base = buffer;
+    in->_position = buffer;
+    in->_end = in->_base + size;
+}
+
+void wave_input_close (void)
+{
+    _wave_input * const in = & _WAVE_INPUT;
+    if (in->_open)
+    {
+        if (in->_mapped && in->_fd >= 0)
+            munmap ((void *) in->_base, in->_mapped_size);
+        if (in->_fd >= 0 && in->_fd != STDIN_FILENO)
+            close (in->_fd);
+        free (in->_buffer);
+        free (in->_elements);
+        free (in->_numbers);
+        free (in->_scratch);
+        * in = (_wave_input) { ._open = false, ._fd = -1 };
+    }
+}
+
+void wave_input_set_collection_max (size_t max)
+{
+    _WAVE_INPUT_COLLECTION_MAX = max < WAVE_DATA_SIZE_MAX ? max : WAVE_DATA_SIZE_MAX;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading.
+////////////////////////////////////////////////////////////////////////////////
+
+bool wave_input_next (wave_data * const data)
+{
+    bool found = false;
+
+    #pragma omp critical (wave_input)
+    {
+        _wave_input * const in = & _WAVE_INPUT;
+        if (! in->_open && ! wave_input_open (getenv ("WAVE_INPUT")))
+        {
+            fprintf (stderr, "Error: cannot open the input: %s.\n", strerror (errno));
+            exit (EX_NOINPUT);
+        }
+
+        _skip_blanks (in);
+        found = _peek (in) != EOF;
+        if (found)
+            _read_value (in, data);
+    }
+
+    return found;
+}
+
+void wave_input_read (wave_data * const data)
+{
+    if (! wave_input_next (data))
+    {
+        fprintf (stderr, "Error: no value left in the input.\n");
+        exit (EX_DATAERR);
+    }
+}
@@ -0,0 +1,990 @@
+/**
+ * \file wave_kernels.c
+ * \brief Wave element-wise kernels.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "wave/common/wave_kernels.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined (__x86_64__) || defined (__i386__)
+/** \brief Defined when the vector kernels are available. */
+#define WAVE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Tab of unary `wave_int -> wave_int` functions.
+ */
+static wave_int (* const _unary_int []) (wave_int) =
+{
+    [WAVE_OP_UNARY_PLUS] = wave_int_unary_plus,
+    [WAVE_OP_UNARY_MINUS] = wave_int_unary_minus,
+    [WAVE_OP_UNARY_INCREMENT] = wave_int_increment,
+    [WAVE_OP_UNARY_DECREMENT] = wave_int_decrement,
+};
+
+/**
+ * \brief Tab of unary `wave_float -> wave_float` functions.
+ */
+static wave_float (* const _unary_float []) (wave_float) =
+{
+    [WAVE_OP_UNARY_PLUS] = wave_float_unary_plus,
+    [WAVE_OP_UNARY_MINUS] = wave_float_unary_minus,
+    [WAVE_OP_UNARY_INCREMENT] = wave_float_increment,
+    [WAVE_OP_UNARY_DECREMENT] = wave_float_decrement,
+    [WAVE_OP_UNARY_SQRT] = wave_float_sqrt,
+    [WAVE_OP_UNARY_SIN] = wave_float_sin,
+    [WAVE_OP_UNARY_COS] = wave_float_cos,
+    [WAVE_OP_UNARY_LOG] = wave_float_log,
+    [WAVE_OP_UNARY_EXP] = wave_float_exp,
+};
+
+/**
+ * \brief Tab of binary `(wave_int, wave_int) -> wave_int` functions.
+ */
+static wave_int (* const _binary_int []) (wave_int, wave_int) =
+{
+    [WAVE_OP_BINARY_PLUS] = wave_int_binary_plus,
+    [WAVE_OP_BINARY_MINUS] = wave_int_binary_minus,
+    [WAVE_OP_BINARY_MIN] = wave_int_min,
+    [WAVE_OP_BINARY_MAX] = wave_int_max,
+    [WAVE_OP_BINARY_TIMES] = wave_int_times,
+    [WAVE_OP_BINARY_DIVIDE] = wave_int_divide,
+    [WAVE_OP_BINARY_MOD] = wave_int_mod,
+};
+
+/**
+ * \brief Tab of binary `(wave_int, wave_int) -> wave_bool` functions.
+ */
+static wave_bool (* const _binary_int_to_bool []) (wave_int, wave_int) =
+{
+    [WAVE_OP_BINARY_EQUALS] = wave_int_equals,
+    [WAVE_OP_BINARY_DIFFERS] = wave_int_differs,
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = wave_int_lesser_or_equals,
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = wave_int_greater_or_equals,
+    [WAVE_OP_BINARY_GREATER] = wave_int_greater,
+    [WAVE_OP_BINARY_LESSER] = wave_int_lesser,
+};
+
+/**
+ * \brief Tab of binary `(wave_float, wave_float) -> wave_float` functions.
+ */
+static wave_float (* const _binary_float []) (wave_float, wave_float) =
+{
+    [WAVE_OP_BINARY_PLUS] = wave_float_binary_plus,
+    [WAVE_OP_BINARY_MINUS] = wave_float_binary_minus,
+    [WAVE_OP_BINARY_MIN] = wave_float_min,
+    [WAVE_OP_BINARY_MAX] = wave_float_max,
+    [WAVE_OP_BINARY_TIMES] = wave_float_times,
+    [WAVE_OP_BINARY_DIVIDE] = wave_float_divide,
+    [WAVE_OP_BINARY_MOD] = wave_float_mod,
+};
+
+/**
+ * \brief Tab of binary `(wave_float, wave_float) -> wave_bool` functions.
+ */
+static wave_bool (* const _binary_float_to_bool []) (wave_float, wave_float) =
+{
+    [WAVE_OP_BINARY_EQUALS] = wave_float_equals,
+    [WAVE_OP_BINARY_DIFFERS] = wave_float_differs,
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = wave_float_lesser_or_equals,
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = wave_float_greater_or_equals,
+    [WAVE_OP_BINARY_GREATER] = wave_float_greater,
+    [WAVE_OP_BINARY_LESSER] = wave_float_lesser,
+};
+
+/**
+ * \brief Tab of binary `(wave_bool, wave_bool) -> wave_bool` functions.
+ */
+static wave_bool (* const _binary_bool []) (wave_bool, wave_bool) =
+{
+    [WAVE_OP_BINARY_AND] = wave_bool_and,
+    [WAVE_OP_BINARY_OR] = wave_bool_or,
+    [WAVE_OP_BINARY_EQUALS] = wave_bool_equals,
+    [WAVE_OP_BINARY_DIFFERS] = wave_bool_differs,
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = wave_bool_lesser_or_equals,
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = wave_bool_greater_or_equals,
+    [WAVE_OP_BINARY_GREATER] = wave_bool_greater,
+    [WAVE_OP_BINARY_LESSER] = wave_bool_lesser,
+};
+
+/** \cond Doxygen ignore. */
+#define _def_scalar_kernel(name, table, operand_type, result_type) \
+    static void _scalar_##name (wave_operator op, const operand_type * operand, result_type * result, size_t size) \
+    { \
+        for (size_t i = 0; i < size; ++i) \
+            result[i] = table[op] (operand[i]); \
+    }
+
+#define _def_scalar_binary_kernel(name, table, operand_type, result_type) \
+    static void _scalar_##name (wave_operator op, const operand_type * left, const operand_type * right, result_type * result, size_t size) \
+    { \
+        for (size_t i = 0; i < size; ++i) \
+            result[i] = table[op] (left[i], right[i]); \
+    }
+
+#define _def_scalar_bits_kernel(name, table, operand_type) \
+    static void _scalar_##name (wave_operator op, const operand_type * left, const operand_type * right, uint64_t * result, size_t size) \
+    { \
+        for (size_t i = 0; i < size; i += WAVE_KERNELS_WORD_BITS) \
+        { \
+            uint64_t word = 0; \
+            for (size_t j = 0; j < WAVE_KERNELS_WORD_BITS && i + j < size; ++j) \
+                word |= (table[op] (left[i + j], right[i + j]) ? UINT64_C (1) : 0) << j; \
+            result[i / WAVE_KERNELS_WORD_BITS] = word; \
+        } \
+    }
+
+_def_scalar_kernel (int_unary, _unary_int, wave_int, wave_int)
+_def_scalar_kernel (float_unary, _unary_float, wave_float, wave_float)
+_def_scalar_binary_kernel (int_binary, _binary_int, wave_int, wave_int)
+_def_scalar_binary_kernel (float_binary, _binary_float, wave_float, wave_float)
+_def_scalar_binary_kernel (int_test, _binary_int_to_bool, wave_int, wave_bool)
+_def_scalar_binary_kernel (float_test, _binary_float_to_bool, wave_float, wave_bool)
+_def_scalar_bits_kernel (int_test_bits, _binary_int_to_bool, wave_int)
+_def_scalar_bits_kernel (float_test_bits, _binary_float_to_bool, wave_float)
+
+#undef _def_scalar_bits_kernel
+#undef _def_scalar_binary_kernel
+#undef _def_scalar_kernel
+/** \endcond Doxygen ignore. */
+
+////////////////////////////////////////////////////////////////////////////////
+// Vector kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef WAVE_KERNELS_X86
+
+/*
+ * The vector kernels are written with the GCC vector extensions. Each
+ * instruction set gets its own copy of the kernels, compiled with the matching
+ * target attribute; the right copy is chosen at runtime.
+ *
+ * Every kernel processes whole vectors first, then finishes the tail with the
+ * scalar functions. The vector types are only aligned on their elements so
+ * that the tabs need no particular alignment.
+ *
+ * Comparisons of vectors yield masks whose lanes are either all ones or all
+ * zeros: masks are used to select lanes, and are converted to wave_bool tabs by
+ * narrowing and negating them. The bitset kernels gather the sign bits of the
+ * lanes of the masks instead, with the movemask instructions, so that a few
+ * vectors fill a whole word.
+ *
+ * The square root uses the instruction of the set and is exact. The other
+ * transcendental functions are polynomial approximations, after the fdlibm
+ * ones:
+ * - exp: reduction by ln(2) in two parts, Taylor polynomial of degree 13, and
+ *   scaling by the power of two in two steps so that subnormal results round
+ *   only once.
+ * - log: split of the exponent and of a mantissa in [sqrt(2)/2, sqrt(2)[, and
+ *   polynomial in s^2 where s = f / (2 + f).
+ * - sin, cos: reduction by pi/2 in up to three parts, and the sine and cosine
+ *   polynomials on [-pi/4, pi/4]. As in fdlibm, a lane only takes the next
+ *   part when the previous one cancelled more than 16, then 49 bits: the
+ *   rounding error of the subtraction is otherwise lost, and the results drift
+ *   1.5 ULP away from the exact values. Lanes beyond 2^19 pi/2 and lanes which
+ *   are not finite are computed by the C library.
+ *
+ * Over 4 million random operands per function and range, including the whole
+ * reduction range of sin and cos and the doubles closest to its multiples of
+ * pi/2, no result was more than 1 ULP away from the C library. The sine and
+ * cosine were at most 0.78 ULP away from the exact values, against 0.52 ULP
+ * for the C library. Special operands (zeros, infinities, NaN,
+ * subnormals, overflows) give the same results as the C library. The tail of a
+ * tab goes through the same approximations as the rest, so that the result of
+ * an element never depends on its position.
+ */
+
+/** \cond Doxygen ignore. */
+#define _SIGN_CLEAR INT64_C (0x7fffffffffffffff)
+#define _EXPONENT_SET INT64_C (0x7ff0000000000000)
+
+#define _load(vector_type, pointer) (* (const vector_type *) (pointer))
+#define _store(vector_type, pointer, value) (* (vector_type *) (pointer) = (value))
+#define _select(mask_type, mask, a, b) (((mask_type) (a) & (mask)) | ((mask_type) (b) & ~ (mask)))
+#define _float_select(float_type, mask_type, mask, a, b) ((float_type) _select (mask_type, mask, a, b))
+#define _float_abs(float_type, mask_type, a) ((float_type) ((mask_type) (a) & _SIGN_CLEAR))
+#define _float_is_nan(mask_type, a) (((mask_type) (a) & _SIGN_CLEAR) > _EXPONENT_SET)
+#define _float_equals(float_type, mask_type, a, b) ((mask_type) (_float_abs (float_type, mask_type, (a) - (b)) < WAVE_FLOAT_EPSILON))
+#define _splat(vector_type, value) ((vector_type) {0} + (value))
+#define _ROUND_SHIFTER 0x1.8p52
+
+#define _vector_unary_loop(vector_type, operand, result, size, expression, table, op) \
+    { \
+        const size_t lanes = sizeof (vector_type) / sizeof (* (operand)); \
+        size_t i = 0; \
+        for (; i + lanes <= (size); i += lanes) \
+        { \
+            vector_type a = _load (vector_type, (operand) + i); \
+            _store (vector_type, (result) + i, (expression)); \
+        } \
+        for (; i < (size); ++i) \
+            (result)[i] = table[op] ((operand)[i]); \
+    }
+
+#define _vector_unary_padded_loop(vector_type, operand, result, size, expression) \
+    { \
+        const size_t lanes = sizeof (vector_type) / sizeof (* (operand)); \
+        size_t i = 0; \
+        for (; i + lanes <= (size); i += lanes) \
+        { \
+            vector_type a = _load (vector_type, (operand) + i); \
+            _store (vector_type, (result) + i, (expression)); \
+        } \
+        if (i < (size)) \
+        { \
+            vector_type a = {0}; \
+            memcpy (& a, (operand) + i, ((size) - i) * sizeof * (operand)); \
+            vector_type tail = (expression); \
+            memcpy ((result) + i, & tail, ((size) - i) * sizeof * (result)); \
+        } \
+    }
+
+#define _vector_binary_loop(vector_type, left, right, result, size, expression, table, op) \
+    { \
+        const size_t lanes = sizeof (vector_type) / sizeof (* (left)); \
+        size_t i = 0; \
+        for (; i + lanes <= (size); i += lanes) \
+        { \
+            vector_type a = _load (vector_type, (left) + i); \
+            vector_type b = _load (vector_type, (right) + i); \
+            _store (vector_type, (result) + i, (expression)); \
+        } \
+        for (; i < (size); ++i) \
+            (result)[i] = table[op] ((left)[i], (right)[i]); \
+    }
+
+#define _vector_test_loop(vector_type, bool_vector_type, left, right, result, size, expression, table, op) \
+    { \
+        const size_t lanes = sizeof (vector_type) / sizeof (* (left)); \
+        size_t i = 0; \
+        for (; i + lanes <= (size); i += lanes) \
+        { \
+            vector_type a = _load (vector_type, (left) + i); \
+            vector_type b = _load (vector_type, (right) + i); \
+            bool_vector_type bools = - __builtin_convertvector ((expression), bool_vector_type); \
+            memcpy ((result) + i, & bools, sizeof bools); \
+        } \
+        for (; i < (size); ++i) \
+            (result)[i] = table[op] ((left)[i], (right)[i]); \
+    }
+
+#define _vector_test_bits_loop(vector_type, movemask, left, right, result, size, expression, table, op) \
+    { \
+        const size_t lanes = sizeof (vector_type) / sizeof (* (left)); \
+        size_t i = 0; \
+        for (; i + WAVE_KERNELS_WORD_BITS <= (size); i += WAVE_KERNELS_WORD_BITS) \
+        { \
+            uint64_t word = 0; \
+            for (size_t j = 0; j < WAVE_KERNELS_WORD_BITS; j += lanes) \
+            { \
+                vector_type a = _load (vector_type, (left) + i + j); \
+                vector_type b = _load (vector_type, (right) + i + j); \
+                word |= (uint64_t) movemask (expression) << j; \
+            } \
+            (result)[i / WAVE_KERNELS_WORD_BITS] = word; \
+        } \
+        if (i < (size)) \
+        { \
+            uint64_t word = 0; \
+            for (size_t j = 0; i + j < (size); ++j) \
+                word |= (table[op] ((left)[i + j], (right)[i + j]) ? UINT64_C (1) : 0) << j; \
+            (result)[i / WAVE_KERNELS_WORD_BITS] = word; \
+        } \
+    }
+
+#define _def_vector_int_test(isa, target_name, name, result_type, loop, narrow) \
+    static __attribute__ ((target (target_name))) void _##isa##_##name (wave_operator op, const wave_int * left, const wave_int * right, result_type * result, size_t size) \
+    { \
+        switch (op) \
+        { \
+            case WAVE_OP_BINARY_EQUALS: \
+                loop (_##isa##_int, narrow, left, right, result, size, a == b, _binary_int_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_DIFFERS: \
+                loop (_##isa##_int, narrow, left, right, result, size, a != b, _binary_int_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_LESSER_OR_EQUALS: \
+                loop (_##isa##_int, narrow, left, right, result, size, a <= b, _binary_int_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_GREATER_OR_EQUALS: \
+                loop (_##isa##_int, narrow, left, right, result, size, a >= b, _binary_int_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_GREATER: \
+                loop (_##isa##_int, narrow, left, right, result, size, a > b, _binary_int_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_LESSER: \
+                loop (_##isa##_int, narrow, left, right, result, size, a < b, _binary_int_to_bool, op); \
+                break; \
+            default: \
+                _scalar_##name (op, left, right, result, size); \
+                break; \
+        } \
+    }
+
+#define _def_vector_float_test(isa, target_name, name, result_type, loop, narrow) \
+    static __attribute__ ((target (target_name))) void _##isa##_##name (wave_operator op, const wave_float * left, const wave_float * right, result_type * result, size_t size) \
+    { \
+        switch (op) \
+        { \
+            case WAVE_OP_BINARY_EQUALS: \
+                loop (_##isa##_float, narrow, left, right, result, size, \
+                    _float_equals (_##isa##_float, _##isa##_mask, a, b), _binary_float_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_DIFFERS: \
+                loop (_##isa##_float, narrow, left, right, result, size, \
+                    ~ _float_equals (_##isa##_float, _##isa##_mask, a, b), _binary_float_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_LESSER_OR_EQUALS: \
+                loop (_##isa##_float, narrow, left, right, result, size, \
+                    _float_equals (_##isa##_float, _##isa##_mask, a, b) | (_##isa##_mask) (a < b), _binary_float_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_GREATER_OR_EQUALS: \
+                loop (_##isa##_float, narrow, left, right, result, size, \
+                    _float_equals (_##isa##_float, _##isa##_mask, a, b) | (_##isa##_mask) (a > b), _binary_float_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_GREATER: \
+                loop (_##isa##_float, narrow, left, right, result, size, \
+                    (_##isa##_mask) (a > b), _binary_float_to_bool, op); \
+                break; \
+            case WAVE_OP_BINARY_LESSER: \
+                loop (_##isa##_float, narrow, left, right, result, size, \
+                    (_##isa##_mask) (a < b), _binary_float_to_bool, op); \
+                break; \
+            default: \
+                _scalar_##name (op, left, right, result, size); \
+                break; \
+        } \
+    }
+
+#define _def_vector_math(isa, target_name, sqrt_function) \
+    static __attribute__ ((target (target_name))) _##isa##_float _##isa##_sqrt (_##isa##_float x) \
+    { \
+        return (_##isa##_float) sqrt_function (x); \
+    } \
+    \
+    static __attribute__ ((target (target_name))) _##isa##_float _##isa##_scale (_##isa##_float x, _##isa##_mask k) \
+    { \
+        _##isa##_mask half = k >> 1; \
+        _##isa##_float first = (_##isa##_float) ((half + 1023) << 52); \
+        _##isa##_float second = (_##isa##_float) ((k - half + 1023) << 52); \
+        return x * first * second; \
+    } \
+    \
+    static __attribute__ ((target (target_name))) _##isa##_float _##isa##_exp (_##isa##_float x) \
+    { \
+        _##isa##_float y = _float_select (_##isa##_float, _##isa##_mask, x > 710.0, _splat (_##isa##_float, 710.0), x); \
+        y = _float_select (_##isa##_float, _##isa##_mask, y < -746.0, _splat (_##isa##_float, -746.0), y); \
+        y = _float_select (_##isa##_float, _##isa##_mask, _float_is_nan (_##isa##_mask, y), _splat (_##isa##_float, 0.0), y); \
+        _##isa##_float k = (y * 0x1.71547652b82fep0 + _ROUND_SHIFTER) - _ROUND_SHIFTER; \
+        _##isa##_float r = (y - k * 0x1.62e42fee00000p-1) - k * 0x1.a39ef35793c76p-33; \
+        _##isa##_float p = r * (1.0 / 6227020800.0) + 1.0 / 479001600.0; \
+        p = p * r + 1.0 / 39916800.0; \
+        p = p * r + 1.0 / 3628800.0; \
+        p = p * r + 1.0 / 362880.0; \
+        p = p * r + 1.0 / 40320.0; \
+        p = p * r + 1.0 / 5040.0; \
+        p = p * r + 1.0 / 720.0; \
+        p = p * r + 1.0 / 120.0; \
+        p = p * r + 1.0 / 24.0; \
+        p = p * r + 1.0 / 6.0; \
+        p = p * r + 0.5; \
+        p = 1.0 + (r + r * r * p); \
+        _##isa##_float e = _##isa##_scale (p, __builtin_convertvector (k, _##isa##_mask)); \
+        e = _float_select (_##isa##_float, _##isa##_mask, x > 0x1.62e42fefa39efp9, _splat (_##isa##_float, __builtin_inf ()), e); \
+        e = _float_select (_##isa##_float, _##isa##_mask, x < -0x1.74910d52d3051p9, _splat (_##isa##_float, 0.0), e); \
+        return _float_select (_##isa##_float, _##isa##_mask, _float_is_nan (_##isa##_mask, x), x + x, e); \
+    } \
+    \
+    static __attribute__ ((target (target_name))) _##isa##_float _##isa##_log (_##isa##_float x) \
+    { \
+        _##isa##_mask subnormal = (_##isa##_mask) x < INT64_C (0x0010000000000000); \
+        _##isa##_float y = _float_select (_##isa##_float, _##isa##_mask, subnormal, x * 0x1p54, x); \
+        _##isa##_mask bits = (_##isa##_mask) y; \
+        _##isa##_mask exponent = ((bits >> 52) & 0x7ff) - 1023 - (subnormal & 54); \
+        _##isa##_float m = (_##isa##_float) ((bits & INT64_C (0x000fffffffffffff)) | INT64_C (0x3ff0000000000000)); \
+        _##isa##_mask high = (_##isa##_mask) (m > 0x1.6a09e667f3bcdp0); \
+        m = _float_select (_##isa##_float, _##isa##_mask, high, m * 0.5, m); \
+        _##isa##_float k = __builtin_convertvector (exponent - high, _##isa##_float); \
+        _##isa##_float f = m - 1.0; \
+        _##isa##_float s = f / (f + 2.0); \
+        _##isa##_float z = s * s; \
+        _##isa##_float w = z * z; \
+        _##isa##_float t1 = w * (0x1.999999997fa04p-2 + w * (0x1.c71c51d8e78afp-3 + w * 0x1.39a09d078c69fp-3)); \
+        _##isa##_float t2 = z * (0x1.5555555555593p-1 + w * (0x1.2492494229359p-2 + w * (0x1.7466496cb03dep-3 + w * 0x1.2f112df3e5244p-3))); \
+        _##isa##_float r = t2 + t1; \
+        _##isa##_float hfsq = 0.5 * f * f; \
+        _##isa##_float l = k * 0x1.62e42fee00000p-1 - ((hfsq - (s * (hfsq + r) + k * 0x1.a39ef35793c76p-33)) - f); \
+        l = _float_select (_##isa##_float, _##isa##_mask, (_##isa##_mask) x == _EXPONENT_SET, x, l); \
+        l = _float_select (_##isa##_float, _##isa##_mask, (_##isa##_mask) x < 0, (x - x) / 0.0, l); \
+        l = _float_select (_##isa##_float, _##isa##_mask, ((_##isa##_mask) x & _SIGN_CLEAR) == 0, _splat (_##isa##_float, - __builtin_inf ()), l); \
+        return _float_select (_##isa##_float, _##isa##_mask, _float_is_nan (_##isa##_mask, x), x + x, l); \
+    } \
+    \
+    static __attribute__ ((target (target_name))) _##isa##_float _##isa##_sin_cos (_##isa##_float x, int64_t quadrant) \
+    { \
+        _##isa##_float n = (x * 0x1.45f306dc9c883p-1 + _ROUND_SHIFTER) - _ROUND_SHIFTER; \
+        _##isa##_mask exponent = ((_##isa##_mask) x >> 52) & 0x7ff; \
+        _##isa##_float r = x - n * 0x1.921fb54400000p0; \
+        _##isa##_float w = n * 0x1.0b4611a626331p-34; \
+        _##isa##_float y0 = r - w; \
+        _##isa##_mask next = exponent - (((_##isa##_mask) y0 >> 52) & 0x7ff) > 16; \
+        _##isa##_float t = r; \
+        _##isa##_float u = n * 0x1.0b4611a600000p-34; \
+        r = _float_select (_##isa##_float, _##isa##_mask, next, t - u, r); \
+        w = _float_select (_##isa##_float, _##isa##_mask, next, n * 0x1.3198a2e037073p-69 - ((t - r) - u), w); \
+        y0 = r - w; \
+        next &= exponent - (((_##isa##_mask) y0 >> 52) & 0x7ff) > 49; \
+        t = r; \
+        u = n * 0x1.3198a2e000000p-69; \
+        r = _float_select (_##isa##_float, _##isa##_mask, next, t - u, r); \
+        w = _float_select (_##isa##_float, _##isa##_mask, next, n * 0x1.b839a252049c1p-104 - ((t - r) - u), w); \
+        y0 = r - w; \
+        _##isa##_float y1 = (r - y0) - w; \
+        _##isa##_float z = y0 * y0; \
+        _##isa##_float v = z * y0; \
+        _##isa##_float zz = z * z; \
+        _##isa##_float p = 0x1.111111110f8a6p-7 + z * (-0x1.a01a019c161d5p-13 + z * 0x1.71de357b1fe7dp-19) \
+            + z * zz * (-0x1.ae5e68a2b9cebp-26 + z * 0x1.5d93a5acfd57cp-33); \
+        _##isa##_float sine = y0 - ((z * (0.5 * y1 - v * p) - y1) - v * -0x1.5555555555549p-3); \
+        p = z * (0x1.555555555554cp-5 + z * (-0x1.6c16c16c15177p-10 + z * 0x1.a01a019cb1590p-16)) \
+            + zz * zz * (-0x1.27e4f809c52adp-22 + z * (0x1.1ee9ebdb4b1c4p-29 + z * -0x1.8fae9be8838d4p-37)); \
+        _##isa##_float half = 0.5 * z; \
+        t = 1.0 - half; \
+        _##isa##_float cosine = t + (((1.0 - t) - half) + (z * p - y0 * y1)); \
+        _##isa##_mask q = __builtin_convertvector (n, _##isa##_mask) + quadrant; \
+        _##isa##_float result = _float_select (_##isa##_float, _##isa##_mask, (q & 1) != 0, cosine, sine); \
+        result = _float_select (_##isa##_float, _##isa##_mask, (q & 2) != 0, - result, result); \
+        _##isa##_mask large = ~ (_##isa##_mask) (_float_abs (_##isa##_float, _##isa##_mask, x) <= 0x1.921fb54442d18p19); \
+        for (size_t lane = 0; lane < sizeof result / sizeof result[0]; ++lane) \
+            if (large[lane]) \
+                result[lane] = quadrant ? wave_float_cos (x[lane]) : wave_float_sin (x[lane]); \
+        return result; \
+    } \
+    \
+    static __attribute__ ((target (target_name))) _##isa##_float _##isa##_sin (_##isa##_float x) \
+    { \
+        return _##isa##_sin_cos (x, 0); \
+    } \
+    \
+    static __attribute__ ((target (target_name))) _##isa##_float _##isa##_cos (_##isa##_float x) \
+    { \
+        return _##isa##_sin_cos (x, 1); \
+    }
+
+#define _def_vector_kernels(isa, target_name, bytes, sqrt_function) \
+    typedef wave_int _##isa##_int __attribute__ ((vector_size (bytes), aligned (sizeof (wave_int)))); \
+    typedef wave_float _##isa##_float __attribute__ ((vector_size (bytes), aligned (sizeof (wave_float)))); \
+    typedef int64_t _##isa##_mask __attribute__ ((vector_size (bytes))); \
+    typedef signed char _##isa##_int_bools __attribute__ ((vector_size (bytes / sizeof (wave_int)))); \
+    typedef signed char _##isa##_float_bools __attribute__ ((vector_size (bytes / sizeof (wave_float)))); \
+    \
+    _def_vector_math (isa, target_name, sqrt_function) \
+    \
+    static __attribute__ ((target (target_name))) void _##isa##_int_unary (wave_operator op, const wave_int * operand, wave_int * result, size_t size) \
+    { \
+        switch (op) \
+        { \
+            case WAVE_OP_UNARY_MINUS: \
+                _vector_unary_loop (_##isa##_int, operand, result, size, - a, _unary_int, op); \
+                break; \
+            case WAVE_OP_UNARY_INCREMENT: \
+                _vector_unary_loop (_##isa##_int, operand, result, size, a + 1, _unary_int, op); \
+                break; \
+            case WAVE_OP_UNARY_DECREMENT: \
+                _vector_unary_loop (_##isa##_int, operand, result, size, a - 1, _unary_int, op); \
+                break; \
+            default: \
+                _scalar_int_unary (op, operand, result, size); \
+                break; \
+        } \
+    } \
+    \
+    static __attribute__ ((target (target_name))) void _##isa##_float_unary (wave_operator op, const wave_float * operand, wave_float * result, size_t size) \
+    { \
+        switch (op) \
+        { \
+            case WAVE_OP_UNARY_MINUS: \
+                _vector_unary_loop (_##isa##_float, operand, result, size, - a, _unary_float, op); \
+                break; \
+            case WAVE_OP_UNARY_INCREMENT: \
+                _vector_unary_loop (_##isa##_float, operand, result, size, a + 1, _unary_float, op); \
+                break; \
+            case WAVE_OP_UNARY_DECREMENT: \
+                _vector_unary_loop (_##isa##_float, operand, result, size, a - 1, _unary_float, op); \
+                break; \
+            case WAVE_OP_UNARY_SQRT: \
+                _vector_unary_padded_loop (_##isa##_float, operand, result, size, _##isa##_sqrt (a)); \
+                break; \
+            case WAVE_OP_UNARY_SIN: \
+                _vector_unary_padded_loop (_##isa##_float, operand, result, size, _##isa##_sin (a)); \
+                break; \
+            case WAVE_OP_UNARY_COS: \
+                _vector_unary_padded_loop (_##isa##_float, operand, result, size, _##isa##_cos (a)); \
+                break; \
+            case WAVE_OP_UNARY_LOG: \
+                _vector_unary_padded_loop (_##isa##_float, operand, result, size, _##isa##_log (a)); \
+                break; \
+            case WAVE_OP_UNARY_EXP: \
+                _vector_unary_padded_loop (_##isa##_float, operand, result, size, _##isa##_exp (a)); \
+                break; \
+            default: \
+                _scalar_float_unary (op, operand, result, size); \
+                break; \
+        } \
+    } \
+    \
+    static __attribute__ ((target (target_name))) void _##isa##_int_binary (wave_operator op, const wave_int * left, const wave_int * right, wave_int * result, size_t size) \
+    { \
+        switch (op) \
+        { \
+            case WAVE_OP_BINARY_PLUS: \
+                _vector_binary_loop (_##isa##_int, left, right, result, size, a + b, _binary_int, op); \
+                break; \
+            case WAVE_OP_BINARY_MINUS: \
+                _vector_binary_loop (_##isa##_int, left, right, result, size, a - b, _binary_int, op); \
+                break; \
+            case WAVE_OP_BINARY_TIMES: \
+                _vector_binary_loop (_##isa##_int, left, right, result, size, a * b, _binary_int, op); \
+                break; \
+            case WAVE_OP_BINARY_MIN: \
+                _vector_binary_loop (_##isa##_int, left, right, result, size, _select (_##isa##_int, a < b, a, b), _binary_int, op); \
+                break; \
+            case WAVE_OP_BINARY_MAX: \
+                _vector_binary_loop (_##isa##_int, left, right, result, size, _select (_##isa##_int, a > b, a, b), _binary_int, op); \
+                break; \
+            default: \
+                _scalar_int_binary (op, left, right, result, size); \
+                break; \
+        } \
+    } \
+    \
+    static __attribute__ ((target (target_name))) void _##isa##_float_binary (wave_operator op, const wave_float * left, const wave_float * right, wave_float * result, size_t size) \
+    { \
+        switch (op) \
+        { \
+            case WAVE_OP_BINARY_PLUS: \
+                _vector_binary_loop (_##isa##_float, left, right, result, size, a + b, _binary_float, op); \
+                break; \
+            case WAVE_OP_BINARY_MINUS: \
+                _vector_binary_loop (_##isa##_float, left, right, result, size, a - b, _binary_float, op); \
+                break; \
+            case WAVE_OP_BINARY_TIMES: \
+                _vector_binary_loop (_##isa##_float, left, right, result, size, a * b, _binary_float, op); \
+                break; \
+            case WAVE_OP_BINARY_DIVIDE: \
+                _vector_binary_loop (_##isa##_float, left, right, result, size, a / b, _binary_float, op); \
+                break; \
+            case WAVE_OP_BINARY_MIN: \
+                _vector_binary_loop (_##isa##_float, left, right, result, size, \
+                    _float_select (_##isa##_float, _##isa##_mask, _float_is_nan (_##isa##_mask, b), a, \
+                        _float_select (_##isa##_float, _##isa##_mask, (_##isa##_mask) (a < b), a, b)), \
+                    _binary_float, op); \
+                break; \
+            case WAVE_OP_BINARY_MAX: \
+                _vector_binary_loop (_##isa##_float, left, right, result, size, \
+                    _float_select (_##isa##_float, _##isa##_mask, _float_is_nan (_##isa##_mask, b), a, \
+                        _float_select (_##isa##_float, _##isa##_mask, (_##isa##_mask) (a > b), a, b)), \
+                    _binary_float, op); \
+                break; \
+            default: \
+                _scalar_float_binary (op, left, right, result, size); \
+                break; \
+        } \
+    } \
+    \
+    _def_vector_int_test (isa, target_name, int_test, wave_bool, _vector_test_loop, _##isa##_int_bools) \
+    _def_vector_int_test (isa, target_name, int_test_bits, uint64_t, _vector_test_bits_loop, _##isa##_int_movemask) \
+    _def_vector_float_test (isa, target_name, float_test, wave_bool, _vector_test_loop, _##isa##_float_bools) \
+    _def_vector_float_test (isa, target_name, float_test_bits, uint64_t, _vector_test_bits_loop, _##isa##_float_movemask)
+
+#define _sse2_int_movemask(mask) _mm_movemask_ps ((__m128) (mask))
+#define _sse2_float_movemask(mask) _mm_movemask_pd ((__m128d) (mask))
+#define _avx2_int_movemask(mask) _mm256_movemask_ps ((__m256) (mask))
+#define _avx2_float_movemask(mask) _mm256_movemask_pd ((__m256d) (mask))
+#define _avx512_int_movemask(mask) _mm512_test_epi32_mask ((__m512i) (mask), (__m512i) (mask))
+#define _avx512_float_movemask(mask) _mm512_test_epi64_mask ((__m512i) (mask), (__m512i) (mask))
+
+_def_vector_kernels (sse2, "sse2", 16, _mm_sqrt_pd)
+_def_vector_kernels (avx2, "avx2", 32, _mm256_sqrt_pd)
+_def_vector_kernels (avx512, "avx512f", 64, _mm512_sqrt_pd)
+
+#undef _avx512_float_movemask
+#undef _avx512_int_movemask
+#undef _avx2_float_movemask
+#undef _avx2_int_movemask
+#undef _sse2_float_movemask
+#undef _sse2_int_movemask
+#undef _def_vector_kernels
+#undef _def_vector_math
+#undef _def_vector_float_test
+#undef _def_vector_int_test
+#undef _vector_test_bits_loop
+#undef _vector_test_loop
+#undef _vector_binary_loop
+#undef _vector_unary_padded_loop
+#undef _vector_unary_loop
+#undef _ROUND_SHIFTER
+#undef _splat
+#undef _float_equals
+#undef _float_is_nan
+#undef _float_abs
+#undef _float_select
+#undef _select
+#undef _store
+#undef _load
+#undef _EXPONENT_SET
+#undef _SIGN_CLEAR
+/** \endcond Doxygen ignore. */
+
+#endif /* WAVE_KERNELS_X86 */
+
+////////////////////////////////////////////////////////////////////////////////
+// Dispatch.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Kernels of an instruction set.
+ */
+typedef struct _kernels
+{
+    void (* _int_unary) (wave_operator, const wave_int *, wave_int *, size_t);                          /**< Unary int kernel. */
+    void (* _float_unary) (wave_operator, const wave_float *, wave_float *, size_t);                    /**< Unary float kernel. */
+    void (* _int_binary) (wave_operator, const wave_int *, const wave_int *, wave_int *, size_t);       /**< Binary int kernel. */
+    void (* _float_binary) (wave_operator, const wave_float *, const wave_float *, wave_float *, size_t);/**< Binary float kernel. */
+    void (* _int_test) (wave_operator, const wave_int *, const wave_int *, wave_bool *, size_t);        /**< Int test kernel. */
+    void (* _float_test) (wave_operator, const wave_float *, const wave_float *, wave_bool *, size_t);  /**< Float test kernel. */
+    void (* _int_test_bits) (wave_operator, const wave_int *, const wave_int *, uint64_t *, size_t);    /**< Int test kernel, to a bitset. */
+    void (* _float_test_bits) (wave_operator, const wave_float *, const wave_float *, uint64_t *, size_t);/**< Float test kernel, to a bitset. */
+} _kernels;
+
+/** \cond Doxygen ignore. */
+#define _kernels_entry(isa) \
+    { \
+        ._int_unary = _##isa##_int_unary, \
+        ._float_unary = _##isa##_float_unary, \
+        ._int_binary = _##isa##_int_binary, \
+        ._float_binary = _##isa##_float_binary, \
+        ._int_test = _##isa##_int_test, \
+        ._float_test = _##isa##_float_test, \
+        ._int_test_bits = _##isa##_int_test_bits, \
+        ._float_test_bits = _##isa##_float_test_bits, \
+    }
+/** \endcond Doxygen ignore. */
+
+/**
+ * \brief Tab of kernels.
+ */
+static const _kernels _kernels_tab [] =
+{
+    [WAVE_KERNELS_SCALAR] = _kernels_entry (scalar),
+#ifdef WAVE_KERNELS_X86
+    [WAVE_KERNELS_SSE2] = _kernels_entry (sse2),
+    [WAVE_KERNELS_AVX2] = _kernels_entry (avx2),
+    [WAVE_KERNELS_AVX512] = _kernels_entry (avx512),
+#endif
+};
+
+/** \cond Doxygen ignore. */
+#undef _kernels_entry
+/** \endcond Doxygen ignore. */
+
+/**
+ * \brief Current level, chosen on the first use of the kernels.
+ */
+static wave_kernels_level _current_level = WAVE_KERNELS_UNKNOWN;
+
+static inline const _kernels * _current_kernels (void)
+{
+    return & _kernels_tab[wave_kernels_get_level ()];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Instruction set selection.
+////////////////////////////////////////////////////////////////////////////////
+
+wave_kernels_level wave_kernels_get_best_level (void)
+{
+    wave_kernels_level level = WAVE_KERNELS_SCALAR;
+#ifdef WAVE_KERNELS_X86
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx512f"))
+        level = WAVE_KERNELS_AVX512;
+    else if (__builtin_cpu_supports ("avx2"))
+        level = WAVE_KERNELS_AVX2;
+    else if (__builtin_cpu_supports ("sse2"))
+        level = WAVE_KERNELS_SSE2;
+#endif
+    return level;
+}
+
+wave_kernels_level wave_kernels_get_level (void)
+{
+    wave_kernels_level level = __atomic_load_n (& _current_level, __ATOMIC_RELAXED);
+    if (level == WAVE_KERNELS_UNKNOWN)
+    {
+        level = wave_kernels_get_best_level ();
+        __atomic_store_n (& _current_level, level, __ATOMIC_RELAXED);
+    }
+    return level;
+}
+
+void wave_kernels_set_level (wave_kernels_level level)
+{
+    wave_kernels_level best = wave_kernels_get_best_level ();
+    if (level > best)
+        level = best;
+    __atomic_store_n (& _current_level, level, __ATOMIC_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties.
+////////////////////////////////////////////////////////////////////////////////
+
+bool wave_kernels_has_int_unary (wave_operator op)
+{
+    return op <= WAVE_OP_UNARY_DECREMENT;
+}
+
+bool wave_kernels_has_float_unary (wave_operator op)
+{
+    switch (op)
+    {
+        case WAVE_OP_UNARY_PLUS:
+        case WAVE_OP_UNARY_MINUS:
+        case WAVE_OP_UNARY_INCREMENT:
+        case WAVE_OP_UNARY_DECREMENT:
+        case WAVE_OP_UNARY_SQRT:
+        case WAVE_OP_UNARY_SIN:
+        case WAVE_OP_UNARY_COS:
+        case WAVE_OP_UNARY_LOG:
+        case WAVE_OP_UNARY_EXP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool wave_kernels_has_int_binary (wave_operator op)
+{
+    return op >= WAVE_OP_BINARY_PLUS && op <= WAVE_OP_BINARY_LESSER;
+}
+
+bool wave_kernels_has_float_binary (wave_operator op)
+{
+    return op >= WAVE_OP_BINARY_PLUS && op <= WAVE_OP_BINARY_LESSER;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+void wave_kernels_int_unary (wave_operator op, const wave_int * operand, wave_int * result, size_t size)
+{
+    _current_kernels ()->_int_unary (op, operand, result, size);
+}
+
+void wave_kernels_float_unary (wave_operator op, const wave_float * operand, wave_float * result, size_t size)
+{
+    _current_kernels ()->_float_unary (op, operand, result, size);
+}
+
+void wave_kernels_int_binary (wave_operator op, const wave_int * left, const wave_int * right, wave_int * result, size_t size)
+{
+    _current_kernels ()->_int_binary (op, left, right, result, size);
+}
+
+void wave_kernels_float_binary (wave_operator op, const wave_float * left, const wave_float * right, wave_float * result, size_t size)
+{
+    _current_kernels ()->_float_binary (op, left, right, result, size);
+}
+
+void wave_kernels_int_test (wave_operator op, const wave_int * left, const wave_int * right, wave_bool * result, size_t size)
+{
+    _current_kernels ()->_int_test (op, left, right, result, size);
+}
+
+void wave_kernels_float_test (wave_operator op, const wave_float * left, const wave_float * right, wave_bool * result, size_t size)
+{
+    _current_kernels ()->_float_test (op, left, right, result, size);
+}
+
+void wave_kernels_int_test_bits (wave_operator op, const wave_int * left, const wave_int * right, uint64_t * result, size_t size)
+{
+    _current_kernels ()->_int_test_bits (op, left, right, result, size);
+}
+
+void wave_kernels_float_test_bits (wave_operator op, const wave_float * left, const wave_float * right, uint64_t * result, size_t size)
+{
+    _current_kernels ()->_float_test_bits (op, left, right, result, size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Broadcast kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of copies of a value given at once to the binary kernels.
+ *
+ * The broadcast kernels feed the binary kernels with a small tab of copies of
+ * their value, which stays in the L1 cache: they read as much memory as an
+ * unary kernel, and give exactly the results of the binary kernels. It is a
+ * multiple of WAVE_KERNELS_WORD_BITS, so that the chunks of a bitset start on
+ * whole words.
+ */
+#define _BROADCAST_CHUNK 256
+
+/** \cond Doxygen ignore. */
+#define _def_broadcast_kernels(name, kernel, value_type, result_type, per_result) \
+    void wave_kernels_##name##_left (wave_operator op, value_type left, const value_type * right, result_type * result, size_t size) \
+    { \
+        const _kernels * const kernels = _current_kernels (); \
+        value_type copies[_BROADCAST_CHUNK]; \
+        for (size_t i = 0; i < _BROADCAST_CHUNK && i < size; ++i) \
+            copies[i] = left; \
+        for (size_t i = 0; i < size; i += _BROADCAST_CHUNK) \
+            kernels->kernel (op, copies, right + i, result + i / (per_result), size - i < _BROADCAST_CHUNK ? size - i : _BROADCAST_CHUNK); \
+    } \
+    \
+    void wave_kernels_##name##_right (wave_operator op, const value_type * left, value_type right, result_type * result, size_t size) \
+    { \
+        const _kernels * const kernels = _current_kernels (); \
+        value_type copies[_BROADCAST_CHUNK]; \
+        for (size_t i = 0; i < _BROADCAST_CHUNK && i < size; ++i) \
+            copies[i] = right; \
+        for (size_t i = 0; i < size; i += _BROADCAST_CHUNK) \
+            kernels->kernel (op, left + i, copies, result + i / (per_result), size - i < _BROADCAST_CHUNK ? size - i : _BROADCAST_CHUNK); \
+    }
+
+_def_broadcast_kernels (int_broadcast, _int_binary, wave_int, wave_int, 1)
+_def_broadcast_kernels (float_broadcast, _float_binary, wave_float, wave_float, 1)
+_def_broadcast_kernels (int_test_broadcast, _int_test, wave_int, wave_bool, 1)
+_def_broadcast_kernels (float_test_broadcast, _float_test, wave_float, wave_bool, 1)
+_def_broadcast_kernels (int_test_bits_broadcast, _int_test_bits, wave_int, uint64_t, WAVE_KERNELS_WORD_BITS)
+_def_broadcast_kernels (float_test_bits_broadcast, _float_test_bits, wave_float, uint64_t, WAVE_KERNELS_WORD_BITS)
+
+#undef _def_broadcast_kernels
+/** \endcond Doxygen ignore. */
+
+////////////////////////////////////////////////////////////////////////////////
+// Bitset kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Truth table of a binary operation on wave_bool values, as words.
+ *
+ * Each mask is either all ones or all zeros, according to the result of the
+ * operation for one combination of the operands: a word of results is then
+ * computed from 64 pairs of operands at once, whatever the operation.
+ */
+typedef struct _truth_table
+{
+    uint64_t _both;         /**< Results when both operands are true. */
+    uint64_t _left;         /**< Results when only the left operand is true. */
+    uint64_t _right;        /**< Results when only the right operand is true. */
+    uint64_t _neither;      /**< Results when both operands are false. */
+} _truth_table;
+
+static inline uint64_t _word_of (wave_bool b)
+{
+    return b ? UINT64_MAX : 0;
+}
+
+static inline _truth_table _truth_table_of (wave_operator op)
+{
+    wave_bool (* const f) (wave_bool, wave_bool) = _binary_bool[op];
+    return (_truth_table)
+    {
+        ._both = _word_of (f (true, true)),
+        ._left = _word_of (f (true, false)),
+        ._right = _word_of (f (false, true)),
+        ._neither = _word_of (f (false, false)),
+    };
+}
+
+static inline uint64_t _truth_table_apply (const _truth_table * table, uint64_t a, uint64_t b)
+{
+    return (a & b & table->_both) | (a & ~ b & table->_left)
+        | (~ a & b & table->_right) | (~ (a | b) & table->_neither);
+}
+
+/**
+ * \brief Clear the bits past the last element of a bitset.
+ * \param bits Bitset.
+ * \param size Number of elements.
+ */
+static inline void _clear_padding (uint64_t * bits, size_t size)
+{
+    if (size % WAVE_KERNELS_WORD_BITS != 0)
+        bits[size / WAVE_KERNELS_WORD_BITS] &= (UINT64_C (1) << (size % WAVE_KERNELS_WORD_BITS)) - 1;
+}
+
+bool wave_kernels_has_bool_binary (wave_operator op)
+{
+    return (op >= WAVE_OP_BINARY_EQUALS && op <= WAVE_OP_BINARY_LESSER)
+        || op == WAVE_OP_BINARY_AND || op == WAVE_OP_BINARY_OR;
+}
+
+void wave_kernels_bool_not (const uint64_t * operand, uint64_t * result, size_t size)
+{
+    for (size_t i = 0; i < WAVE_KERNELS_WORDS (size); ++i)
+        result[i] = ~ operand[i];
+    _clear_padding (result, size);
+}
+
+void wave_kernels_bool_binary (wave_operator op, const uint64_t * left, const uint64_t * right, uint64_t * result, size_t size)
+{
+    const _truth_table table = _truth_table_of (op);
+    for (size_t i = 0; i < WAVE_KERNELS_WORDS (size); ++i)
+        result[i] = _truth_table_apply (& table, left[i], right[i]);
+    _clear_padding (result, size);
+}
+
+void wave_kernels_bool_broadcast_left (wave_operator op, wave_bool left, const uint64_t * right, uint64_t * result, size_t size)
+{
+    const _truth_table table = _truth_table_of (op);
+    const uint64_t a = _word_of (left);
+    for (size_t i = 0; i < WAVE_KERNELS_WORDS (size); ++i)
+        result[i] = _truth_table_apply (& table, a, right[i]);
+    _clear_padding (result, size);
+}
+
+void wave_kernels_bool_broadcast_right (wave_operator op, const uint64_t * left, wave_bool right, uint64_t * result, size_t size)
+{
+    const _truth_table table = _truth_table_of (op);
+    const uint64_t b = _word_of (right);
+    for (size_t i = 0; i < WAVE_KERNELS_WORDS (size); ++i)
+        result[i] = _truth_table_apply (& table, left[i], b);
+    _clear_padding (result, size);
+}
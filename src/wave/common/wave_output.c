@@ -0,0 +1,497 @@
+/**
+ * \file wave_output.c
+ * \brief Wave output engine.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "wave/common/wave_output.h"
+#include "wave/common/wave_kernels.h"
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sysexits.h>
+#include <sys/uio.h>
+#include <omp.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Size of the buffers which have a file descriptor.
+ */
+static const size_t _WAVE_OUTPUT_BLOCK = 1 << 20;
+
+/**
+ * \brief Minimal size of the buffers which grow.
+ */
+static const size_t _WAVE_OUTPUT_MIN = 1 << 12;
+
+/**
+ * \brief Number of elements of the chunks formatted in parallel.
+ */
+static const size_t _WAVE_OUTPUT_CHUNK = 1 << 14;
+
+/**
+ * \brief Maximal number of buffers written by a single system call.
+ */
+#define _WAVE_OUTPUT_VECTORS 64
+
+/**
+ * \brief Standard output buffer, shared by all the threads.
+ *
+ * Inside parallel regions, it is only used in the \c wave_output_stdout
+ * critical section.
+ */
+static wave_output_buffer _WAVE_OUTPUT = { ._data = NULL, ._size = 0, ._used = 0, ._fd = STDOUT_FILENO };
+
+/**
+ * \brief Whether _flush_all() is registered at exit.
+ */
+static bool _WAVE_OUTPUT_REGISTERED = false;
+
+/**
+ * \brief Whether the standard output is a terminal: 1 if so, 0 if not, -1 if unknown yet.
+ */
+static int _WAVE_OUTPUT_TERMINAL = -1;
+
+/**
+ * \brief Whether writing failed, in which case nothing is written at exit.
+ */
+static bool _WAVE_OUTPUT_FAILED = false;
+
+/**
+ * \brief Exit because of a lack of memory.
+ */
+static void _memory_error (void)
+{
+    fprintf (stderr, "Error: not enough memory to print the output.\n");
+    exit (EX_OSERR);
+}
+
+/**
+ * \brief Exit because of a write error.
+ */
+static void _write_error (void)
+{
+    _WAVE_OUTPUT_FAILED = true;
+    fprintf (stderr, "Error: cannot write the output: %s.\n", strerror (errno));
+    exit (EX_IOERR);
+}
+
+/**
+ * \brief Make room in a buffer.
+ * \param buffer Buffer.
+ * \param size Number of bytes needed.
+ * \return Where to write the bytes.
+ *
+ * The bytes are committed by adding their number to \c _used.
+ */
+static char * _reserve (wave_output_buffer * const buffer, size_t size)
+{
+    if (buffer->_size - buffer->_used < size)
+    {
+        if (buffer->_fd >= 0 && buffer->_used > 0)
+            wave_output_buffer_flush (buffer);
+
+        if (buffer->_size - buffer->_used < size)
+        {
+            size_t new_size = buffer->_size > 0 ? buffer->_size : buffer->_fd >= 0 ? _WAVE_OUTPUT_BLOCK : _WAVE_OUTPUT_MIN;
+            while (new_size - buffer->_used < size)
+                new_size *= 2;
+            char * new_data = realloc (buffer->_data, new_size);
+            if (new_data == NULL)
+                _memory_error ();
+            buffer->_data = new_data;
+            buffer->_size = new_size;
+        }
+    }
+
+    return buffer->_data + buffer->_used;
+}
+
+/**
+ * \brief Append a character to a buffer.
+ * \param buffer Buffer.
+ * \param c Character.
+ */
+static inline void _append_char (wave_output_buffer * const buffer, char c)
+{
+    * _reserve (buffer, 1) = c;
+    buffer->_used++;
+}
+
+/**
+ * \brief Append a boolean to a buffer.
+ * \param buffer Buffer.
+ * \param b Boolean.
+ */
+static inline void _append_bool (wave_output_buffer * const buffer, wave_bool b)
+{
+    if (b)
+        wave_output_buffer_append (buffer, "true", 4);
+    else
+        wave_output_buffer_append (buffer, "false", 5);
+}
+
+/**
+ * \brief Get the number of elements of a collection.
+ * \param data Data of interest.
+ * \return The number of elements, or 0 if the data is not a collection.
+ */
+static inline size_t _collection_size (const wave_data * const data)
+{
+    switch (wave_data_get_type (data))
+    {
+        case WAVE_DATA_SEQ:
+        case WAVE_DATA_PAR:
+            return data->_content._collection._size;
+        case WAVE_DATA_PAR_INT:
+        case WAVE_DATA_PAR_FLOAT:
+        case WAVE_DATA_PAR_BOOL:
+            return data->_content._packed._size;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * \brief Append a range of elements of a collection to a buffer.
+ * \param buffer Buffer.
+ * \param data Data holding the collection of interest.
+ * \param from Index of the first element.
+ * \param to Index following the last element.
+ *
+ * Each element is preceded by the separator of the collection, except the
+ * first element of the collection. The unboxed collections are printed
+ * exactly like parallel collections of atoms: the booleans of a bitset are
+ * read from its words as they are printed.
+ */
+static void _append_range (wave_output_buffer * const buffer, const wave_data * const data, size_t from, size_t to)
+{
+    wave_data_type t = wave_data_get_type (data);
+    const char * separator = t == WAVE_DATA_SEQ ? ";" : "||";
+    size_t separator_length = t == WAVE_DATA_SEQ ? 1 : 2;
+
+    for (size_t i = from; i < to; ++i)
+    {
+        if (i > 0)
+            wave_output_buffer_append (buffer, separator, separator_length);
+
+        if (t == WAVE_DATA_PAR_INT)
+            wave_output_buffer_append_int (buffer, data->_content._packed._tab._ints[i]);
+        else if (t == WAVE_DATA_PAR_FLOAT)
+            wave_output_buffer_append_float (buffer, data->_content._packed._tab._floats[i]);
+        else if (t == WAVE_DATA_PAR_BOOL)
+            _append_bool (buffer, (data->_content._packed._tab._bits[i / WAVE_KERNELS_WORD_BITS] >> (i % WAVE_KERNELS_WORD_BITS) & 1) != 0);
+        else
+            wave_output_buffer_append_data (buffer, & data->_content._collection._tab[i]);
+    }
+}
+
+/**
+ * \brief Append a collection to a buffer.
+ * \param buffer Buffer.
+ * \param data Data holding the collection of interest.
+ */
+static void _append_collection (wave_output_buffer * const buffer, const wave_data * const data)
+{
+    _append_char (buffer, '(');
+    _append_range (buffer, data, 0, _collection_size (data));
+    _append_char (buffer, ')');
+}
+
+/**
+ * \brief Print a large collection and a newline to the file descriptor of a buffer.
+ * \param buffer Buffer.
+ * \param data Data holding the collection of interest.
+ * \retval true if the collection was printed.
+ * \retval false if it is too small, or if several threads can not be used.
+ * \pre The caller is not in a parallel region.
+ *
+ * The elements are split in chunks of #_WAVE_OUTPUT_CHUNK elements, which
+ * are formatted into their own buffers by several threads. The buffers are
+ * then written in order, a batch at a time, so that only a few chunks are in
+ * memory at the same time.
+ */
+static bool _print_parallel (wave_output_buffer * const buffer, const wave_data * const data)
+{
+    size_t size = _collection_size (data);
+    int threads = omp_get_max_threads ();
+    if (size < 2 * _WAVE_OUTPUT_CHUNK || threads < 2 || omp_in_parallel ())
+        return false;
+
+    size_t chunk_count = (size + _WAVE_OUTPUT_CHUNK - 1) / _WAVE_OUTPUT_CHUNK;
+    size_t batch = 4 * (size_t) threads;
+    if (batch > chunk_count)
+        batch = chunk_count;
+
+    wave_output_buffer * chunks = malloc (batch * sizeof * chunks);
+    if (chunks == NULL)
+        return false;
+    for (size_t c = 0; c < batch; ++c)
+        wave_output_buffer_init (& chunks[c], -1);
+
+    /* What was printed before, by any thread, goes first. */
+    if (buffer->_used > 0)
+        wave_output_buffer_flush (buffer);
+
+    for (size_t first = 0; first < chunk_count; first += batch)
+    {
+        size_t count = chunk_count - first < batch ? chunk_count - first : batch;
+
+        #pragma omp parallel for schedule (dynamic, 1)
+        for (size_t c = 0; c < count; ++c)
+        {
+            size_t chunk = first + c;
+            size_t from = chunk * _WAVE_OUTPUT_CHUNK;
+            size_t to = from + _WAVE_OUTPUT_CHUNK < size ? from + _WAVE_OUTPUT_CHUNK : size;
+
+            chunks[c]._used = 0;
+            if (chunk == 0)
+                _append_char (& chunks[c], '(');
+            _append_range (& chunks[c], data, from, to);
+            if (chunk == chunk_count - 1)
+                wave_output_buffer_append (& chunks[c], ")\n", 2);
+        }
+
+        wave_output_write (buffer->_fd, chunks, count);
+    }
+
+    for (size_t c = 0; c < batch; ++c)
+        wave_output_buffer_free (& chunks[c]);
+    free (chunks);
+    return true;
+}
+
+/**
+ * \brief Write the standard output buffer.
+ *
+ * Called at exit.
+ */
+static void _flush_all (void)
+{
+    if (! _WAVE_OUTPUT_FAILED && _WAVE_OUTPUT._used > 0)
+        wave_output_buffer_flush (& _WAVE_OUTPUT);
+}
+
+/**
+ * \brief Get the standard output buffer.
+ * \return The buffer.
+ *
+ * The first call registers _flush_all() at exit.
+ * \pre The caller is in the \c wave_output_stdout critical section, or not
+ * in a parallel region.
+ */
+static inline wave_output_buffer * _shared_buffer (void)
+{
+    if (! _WAVE_OUTPUT_REGISTERED)
+    {
+        atexit (_flush_all);
+        _WAVE_OUTPUT_REGISTERED = true;
+    }
+    return & _WAVE_OUTPUT;
+}
+
+/**
+ * \brief Append a data and a newline to the standard output buffer.
+ * \param buffer Standard output buffer.
+ * \param data Data of interest.
+ *
+ * The buffer is written after each data if the standard output is a terminal.
+ */
+static void _print (wave_output_buffer * const buffer, const wave_data * const data)
+{
+    wave_output_buffer_append_data (buffer, data);
+    _append_char (buffer, '\n');
+
+    if (_WAVE_OUTPUT_TERMINAL < 0)
+        _WAVE_OUTPUT_TERMINAL = isatty (STDOUT_FILENO);
+    if (_WAVE_OUTPUT_TERMINAL)
+        wave_output_buffer_flush (buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Buffers.
+////////////////////////////////////////////////////////////////////////////////
+
+void wave_output_buffer_init (wave_output_buffer * const buffer, int fd)
+{
+    * buffer = (wave_output_buffer) { ._data = NULL, ._size = 0, ._used = 0, ._fd = fd };
+}
+
+void wave_output_buffer_free (wave_output_buffer * const buffer)
+{
+    free (buffer->_data);
+    * buffer = (wave_output_buffer) { ._data = NULL, ._size = 0, ._used = 0, ._fd = buffer->_fd };
+}
+
+void wave_output_buffer_append (wave_output_buffer * const buffer, const char * const bytes, size_t size)
+{
+    /* Large blocks are not copied into buffers which would be written anyway. */
+    if (buffer->_fd >= 0 && size >= _WAVE_OUTPUT_BLOCK)
+    {
+        wave_output_buffer_flush (buffer);
+        wave_output_buffer block = { ._data = (char *) bytes, ._size = size, ._used = size, ._fd = buffer->_fd };
+        wave_output_write (buffer->_fd, & block, 1);
+        return;
+    }
+
+    memcpy (_reserve (buffer, size), bytes, size);
+    buffer->_used += size;
+}
+
+void wave_output_buffer_append_int (wave_output_buffer * const buffer, wave_int i)
+{
+    buffer->_used += wave_int_to_chars (_reserve (buffer, WAVE_INT_CHARS_MAX), i);
+}
+
+void wave_output_buffer_append_float (wave_output_buffer * const buffer, wave_float f)
+{
+    buffer->_used += wave_float_to_chars (_reserve (buffer, WAVE_FLOAT_CHARS_MAX), f);
+}
+
+void wave_output_buffer_append_data (wave_output_buffer * const buffer, const wave_data * const data)
+{
+    switch (wave_data_get_type (data))
+    {
+        case WAVE_DATA_INT:
+            wave_output_buffer_append_int (buffer, data->_content._int);
+            break;
+        case WAVE_DATA_FLOAT:
+            wave_output_buffer_append_float (buffer, data->_content._float);
+            break;
+        case WAVE_DATA_BOOL:
+            _append_bool (buffer, data->_content._bool);
+            break;
+        case WAVE_DATA_CHAR:
+        {
+            char * out = _reserve (buffer, 3);
+            out[0] = '\'';
+            out[1] = data->_content._char;
+            out[2] = '\'';
+            buffer->_used += 3;
+            break;
+        }
+        case WAVE_DATA_STRING:
+        {
+            size_t length;
+            const wave_char * s = wave_data_get_characters (data, & length);
+            _append_char (buffer, '"');
+            wave_output_buffer_append (buffer, s, length);
+            _append_char (buffer, '"');
+            break;
+        }
+        case WAVE_DATA_SEQ:
+        case WAVE_DATA_PAR:
+        case WAVE_DATA_PAR_INT:
+        case WAVE_DATA_PAR_FLOAT:
+        case WAVE_DATA_PAR_BOOL:
+            _append_collection (buffer, data);
+            break;
+        default:
+            break;
+    }
+}
+
+void wave_output_buffer_flush (wave_output_buffer * const buffer)
+{
+    wave_output_write (buffer->_fd, buffer, 1);
+    buffer->_used = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writing.
+////////////////////////////////////////////////////////////////////////////////
+
+void wave_output_write (int fd, const wave_output_buffer buffers[], size_t count)
+{
+    #pragma omp critical (wave_output)
+    {
+        size_t next = 0;
+        size_t offset = 0;
+        while (next < count)
+        {
+            struct iovec vectors[_WAVE_OUTPUT_VECTORS];
+            int vector_count = 0;
+            for (size_t i = next; i < count && vector_count < _WAVE_OUTPUT_VECTORS; ++i)
+            {
+                size_t skip = i == next ? offset : 0;
+                if (buffers[i]._used > skip)
+                    vectors[vector_count++] = (struct iovec)
+                    {
+                        .iov_base = buffers[i]._data + skip,
+                        .iov_len = buffers[i]._used - skip,
+                    };
+            }
+
+            ssize_t written = 0;
+            if (vector_count > 0)
+            {
+                written = writev (fd, vectors, vector_count);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    _write_error ();
+                }
+            }
+
+            /* Skip the bytes written, and the empty buffers. */
+            size_t left = (size_t) written;
+            while (next < count && left >= buffers[next]._used - offset)
+            {
+                left -= buffers[next]._used - offset;
+                offset = 0;
+                next++;
+            }
+            offset += left;
+        }
+    }
+}
+
+void wave_output_print (const wave_data * const data)
+{
+    /* The threads print in turn, so that the values keep the order in which
+     * they are printed.
+     */
+    if (omp_in_parallel ())
+    {
+        #pragma omp critical (wave_output_stdout)
+        _print (_shared_buffer (), data);
+    }
+    else if (! _print_parallel (_shared_buffer (), data))
+        _print (_shared_buffer (), data);
+}
+
+void wave_output_flush (void)
+{
+    #pragma omp critical (wave_output_stdout)
+    if (_WAVE_OUTPUT._used > 0)
+        wave_output_buffer_flush (& _WAVE_OUTPUT);
+}
@@ -60,25 +60,51 @@ static char _path_symbol[] =
     [PATH_CSQBRACKET] = ']',
 };
 
-static wave_data* _goto_previous (wave_data* data){
-    return data-1;
+/**
+ * \brief Maximal number of nested collections a path can go down into.
+ */
+#define _PATH_DEPTH_MAX 64
+
+/**
+ * \brief Position reached by a path.
+ *
+ * The data do not know their parent collection: the cursor keeps the
+ * collections it went down into, so that going up is a simple pop.
+ */
+typedef struct _path_cursor {
+    wave_data* data;                        /**< Current data. */
+    wave_data* parents[_PATH_DEPTH_MAX];    /**< Collections containing the current data. */
+    size_t depth;                           /**< Number of parents. */
+} _path_cursor;
+
+static wave_data* _goto_previous (_path_cursor* cursor){
+    cursor->data = cursor->data - 1;
+    return cursor->data;
 }
 
-static wave_data* _goto_next (wave_data* data){
-    return data+1;
+static wave_data* _goto_next (_path_cursor* cursor){
+    cursor->data = cursor->data + 1;
+    return cursor->data;
 }
 
-static wave_data* _goto_up (wave_data* data){
-    return data->up;
+static wave_data* _goto_up (_path_cursor* cursor){
+    if(cursor->depth == 0)
+        return NULL;
+    cursor->data = cursor->parents[--cursor->depth];
+    return cursor->data;
 }
 
-static wave_data* _goto_down (wave_data* data){
-    if(data->_type == WAVE_DATA_SEQ || data->_type == WAVE_DATA_PAR)
-        return data->_content._collection._tab;
+static wave_data* _goto_down (_path_cursor* cursor){
+    wave_data* data = cursor->data;
+    if((data->_type == WAVE_DATA_SEQ || data->_type == WAVE_DATA_PAR) && cursor->depth < _PATH_DEPTH_MAX){
+        cursor->parents[cursor->depth++] = data;
+        cursor->data = data->_content._collection._tab;
+        return cursor->data;
+    }
     return NULL;
 }
 
-static wave_data* (* _follow_me []) (wave_data*) =
+static wave_data* (* _follow_me []) (_path_cursor*) =
 {
     [PATH_PREVIOUS  ] = _goto_previous,
     [PATH_NEXT      ] = _goto_next,
@@ -30,12 +30,12 @@
  */
 #include "wave/common/wave_types.h"
 
+#include <stdint.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 // static utilities
 ////////////////////////////////////////////////////////////////////////////////
 
-static const double _WAVE_FLOAT_EPSILON = 1.0e-5;
-
 static inline wave_string _wave_string_alloc (size_t length)
 {
     return calloc (length + 1, sizeof (wave_char));
@@ -47,6 +47,294 @@ static inline void _string_to_lower (char * const s)
         s[i] = (wave_char) tolower (s[i]);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// static utilities for numbers
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Decimal digits of the numbers from 00 to 99.
+ */
+static const char _DIGIT_PAIRS[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * \brief Powers of ten which fit in 64 bits.
+ */
+static const uint64_t _POW10[20] =
+{
+    UINT64_C (1), UINT64_C (10), UINT64_C (100), UINT64_C (1000), UINT64_C (10000),
+    UINT64_C (100000), UINT64_C (1000000), UINT64_C (10000000), UINT64_C (100000000),
+    UINT64_C (1000000000), UINT64_C (10000000000), UINT64_C (100000000000),
+    UINT64_C (1000000000000), UINT64_C (10000000000000), UINT64_C (100000000000000),
+    UINT64_C (1000000000000000), UINT64_C (10000000000000000),
+    UINT64_C (100000000000000000), UINT64_C (1000000000000000000),
+    UINT64_C (10000000000000000000),
+};
+
+/**
+ * \brief Powers of ten which are exact wave_float values.
+ */
+static const wave_float _EXACT_POW10[23] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/**
+ * \brief Significands of the powers of ten \f$ 10^{-348 + 8i} \f$, rounded to 64 bits.
+ */
+static const uint64_t _CACHED_POWERS_F[87] =
+{
+    UINT64_C (0xfa8fd5a0081c0288), UINT64_C (0xbaaee17fa23ebf76), UINT64_C (0x8b16fb203055ac76),
+    UINT64_C (0xcf42894a5dce35ea), UINT64_C (0x9a6bb0aa55653b2d), UINT64_C (0xe61acf033d1a45df),
+    UINT64_C (0xab70fe17c79ac6ca), UINT64_C (0xff77b1fcbebcdc4f), UINT64_C (0xbe5691ef416bd60c),
+    UINT64_C (0x8dd01fad907ffc3c), UINT64_C (0xd3515c2831559a83), UINT64_C (0x9d71ac8fada6c9b5),
+    UINT64_C (0xea9c227723ee8bcb), UINT64_C (0xaecc49914078536d), UINT64_C (0x823c12795db6ce57),
+    UINT64_C (0xc21094364dfb5637), UINT64_C (0x9096ea6f3848984f), UINT64_C (0xd77485cb25823ac7),
+    UINT64_C (0xa086cfcd97bf97f4), UINT64_C (0xef340a98172aace5), UINT64_C (0xb23867fb2a35b28e),
+    UINT64_C (0x84c8d4dfd2c63f3b), UINT64_C (0xc5dd44271ad3cdba), UINT64_C (0x936b9fcebb25c996),
+    UINT64_C (0xdbac6c247d62a584), UINT64_C (0xa3ab66580d5fdaf6), UINT64_C (0xf3e2f893dec3f126),
+    UINT64_C (0xb5b5ada8aaff80b8), UINT64_C (0x87625f056c7c4a8b), UINT64_C (0xc9bcff6034c13053),
+    UINT64_C (0x964e858c91ba2655), UINT64_C (0xdff9772470297ebd), UINT64_C (0xa6dfbd9fb8e5b88f),
+    UINT64_C (0xf8a95fcf88747d94), UINT64_C (0xb94470938fa89bcf), UINT64_C (0x8a08f0f8bf0f156b),
+    UINT64_C (0xcdb02555653131b6), UINT64_C (0x993fe2c6d07b7fac), UINT64_C (0xe45c10c42a2b3b06),
+    UINT64_C (0xaa242499697392d3), UINT64_C (0xfd87b5f28300ca0e), UINT64_C (0xbce5086492111aeb),
+    UINT64_C (0x8cbccc096f5088cc), UINT64_C (0xd1b71758e219652c), UINT64_C (0x9c40000000000000),
+    UINT64_C (0xe8d4a51000000000), UINT64_C (0xad78ebc5ac620000), UINT64_C (0x813f3978f8940984),
+    UINT64_C (0xc097ce7bc90715b3), UINT64_C (0x8f7e32ce7bea5c70), UINT64_C (0xd5d238a4abe98068),
+    UINT64_C (0x9f4f2726179a2245), UINT64_C (0xed63a231d4c4fb27), UINT64_C (0xb0de65388cc8ada8),
+    UINT64_C (0x83c7088e1aab65db), UINT64_C (0xc45d1df942711d9a), UINT64_C (0x924d692ca61be758),
+    UINT64_C (0xda01ee641a708dea), UINT64_C (0xa26da3999aef774a), UINT64_C (0xf209787bb47d6b85),
+    UINT64_C (0xb454e4a179dd1877), UINT64_C (0x865b86925b9bc5c2), UINT64_C (0xc83553c5c8965d3d),
+    UINT64_C (0x952ab45cfa97a0b3), UINT64_C (0xde469fbd99a05fe3), UINT64_C (0xa59bc234db398c25),
+    UINT64_C (0xf6c69a72a3989f5c), UINT64_C (0xb7dcbf5354e9bece), UINT64_C (0x88fcf317f22241e2),
+    UINT64_C (0xcc20ce9bd35c78a5), UINT64_C (0x98165af37b2153df), UINT64_C (0xe2a0b5dc971f303a),
+    UINT64_C (0xa8d9d1535ce3b396), UINT64_C (0xfb9b7cd9a4a7443c), UINT64_C (0xbb764c4ca7a44410),
+    UINT64_C (0x8bab8eefb6409c1a), UINT64_C (0xd01fef10a657842c), UINT64_C (0x9b10a4e5e9913129),
+    UINT64_C (0xe7109bfba19c0c9d), UINT64_C (0xac2820d9623bf429), UINT64_C (0x80444b5e7aa7cf85),
+    UINT64_C (0xbf21e44003acdd2d), UINT64_C (0x8e679c2f5e44ff8f), UINT64_C (0xd433179d9c8cb841),
+    UINT64_C (0x9e19db92b4e31ba9), UINT64_C (0xeb96bf6ebadf77d9), UINT64_C (0xaf87023b9bf0ee6b),
+};
+
+/**
+ * \brief Binary exponents of the powers of ten of _CACHED_POWERS_F.
+ */
+static const int16_t _CACHED_POWERS_E[87] =
+{
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066,
+};
+
+/**
+ * \brief Floating point value with a 64 bits significand: \f$ f \times 2^e \f$.
+ */
+typedef struct _diy_fp
+{
+    uint64_t _f;    /**< Significand. */
+    int _e;         /**< Binary exponent. */
+} _diy_fp;
+
+/**
+ * \brief Write the digits of an unsigned integer.
+ * \param buffer Storage for the digits, of at least 20 characters.
+ * \param value Value.
+ * \return Number of digits.
+ *
+ * The digits are produced two at a time, from the end.
+ */
+static inline size_t _unsigned_to_chars (char * const buffer, uint64_t value)
+{
+    char digits[20];
+    char * d = digits + sizeof digits;
+
+    while (value >= 100)
+    {
+        d -= 2;
+        memcpy (d, _DIGIT_PAIRS + 2 * (value % 100), 2);
+        value /= 100;
+    }
+    if (value >= 10)
+    {
+        d -= 2;
+        memcpy (d, _DIGIT_PAIRS + 2 * value, 2);
+    }
+    else
+        * -- d = (char) ('0' + value);
+
+    size_t length = (size_t) (digits + sizeof digits - d);
+    memcpy (buffer, d, length);
+    return length;
+}
+
+/**
+ * \brief Multiply two _diy_fp, keeping the 64 upper bits rounded.
+ * \param a First value.
+ * \param b Second value.
+ * \return a * b.
+ */
+static inline _diy_fp _diy_fp_multiply (_diy_fp a, _diy_fp b)
+{
+    const uint64_t mask = UINT64_C (0xffffffff);
+    uint64_t a_high = a._f >> 32, a_low = a._f & mask;
+    uint64_t b_high = b._f >> 32, b_low = b._f & mask;
+    uint64_t high_high = a_high * b_high;
+    uint64_t high_low = a_high * b_low;
+    uint64_t low_high = a_low * b_high;
+    uint64_t low_low = a_low * b_low;
+    uint64_t middle = (low_low >> 32) + (high_low & mask) + (low_high & mask) + (UINT64_C (1) << 31);
+    return (_diy_fp) { ._f = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32), ._e = a._e + b._e + 64 };
+}
+
+/**
+ * \brief Shift a _diy_fp so that the upper bit of its significand is set.
+ * \param x Value, not 0.
+ * \return The normalized value.
+ */
+static inline _diy_fp _diy_fp_normalize (_diy_fp x)
+{
+    while ((x._f & (UINT64_C (1) << 63)) == 0)
+    {
+        x._f <<= 1;
+        x._e--;
+    }
+    return x;
+}
+
+/**
+ * \brief Move the last digit towards the exact value while it stays in the bounds.
+ * \param digits Digits.
+ * \param length Number of digits.
+ * \param delta Distance between the bounds.
+ * \param rest Distance between the digits and the upper bound.
+ * \param ten_kappa Weight of the last digit.
+ * \param distance Distance between the exact value and the upper bound.
+ */
+static inline void _grisu_round (char * const digits, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t distance)
+{
+    while (rest < distance && delta - rest >= ten_kappa
+        && (rest + ten_kappa < distance || distance - rest > rest + ten_kappa - distance))
+    {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+/**
+ * \brief Generate the shortest digits between two bounds.
+ * \param w Scaled exact value.
+ * \param upper Scaled upper bound.
+ * \param delta Distance between the bounds.
+ * \param digits Storage for the digits.
+ * \param length Storage for the number of digits.
+ * \param k Decimal exponent, updated.
+ */
+static void _grisu_digits (_diy_fp w, _diy_fp upper, uint64_t delta, char * const digits, int * const length, int * const k)
+{
+    const int shift = - upper._e;
+    const uint64_t one = UINT64_C (1) << shift;
+    const uint64_t distance = upper._f - w._f;
+    uint32_t integral = (uint32_t) (upper._f >> shift);
+    uint64_t fractional = upper._f & (one - 1);
+
+    int kappa = 1;
+    while (kappa < 10 && integral >= _POW10[kappa])
+        kappa++;
+
+    * length = 0;
+    while (kappa > 0)
+    {
+        uint32_t d = (uint32_t) (integral / _POW10[kappa - 1]);
+        integral = (uint32_t) (integral % _POW10[kappa - 1]);
+        if (d != 0 || * length != 0)
+            digits[(* length)++] = (char) ('0' + d);
+        kappa--;
+
+        uint64_t rest = ((uint64_t) integral << shift) + fractional;
+        if (rest <= delta)
+        {
+            * k += kappa;
+            _grisu_round (digits, * length, delta, rest, _POW10[kappa] << shift, distance);
+            return;
+        }
+    }
+
+    for (;;)
+    {
+        fractional *= 10;
+        delta *= 10;
+        char d = (char) (fractional >> shift);
+        if (d != 0 || * length != 0)
+            digits[(* length)++] = (char) ('0' + d);
+        fractional &= one - 1;
+        kappa--;
+
+        if (fractional < delta)
+        {
+            * k += kappa;
+            _grisu_round (digits, * length, delta, fractional, one, - kappa < 20 ? distance * _POW10[- kappa] : 0);
+            return;
+        }
+    }
+}
+
+/**
+ * \brief Compute the shortest digits of a wave_float with the Grisu2 algorithm.
+ * \param f Value, positive and finite.
+ * \param digits Storage for the digits, of at least 18 characters.
+ * \param length Storage for the number of digits.
+ * \param k Storage for the decimal exponent: f = digits * 10^k.
+ *
+ * The digits always read back as \c f. They are the shortest ones for the
+ * vast majority of the values, and one digit longer otherwise.
+ */
+static void _grisu2 (wave_float f, char * const digits, int * const length, int * const k)
+{
+    const uint64_t hidden_bit = UINT64_C (1) << 52;
+    uint64_t bits;
+    memcpy (& bits, & f, sizeof bits);
+    int biased_exponent = (int) ((bits >> 52) & 0x7ff);
+    uint64_t significand = bits & (hidden_bit - 1);
+
+    _diy_fp v = biased_exponent != 0
+        ? (_diy_fp) { ._f = significand | hidden_bit, ._e = biased_exponent - 1075 }
+        : (_diy_fp) { ._f = significand, ._e = -1074 };
+
+    /* Bounds of the values which round to f. */
+    _diy_fp plus = _diy_fp_normalize ((_diy_fp) { ._f = (v._f << 1) + 1, ._e = v._e - 1 });
+    _diy_fp minus = v._f == hidden_bit
+        ? (_diy_fp) { ._f = (v._f << 2) - 1, ._e = v._e - 2 }
+        : (_diy_fp) { ._f = (v._f << 1) - 1, ._e = v._e - 1 };
+    minus._f <<= minus._e - plus._e;
+    minus._e = plus._e;
+
+    /* Cached power of ten bringing the upper bound in [2^-60, 2^-32]. */
+    double dk = (-61 - plus._e) * 0.30102999566398114 + 347;
+    int ik = (int) dk;
+    if (dk - ik > 0.0)
+        ik++;
+    unsigned int index = (unsigned int) ((ik >> 3) + 1);
+    * k = - (-348 + (int) (index << 3));
+    _diy_fp power = { ._f = _CACHED_POWERS_F[index], ._e = _CACHED_POWERS_E[index] };
+
+    _diy_fp w = _diy_fp_multiply (_diy_fp_normalize (v), power);
+    _diy_fp upper = _diy_fp_multiply (plus, power);
+    _diy_fp lower = _diy_fp_multiply (minus, power);
+    upper._f--;
+    lower._f++;
+    _grisu_digits (w, upper, upper._f - lower._f, digits, length, k);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // wave_bool
 ////////////////////////////////////////////////////////////////////////////////
@@ -136,7 +424,34 @@ wave_int wave_int_from_wave_float (wave_float f)
 
 wave_int wave_int_from_string (const char * const str)
 {
-    return atoi (str);
+    return wave_int_parse (str, NULL);
+}
+
+wave_int wave_int_parse (const char * const str, const char ** const end)
+{
+    const char * s = str;
+    while (isspace ((unsigned char) * s))
+        s++;
+
+    bool negative = * s == '-';
+    if (* s == '-' || * s == '+')
+        s++;
+
+    if (! isdigit ((unsigned char) * s))
+    {
+        if (end != NULL)
+            * end = str;
+        return 0;
+    }
+
+    /* Out of range values wrap around. */
+    unsigned int value = 0;
+    for (; isdigit ((unsigned char) * s); ++s)
+        value = value * 10 + (unsigned int) (* s - '0');
+
+    if (end != NULL)
+        * end = s;
+    return (wave_int) (negative ? 0u - value : value);
 }
 
 wave_int wave_int_unary_plus (wave_int a)
@@ -275,9 +590,20 @@ wave_char wave_char_get (const_wave_string s, wave_int i)
     return wave_string_nth (s, i);
 }
 
+size_t wave_int_to_chars (char * const buffer, wave_int i)
+{
+    if (i < 0)
+    {
+        buffer[0] = '-';
+        return 1 + _unsigned_to_chars (buffer + 1, 0u - (unsigned int) i);
+    }
+    return _unsigned_to_chars (buffer, (unsigned int) i);
+}
+
 void wave_int_fprint (FILE * stream, wave_int i)
 {
-    fprintf (stream, "%d", i);
+    char buffer[WAVE_INT_CHARS_MAX];
+    fwrite (buffer, 1, wave_int_to_chars (buffer, i), stream);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -385,7 +711,7 @@ wave_float wave_float_mod (wave_float a, wave_float b)
 
 wave_bool wave_float_equals (wave_float a, wave_float b)
 {
-    return fabs (a - b) < _WAVE_FLOAT_EPSILON;
+    return fabs (a - b) < WAVE_FLOAT_EPSILON;
 }
 
 wave_bool wave_float_differs (wave_float a, wave_float b)
@@ -415,12 +741,243 @@ wave_bool wave_float_lesser (wave_float a, wave_float b)
 
 wave_float wave_float_from_string (const char * const str)
 {
-    return strtof (str, NULL);
+    return wave_float_parse (str, NULL);
+}
+
+wave_float wave_float_parse (const char * const str, const char ** const end)
+{
+    const char * s = str;
+    bool negative = * s == '-';
+    if (* s == '-' || * s == '+')
+        s++;
+
+    /* Up to 19 significant digits are kept in the significand. */
+    uint64_t significand = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool has_digits = false;
+    bool truncated = false;
+
+    for (; isdigit ((unsigned char) * s); ++s)
+    {
+        has_digits = true;
+        if (digits < 19)
+        {
+            significand = significand * 10 + (uint64_t) (* s - '0');
+            digits += significand != 0;
+        }
+        else
+        {
+            truncated |= * s != '0';
+            exponent++;
+        }
+    }
+
+    if (* s == '.')
+    {
+        for (++s; isdigit ((unsigned char) * s); ++s)
+        {
+            has_digits = true;
+            if (digits < 19)
+            {
+                significand = significand * 10 + (uint64_t) (* s - '0');
+                digits += significand != 0;
+                exponent--;
+            }
+            else
+                truncated |= * s != '0';
+        }
+    }
+
+    if (has_digits && (* s == 'e' || * s == 'E'))
+    {
+        const char * e = s + 1;
+        bool negative_exponent = * e == '-';
+        if (* e == '-' || * e == '+')
+            e++;
+        if (isdigit ((unsigned char) * e))
+        {
+            int value = 0;
+            for (; isdigit ((unsigned char) * e); ++e)
+                if (value < 100000)
+                    value = value * 10 + (* e - '0');
+            exponent += negative_exponent ? - value : value;
+            s = e;
+        }
+    }
+
+    /* The significand and the power of ten are exact, so is a single
+     * multiplication or division. The other cases, as well as the infinite
+     * values, NaN and the hexadecimal values, are left to strtod().
+     */
+    wave_float f;
+    if (has_digits && ! truncated && * s != 'x' && * s != 'X'
+        && significand <= (UINT64_C (1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+        f = (wave_float) significand;
+        f = exponent < 0 ? f / _EXACT_POW10[- exponent] : f * _EXACT_POW10[exponent];
+        if (negative)
+            f = - f;
+    }
+    else
+    {
+        char * strtod_end;
+        f = strtod (str, & strtod_end);
+        s = strtod_end;
+    }
+
+    if (end != NULL)
+        * end = s;
+    return f;
+}
+
+size_t wave_float_to_chars (char * const buffer, wave_float f)
+{
+    uint64_t bits;
+    memcpy (& bits, & f, sizeof bits);
+    unsigned int exponent = (unsigned int) (bits >> 52) & 0x7ff;
+    uint64_t significand = bits & ((UINT64_C (1) << 52) - 1);
+
+    /* The value is m * 2^e: the six decimals are the digits of the fractional
+     * part of m, computed exactly in 64 bits, then rounded half to even. The
+     * infinite values, the values from 2^63 and the values between 2^-21 and
+     * 2^-8, whose fractional part is too long, are left to snprintf().
+     */
+    uint64_t integer = 0;
+    uint64_t fraction = 0;
+    unsigned int shift = 0;
+
+    if (exponent == 0x7ff)
+        return (size_t) snprintf (buffer, WAVE_FLOAT_CHARS_MAX, "%f", f);
+    /* Below 2^-21, the value rounds to 0. */
+    else if (exponent >= 1023 - 21)
+    {
+        int e = (int) exponent - 1075;
+        significand |= UINT64_C (1) << 52;
+        if (e > 10 || e < -60)
+            return (size_t) snprintf (buffer, WAVE_FLOAT_CHARS_MAX, "%f", f);
+        else if (e >= 0)
+            integer = significand << e;
+        else
+        {
+            shift = (unsigned int) - e;
+            integer = significand >> shift;
+            fraction = significand & ((UINT64_C (1) << shift) - 1);
+        }
+    }
+
+    uint64_t decimals = 0;
+    if (shift > 0)
+    {
+        uint64_t mask = (UINT64_C (1) << shift) - 1;
+        for (int i = 0; i < 6; ++i)
+        {
+            fraction *= 10;
+            decimals = decimals * 10 + (fraction >> shift);
+            fraction &= mask;
+        }
+
+        uint64_t half = UINT64_C (1) << (shift - 1);
+        if ((fraction > half || (fraction == half && (decimals & 1) != 0)) && ++decimals == 1000000)
+        {
+            decimals = 0;
+            integer++;
+        }
+    }
+
+    size_t length = 0;
+    if (bits >> 63)
+        buffer[length++] = '-';
+    length += _unsigned_to_chars (buffer + length, integer);
+    buffer[length++] = '.';
+    for (int i = 0; i < 3; ++i)
+    {
+        memcpy (buffer + length + 4 - 2 * (size_t) i, _DIGIT_PAIRS + 2 * (decimals % 100), 2);
+        decimals /= 100;
+    }
+    return length + 6;
+}
+
+size_t wave_float_to_chars_shortest (char * const buffer, wave_float f)
+{
+    size_t length = 0;
+    if (isnan (f))
+    {
+        memcpy (buffer, "nan", 3);
+        return 3;
+    }
+    if (signbit (f))
+    {
+        buffer[length++] = '-';
+        f = - f;
+    }
+    if (isinf (f))
+    {
+        memcpy (buffer + length, "inf", 3);
+        return length + 3;
+    }
+    if (fpclassify (f) == FP_ZERO)
+    {
+        memcpy (buffer + length, "0.0", 3);
+        return length + 3;
+    }
+
+    char digits[20];
+    int count, k;
+    _grisu2 (f, digits, & count, & k);
+
+    /* Position of the decimal point relative to the first digit. */
+    int point = count + k;
+    char * out = buffer + length;
+    if (k >= 0 && point <= 21)
+    {
+        /* 1234e2 -> 123400.0 */
+        memcpy (out, digits, (size_t) count);
+        memset (out + count, '0', (size_t) k);
+        memcpy (out + point, ".0", 2);
+        return length + (size_t) point + 2;
+    }
+    else if (point > 0 && point <= 21)
+    {
+        /* 1234e-2 -> 12.34 */
+        memcpy (out, digits, (size_t) point);
+        out[point] = '.';
+        memcpy (out + point + 1, digits + point, (size_t) (count - point));
+        return length + (size_t) count + 1;
+    }
+    else if (point > -6 && point <= 0)
+    {
+        /* 1234e-6 -> 0.001234 */
+        memcpy (out, "0.", 2);
+        memset (out + 2, '0', (size_t) - point);
+        memcpy (out + 2 - point, digits, (size_t) count);
+        return length + 2 + (size_t) (count - point);
+    }
+
+    /* 1234e30 -> 1.234e33 */
+    size_t n = 0;
+    out[n++] = digits[0];
+    if (count > 1)
+    {
+        out[n++] = '.';
+        memcpy (out + n, digits + 1, (size_t) (count - 1));
+        n += (size_t) (count - 1);
+    }
+    out[n++] = 'e';
+    int exponent = point - 1;
+    if (exponent < 0)
+    {
+        out[n++] = '-';
+        exponent = - exponent;
+    }
+    n += _unsigned_to_chars (out + n, (uint64_t) exponent);
+    return length + n;
 }
 
 void wave_float_fprint (FILE * const stream, wave_float f)
 {
-    fprintf (stream, "%f", f);
+    char buffer[WAVE_FLOAT_CHARS_MAX];
+    fwrite (buffer, 1, wave_float_to_chars_shortest (buffer, f), stream);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
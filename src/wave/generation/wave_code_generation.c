@@ -31,43 +31,25 @@
 
 #include "wave/generation/wave_code_generation.h"
 
+#include <sysexits.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 // Static utilities.
 ////////////////////////////////////////////////////////////////////////////////
 
-/**
- * \brief Concatenate two files.
- * \param destination Destination.
- * \param source Source.
+/* Tabs longer than this are static, so that they do not overflow the stack.
+ * Each phrase function is called once.
  */
-static inline void file_cat (FILE * destination, FILE * source)
-{
-    bool end = false;
-    char buffer[2048];
-
-    while (! end)
-    {
-        int count = 0;
-        fscanf (source, "%2047c%n", buffer, & count);
-        end = count == 0;
-
-        if (! end)
-        {
-            buffer[count] = '\0';
-            fprintf (destination, "%s", buffer);
-        }
-    }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// Static utilities.
-////////////////////////////////////////////////////////////////////////////////
+#define _STACK_TAB_MAX_LENGTH 4096
 
 static inline void wave_code_generation_alloc_collection_tab (FILE * const alloc_file, const wave_collection* collection)
 {
     wave_coordinate * collection_coordinate = wave_collection_get_list_length (collection);
     wave_int_list * collection_index_list = wave_collection_get_full_indexes (collection);
 
+    if (wave_coordinate_is_constant (collection_coordinate)
+        && wave_coordinate_get_constant (collection_coordinate) > _STACK_TAB_MAX_LENGTH)
+        fprintf (alloc_file, "static ");
     fprintf (alloc_file, "wave_data ");
     wave_code_generation_fprint_tab_with_init (alloc_file, collection_index_list, collection_coordinate, "");
     fprintf (alloc_file, ";\n");
@@ -85,6 +67,7 @@ static void wave_code_generation_print_sub_info (FILE * const code_file, const w
 
     wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "._type = ");
     fprintf (code_file, "%s;\n", type_string);
+    wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "._flags = WAVE_DATA_FLAG_NONE;\n");
 
     wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "._content._collection._size = ");
     wave_coordinate_fprint (code_file, collection_length);
@@ -100,122 +83,316 @@ static void wave_code_generation_print_sub_info (FILE * const code_file, const w
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Static utilities for the various types of collections.
+// Static utilities for unboxed collections.
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
- * \brief Generate C source code giving a sequential collection.
+ * \brief Determine whether a parallel collection can be stored unboxed.
+ * \param collection Collection of interest.
+ * \return #WAVE_ATOM_LITERAL_INT (resp. #WAVE_ATOM_LITERAL_FLOAT) if the
+ * collection only contains integer (resp. floating point) literals,
+ * #WAVE_ATOM_UNKNOWN otherwise.
+ *
+ * Paths pointing to literals are always replaced by
+ * wave_collection_replace_path(), so the elements of such a collection are
+ * never addressed on their own.
+ */
+static wave_atom_type _packed_element_type (const wave_collection * const collection)
+{
+    wave_atom_type element_type = WAVE_ATOM_UNKNOWN;
+    if (wave_collection_get_type (collection) == WAVE_COLLECTION_PAR)
+    {
+        const wave_collection * c = wave_collection_get_list (collection);
+        if (c != NULL && wave_collection_get_type (c) == WAVE_COLLECTION_ATOM)
+            element_type = wave_atom_get_type (wave_collection_get_atom (c));
+
+        if (element_type != WAVE_ATOM_LITERAL_INT && element_type != WAVE_ATOM_LITERAL_FLOAT)
+            element_type = WAVE_ATOM_UNKNOWN;
+
+        for (; c != NULL && element_type != WAVE_ATOM_UNKNOWN; c = wave_collection_get_next (c))
+            if (wave_collection_get_type (c) != WAVE_COLLECTION_ATOM
+                || wave_atom_get_type (wave_collection_get_atom (c)) != element_type)
+                element_type = WAVE_ATOM_UNKNOWN;
+    }
+
+    return element_type;
+}
+
+/**
+ * \brief Generate C source code giving an unboxed parallel collection.
  * \param code_file The file where the C code will be written.
  * \param alloc_file File for allocations.
+ * \param parent Parent of the collection.
+ * \param collection The parallel collection to translate into C code.
+ * \param element_type Type of the elements.
+ *
+ * The literals are stored in a plain \c wave_int or \c wave_float tab.
+ */
+static void wave_code_generation_packed_collection (FILE * const code_file, FILE * const alloc_file, const wave_collection * const parent, const wave_collection * const collection, wave_atom_type element_type)
+{
+    wave_coordinate * collection_coordinate = wave_collection_get_coordinate (collection);
+    wave_int_list * parent_index_list = wave_collection_get_full_indexes (parent);
+    wave_int_list * collection_index_list = wave_collection_get_full_indexes (collection);
+    wave_coordinate * collection_length = wave_collection_get_list_length (collection);
+    bool is_int = element_type == WAVE_ATOM_LITERAL_INT;
+
+    /* The tab, directly initialized with the literals. */
+    fprintf (alloc_file, "wave_%s ", wave_generation_atom_type_string (element_type));
+    wave_code_generation_fprint_tab_with_init (alloc_file, collection_index_list, collection_length, " = { ");
+    for (const wave_collection * c = wave_collection_get_list (collection); c != NULL; c = wave_collection_get_next (c))
+    {
+        wave_atom_fprint (alloc_file, wave_collection_get_atom (c));
+        fprintf (alloc_file, "%s", wave_collection_has_next (c) ? ", " : "");
+    }
+    fprintf (alloc_file, " };\n");
+
+    /* The data pointing to the tab. */
+    wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "._type = ");
+    fprintf (code_file, "%s;\n", is_int ? "WAVE_DATA_PAR_INT" : "WAVE_DATA_PAR_FLOAT");
+    wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "._flags = WAVE_DATA_FLAG_NONE;\n");
+
+    wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "._content._packed._size = ");
+    wave_coordinate_fprint (code_file, collection_length);
+    fprintf (code_file, ";\n");
+
+    wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "._content._packed._tab.");
+    fprintf (code_file, "%s = wave_tab", is_int ? "_ints" : "_floats");
+    wave_int_list_code_fprint (code_file, collection_index_list);
+    fprintf (code_file, ";\n");
+
+    wave_int_list_free (parent_index_list);
+    wave_int_list_free (collection_index_list);
+    wave_coordinate_free (collection_length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for cyclic collections.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Generate C source code marking the tabs of a collection as unset.
+ * \param code_file The file where the C code will be written.
+ * \param collection The collection.
+ *
+ * The tabs of the sub-collections are reset too, so that the values carried
+ * by a loop never contain uninitialized data.
+ */
+static void wave_code_generation_cyclic_reset (FILE * const code_file, const wave_collection * const collection)
+{
+    wave_int_list * collection_index_list = wave_collection_get_full_indexes (collection);
+    wave_coordinate * collection_length = wave_collection_get_list_length (collection);
+
+    fprintf (code_file, "for (size_t __wave__reset__iterator__ = 0; __wave__reset__iterator__ < ");
+    wave_coordinate_fprint (code_file, collection_length);
+    fprintf (code_file, "; ++__wave__reset__iterator__)\nwave_tab");
+    wave_int_list_code_fprint (code_file, collection_index_list);
+    fprintf (code_file, "[__wave__reset__iterator__]._type = WAVE_DATA_UNKNOWN;\n");
+
+    /* The elements of repetitions are in the tab of the collection. */
+    for (const wave_collection * c = wave_collection_get_list (collection); c != NULL; c = wave_collection_get_next (c))
+    {
+        wave_collection_type t = wave_collection_get_type (c);
+        if (t != WAVE_COLLECTION_ATOM && t != WAVE_COLLECTION_REP_SEQ && t != WAVE_COLLECTION_REP_PAR
+            && _packed_element_type (c) == WAVE_ATOM_UNKNOWN)
+            wave_code_generation_cyclic_reset (code_file, c);
+    }
+
+    wave_int_list_free (collection_index_list);
+    wave_coordinate_free (collection_length);
+}
+
+/**
+ * \brief Generate C source code taking a garbage checkpoint before a loop.
+ * \param code_file The file where the C code will be written.
+ * \param collection The cyclic collection.
+ *
+ * The checkpoint is declared in a block which must be closed after the loop.
+ */
+static void wave_code_generation_cyclic_mark (FILE * const code_file, const wave_collection * const collection)
+{
+    wave_int_list * collection_index_list = wave_collection_get_full_indexes (collection);
+
+    fprintf (code_file, "{\nwave_garbage_checkpoint wave_checkpoint");
+    wave_int_list_code_fprint (code_file, collection_index_list);
+    fprintf (code_file, " = wave_garbage_mark ();\n");
+
+    wave_code_generation_cyclic_reset (code_file, collection);
+    if (wave_collection_has_parent (collection))
+    {
+        wave_collection * parent = wave_collection_get_parent (collection);
+        wave_int_list * parent_index_list = wave_collection_get_full_indexes (parent);
+        wave_coordinate * collection_coordinate = wave_collection_get_coordinate (collection);
+
+        wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "._type = WAVE_DATA_UNKNOWN;\n");
+
+        wave_int_list_free (parent_index_list);
+    }
+
+    wave_int_list_free (collection_index_list);
+}
+
+/**
+ * \brief Generate C source code releasing the temporaries of an iteration.
+ * \param code_file The file where the C code will be written.
+ * \param collection The cyclic collection.
+ *
+ * The values carried to the next iteration are the tab of the collection and
+ * the element of the parent the collection may write to.
+ */
+static void wave_code_generation_cyclic_release (FILE * const code_file, const wave_collection * const collection)
+{
+    wave_int_list * collection_index_list = wave_collection_get_full_indexes (collection);
+    wave_coordinate * collection_length = wave_collection_get_list_length (collection);
+    bool has_parent = wave_collection_has_parent (collection);
+
+    fprintf (code_file, "wave_data_release_to (wave_checkpoint");
+    wave_int_list_code_fprint (code_file, collection_index_list);
+    fprintf (code_file, ", (wave_data * []) { wave_tab");
+    wave_int_list_code_fprint (code_file, collection_index_list);
+    if (has_parent)
+    {
+        wave_collection * parent = wave_collection_get_parent (collection);
+        wave_int_list * parent_index_list = wave_collection_get_full_indexes (parent);
+        wave_coordinate * collection_coordinate = wave_collection_get_coordinate (collection);
+
+        fprintf (code_file, ", & ");
+        wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, "");
+
+        wave_int_list_free (parent_index_list);
+    }
+    fprintf (code_file, " }, (size_t []) { ");
+    wave_coordinate_fprint (code_file, collection_length);
+    fprintf (code_file, "%s }, %d);\n", has_parent ? ", 1" : "", has_parent ? 2 : 1);
+
+    wave_int_list_free (collection_index_list);
+    wave_coordinate_free (collection_length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for the various types of collections.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Generate C source code giving a sequential collection.
+ * \param emitter The emitter where the C code will be written.
  * \param collection The sequential collection to translate into C code.
- * \pre code_file and collection must not be NULL.
+ * \pre emitter and collection must not be NULL.
  * \relatesalso wave_collection
  */
-static void wave_code_generation_collection_seq(FILE* code_file, FILE * alloc_file, const wave_collection* collection){
+static void wave_code_generation_collection_seq(wave_emitter * emitter, const wave_collection* collection){
+    FILE * const code_file = wave_emitter_stream (emitter, WAVE_EMITTER_CODE);
+    FILE * const alloc_file = wave_emitter_stream (emitter, WAVE_EMITTER_ALLOCATIONS);
     unsigned long long int curly_backup = wave_generate_backup_curly ();
     wave_code_generation_alloc_collection_tab(alloc_file, collection);
-    wave_code_generation_collection(code_file, alloc_file, wave_collection_get_list(collection) );
+    wave_code_generation_collection(emitter, wave_collection_get_list(collection) );
     wave_generate_flush_curly (code_file);
     wave_generate_restore_curly (curly_backup);
 }
 
 /**
  * \brief Generate C source code giving a collection.
- * \param code_file The file where the C code will be written.
- * \param alloc_file File for allocations.
+ * \param emitter The emitter where the C code will be written.
  * \param collection The parallel collection to translate into C code.
- * \pre code_file and collection must not be NULL.
+ * \pre emitter and collection must not be NULL.
  * \relatesalso wave_collection
  */
-static void wave_code_generation_collection_par(FILE* code_file, FILE * alloc_file, const wave_collection* collection){
+static void wave_code_generation_collection_par(wave_emitter * emitter, const wave_collection* collection){
+    FILE * const code_file = wave_emitter_stream (emitter, WAVE_EMITTER_CODE);
+    FILE * const alloc_file = wave_emitter_stream (emitter, WAVE_EMITTER_ALLOCATIONS);
     unsigned long long int curly_backup = wave_generate_backup_curly ();
     wave_code_generation_alloc_collection_tab(alloc_file, collection);
-    wave_code_generation_collection(code_file, alloc_file, wave_collection_get_list(collection) );
+    wave_code_generation_collection(emitter, wave_collection_get_list(collection) );
     wave_generate_flush_curly (code_file);
     wave_generate_restore_curly (curly_backup);
 }
 
 /**
- * \brief Generate C source code giving a sequential repeated collection.
- * \param code_file The file where the C code will be written.
- * \param alloc_file File for allocations.
- * \param collection The cyclic collection to translate into C code.
- * \pre code_file and collection must not be NULL.
+ * \brief Generate C source code giving a repeated collection.
+ * \param emitter The emitter where the C code will be written.
+ * \param collection The repeated collection to translate into C code.
+ * \pre emitter and collection must not be NULL.
  * \relatesalso wave_collection
+ *
+ * Only constant repetitions are left by wave_collection_unroll_path(). The
+ * elements are stored in the tab of the parent, at coordinates depending on
+ * the iterator of the loop. Since each iteration reads the elements of the
+ * previous one, parallel repetitions are computed in sequence too.
  */
-static void wave_code_generation_collection_rep_seq(FILE* code_file, FILE * alloc_file, const wave_collection* collection){
-    fprintf(code_file, "for(int __wave__parallel__iterator__ = 0;");
-    fprintf(code_file, "__wave__parallel__iterator__ < ");
-    ///////////// HERE PATH SIZE //////////////////
-    fprintf(code_file, " ++__wave__parallel__iterator__)\n{\n");
-    wave_code_generation_alloc_collection_tab(alloc_file, collection);
-    wave_code_generation_collection(code_file, alloc_file, wave_collection_get_list(collection) );
+static void wave_code_generation_collection_rep(wave_emitter * emitter, const wave_collection* collection){
+    FILE * const code_file = wave_emitter_stream (emitter, WAVE_EMITTER_CODE);
+    wave_coordinate * iterator = wave_collection_get_repetition_iterator (collection);
+    unsigned long long int curly_backup = wave_generate_backup_curly ();
+
+    fprintf (code_file, "for (int ");
+    wave_coordinate_fprint (code_file, iterator);
+    fprintf (code_file, " = 0; ");
+    wave_coordinate_fprint (code_file, iterator);
+    fprintf (code_file, " < %d; ++", wave_collection_get_repetition_times (collection));
+    wave_coordinate_fprint (code_file, iterator);
+    fprintf (code_file, ")\n{\n");
+    wave_code_generation_collection(emitter, wave_collection_get_list(collection) );
+    wave_generate_flush_curly (code_file);
+    wave_generate_restore_curly (curly_backup);
     fprintf_closing_curly (code_file, 1);
-}
 
-/**
- * \brief Generate C source code giving a parallel repeated collection.
- * \param code_file The file where the C code will be written.
- * \param alloc_file File for allocations.
- * \param collection The cyclic collection to translate into C code.
- * \pre code_file and collection must not be NULL.
- * \relatesalso wave_collection
- */
-static void wave_code_generation_collection_rep_par(FILE* code_file, FILE * alloc_file, const wave_collection* collection){
-    fprintf(code_file, "#pragma omp parallel\n{\n");
-    fprintf(code_file, "#pragma omp for\n{\n");
-    fprintf(code_file, "for(int __wave__parallel__iterator__ = 0;");
-    fprintf(code_file, "__wave__parallel__iterator__ < ");
-    ///////////// HERE PATH SIZE //////////////////
-    fprintf(code_file, " ++__wave__parallel__iterator__)\n{\n");
-    fprintf(code_file, "#pragma omp sections\n{\n");
-    wave_code_generation_alloc_collection_tab(alloc_file, collection);
-    fprintf(code_file, "#pragma omp section\n{\n");
-    wave_code_generation_collection(code_file, alloc_file, wave_collection_get_list(collection) );
-    fprintf_closing_curly (code_file, 5);
+    wave_coordinate_free (iterator);
 }
 
 /**
  * \brief Generate C source code giving a sequential cyclic collection.
- * \param code_file The file where the C code will be written.
- * \param alloc_file File for allocations.
+ * \param emitter The emitter where the C code will be written.
  * \param collection The cyclic collection to translate into C code.
- * \pre code_file and collection must not be NULL.
+ * \pre emitter and collection must not be NULL.
  * \relatesalso wave_collection
  */
-static void wave_code_generation_collection_cyclic_seq(FILE* code_file, FILE * alloc_file, const wave_collection* collection){
+static void wave_code_generation_collection_cyclic_seq(wave_emitter * emitter, const wave_collection* collection){
+    FILE * const code_file = wave_emitter_stream (emitter, WAVE_EMITTER_CODE);
+    FILE * const alloc_file = wave_emitter_stream (emitter, WAVE_EMITTER_ALLOCATIONS);
+    unsigned long long int curly_backup = wave_generate_backup_curly ();
+    wave_code_generation_cyclic_mark (code_file, collection);
     fprintf(code_file, "for(;;)\n{\n");
     wave_code_generation_alloc_collection_tab(alloc_file, collection);
-    wave_code_generation_collection(code_file, alloc_file, wave_collection_get_list(collection) );
-    fprintf_closing_curly (code_file, 1);
+    wave_code_generation_collection(emitter, wave_collection_get_list(collection) );
+    wave_generate_flush_curly (code_file);
+    wave_generate_restore_curly (curly_backup);
+    wave_code_generation_cyclic_release (code_file, collection);
+    fprintf_closing_curly (code_file, 2);
 }
 
 /**
  * \brief Generate C source code giving a parallel cyclic collection.
- * \param code_file The file where the C code will be written.
- * \param alloc_file File for allocations.
+ * \param emitter The emitter where the C code will be written.
  * \param collection The cyclic collection to translate into C code.
- * \pre code_file and collection must not be NULL.
+ * \pre emitter and collection must not be NULL.
  * \relatesalso wave_collection
  */
-static void wave_code_generation_collection_cyclic_par(FILE* code_file, FILE * alloc_file, const wave_collection* collection){
+static void wave_code_generation_collection_cyclic_par(wave_emitter * emitter, const wave_collection* collection){
+    FILE * const code_file = wave_emitter_stream (emitter, WAVE_EMITTER_CODE);
+    FILE * const alloc_file = wave_emitter_stream (emitter, WAVE_EMITTER_ALLOCATIONS);
+    unsigned long long int curly_backup = wave_generate_backup_curly ();
+    wave_code_generation_cyclic_mark (code_file, collection);
     fprintf(code_file, "for(;;)\n{\n");
     fprintf(code_file, "#pragma omp parallel\n{\n");
     fprintf(code_file, "#pragma omp sections\n{\n");
     wave_code_generation_alloc_collection_tab(alloc_file, collection);
     fprintf(code_file, "#pragma omp section\n{\n");
-    wave_code_generation_collection(code_file, alloc_file, wave_collection_get_list(collection) );
-    fprintf_closing_curly (code_file, 4);
+    wave_code_generation_collection(emitter, wave_collection_get_list(collection) );
+    wave_generate_flush_curly (code_file);
+    wave_generate_restore_curly (curly_backup);
+    fprintf_closing_curly (code_file, 3);
+    /* The temporaries are released outside of the parallel region. */
+    wave_code_generation_cyclic_release (code_file, collection);
+    fprintf_closing_curly (code_file, 2);
 }
 
 /**
  * \brief An array for the code generation switch.
  */
-static void (* const _wave_code_generation_collection_generation []) (FILE*, FILE *, const wave_collection*)=
+static void (* const _wave_code_generation_collection_generation []) (wave_emitter *, const wave_collection*)=
 {
     [WAVE_COLLECTION_ATOM]          = wave_code_generation_atom,
-    [WAVE_COLLECTION_REP_SEQ]       = wave_code_generation_collection_rep_seq,
-    [WAVE_COLLECTION_REP_PAR]       = wave_code_generation_collection_rep_par,
+    [WAVE_COLLECTION_REP_SEQ]       = wave_code_generation_collection_rep,
+    [WAVE_COLLECTION_REP_PAR]       = wave_code_generation_collection_rep,
     [WAVE_COLLECTION_SEQ]           = wave_code_generation_collection_seq,
     [WAVE_COLLECTION_PAR]           = wave_code_generation_collection_par,
     [WAVE_COLLECTION_CYCLIC_SEQ]    = wave_code_generation_collection_cyclic_seq,
@@ -223,41 +400,50 @@ static void (* const _wave_code_generation_collection_generation []) (FILE*, FIL
     [WAVE_COLLECTION_UNKNOWN]       = NULL,
 };
 
-static inline void _current_phrase (FILE * const output, const wave_phrase * const p, unsigned int phrase_count)
+/**
+ * \brief Generate the function of a phrase.
+ * \param emitter Emitter.
+ * \param p Phrase.
+ * \param phrase_count Number of the phrase.
+ */
+static inline void _current_phrase (wave_emitter * const emitter, const wave_phrase * const p, unsigned int phrase_count)
 {
-    FILE * code_file = tmpfile ();
-    FILE * alloc_file = tmpfile ();
+    FILE * const output = wave_emitter_stream (emitter, WAVE_EMITTER_PROGRAM);
     wave_collection* collection = wave_phrase_get_collection(p);
 
     /* Print the beginning of the function.
      * Each function shall contain exactly one phrase.
      */
     fprintf (output, "void phrase_%d (void)\n{\n", phrase_count);
-    /* Unroll repetitions that depend on paths. */
+    /* Expand the repetitions, but the constant ones generated as loops. */
     wave_collection_unroll_path(collection);
     /* Compute the AST indexes. */
     wave_collection_compute_indexes(collection);
     /* Replace paths that can be replaced. */
     wave_collection_replace_path(collection);
+    /* Infer the types of the atoms, so that operators on known types are
+     * computed without dispatch.
+     */
+    wave_collection_compute_types(collection);
+    /* Find the operands which can be updated in place. */
+    wave_code_generation_prepare_operators(collection);
+    /* Find the values which can be computed at compile time. */
+    wave_code_generation_prepare_fold(collection);
     /* Compute the lengths and coordinates of the collections. */
     wave_collection_compute_length_and_coords(collection);
     /* Generate the code and the allocations.
      * Required allocations are discovered while generating the code, but must
      * be put at the beginning.
      */
-    wave_code_generation_collection(code_file, alloc_file, collection);
-    /* Append the contents of the files to the real output. */
-    fseek (alloc_file, 0, SEEK_SET);
-    fseek (code_file, 0, SEEK_SET);
-    file_cat (output, alloc_file);
-    file_cat (output, code_file);
+    wave_code_generation_collection(emitter, collection);
+    /* Release the values computed at compile time. */
+    wave_code_generation_clean_fold();
+    /* Append the allocations, then the code, to the function. */
+    wave_emitter_end_phrase (emitter);
     /* Print the garbage cleaning at the end of the function. */
     fprintf (output, "wave_garbage_clean ();\n");
     /* Close the function. */
     fprintf (output, "}\n");
-
-    fclose (code_file);
-    fclose (alloc_file);
 }
 
 /**
@@ -269,9 +455,9 @@ static inline void _print_main (FILE * const output, unsigned int phrase_count)
 {
     /* Print the main beginning. */
     fprintf (output, "int main(void)\n{\n");
-    /* Call the functions for each phrases. */
+    /* Call the functions for each phrases, and report their statistics. */
     for (unsigned int i = 0; i < phrase_count; ++i)
-        fprintf (output, "phrase_%d ();\n", i);
+        fprintf (output, "phrase_%d ();\nwave_garbage_report_stats (\"phrase_%d\");\n", i, i);
     /* Destroy the garbage collector. */
     fprintf (output, "wave_garbage_destroy ();\n");
     /* Close the main function. */
@@ -284,27 +470,51 @@ static inline void _print_main (FILE * const output, unsigned int phrase_count)
 
 void wave_code_generation_generate (FILE * const output_file, const wave_phrase * phrases)
 {
-    wave_code_generation_fprintf_headers (output_file);
+    wave_emitter emitter;
+    wave_emitter_init (& emitter);
+    FILE * const program = wave_emitter_stream (& emitter, WAVE_EMITTER_PROGRAM);
+
+    wave_code_generation_fprintf_headers (program);
     unsigned int count = 0;
 
     for (const wave_phrase * p = phrases; p != NULL; p = wave_phrase_get_next (p))
-        _current_phrase (output_file, p, count++);
-    _print_main (output_file, count);
+        _current_phrase (& emitter, p, count++);
+    _print_main (program, count);
+
+    /* The whole program is written at once. */
+    bool written = wave_emitter_write (& emitter, output_file);
+    wave_emitter_clean (& emitter);
+    if (! written)
+    {
+        fprintf (stderr, "Error: could not write the generated code.\n");
+        exit (EX_IOERR);
+    }
 }
 
-void wave_code_generation_collection (FILE * const code_file, FILE * const alloc_file, const wave_collection * const collection)
+void wave_code_generation_collection (wave_emitter * const emitter, const wave_collection * const collection)
 {
-    for (const wave_collection * c = collection; c != NULL; c = wave_collection_get_next (c))
+    FILE * const code_file = wave_emitter_stream (emitter, WAVE_EMITTER_CODE);
+    FILE * const alloc_file = wave_emitter_stream (emitter, WAVE_EMITTER_ALLOCATIONS);
+    const wave_data * const values = wave_code_generation_fold_list (collection);
+    size_t i = 0;
+    for (const wave_collection * c = collection; c != NULL; c = wave_collection_get_next (c), ++i)
     {
+        /* Values known at compile time replace the code computing them. */
+        bool is_folded = values != NULL && wave_code_generation_fold_collection (code_file, alloc_file, c, & values[i]);
         wave_collection_type collection_type = wave_collection_get_type (c);
-        if (wave_collection_has_parent (c))
+        wave_atom_type packed_type = WAVE_ATOM_UNKNOWN;
+        if (! is_folded && wave_collection_has_parent (c))
         {
             wave_collection * parent = wave_collection_get_parent (c);
-            if (collection_type == WAVE_COLLECTION_SEQ)
+            packed_type = _packed_element_type (c);
+            if (packed_type != WAVE_ATOM_UNKNOWN)
+                wave_code_generation_packed_collection (code_file, alloc_file, parent, c, packed_type);
+            else if (collection_type == WAVE_COLLECTION_SEQ)
                 wave_code_generation_print_sub_info (code_file, parent, c, "WAVE_DATA_SEQ");
             else if (collection_type == WAVE_COLLECTION_PAR)
                 wave_code_generation_print_sub_info (code_file, parent, c, "WAVE_DATA_PAR");
         }
-        _wave_code_generation_collection_generation [collection_type] (code_file, alloc_file, c);
+        if (! is_folded && packed_type == WAVE_ATOM_UNKNOWN)
+            _wave_code_generation_collection_generation [collection_type] (emitter, c);
     }
 }
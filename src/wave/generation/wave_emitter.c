@@ -0,0 +1,123 @@
+/**
+ * \file wave_emitter.c
+ * \brief Wave code generation, emitter.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "wave/generation/wave_emitter.h"
+
+#include <sysexits.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Exit because of a lack of memory.
+ */
+static void _memory_error (void)
+{
+    fprintf (stderr, "Error: not enough memory to generate the code.\n");
+    exit (EX_OSERR);
+}
+
+/**
+ * \brief Get the contents of a section.
+ * \param emitter Emitter.
+ * \param section Section.
+ * \param size Storage for the number of bytes.
+ * \return The bytes.
+ *
+ * The streams are only written at their end, so the position of a stream is
+ * the size of its contents.
+ */
+static const char * _contents (wave_emitter * const emitter, wave_emitter_section section, size_t * const size)
+{
+    FILE * const stream = emitter->_streams[section];
+    off_t position;
+    if (fflush (stream) != 0 || ferror (stream) || (position = ftello (stream)) < 0)
+        _memory_error ();
+
+    * size = (size_t) position;
+    return emitter->_buffers[section];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization, cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+void wave_emitter_init (wave_emitter * const emitter)
+{
+    for (int s = 0; s < WAVE_EMITTER_SECTION_COUNT; ++s)
+    {
+        emitter->_buffers[s] = NULL;
+        emitter->_sizes[s] = 0;
+        emitter->_streams[s] = open_memstream (& emitter->_buffers[s], & emitter->_sizes[s]);
+        if (emitter->_streams[s] == NULL)
+            _memory_error ();
+    }
+}
+
+void wave_emitter_clean (wave_emitter * const emitter)
+{
+    for (int s = 0; s < WAVE_EMITTER_SECTION_COUNT; ++s)
+    {
+        fclose (emitter->_streams[s]);
+        free (emitter->_buffers[s]);
+        emitter->_streams[s] = NULL;
+        emitter->_buffers[s] = NULL;
+        emitter->_sizes[s] = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Emitting.
+////////////////////////////////////////////////////////////////////////////////
+
+FILE * wave_emitter_stream (wave_emitter * const emitter, wave_emitter_section section)
+{
+    return emitter->_streams[section];
+}
+
+void wave_emitter_end_phrase (wave_emitter * const emitter)
+{
+    FILE * const program = emitter->_streams[WAVE_EMITTER_PROGRAM];
+    for (wave_emitter_section s = WAVE_EMITTER_ALLOCATIONS; s <= WAVE_EMITTER_CODE; ++s)
+    {
+        size_t size;
+        const char * const bytes = _contents (emitter, s, & size);
+        if (fwrite (bytes, 1, size, program) != size || fseeko (emitter->_streams[s], 0, SEEK_SET) != 0)
+            _memory_error ();
+    }
+}
+
+bool wave_emitter_write (wave_emitter * const emitter, FILE * const stream)
+{
+    size_t size;
+    const char * const bytes = _contents (emitter, WAVE_EMITTER_PROGRAM, & size);
+    return fwrite (bytes, 1, size, stream) == size && fflush (stream) == 0;
+}
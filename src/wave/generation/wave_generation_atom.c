@@ -37,13 +37,18 @@
 static inline void _wave_generate_with_strings_inside_tm(FILE* const code_file, const wave_collection* const collection, wave_atom_type t){
     wave_coordinate* collection_coordinate = wave_collection_get_coordinate(collection);
     wave_int_list* collection_index_list = wave_collection_get_full_indexes(wave_collection_get_parent(collection));
+    bool is_scalar = wave_code_generation_is_scalar (collection);
 
-    wave_generate_content_assignement (code_file, collection_index_list, collection_coordinate, t);
+    if (is_scalar)
+        wave_code_generation_fprint_scalar_declaration (code_file, collection);
+    else
+        wave_generate_content_assignement (code_file, collection_index_list, collection_coordinate, t);
     fprintf(code_file, " = ");
     wave_atom_fprint(code_file, wave_collection_get_atom( collection ));
     fprintf(code_file, ";\n");
 
-    wave_generate_type_assignement (code_file, collection_index_list , collection_coordinate, t);
+    if (! is_scalar)
+        wave_generate_type_assignement (code_file, collection_index_list , collection_coordinate, t);
     wave_int_list_free (collection_index_list);
 }
 
@@ -161,8 +166,8 @@ static void (* const _wave_code_generation_atom []) (FILE*, const wave_collectio
 // Atom generation.
 ////////////////////////////////////////////////////////////////////////////////
 
-void wave_code_generation_atom(FILE* code_file, FILE * alloc_file, const wave_collection* collection){
-    (void) alloc_file;
+void wave_code_generation_atom(wave_emitter * emitter, const wave_collection* collection){
+    FILE * const code_file = wave_emitter_stream (emitter, WAVE_EMITTER_CODE);
     wave_atom * atom = wave_collection_get_atom(collection);
     wave_atom_type atom_type = wave_atom_get_type(atom);
     _wave_code_generation_atom[atom_type] (code_file, collection);
@@ -97,6 +97,7 @@ void wave_generate_type_assignement (FILE * const code_file, const wave_int_list
 {
     wave_code_generation_fprint_tab_with_init (code_file, list, c, "._type = ");
     fprintf (code_file, "%s;\n", _atom_type_data_strings[t]);
+    wave_code_generation_fprint_tab_with_init (code_file, list, c, "._flags = WAVE_DATA_FLAG_NONE;\n");
 }
 
 const char * wave_generation_atom_type_string (wave_atom_type t)
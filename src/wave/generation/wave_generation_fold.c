@@ -0,0 +1,705 @@
+/**
+ * \file wave_generation_fold.c
+ * \brief Wave code generation, constant folding.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \author SCHMITT Maxime
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "wave/generation/wave_generation_fold.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <ctype.h>
+#include <math.h>
+#include <sysexits.h>
+
+#include "wave/common/wave_garbage.h"
+#include "wave/common/wave_kernels.h"
+#include "wave/generation/wave_generation_operators.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static variables.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Maximal number of atoms computed for the value of an element.
+ *
+ * Read once from the \c WAVE2C_FOLD_BUDGET environment variable; zero disables
+ * the folding.
+ */
+static size_t _budget = 0;
+
+/**
+ * \brief Whether #_budget was read.
+ */
+static bool _budget_read = false;
+
+/**
+ * \brief Whether the current phrase contains paths.
+ */
+static bool _phrase_has_path = true;
+
+/**
+ * \brief Number of the last static tab generated.
+ */
+static unsigned long int _storage_count = 0;
+
+/**
+ * \brief Names of the data types in the generated code.
+ */
+static const char * const _type_names [WAVE_DATA_UNKNOWN + 1] =
+{
+    [WAVE_DATA_INT]         = "WAVE_DATA_INT",
+    [WAVE_DATA_FLOAT]       = "WAVE_DATA_FLOAT",
+    [WAVE_DATA_CHAR]        = "WAVE_DATA_CHAR",
+    [WAVE_DATA_STRING]      = "WAVE_DATA_STRING",
+    [WAVE_DATA_BOOL]        = "WAVE_DATA_BOOL",
+    [WAVE_DATA_SEQ]         = "WAVE_DATA_SEQ",
+    [WAVE_DATA_PAR]         = "WAVE_DATA_PAR",
+    [WAVE_DATA_PAR_INT]     = "WAVE_DATA_PAR_INT",
+    [WAVE_DATA_PAR_FLOAT]   = "WAVE_DATA_PAR_FLOAT",
+    [WAVE_DATA_PAR_BOOL]    = "WAVE_DATA_PAR_BOOL",
+    [WAVE_DATA_OPERATOR]    = "WAVE_DATA_OPERATOR",
+    [WAVE_DATA_UNKNOWN]     = "WAVE_DATA_UNKNOWN",
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the folding budget.
+ * \return Maximal number of atoms computed for the value of an element.
+ */
+static size_t _fold_budget (void)
+{
+    if (! _budget_read)
+    {
+        const char * const env = getenv ("WAVE2C_FOLD_BUDGET");
+        unsigned long long int value = env != NULL ? strtoull (env, NULL, 10) : 0;
+        _budget = (size_t) value;
+        _budget_read = true;
+    }
+    return _budget;
+}
+
+/**
+ * \brief Allocate memory released with the values of the phrase.
+ * \param size Size requested.
+ */
+static void * _alloc (size_t size)
+{
+    void * const memory = wave_garbage_alloc (size > 0 ? size : 1);
+    if (memory == NULL)
+    {
+        fprintf (stderr, "Error: not enough memory to generate the code.\n");
+        exit (EX_OSERR);
+    }
+    return memory;
+}
+
+/**
+ * \brief Mark a value as unknown.
+ * \param value Value.
+ */
+static inline void _set_unknown (wave_data * const value)
+{
+    value->_type = WAVE_DATA_UNKNOWN;
+    value->_flags = WAVE_DATA_FLAG_NONE;
+}
+
+/**
+ * \brief Determine whether a value is known.
+ * \param value Value.
+ */
+static inline bool _is_known (const wave_data * const value)
+{
+    return wave_data_get_type (value) != WAVE_DATA_UNKNOWN;
+}
+
+/**
+ * \brief Determine whether a collection is repeated or cyclic.
+ * \param collection Collection.
+ */
+static inline bool _is_loop (const wave_collection * const collection)
+{
+    wave_collection_type t = wave_collection_get_type (collection);
+    return t != WAVE_COLLECTION_ATOM && t != WAVE_COLLECTION_SEQ && t != WAVE_COLLECTION_PAR;
+}
+
+/**
+ * \brief Get the operator of a collection.
+ * \param collection Collection.
+ * \return The operator, or #WAVE_OP_UNKNOWN if the collection is not an
+ * operator.
+ */
+static wave_operator _operator (const wave_collection * const collection)
+{
+    wave_operator op = WAVE_OP_UNKNOWN;
+    if (wave_collection_get_type (collection) == WAVE_COLLECTION_ATOM)
+    {
+        const wave_atom * const atom = wave_collection_get_atom (collection);
+        if (wave_atom_get_type (atom) == WAVE_ATOM_OPERATOR)
+            op = wave_atom_get_operator (atom);
+    }
+    return op;
+}
+
+/**
+ * \brief Determine whether a collection contains an operator.
+ * \param collection Collection.
+ */
+static bool _contains_operator (const wave_collection * const collection)
+{
+    bool contains = _operator (collection) != WAVE_OP_UNKNOWN;
+    if (wave_collection_get_type (collection) != WAVE_COLLECTION_ATOM)
+        for (const wave_collection * c = wave_collection_get_list (collection); c != NULL && ! contains; c = wave_collection_get_next (c))
+            contains = _contains_operator (c);
+
+    return contains;
+}
+
+/**
+ * \brief Get the number of elements of a list.
+ * \param list The first element of the list.
+ */
+static size_t _list_length (const wave_collection * list)
+{
+    size_t length = 0;
+    for (; list != NULL; list = wave_collection_get_next (list))
+        ++length;
+
+    return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for the evaluation.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Take atoms from the budget.
+ * \param budget Remaining budget.
+ * \param cost Number of atoms.
+ * \retval true if the budget was sufficient.
+ * \retval false otherwise; the budget is then exhausted.
+ */
+static inline bool _spend (size_t * const budget, size_t cost)
+{
+    bool is_affordable = cost <= * budget;
+    * budget = is_affordable ? * budget - cost : 0;
+    return is_affordable;
+}
+
+/**
+ * \brief Get the number of atoms of a value.
+ * \param value Value.
+ * \return The number of atoms, counting the collections themselves and the
+ * characters of the strings.
+ */
+static size_t _value_size (const wave_data * const value)
+{
+    wave_data_type t = wave_data_get_type (value);
+    size_t size = 1;
+    size_t length;
+    if (t == WAVE_DATA_STRING && wave_data_get_characters (value, & length) != NULL)
+        size += length;
+    else if (t == WAVE_DATA_SEQ || t == WAVE_DATA_PAR)
+        for (size_t i = 0; i < wave_data_get_par_size (value); ++i)
+            size += _value_size (& value->_content._collection._tab[i]);
+    else if (t == WAVE_DATA_PAR_INT || t == WAVE_DATA_PAR_FLOAT || t == WAVE_DATA_PAR_BOOL)
+        size += wave_data_get_par_size (value);
+
+    return size;
+}
+
+/**
+ * \brief Determine whether a value can be written in the generated code.
+ * \param value Value.
+ *
+ * Infinite and NaN floating point values have no literal.
+ */
+static bool _is_printable (const wave_data * const value)
+{
+    wave_data_type t = wave_data_get_type (value);
+    bool is_printable = true;
+    if (t == WAVE_DATA_FLOAT)
+        is_printable = isfinite (wave_data_get_float (value));
+    else if (t == WAVE_DATA_PAR_FLOAT)
+        for (size_t i = 0; is_printable && i < wave_data_get_par_size (value); ++i)
+            is_printable = isfinite (value->_content._packed._tab._floats[i]);
+    else if (t == WAVE_DATA_SEQ || t == WAVE_DATA_PAR)
+        for (size_t i = 0; is_printable && i < wave_data_get_par_size (value); ++i)
+            is_printable = _is_printable (& value->_content._collection._tab[i]);
+
+    return is_printable;
+}
+
+/**
+ * \brief Get the value of a literal.
+ * \param collection Atom collection.
+ * \param value Storage for the value.
+ * \retval true if the atom is a literal.
+ * \retval false otherwise.
+ */
+static bool _evaluate_literal (const wave_collection * const collection, wave_data * const value)
+{
+    const wave_atom * const atom = wave_collection_get_atom (collection);
+    bool is_literal = true;
+    switch (wave_atom_get_type (atom))
+    {
+        case WAVE_ATOM_LITERAL_INT:
+            wave_data_set_int (value, wave_atom_get_int (atom));
+            break;
+        case WAVE_ATOM_LITERAL_FLOAT:
+            wave_data_set_float (value, wave_atom_get_float (atom));
+            break;
+        case WAVE_ATOM_LITERAL_CHAR:
+            wave_data_set_char (value, wave_atom_get_char (atom));
+            break;
+        case WAVE_ATOM_LITERAL_BOOL:
+            wave_data_set_bool (value, wave_atom_get_bool (atom));
+            break;
+        case WAVE_ATOM_LITERAL_STRING:
+        {
+            const_wave_string s = wave_atom_get_string (atom);
+            wave_data_set_string_copy (value, s, wave_string_length (s));
+            break;
+        }
+        case WAVE_ATOM_OPERATOR:
+        case WAVE_ATOM_PATH:
+        case WAVE_ATOM_UNKNOWN:
+        default:
+            is_literal = false;
+            break;
+    }
+    return is_literal;
+}
+
+/**
+ * \brief Compute the value of an unary or binary operator.
+ * \param op Operator.
+ * \param values Values of the elements of the list.
+ * \param i Index of the operator.
+ * \param budget Remaining budget.
+ * \retval true if the value was computed.
+ * \retval false otherwise.
+ *
+ * The operation is only computed when wave_data_unary() or wave_data_binary()
+ * would not report an error.
+ */
+static bool _evaluate_operation (wave_operator op, wave_data * const values, size_t i, size_t * const budget)
+{
+    bool is_known = false;
+    if (wave_operator_is_unary (op) || op == WAVE_OP_SPECIFIC_ATOM)
+    {
+        is_known = i >= 1 && _is_known (& values[i - 1]) && wave_data_unary_is_defined (& values[i - 1], op);
+        if (is_known)
+            wave_data_unary (& values[i - 1], & values[i], op);
+    }
+    else if (wave_operator_is_binary (op))
+    {
+        is_known = i >= 2 && _is_known (& values[i - 2]) && _is_known (& values[i - 1])
+            && wave_data_binary_is_defined (& values[i - 2], & values[i - 1], op);
+        if (is_known)
+            wave_data_binary (& values[i - 2], & values[i - 1], & values[i], op);
+    }
+
+    is_known = is_known && _spend (budget, _value_size (& values[i])) && _is_printable (& values[i]);
+    if (! is_known)
+        _set_unknown (& values[i]);
+
+    return is_known;
+}
+
+static bool _evaluate_collection (const wave_collection * collection, wave_data * value, size_t * budget);
+
+/**
+ * \brief Compute the value of an element of a collection.
+ * \param collection Element.
+ * \param values Values of the elements of the list.
+ * \param i Index of the element.
+ * \param result Value of the collection, set by a stop or a cut.
+ * \param stopped Set when a stop ends the collection.
+ * \param budget Remaining budget.
+ * \retval true if the value was computed.
+ * \retval false otherwise.
+ */
+static bool _evaluate_element (const wave_collection * const collection, wave_data * const values, size_t i, wave_data * const result, bool * const stopped, size_t * const budget)
+{
+    wave_operator op = _operator (collection);
+    bool is_known;
+
+    _set_unknown (& values[i]);
+    if (op == WAVE_OP_SPECIFIC_STOP)
+    {
+        /* The else branch of the stop shares the previous value. */
+        is_known = i >= 2 && wave_data_get_type (& values[i - 2]) == WAVE_DATA_BOOL && _is_known (& values[i - 1]);
+        * stopped = is_known && wave_data_get_bool (& values[i - 2]);
+        if (* stopped)
+            * result = values[i - 1];
+        else if (is_known)
+            values[i] = values[i - 1];
+    }
+    else if (op == WAVE_OP_SPECIFIC_CUT)
+    {
+        is_known = i >= 1 && _is_known (& values[i - 1]);
+        if (is_known)
+            * result = values[i - 1];
+    }
+    else if (op != WAVE_OP_UNKNOWN)
+        is_known = _evaluate_operation (op, values, i, budget);
+    else if (wave_collection_get_type (collection) == WAVE_COLLECTION_ATOM)
+        is_known = _evaluate_literal (collection, & values[i]);
+    else
+        is_known = _evaluate_collection (collection, & values[i], budget);
+
+    return is_known;
+}
+
+/**
+ * \brief Get the type of the literals of a parallel collection stored unboxed.
+ * \param collection Collection.
+ * \return #WAVE_DATA_INT or #WAVE_DATA_FLOAT if the collection only contains
+ * such literals, #WAVE_DATA_UNKNOWN otherwise.
+ *
+ * Such collections are stored unboxed by the generated code.
+ */
+static wave_data_type _packed_type (const wave_collection * const collection)
+{
+    wave_atom_type element_type = WAVE_ATOM_UNKNOWN;
+    const wave_collection * c = wave_collection_get_list (collection);
+    if (wave_collection_get_type (collection) == WAVE_COLLECTION_PAR && c != NULL && wave_collection_get_type (c) == WAVE_COLLECTION_ATOM)
+        element_type = wave_atom_get_type (wave_collection_get_atom (c));
+
+    for (; c != NULL && element_type != WAVE_ATOM_UNKNOWN; c = wave_collection_get_next (c))
+        if (wave_collection_get_type (c) != WAVE_COLLECTION_ATOM
+            || wave_atom_get_type (wave_collection_get_atom (c)) != element_type)
+            element_type = WAVE_ATOM_UNKNOWN;
+
+    return element_type == WAVE_ATOM_LITERAL_INT ? WAVE_DATA_INT
+        : element_type == WAVE_ATOM_LITERAL_FLOAT ? WAVE_DATA_FLOAT
+        : WAVE_DATA_UNKNOWN;
+}
+
+/**
+ * \brief Store the literals of a parallel collection unboxed.
+ * \param value Collection value.
+ * \param element_type Type of the literals.
+ */
+static void _pack (wave_data * const value, wave_data_type element_type)
+{
+    const wave_data * const tab = value->_content._collection._tab;
+    size_t size = wave_data_get_par_size (value);
+    if (element_type == WAVE_DATA_INT)
+    {
+        wave_int * const ints = _alloc (size * sizeof (wave_int));
+        for (size_t i = 0; i < size; ++i)
+            ints[i] = wave_data_get_int (& tab[i]);
+        wave_data_set_par_int (value, ints, size);
+    }
+    else
+    {
+        wave_float * const floats = _alloc (size * sizeof (wave_float));
+        for (size_t i = 0; i < size; ++i)
+            floats[i] = wave_data_get_float (& tab[i]);
+        wave_data_set_par_float (value, floats, size);
+    }
+}
+
+/**
+ * \brief Compute the value of a sequential or parallel collection.
+ * \param collection Collection.
+ * \param value Storage for the value.
+ * \param budget Remaining budget.
+ * \retval true if the value was computed.
+ * \retval false otherwise.
+ *
+ * The value is the collection itself, unless a stop or a cut gives it the
+ * value of one of its elements. Every element must be known.
+ */
+static bool _evaluate_collection (const wave_collection * const collection, wave_data * const value, size_t * const budget)
+{
+    wave_collection_type t = wave_collection_get_type (collection);
+    const wave_collection * const list = wave_collection_get_list (collection);
+    size_t size = _list_length (list);
+    /* The elements are taken from the budget before being computed. */
+    bool is_known = (t == WAVE_COLLECTION_SEQ || t == WAVE_COLLECTION_PAR) && _spend (budget, size);
+
+    if (is_known)
+    {
+        wave_data * const tab = _alloc (size * sizeof (wave_data));
+        value->_type = t == WAVE_COLLECTION_SEQ ? WAVE_DATA_SEQ : WAVE_DATA_PAR;
+        value->_flags = WAVE_DATA_FLAG_NONE;
+        value->_content._collection._tab = tab;
+        value->_content._collection._size = (uint32_t) size;
+
+        bool stopped = false;
+        size_t i = 0;
+        for (const wave_collection * c = list; c != NULL && is_known && ! stopped; c = wave_collection_get_next (c), ++i)
+            is_known = _evaluate_element (c, tab, i, value, & stopped, budget);
+        /* The elements following a stop are never computed. */
+        for (; i < size; ++i)
+            _set_unknown (& tab[i]);
+    }
+
+    wave_data_type packed_type = _packed_type (collection);
+    if (is_known && packed_type != WAVE_DATA_UNKNOWN)
+        _pack (value, packed_type);
+
+    return is_known;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities for the generation.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Print a string literal.
+ * \param stream Stream.
+ * \param s Characters.
+ * \param length Number of characters.
+ */
+static void _print_string (FILE * const stream, const wave_char * const s, size_t length)
+{
+    fprintf (stream, "\"");
+    for (size_t i = 0; i < length; ++i)
+    {
+        unsigned char c = (unsigned char) s[i];
+        /* Question marks are escaped to avoid trigraphs. */
+        if (c == '"' || c == '\\' || c == '?')
+            fprintf (stream, "\\%c", c);
+        else if (isprint (c))
+            fprintf (stream, "%c", c);
+        else
+            fprintf (stream, "\\%03o", (unsigned int) c);
+    }
+    fprintf (stream, "\"");
+}
+
+/**
+ * \brief Print the initializer of a data.
+ * \param stream Stream.
+ * \param value Value.
+ * \param storage Number of the static tab of a collection, zero if the
+ * collection is empty.
+ */
+static void _print_initializer (FILE * const stream, const wave_data * const value, unsigned long int storage)
+{
+    wave_data_type t = wave_data_get_type (value);
+    size_t length;
+
+    fprintf (stream, "{ ");
+    switch (t)
+    {
+        case WAVE_DATA_INT:
+            fprintf (stream, "._content._int = %d, ", wave_data_get_int (value));
+            break;
+        case WAVE_DATA_FLOAT:
+            fprintf (stream, "._content._float = %a, ", wave_data_get_float (value));
+            break;
+        case WAVE_DATA_CHAR:
+            fprintf (stream, "._content._char = %d, ", wave_data_get_char (value));
+            break;
+        case WAVE_DATA_BOOL:
+            fprintf (stream, "._content._bool = %s, ", wave_data_get_bool (value) ? "true" : "false");
+            break;
+        case WAVE_DATA_STRING:
+        {
+            const wave_char * const s = wave_data_get_characters (value, & length);
+            fprintf (stream, "._content._string = ");
+            _print_string (stream, s, length);
+            fprintf (stream, ", ");
+            break;
+        }
+        case WAVE_DATA_SEQ:
+        case WAVE_DATA_PAR:
+            if (storage != 0)
+                fprintf (stream, "._content._collection = { wave_fold_%lu, %zu }, ", storage, wave_data_get_par_size (value));
+            else
+                fprintf (stream, "._content._collection = { NULL, 0 }, ");
+            break;
+        case WAVE_DATA_PAR_INT:
+        case WAVE_DATA_PAR_FLOAT:
+        case WAVE_DATA_PAR_BOOL:
+        {
+            const char * const field = t == WAVE_DATA_PAR_INT ? "_ints" : t == WAVE_DATA_PAR_FLOAT ? "_floats" : "_bits";
+            if (storage != 0)
+                fprintf (stream, "._content._packed = { { .%s = wave_fold_%lu }, %zu }, ", field, storage, wave_data_get_par_size (value));
+            else
+                fprintf (stream, "._content._packed = { { .%s = NULL }, 0 }, ", field);
+            break;
+        }
+        case WAVE_DATA_OPERATOR:
+        case WAVE_DATA_UNKNOWN:
+        default:
+            break;
+    }
+    fprintf (stream, "._type = %s }", _type_names[t]);
+}
+
+/**
+ * \brief Print the static tabs of a value.
+ * \param alloc_file File for allocations.
+ * \param value Value.
+ * \return The number of the tab of the value, zero if the value has none.
+ *
+ * The tabs of the elements are printed first, so that the initializer of the
+ * tab of the value may refer to them.
+ */
+static unsigned long int _print_storage (FILE * const alloc_file, const wave_data * const value)
+{
+    wave_data_type t = wave_data_get_type (value);
+    bool is_collection = t == WAVE_DATA_SEQ || t == WAVE_DATA_PAR;
+    bool is_packed = t == WAVE_DATA_PAR_INT || t == WAVE_DATA_PAR_FLOAT || t == WAVE_DATA_PAR_BOOL;
+    size_t size = is_collection || is_packed ? wave_data_get_par_size (value) : 0;
+    unsigned long int storage = 0;
+
+    if (is_collection && size > 0)
+    {
+        const wave_data * const tab = value->_content._collection._tab;
+        unsigned long int * const element_storage = _alloc (size * sizeof (unsigned long int));
+        for (size_t i = 0; i < size; ++i)
+            element_storage[i] = _print_storage (alloc_file, & tab[i]);
+
+        storage = ++ _storage_count;
+        fprintf (alloc_file, "static wave_data wave_fold_%lu[%zu] =\n{\n", storage, size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            _print_initializer (alloc_file, & tab[i], element_storage[i]);
+            fprintf (alloc_file, ",\n");
+        }
+        fprintf (alloc_file, "};\n");
+    }
+    else if (is_packed && size > 0)
+    {
+        storage = ++ _storage_count;
+        if (t == WAVE_DATA_PAR_INT)
+        {
+            fprintf (alloc_file, "static wave_int wave_fold_%lu[%zu] = { ", storage, size);
+            for (size_t i = 0; i < size; ++i)
+                fprintf (alloc_file, "%d%s", value->_content._packed._tab._ints[i], i + 1 < size ? ", " : "");
+        }
+        else if (t == WAVE_DATA_PAR_FLOAT)
+        {
+            fprintf (alloc_file, "static wave_float wave_fold_%lu[%zu] = { ", storage, size);
+            for (size_t i = 0; i < size; ++i)
+                fprintf (alloc_file, "%a%s", value->_content._packed._tab._floats[i], i + 1 < size ? ", " : "");
+        }
+        else
+        {
+            size_t words = (size + WAVE_KERNELS_WORD_BITS - 1) / WAVE_KERNELS_WORD_BITS;
+            fprintf (alloc_file, "static uint64_t wave_fold_%lu[%zu] = { ", storage, words);
+            for (size_t i = 0; i < words; ++i)
+                fprintf (alloc_file, "UINT64_C (0x%" PRIx64 ")%s", value->_content._packed._tab._bits[i], i + 1 < words ? ", " : "");
+        }
+        fprintf (alloc_file, " };\n");
+    }
+
+    return storage;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Folding.
+////////////////////////////////////////////////////////////////////////////////
+
+void wave_code_generation_prepare_fold (const wave_collection * const phrase)
+{
+    _phrase_has_path = wave_collection_contains_path (phrase);
+}
+
+wave_data * wave_code_generation_fold_list (const wave_collection * const list)
+{
+    bool is_folded = _fold_budget () > 0 && wave_collection_has_parent (list);
+    for (const wave_collection * c = list; is_folded && wave_collection_has_parent (c); c = wave_collection_get_parent (c))
+        is_folded = ! _is_loop (wave_collection_get_parent (c));
+
+    wave_data * values = NULL;
+    if (is_folded)
+    {
+        values = _alloc (_list_length (list) * sizeof (wave_data));
+        size_t i = 0;
+        for (const wave_collection * c = list; c != NULL; c = wave_collection_get_next (c), ++i)
+        {
+            wave_operator op = _operator (c);
+            wave_collection_type t = wave_collection_get_type (c);
+            size_t budget = _fold_budget ();
+            wave_data result;
+
+            _set_unknown (& values[i]);
+            if (op == WAVE_OP_SPECIFIC_STOP || op == WAVE_OP_SPECIFIC_PRINT)
+            {
+                /* Both share the previous value. */
+                if (i >= 1)
+                    values[i] = values[i - 1];
+            }
+            else if (op != WAVE_OP_UNKNOWN)
+                _evaluate_operation (op, values, i, & budget);
+            else if (t == WAVE_COLLECTION_ATOM)
+                _evaluate_literal (c, & values[i]);
+            else if (! _phrase_has_path && _evaluate_collection (c, & result, & budget))
+                values[i] = result;
+        }
+    }
+
+    return values;
+}
+
+bool wave_code_generation_fold_collection (FILE * const code_file, FILE * const alloc_file, const wave_collection * const collection, const wave_data * const value)
+{
+    wave_operator op = _operator (collection);
+    bool is_folded = _is_known (value)
+        && (wave_operator_is_unary (op) || wave_operator_is_binary (op) || op == WAVE_OP_SPECIFIC_ATOM
+            || (op == WAVE_OP_UNKNOWN && wave_collection_get_type (collection) != WAVE_COLLECTION_ATOM && _contains_operator (collection)));
+
+    if (is_folded && wave_code_generation_is_scalar (collection))
+    {
+        wave_code_generation_fprint_scalar_declaration (code_file, collection);
+        if (wave_data_get_type (value) == WAVE_DATA_INT)
+            fprintf (code_file, " = %d;\n", wave_data_get_int (value));
+        else
+            fprintf (code_file, " = %a;\n", wave_data_get_float (value));
+    }
+    else if (is_folded)
+    {
+        wave_coordinate * collection_coordinate = wave_collection_get_coordinate (collection);
+        wave_int_list * parent_index_list = wave_collection_get_full_indexes (wave_collection_get_parent (collection));
+        unsigned long int storage = _print_storage (alloc_file, value);
+
+        wave_code_generation_fprint_tab_with_init (code_file, parent_index_list, collection_coordinate, " = (wave_data) ");
+        _print_initializer (code_file, value, storage);
+        fprintf (code_file, ";\n");
+
+        wave_int_list_free (parent_index_list);
+    }
+
+    return is_folded;
+}
+
+void wave_code_generation_clean_fold (void)
+{
+    wave_garbage_clean ();
+}
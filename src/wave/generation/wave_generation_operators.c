@@ -124,11 +124,6 @@ static const char * const _operator_functions_strings[] =
 // Static functions for errors.
 ////////////////////////////////////////////////////////////////////////////////
 
-static inline void _type_error (FILE * const code_file)
-{
-    wave_code_generate_error (code_file, "trying to use an operator on non valid types.", "EX_DATAERR");
-}
-
 static inline void _operand_error (FILE * const code_file)
 {
     wave_code_generate_error (code_file, "no operand supplied to the operator.", "EX_DATAERR");
@@ -155,454 +150,438 @@ static inline void _print_tab_minus (FILE * const code_file, const wave_int_list
     wave_coordinate_free (shifted);
 }
 
-static inline void _print_arg (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, wave_atom_type t, int shift)
-{
-    _print_tab_minus (code_file, list, c, shift);
-    fprintf (code_file, "._content._%s", wave_generation_atom_type_string (t));
-}
+static bool _is_scalar (const wave_collection * collection);
+static void _print_scalar (FILE * code_file, const wave_collection * collection);
 
-static void _print_args_binary (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, wave_atom_type left, wave_atom_type right)
+/* Strings are read through wave_data_get_string(), since they may be stored in
+ * the data itself or in a string buffer. Scalar operands are read from their
+ * local variable.
+ */
+static inline void _print_arg (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, const wave_collection * const operand, wave_atom_type t, int shift)
 {
-    _print_arg (code_file, list, c, left, -2);
-    fprintf (code_file, ", ");
-    _print_arg (code_file, list, c, right, -1);
-    fprintf (code_file, ");\n");
+    if (_is_scalar (operand))
+        _print_scalar (code_file, operand);
+    else if (t == WAVE_ATOM_LITERAL_STRING)
+    {
+        fprintf (code_file, "wave_data_get_string (& ");
+        _print_tab_minus (code_file, list, c, shift);
+        fprintf (code_file, ")");
+    }
+    else
+    {
+        _print_tab_minus (code_file, list, c, shift);
+        fprintf (code_file, "._content._%s", wave_generation_atom_type_string (t));
+    }
 }
 
-static void _print_register_string (FILE * const code_file, const wave_int_list * const indexes, const wave_coordinate * const c)
+static void _print_args_binary (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, const wave_collection * const collection, wave_atom_type left, wave_atom_type right)
 {
-    fprintf (code_file, "wave_garbage_register (");
-    wave_generate_content_assignement (code_file, indexes, c, WAVE_ATOM_LITERAL_STRING);
+    const wave_collection * const right_operand = wave_collection_get_previous (collection);
+    _print_arg (code_file, list, c, wave_collection_get_previous (right_operand), left, -2);
+    fprintf (code_file, ", ");
+    _print_arg (code_file, list, c, right_operand, right, -1);
     fprintf (code_file, ");\n");
 }
 
-static inline void _print_operator_prelude (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, wave_atom_type t, wave_operator op)
+static inline void _print_operator_prelude (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, const wave_collection * const collection, wave_atom_type destination, wave_atom_type t, wave_operator op)
 {
-    wave_generate_type_assignement (code_file, list, c, t);
-    wave_generate_content_assignement (code_file, list, c, t);
+    if (_is_scalar (collection))
+        wave_code_generation_fprint_scalar_declaration (code_file, collection);
+    else
+    {
+        wave_generate_type_assignement (code_file, list, c, destination);
+        wave_generate_content_assignement (code_file, list, c, destination);
+    }
 
     /* The actual functions are named following the convention:
      * wave_<type>_<operation>
-     * Thus functions names can be found from the type.
+     * Thus functions names can be found from the type of the operands.
      */
     fprintf (code_file, " = wave_%s_%s", wave_generation_atom_type_string (t), _operator_functions_strings[op]);
 }
 
-////////////////////////////////////////////////////////////////////////////////
-// Static functions for dynamic operations.
-////////////////////////////////////////////////////////////////////////////////
-
-/* These functions are used when the type of at least one of the operands is
- * unknown.
- * The wave_data_unary() and wave_data_binary() functions determine at runtime
- * how to compute the requested operation.
- * See wave/common/wave_data.h.
+/* Copies an element into another one. The copies share their tabs, so
+ * wave_data_share() prevents in place updates of both of them.
  */
-
-static void _print_dynamic_unary (FILE * const code_file, const wave_int_list * const indexes, const wave_coordinate * const c, wave_operator op)
-{
-    fprintf (code_file, "wave_data_unary (& ");
-    _print_tab_minus (code_file, indexes, c, -1);
-    fprintf (code_file, ", & ");
-    wave_code_generation_fprint_tab_with_init(code_file, indexes, c, "");
-    fprintf (code_file, ", %s);\n", _operator_enum_strings[op]);
-}
-
-static void _print_dynamic_binary (FILE * const code_file, const wave_int_list * const indexes, const wave_coordinate * const c, wave_operator op)
+static void _print_share (FILE * const code_file, const wave_int_list * const destination_list, const wave_coordinate * const destination, const wave_int_list * const list, const wave_coordinate * const c, int shift)
 {
-    fprintf (code_file, "wave_data_binary (& ");
-    _print_tab_minus (code_file, indexes, c, -2);
+    fprintf (code_file, "wave_data_share (& ");
+    wave_code_generation_fprint_tab_with_init (code_file, destination_list, destination, "");
     fprintf (code_file, ", & ");
-    _print_tab_minus (code_file, indexes, c, -1);
-    fprintf (code_file, ", & ");
-    wave_code_generation_fprint_tab_with_init(code_file, indexes, c, "");
-    fprintf (code_file, ", %s);\n", _operator_enum_strings[op]);
+    _print_tab_minus (code_file, list, c, shift);
+    fprintf (code_file, ");\n");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Static functions for known types operations.
+// Static functions for operands.
 ////////////////////////////////////////////////////////////////////////////////
 
-/* Used for most unary operations. */
-static void _print_unary (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, wave_atom_type t, wave_operator op)
-{
-    _print_operator_prelude (code_file, list, c, t, op);
-    fprintf (code_file, " (");
-    _print_arg (code_file, list, c, t, -1);
-    fprintf (code_file, ");\n");
-}
-
-/* Used for binary operations where both operands are of the same type. */
-static void _print_binary (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, wave_atom_type destination, wave_atom_type left, wave_atom_type right, wave_operator op)
+static inline bool _is_repetition (const wave_collection * const collection)
 {
-    _print_operator_prelude (code_file, list, c, destination, op);
-    fprintf (code_file, " (");
-    _print_args_binary (code_file, list, c, left, right);
-    if (destination == WAVE_ATOM_LITERAL_STRING)
-        _print_register_string (code_file, list, c);
+    wave_collection_type t = wave_collection_get_type (collection);
+    return t == WAVE_COLLECTION_REP_SEQ || t == WAVE_COLLECTION_REP_PAR;
 }
 
-/* Used for binary operations where one of the operand is a char while the other
- * one is a string.
+/* Checks whether the elements read by an operator exist. The first elements of
+ * a repeated list read the elements of the previous iteration, or the ones
+ * preceding the repetition in the tab of its parent for the first iteration.
+ * Such operands have no collection: their types are unknown.
  */
-static void _print_binary_char_string (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, wave_atom_type destination, wave_atom_type left, wave_atom_type right, wave_operator op)
+static bool _has_operands (const wave_collection * const collection, int count)
 {
-    _print_operator_prelude (code_file, list, c, destination, op);
-    fprintf (code_file, "_char_%s", left == WAVE_ATOM_LITERAL_CHAR ? "left" : "right");
-    fprintf (code_file, " (");
-    _print_args_binary (code_file, list, c, left, right);
-    if (destination == WAVE_ATOM_LITERAL_STRING)
-        _print_register_string (code_file, list, c);
+    const wave_collection * c = collection;
+    for (; count > 0 && wave_collection_has_previous (c); --count)
+        c = wave_collection_get_previous (c);
+
+    if (count > 0 && wave_collection_has_parent (c) && _is_repetition (wave_collection_get_parent (c)))
+    {
+        const wave_coordinate * const start = wave_collection_get_coordinate (wave_collection_get_parent (c));
+        if (wave_coordinate_is_constant (start))
+            count -= wave_coordinate_get_constant (start);
+    }
+
+    return count <= 0;
 }
 
-static void _print_char_plus (FILE * const code_file, const wave_int_list * const indexes, const wave_coordinate * const c)
+/* Gets the inferred type of an operand, which may be missing. */
+static inline wave_atom_type _operand_type (const wave_collection * const operand)
 {
-    wave_generate_type_assignement (code_file, indexes, c, WAVE_ATOM_LITERAL_STRING);
-    wave_generate_content_assignement (code_file, indexes, c, WAVE_ATOM_LITERAL_STRING);
-    fprintf (code_file, " = wave_%s_%s", wave_generation_atom_type_string (WAVE_ATOM_LITERAL_CHAR), _operator_functions_strings[WAVE_OP_BINARY_PLUS]);
-    fprintf (code_file, " (");
-    _print_args_binary (code_file, indexes, c, WAVE_ATOM_LITERAL_CHAR, WAVE_ATOM_LITERAL_CHAR);
-    _print_register_string (code_file, indexes, c);
+    return operand != NULL ? wave_collection_get_inferred_type (operand) : WAVE_ATOM_UNKNOWN;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Specialized functions intended to be passed as a parameter to _unary().
+// Static functions for in place operations.
 ////////////////////////////////////////////////////////////////////////////////
 
-/* Specialized function for the ``chr`` operator. */
-static void _chr_for_unary (FILE * const code_file, const wave_coordinate * const c, wave_atom_type t, const wave_int_list * const indexes, wave_operator op)
+/* Paths may read any element of their phrase, thus the elements of a phrase
+ * containing paths are never known to be dead.
+ */
+static bool _phrase_has_path = true;
+
+/* Checks whether the elements of a collection can only be read by the
+ * operators following them.
+ * The elements of the root collection and of sequential collections ending
+ * with a cut are never referenced by another collection, while the elements of
+ * repeated and cyclic collections are read again by the next iterations.
+ */
+static bool _has_private_elements (const wave_collection * const collection)
 {
-    if (t == WAVE_ATOM_LITERAL_INT)
+    bool is_private = wave_collection_get_type (collection) == WAVE_COLLECTION_SEQ;
+
+    if (is_private && wave_collection_has_parent (collection))
     {
-        wave_generate_type_assignement (code_file, indexes, c, WAVE_ATOM_LITERAL_CHAR);
-        wave_generate_content_assignement (code_file, indexes, c, WAVE_ATOM_LITERAL_CHAR);
-        fprintf (code_file, " = wave_%s_%s", wave_generation_atom_type_string (WAVE_ATOM_LITERAL_INT), _operator_functions_strings[op]);
-        fprintf (code_file, " (");
-        _print_arg (code_file, indexes, c, t, -1);
-        fprintf (code_file, ");\n");
+        const wave_collection * last = wave_collection_get_list (collection);
+        while (last != NULL && wave_collection_has_next (last))
+            last = wave_collection_get_next (last);
+
+        is_private = last != NULL && wave_collection_get_type (last) == WAVE_COLLECTION_ATOM
+            && wave_atom_get_type (wave_collection_get_atom (last)) == WAVE_ATOM_OPERATOR
+            && wave_atom_get_operator (wave_collection_get_atom (last)) == WAVE_OP_SPECIFIC_CUT;
     }
-    else
-        _print_dynamic_unary (code_file, indexes, c, op);
-}
 
-/* Specialized function for the ``code`` operator. */
-static void _code_for_unary (FILE * const code_file, const wave_coordinate * const c, wave_atom_type t, const wave_int_list * const indexes, wave_operator op)
-{
-    if (t == WAVE_ATOM_LITERAL_CHAR)
+    for (const wave_collection * c = collection; is_private && c != NULL; c = wave_collection_get_parent (c))
     {
-        wave_generate_type_assignement (code_file, indexes, c, WAVE_ATOM_LITERAL_INT);
-        wave_generate_content_assignement (code_file, indexes, c, WAVE_ATOM_LITERAL_INT);
-        fprintf (code_file, " = wave_%s_%s", wave_generation_atom_type_string (WAVE_ATOM_LITERAL_CHAR), _operator_functions_strings[op]);
-        fprintf (code_file, " (");
-        _print_arg (code_file, indexes, c, t, -1);
-        fprintf (code_file, ");\n");
+        wave_collection_type t = wave_collection_get_type (c);
+        is_private = t != WAVE_COLLECTION_REP_SEQ && t != WAVE_COLLECTION_REP_PAR
+            && t != WAVE_COLLECTION_CYCLIC_SEQ && t != WAVE_COLLECTION_CYCLIC_PAR;
     }
-    else
-        _print_dynamic_unary (code_file, indexes, c, op);
-}
 
-/* Specialized function for unary operations that are valid for bot int and
- * float values.
- */
-static void _int_float_for_unary (FILE * const code_file, const wave_coordinate * const c, wave_atom_type t, const wave_int_list * const indexes, wave_operator op)
-{
-    if (t == WAVE_ATOM_LITERAL_INT || t == WAVE_ATOM_LITERAL_FLOAT)
-        _print_unary (code_file, indexes, c, t, op);
-    else
-        _print_dynamic_unary (code_file, indexes, c, op);
+    return is_private;
 }
 
-/* Specialized function valid only for bool values. */
-static void _bool (FILE * const code_file, const wave_coordinate * const c, wave_atom_type t, const wave_int_list * const indexes, wave_operator op)
+/* Checks whether an operand is the result of an operation and is not read
+ * after the operator ``user``.
+ * An element is read by the two following operators at most: only a binary
+ * operator or a stop following ``user`` may read its previous element again.
+ */
+static bool _is_last_use (const wave_collection * const operand, const wave_collection * const user)
 {
-    if (t == WAVE_ATOM_LITERAL_BOOL)
-        _print_unary (code_file, indexes, c, t, op);
-    else
-        _print_dynamic_unary (code_file, indexes, c, op);
-}
+    bool is_last = ! _phrase_has_path && operand != NULL && wave_collection_get_type (operand) == WAVE_COLLECTION_ATOM;
 
-////////////////////////////////////////////////////////////////////////////////
-//  _unary().
-////////////////////////////////////////////////////////////////////////////////
+    if (is_last)
+    {
+        const wave_atom * const a = wave_collection_get_atom (operand);
+        is_last = wave_atom_get_type (a) == WAVE_ATOM_OPERATOR
+            && (wave_operator_is_unary (wave_atom_get_operator (a)) || wave_operator_is_binary (wave_atom_get_operator (a)))
+            && wave_collection_has_parent (operand)
+            && _has_private_elements (wave_collection_get_parent (operand));
+    }
 
-/* Checks whether the type of the operand is known and is fit (ie, the operand
- * holds a constant).
- * If the operand is a constant, use the specialized function passed as ``fun``.
- * Otherwise, try with the dynamic unary function.
- */
-static void _unary (FILE * const code_file, const wave_collection * const collection, wave_operator op, void (* fun) (FILE *, const wave_coordinate *, wave_atom_type, const wave_int_list *, wave_operator))
-{
-    if (wave_collection_has_previous (collection))
+    if (is_last && wave_collection_get_previous (user) == operand && wave_collection_has_next (user))
     {
-        wave_collection * previous = wave_collection_get_previous (collection);
-        wave_collection_type tc = wave_collection_get_type (previous);
-        wave_int_list * indexes = wave_collection_get_full_indexes (wave_collection_get_parent(collection));
-        wave_coordinate * c = wave_collection_get_coordinate (collection);
-        if (tc == WAVE_COLLECTION_ATOM)
+        const wave_collection * const next = wave_collection_get_next (user);
+        if (wave_collection_get_type (next) == WAVE_COLLECTION_ATOM
+            && wave_atom_get_type (wave_collection_get_atom (next)) == WAVE_ATOM_OPERATOR)
         {
-            wave_atom * a = wave_collection_get_atom (previous);
-            wave_atom_type ta = wave_atom_get_type (a);
-            if (ta == WAVE_ATOM_OPERATOR || ta == WAVE_ATOM_PATH)
-                _print_dynamic_unary (code_file, indexes, c, op);
-            else
-                fun (code_file, c, ta, indexes, op);
+            wave_operator op = wave_atom_get_operator (wave_collection_get_atom (next));
+            is_last = ! wave_operator_is_binary (op) && op != WAVE_OP_SPECIFIC_STOP;
         }
-        else if (tc == WAVE_COLLECTION_PAR)
-            _print_dynamic_unary (code_file, indexes, c, op);
         else
-            _print_dynamic_unary (code_file, indexes, c, op);
-        wave_int_list_free (indexes);
+            is_last = ! _is_repetition (next);
     }
-    else
-        _operand_error (code_file);
-}
 
-////////////////////////////////////////////////////////////////////////////////
-// Specialized functions intended to be passed as a parameter to _binary().
-////////////////////////////////////////////////////////////////////////////////
+    return is_last;
+}
 
-/* Specialized function for binary operations that are valid for both int and
- * float values.
+/* Flags an operand which is not read anymore, so that wave_data_unary() and
+ * wave_data_binary() may compute the result in its storage.
  */
-static void _int_float_for_binary (FILE * const code_file, const wave_coordinate * const c, wave_atom_type left, wave_atom_type right, const wave_int_list * const indexes, wave_operator op)
+static void _print_last_use (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, const wave_collection * const operand, const wave_collection * const user, int shift)
 {
-    if (left == right)
-    {
-        if (left == WAVE_ATOM_LITERAL_INT)
-            _print_binary (code_file, indexes, c, left, left, right, op);
-        else if (left == WAVE_ATOM_LITERAL_FLOAT)
-            _print_binary (code_file, indexes, c, left, left, right, op);
-        else
-            _print_dynamic_binary (code_file, indexes, c, op);
-    }
-    else
+    if (_is_last_use (operand, user))
     {
-        if (left == WAVE_ATOM_LITERAL_INT && right == WAVE_ATOM_LITERAL_FLOAT)
-            _print_binary (code_file, indexes, c, WAVE_ATOM_LITERAL_FLOAT, left, right, op);
-        else if (left == WAVE_ATOM_LITERAL_FLOAT && right == WAVE_ATOM_LITERAL_INT)
-            _print_binary (code_file, indexes, c, WAVE_ATOM_LITERAL_FLOAT, left, right, op);
-        else
-            _print_dynamic_binary (code_file, indexes, c, op);
+        _print_tab_minus (code_file, list, c, shift);
+        fprintf (code_file, "._flags |= WAVE_DATA_FLAG_LAST_USE;\n");
     }
 }
 
-/* Specialized function for binary operations that are valid for all types. */
-static void _all_for_binary (FILE * const code_file, const wave_coordinate * const c, wave_atom_type left, wave_atom_type right, const wave_int_list * const indexes, wave_operator op)
+////////////////////////////////////////////////////////////////////////////////
+// Static functions for scalar elements.
+////////////////////////////////////////////////////////////////////////////////
+
+/* The last collection checked by _is_scalar(), whose elements are all checked
+ * in a row.
+ */
+static const wave_collection * _scalar_parent = NULL;
+static bool _scalar_parent_is_private = false;
+
+/* Gets the operator of a collection, or WAVE_OP_UNKNOWN. */
+static wave_operator _collection_operator (const wave_collection * const collection)
 {
-    if (left == right)
-        _print_binary (code_file, indexes, c, left, left, right, op);
-    else
-    {
-        if ((left == WAVE_ATOM_LITERAL_INT && right == WAVE_ATOM_LITERAL_FLOAT)
-            || (left == WAVE_ATOM_LITERAL_FLOAT && right == WAVE_ATOM_LITERAL_INT))
-            _print_binary (code_file, indexes, c, WAVE_ATOM_LITERAL_FLOAT, left, right, op);
-        else if ((left == WAVE_ATOM_LITERAL_CHAR && right == WAVE_ATOM_LITERAL_STRING)
-            || (left == WAVE_ATOM_LITERAL_STRING && right == WAVE_ATOM_LITERAL_CHAR))
-            _print_binary_char_string (code_file, indexes, c, WAVE_ATOM_LITERAL_STRING, left, right, op);
-        else
-            _print_dynamic_binary (code_file, indexes, c, op);
-    }
+    wave_operator op = WAVE_OP_UNKNOWN;
+    if (collection != NULL && wave_collection_get_type (collection) == WAVE_COLLECTION_ATOM
+        && wave_atom_get_type (wave_collection_get_atom (collection)) == WAVE_ATOM_OPERATOR)
+        op = wave_atom_get_operator (wave_collection_get_atom (collection));
+
+    return op;
 }
 
-/* Specialized function for the ``get`` operation. */
-static void _get_for_binary (FILE * const code_file, const wave_coordinate * const c, wave_atom_type left, wave_atom_type right, const wave_int_list * const indexes, wave_operator op)
+/* Checks whether an operator is generated as a direct call to the functions of
+ * wave/common/wave_types.h, see _unary() and _binary(). Such operators only
+ * read the content of their operands.
+ */
+static bool _is_direct (const wave_collection * const collection)
 {
-    if (left == WAVE_ATOM_LITERAL_STRING && right == WAVE_ATOM_LITERAL_INT)
-        _print_binary (code_file, indexes, c, WAVE_ATOM_LITERAL_CHAR, left, right, op);
-    else
-        _print_dynamic_binary (code_file, indexes, c, op);
+    wave_operator op = _collection_operator (collection);
+    wave_atom_type t = wave_collection_get_inferred_type (collection);
+    return ((wave_operator_is_unary (op) && t != WAVE_ATOM_UNKNOWN)
+        || (wave_operator_is_binary (op) && t != WAVE_ATOM_UNKNOWN && t != WAVE_ATOM_LITERAL_STRING));
 }
 
-/* Specialized function for the ``plus`` operation. */
-static void _plus_for_binary (FILE * const code_file, const wave_coordinate * const c, wave_atom_type left, wave_atom_type right, const wave_int_list * const indexes, wave_operator op)
-{
-    if (left != WAVE_ATOM_LITERAL_BOOL && right != WAVE_ATOM_LITERAL_BOOL)
+/* Checks whether an element is an integer or a floating point value only read
+ * by direct operators, so that it can be stored in a local variable instead of
+ * the tab of its collection.
+ * The elements are read by the next operator, and by the operator after it
+ * when it is a binary operator or a stop. The tab itself must never be read,
+ * see _has_private_elements(), and the element must not be addressed by a
+ * path.
+ */
+static bool _is_scalar (const wave_collection * const collection)
+{
+    wave_atom_type t = wave_collection_get_inferred_type (collection);
+    wave_operator op = _collection_operator (collection);
+    bool is_scalar = ! _phrase_has_path
+        && (t == WAVE_ATOM_LITERAL_INT || t == WAVE_ATOM_LITERAL_FLOAT)
+        && (op == WAVE_OP_UNKNOWN || _is_direct (collection))
+        && wave_collection_get_type (collection) == WAVE_COLLECTION_ATOM
+        && wave_collection_has_parent (collection)
+        && wave_coordinate_is_constant (wave_collection_get_coordinate (collection));
+
+    if (is_scalar)
     {
-        if (left == right)
-        {
-            if (left == WAVE_ATOM_LITERAL_CHAR)
-                _print_char_plus (code_file, indexes, c);
-            else
-                _print_binary (code_file, indexes, c, left, left, right, op);
-        }
-        else
+        const wave_collection * const parent = wave_collection_get_parent (collection);
+        if (parent != _scalar_parent)
         {
-            if ((left == WAVE_ATOM_LITERAL_INT && right == WAVE_ATOM_LITERAL_FLOAT)
-                || (left == WAVE_ATOM_LITERAL_FLOAT && right == WAVE_ATOM_LITERAL_INT))
-                _print_binary (code_file, indexes, c, WAVE_ATOM_LITERAL_FLOAT, left, right, op);
-            else if ((left == WAVE_ATOM_LITERAL_CHAR && right == WAVE_ATOM_LITERAL_STRING)
-                || (left == WAVE_ATOM_LITERAL_STRING && right == WAVE_ATOM_LITERAL_CHAR))
-                _print_binary_char_string (code_file, indexes, c, WAVE_ATOM_LITERAL_STRING, left, right, op);
-            else
-                _print_dynamic_binary (code_file, indexes, c, op);
+            _scalar_parent = parent;
+            _scalar_parent_is_private = _has_private_elements (parent);
         }
+        is_scalar = _scalar_parent_is_private;
     }
-    else
-        _print_dynamic_binary (code_file, indexes, c, op);
-}
 
-/* Specialized function for binary operations valid only on bool values. */
-static void _bool_for_binary (FILE * const code_file, const wave_coordinate * const c, wave_atom_type left, wave_atom_type right, const wave_int_list * const indexes, wave_operator op)
-{
-    if (left == WAVE_ATOM_LITERAL_BOOL && right == WAVE_ATOM_LITERAL_BOOL)
-        _print_binary (code_file, indexes, c, left, left, right, op);
-    else
-        _type_error (code_file);
-}
+    bool is_read = false;
+    const wave_collection * const next = is_scalar ? wave_collection_get_next (collection) : NULL;
+    if (next != NULL && _collection_operator (next) != WAVE_OP_UNKNOWN)
+    {
+        is_read = true;
+        is_scalar = _is_direct (next);
+    }
 
-////////////////////////////////////////////////////////////////////////////////
-// _binary().
-////////////////////////////////////////////////////////////////////////////////
+    /* The elements preceding a repetition are read by its loop. */
+    if (next != NULL && _is_repetition (next))
+        is_scalar = false;
 
-/* Checks whether the types of the operands are known and fit (ie, the operands
- * hold constants).
- * If thes operands are constants, use the specialized function passed as ``fun``.
- * Otherwise, try with the dynamic binary function.
- */
-static void _binary (FILE * const code_file, const wave_collection * const collection, wave_operator op, void (* fun) (FILE *, const wave_coordinate *, wave_atom_type,  wave_atom_type, const wave_int_list *, wave_operator))
-{
-    if (wave_collection_has_previous (collection) && wave_collection_has_previous (wave_collection_get_previous (collection)))
+    const wave_collection * const after = is_scalar && next != NULL ? wave_collection_get_next (next) : NULL;
+    if (after != NULL && _is_repetition (after))
+        is_scalar = false;
+
+    wave_operator after_op = _collection_operator (after);
+    if (wave_operator_is_binary (after_op) || after_op == WAVE_OP_SPECIFIC_STOP)
     {
-        wave_collection * right = wave_collection_get_previous (collection);
-        wave_collection * left = wave_collection_get_previous (right);
-        wave_collection_type tc_right = wave_collection_get_type (right);
-        wave_collection_type tc_left = wave_collection_get_type (left);
-        wave_coordinate * c = wave_collection_get_coordinate (collection);
-        wave_int_list * indexes = wave_collection_get_full_indexes (wave_collection_get_parent(collection));
-        if (tc_right == WAVE_COLLECTION_ATOM && tc_left == WAVE_COLLECTION_ATOM)
-        {
-            wave_atom * a_right = wave_collection_get_atom (right);
-            wave_atom * a_left = wave_collection_get_atom (left);
-            wave_atom_type ta_right = wave_atom_get_type (a_right);
-            wave_atom_type ta_left = wave_atom_get_type (a_left);
-            if (ta_left == WAVE_ATOM_PATH || ta_left == WAVE_ATOM_OPERATOR
-                || ta_right == WAVE_ATOM_PATH || ta_right == WAVE_ATOM_OPERATOR)
-                _print_dynamic_binary (code_file, indexes, c, op);
-            else
-                fun (code_file, c, ta_left, ta_right, indexes, op);
-        }
-        else if (tc_left == tc_right && tc_left == WAVE_COLLECTION_PAR)
-            _print_dynamic_binary (code_file, indexes, c, op);
-        else if (tc_right == WAVE_COLLECTION_ATOM && tc_left == WAVE_COLLECTION_PAR)
-        {
-            wave_atom * a = wave_collection_get_atom (right);
-            wave_atom_type ta = wave_atom_get_type (a);
-            if (ta == WAVE_ATOM_PATH || ta == WAVE_ATOM_OPERATOR)
-                _print_dynamic_binary (code_file, indexes, c, op);
-            else
-                _print_dynamic_binary (code_file, indexes, c, op);
-        }
-        else if (tc_left == WAVE_COLLECTION_ATOM && tc_right == WAVE_COLLECTION_PAR)
-        {
-            wave_atom * a = wave_collection_get_atom (left);
-            wave_atom_type ta = wave_atom_get_type (a);
-            if (ta == WAVE_ATOM_PATH || ta == WAVE_ATOM_OPERATOR)
-                _print_dynamic_binary (code_file, indexes, c, op);
-            else
-                _print_dynamic_binary (code_file, indexes, c, op);
-        }
-        else
-            _print_dynamic_binary (code_file, indexes, c, op);
-        wave_int_list_free (indexes);
+        is_read = true;
+        is_scalar = _is_direct (after);
     }
-    else
-        _operand_error (code_file);
+
+    return is_scalar && is_read;
+}
+
+/* Prints the name of the local variable of a scalar element. */
+static void _print_scalar (FILE * const code_file, const wave_collection * const collection)
+{
+    wave_int_list * indexes = wave_collection_get_full_indexes (wave_collection_get_parent (collection));
+    fprintf (code_file, "wave_scalar");
+    wave_int_list_code_fprint (code_file, indexes);
+    fprintf (code_file, "_%d", wave_coordinate_get_constant (wave_collection_get_coordinate (collection)));
+    wave_int_list_free (indexes);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Operation functions.
+// Static functions for dynamic operations.
 ////////////////////////////////////////////////////////////////////////////////
-/** \cond Doxygen ignore. */
 
-/**
- * \brief Define all operation functions from a name and a generic function.
- * \param function_name Partial function name.
- * \param generic_function Generic function.
+/* These functions are used when the type of at least one of the operands is
+ * unknown.
+ * The wave_data_unary() and wave_data_binary() functions determine at runtime
+ * how to compute the requested operation.
+ * See wave/common/wave_data.h.
  */
-#define _def_operator_function(function_name, generic_function) \
-    static void function_name (FILE * code_file, const wave_collection * collection, wave_operator op) \
-    { \
-        generic_function (code_file, collection, op); \
-    }
 
-static inline void _unary_int_float (FILE * code_file, const wave_collection * collection, wave_operator op)
+static void _print_dynamic_unary (FILE * const code_file, const wave_int_list * const indexes, const wave_coordinate * const c, wave_operator op)
 {
-    _unary (code_file, collection, op, _int_float_for_unary);
+    fprintf (code_file, "wave_data_unary (& ");
+    _print_tab_minus (code_file, indexes, c, -1);
+    fprintf (code_file, ", & ");
+    wave_code_generation_fprint_tab_with_init(code_file, indexes, c, "");
+    fprintf (code_file, ", %s);\n", _operator_enum_strings[op]);
 }
 
-static inline void _binary_int_float (FILE * code_file, const wave_collection * collection, wave_operator op)
+static void _print_dynamic_binary (FILE * const code_file, const wave_int_list * const indexes, const wave_coordinate * const c, wave_operator op)
 {
-    _binary (code_file, collection, op, _int_float_for_binary);
+    fprintf (code_file, "wave_data_binary (& ");
+    _print_tab_minus (code_file, indexes, c, -2);
+    fprintf (code_file, ", & ");
+    _print_tab_minus (code_file, indexes, c, -1);
+    fprintf (code_file, ", & ");
+    wave_code_generation_fprint_tab_with_init(code_file, indexes, c, "");
+    fprintf (code_file, ", %s);\n", _operator_enum_strings[op]);
 }
 
-static inline void _binary_all (FILE * code_file, const wave_collection * collection, wave_operator op)
+/* Used when one operand is a constant and the other one a parallel collection:
+ * wave_data_broadcast() goes straight to the broadcast kernels.
+ */
+static void _print_broadcast (FILE * const code_file, const wave_int_list * const indexes, const wave_coordinate * const c, wave_operator op)
 {
-    _binary (code_file, collection, op, _all_for_binary);
+    fprintf (code_file, "wave_data_broadcast (& ");
+    _print_tab_minus (code_file, indexes, c, -2);
+    fprintf (code_file, ", & ");
+    _print_tab_minus (code_file, indexes, c, -1);
+    fprintf (code_file, ", & ");
+    wave_code_generation_fprint_tab_with_init(code_file, indexes, c, "");
+    fprintf (code_file, ", %s);\n", _operator_enum_strings[op]);
 }
 
-static inline void _binary_bool (FILE * code_file, const wave_collection * collection, wave_operator op)
-{
-    _binary (code_file, collection, op, _bool_for_binary);
-}
+////////////////////////////////////////////////////////////////////////////////
+// Static functions for known types operations.
+////////////////////////////////////////////////////////////////////////////////
 
-_def_operator_function (_unary_plus, _unary_int_float)
-_def_operator_function (_unary_minus, _unary_int_float)
-_def_operator_function (_unary_increment, _unary_int_float)
-_def_operator_function (_unary_decrement, _unary_int_float)
-_def_operator_function (_unary_sqrt, _unary_int_float)
-_def_operator_function (_unary_sin, _unary_int_float)
-_def_operator_function (_unary_cos, _unary_int_float)
-_def_operator_function (_unary_log, _unary_int_float)
-_def_operator_function (_unary_exp, _unary_int_float)
-_def_operator_function (_unary_ceil, _unary_int_float)
-_def_operator_function (_unary_floor, _unary_int_float)
+/* These functions are used when the types of the operands and of the result
+ * are known, see wave_collection_compute_types(). The functions of
+ * wave/common/wave_types.h are called directly.
+ */
 
-static void _unary_not (FILE * code_file, const wave_collection * collection, wave_operator op)
+static void _print_unary (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, const wave_collection * const collection, wave_atom_type destination, wave_atom_type t, wave_operator op)
 {
-    _unary (code_file, collection, op, _bool);
+    _print_operator_prelude (code_file, list, c, collection, destination, t, op);
+    fprintf (code_file, " (");
+    _print_arg (code_file, list, c, wave_collection_get_previous (collection), t, -1);
+    fprintf (code_file, ");\n");
 }
 
-static void _unary_chr (FILE * code_file, const wave_collection * collection, wave_operator op)
+/* The functions are named after the type of their operands. Mixed int and
+ * float operands are computed on floats, mixed char and string operands on
+ * strings, by the functions suffixed with the side of the char. The ``get``
+ * function is named after the type of its result.
+ */
+static void _print_binary (FILE * const code_file, const wave_int_list * const list, const wave_coordinate * const c, const wave_collection * const collection, wave_atom_type destination, wave_atom_type left, wave_atom_type right, wave_operator op)
 {
-    _unary (code_file, collection, op, _chr_for_unary);
-}
+    wave_atom_type t = left;
+    const char * suffix = "";
+    if (op == WAVE_OP_BINARY_GET)
+        t = destination;
+    else if (left == WAVE_ATOM_LITERAL_CHAR && right == WAVE_ATOM_LITERAL_STRING)
+        t = right, suffix = "_char_left";
+    else if (left == WAVE_ATOM_LITERAL_STRING && right == WAVE_ATOM_LITERAL_CHAR)
+        t = left, suffix = "_char_right";
+    else if (left != right)
+        t = WAVE_ATOM_LITERAL_FLOAT;
 
-static void _unary_code (FILE * code_file, const wave_collection * collection, wave_operator op)
-{
-    _unary (code_file, collection, op, _code_for_unary);
+    _print_operator_prelude (code_file, list, c, collection, destination, t, op);
+    fprintf (code_file, "%s (", suffix);
+    _print_args_binary (code_file, list, c, collection, left, right);
 }
 
-_def_operator_function (_binary_minus, _binary_int_float)
-_def_operator_function (_binary_times, _binary_int_float)
-_def_operator_function (_binary_divide, _binary_int_float)
-_def_operator_function (_binary_mod, _binary_int_float)
-
-_def_operator_function (_binary_min, _binary_all)
-_def_operator_function (_binary_max, _binary_all)
-_def_operator_function (_binary_equals, _binary_all)
-_def_operator_function (_binary_differs, _binary_all)
-_def_operator_function (_binary_lesser_or_equals, _binary_all)
-_def_operator_function (_binary_greater_or_equals, _binary_all)
-_def_operator_function (_binary_greater, _binary_all)
-_def_operator_function (_binary_lesser, _binary_all)
-
-_def_operator_function (_binary_and, _binary_bool)
-_def_operator_function (_binary_or, _binary_bool)
+////////////////////////////////////////////////////////////////////////////////
+//  _unary(), _binary().
+////////////////////////////////////////////////////////////////////////////////
 
-static void _binary_plus (FILE * code_file, const wave_collection * collection, wave_operator op)
+/* Checks whether the types of the operand and of the result are known.
+ * Otherwise, use the dynamic unary function.
+ */
+static void _unary (FILE * const code_file, const wave_collection * const collection, wave_operator op)
 {
-    _binary (code_file, collection, op, _plus_for_binary);
+    if (_has_operands (collection, 1))
+    {
+        wave_collection * previous = wave_collection_get_previous (collection);
+        wave_int_list * indexes = wave_collection_get_full_indexes (wave_collection_get_parent(collection));
+        wave_coordinate * c = wave_collection_get_coordinate (collection);
+        wave_atom_type destination = wave_collection_get_inferred_type (collection);
+        if (destination != WAVE_ATOM_UNKNOWN)
+            _print_unary (code_file, indexes, c, collection, destination, _operand_type (previous), op);
+        else
+        {
+            _print_last_use (code_file, indexes, c, previous, collection, -1);
+            _print_dynamic_unary (code_file, indexes, c, op);
+        }
+        wave_int_list_free (indexes);
+    }
+    else
+        _operand_error (code_file);
 }
 
-static void _binary_get (FILE * code_file, const wave_collection * collection, wave_operator op)
+/* Checks whether the types of the operands and of the result are known.
+ * Strings are computed by wave_data_binary(), which stores the small ones in
+ * the data itself and the others in the garbage collector.
+ * An atom of known type and a parallel collection are given to the broadcast
+ * function. Otherwise, use the dynamic binary function.
+ */
+static void _binary (FILE * const code_file, const wave_collection * const collection, wave_operator op)
 {
-    _binary (code_file, collection, op, _get_for_binary);
+    if (_has_operands (collection, 2))
+    {
+        wave_collection * right = wave_collection_get_previous (collection);
+        wave_collection * left = right != NULL ? wave_collection_get_previous (right) : NULL;
+        wave_atom_type t_right = _operand_type (right);
+        wave_atom_type t_left = _operand_type (left);
+        wave_atom_type destination = wave_collection_get_inferred_type (collection);
+        wave_coordinate * c = wave_collection_get_coordinate (collection);
+        wave_int_list * indexes = wave_collection_get_full_indexes (wave_collection_get_parent(collection));
+        if (destination != WAVE_ATOM_UNKNOWN && destination != WAVE_ATOM_LITERAL_STRING)
+            _print_binary (code_file, indexes, c, collection, destination, t_left, t_right, op);
+        else
+        {
+            _print_last_use (code_file, indexes, c, left, collection, -2);
+            _print_last_use (code_file, indexes, c, right, collection, -1);
+            if ((left != NULL && wave_collection_get_type (left) == WAVE_COLLECTION_PAR && t_right != WAVE_ATOM_UNKNOWN)
+                || (t_left != WAVE_ATOM_UNKNOWN && wave_collection_get_type (right) == WAVE_COLLECTION_PAR))
+                _print_broadcast (code_file, indexes, c, op);
+            else
+                _print_dynamic_binary (code_file, indexes, c, op);
+        }
+        wave_int_list_free (indexes);
+    }
+    else
+        _operand_error (code_file);
 }
 
-#undef _def_operator_function
-
-/** \endcond Doxygen ignore. */
-
 ////////////////////////////////////////////////////////////////////////////////
 // Specific operators.
 ////////////////////////////////////////////////////////////////////////////////
@@ -616,14 +595,11 @@ static void _specific_print (FILE * const code_file, const wave_collection * con
         wave_int_list * indexes = wave_collection_get_full_indexes (wave_collection_get_parent(collection));
         wave_coordinate * c = wave_collection_get_coordinate (collection);
 
-        wave_code_generation_fprint_tab_with_init(code_file, indexes, c, "");
-        fprintf (code_file, " = ");
-        _print_tab_minus (code_file, indexes, c, -1);
-        fprintf (code_file, ";\n");
+        _print_share (code_file, indexes, c, indexes, c, -1);
 
-        fprintf (code_file, "wave_data_fprint (stdout, & ");
+        fprintf (code_file, "wave_data_print (& ");
         _print_tab_minus (code_file, indexes, c, -1);
-        fprintf (code_file, ");\nprintf(\"\\n\");\n");
+        fprintf (code_file, ");\n");
         wave_int_list_free (indexes);
     }
     else
@@ -648,6 +624,20 @@ static void _specific_atom (FILE * const code_file, const wave_collection * cons
         _operand_error (code_file);
 }
 
+static void _specific_read (FILE * const code_file, const wave_collection * const collection, wave_operator op)
+{
+    (void) op;
+
+    wave_int_list * indexes = wave_collection_get_full_indexes (wave_collection_get_parent (collection));
+    wave_coordinate * c = wave_collection_get_coordinate (collection);
+
+    fprintf (code_file, "wave_input_read (& ");
+    wave_code_generation_fprint_tab_with_init (code_file, indexes, c, "");
+    fprintf (code_file, ");\n");
+
+    wave_int_list_free (indexes);
+}
+
 static void _specific_stop (FILE * const code_file, const wave_collection * const collection, wave_operator op)
 {
     (void) op;
@@ -670,18 +660,12 @@ static void _specific_stop (FILE * const code_file, const wave_collection * cons
         wave_int_list * parent_indexes = wave_collection_get_full_indexes (parent_parent);
         wave_coordinate * parent_coordinate = wave_collection_get_coordinate (parent);
 
-        wave_code_generation_fprint_tab_with_init(code_file, parent_indexes, parent_coordinate, "");
-        fprintf (code_file, " = ");
-        _print_tab_minus (code_file, indexes, c, -1);
-        fprintf (code_file, ";\n");
+        _print_share (code_file, parent_indexes, parent_coordinate, indexes, c, -1);
 
         fprintf (code_file, "}\nelse\n{\n");
         wave_generate_stack_curly ();
 
-        wave_code_generation_fprint_tab_with_init(code_file, indexes, c, "");
-        fprintf (code_file, " = ");
-        _print_tab_minus (code_file, indexes, c, -1);
-        fprintf (code_file, ";\n");
+        _print_share (code_file, indexes, c, indexes, c, -1);
 
         wave_int_list_free (indexes);
         wave_int_list_free (parent_indexes);
@@ -704,10 +688,7 @@ static void _specific_cut (FILE * const code_file, const wave_collection * const
         wave_int_list * parent_indexes = wave_collection_get_full_indexes (parent_parent);
         wave_coordinate * parent_coordinate = wave_collection_get_coordinate (parent);
 
-        wave_code_generation_fprint_tab_with_init(code_file, parent_indexes, parent_coordinate, "");
-        fprintf (code_file, " = ");
-        _print_tab_minus (code_file, indexes, c, -1);
-        fprintf (code_file, ";\n");
+        _print_share (code_file, parent_indexes, parent_coordinate, indexes, c, -1);
 
         wave_int_list_free (indexes);
         wave_int_list_free (parent_indexes);
@@ -722,40 +703,40 @@ static void _specific_cut (FILE * const code_file, const wave_collection * const
 
 static void (* const _operator_functions[]) (FILE *, const wave_collection *, wave_operator) =
 {
-    [WAVE_OP_UNARY_PLUS]                = _unary_plus,
-    [WAVE_OP_UNARY_MINUS]               = _unary_minus,
-    [WAVE_OP_UNARY_INCREMENT]           = _unary_increment,
-    [WAVE_OP_UNARY_DECREMENT]           = _unary_decrement,
-    [WAVE_OP_UNARY_SQRT]                = _unary_sqrt,
-    [WAVE_OP_UNARY_SIN]                 = _unary_sin,
-    [WAVE_OP_UNARY_COS]                 = _unary_cos,
-    [WAVE_OP_UNARY_NOT]                 = _unary_not,
-    [WAVE_OP_UNARY_LOG]                 = _unary_log,
-    [WAVE_OP_UNARY_EXP]                 = _unary_exp,
-    [WAVE_OP_UNARY_CEIL]                = _unary_ceil,
-    [WAVE_OP_UNARY_FLOOR]               = _unary_floor,
-    [WAVE_OP_UNARY_CHR]                 = _unary_chr,
-    [WAVE_OP_UNARY_CODE]                = _unary_code,
-    [WAVE_OP_BINARY_PLUS]               = _binary_plus,
-    [WAVE_OP_BINARY_MINUS]              = _binary_minus,
-    [WAVE_OP_BINARY_MIN]                = _binary_min,
-    [WAVE_OP_BINARY_MAX]                = _binary_max,
-    [WAVE_OP_BINARY_TIMES]              = _binary_times,
-    [WAVE_OP_BINARY_DIVIDE]             = _binary_divide,
-    [WAVE_OP_BINARY_MOD]                = _binary_mod,
-    [WAVE_OP_BINARY_EQUALS]             = _binary_equals,
-    [WAVE_OP_BINARY_DIFFERS]            = _binary_differs,
-    [WAVE_OP_BINARY_LESSER_OR_EQUALS]   = _binary_lesser_or_equals,
-    [WAVE_OP_BINARY_GREATER_OR_EQUALS]  = _binary_greater_or_equals,
-    [WAVE_OP_BINARY_GREATER]            = _binary_greater,
-    [WAVE_OP_BINARY_LESSER]             = _binary_lesser,
-    [WAVE_OP_BINARY_AND]                = _binary_and,
-    [WAVE_OP_BINARY_OR]                 = _binary_or,
-    [WAVE_OP_BINARY_GET]                = _binary_get,
+    [WAVE_OP_UNARY_PLUS]                = _unary,
+    [WAVE_OP_UNARY_MINUS]               = _unary,
+    [WAVE_OP_UNARY_INCREMENT]           = _unary,
+    [WAVE_OP_UNARY_DECREMENT]           = _unary,
+    [WAVE_OP_UNARY_SQRT]                = _unary,
+    [WAVE_OP_UNARY_SIN]                 = _unary,
+    [WAVE_OP_UNARY_COS]                 = _unary,
+    [WAVE_OP_UNARY_NOT]                 = _unary,
+    [WAVE_OP_UNARY_LOG]                 = _unary,
+    [WAVE_OP_UNARY_EXP]                 = _unary,
+    [WAVE_OP_UNARY_CEIL]                = _unary,
+    [WAVE_OP_UNARY_FLOOR]               = _unary,
+    [WAVE_OP_UNARY_CHR]                 = _unary,
+    [WAVE_OP_UNARY_CODE]                = _unary,
+    [WAVE_OP_BINARY_PLUS]               = _binary,
+    [WAVE_OP_BINARY_MINUS]              = _binary,
+    [WAVE_OP_BINARY_MIN]                = _binary,
+    [WAVE_OP_BINARY_MAX]                = _binary,
+    [WAVE_OP_BINARY_TIMES]              = _binary,
+    [WAVE_OP_BINARY_DIVIDE]             = _binary,
+    [WAVE_OP_BINARY_MOD]                = _binary,
+    [WAVE_OP_BINARY_EQUALS]             = _binary,
+    [WAVE_OP_BINARY_DIFFERS]            = _binary,
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS]   = _binary,
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS]  = _binary,
+    [WAVE_OP_BINARY_GREATER]            = _binary,
+    [WAVE_OP_BINARY_LESSER]             = _binary,
+    [WAVE_OP_BINARY_AND]                = _binary,
+    [WAVE_OP_BINARY_OR]                 = _binary,
+    [WAVE_OP_BINARY_GET]                = _binary,
     [WAVE_OP_SPECIFIC_ATOM]             = _specific_atom,
     [WAVE_OP_SPECIFIC_STOP]             = _specific_stop,
     [WAVE_OP_SPECIFIC_CUT]              = _specific_cut,
-    [WAVE_OP_SPECIFIC_READ]             = NULL,
+    [WAVE_OP_SPECIFIC_READ]             = _specific_read,
     [WAVE_OP_SPECIFIC_PRINT]            = _specific_print,
     [WAVE_OP_UNKNOWN]                   = _unknown_error,
 };
@@ -764,6 +745,23 @@ static void (* const _operator_functions[]) (FILE *, const wave_collection *, wa
 // Printing.
 ////////////////////////////////////////////////////////////////////////////////
 
+void wave_code_generation_prepare_operators (const wave_collection * phrase)
+{
+    _phrase_has_path = wave_collection_contains_path (phrase);
+    _scalar_parent = NULL;
+}
+
+bool wave_code_generation_is_scalar (const wave_collection * collection)
+{
+    return _is_scalar (collection);
+}
+
+void wave_code_generation_fprint_scalar_declaration (FILE * code_file, const wave_collection * collection)
+{
+    fprintf (code_file, "wave_%s ", wave_generation_atom_type_string (wave_collection_get_inferred_type (collection)));
+    _print_scalar (code_file, collection);
+}
+
 void wave_code_generation_fprint_operator (FILE * code_file, const wave_collection * collection)
 {
     /* We already know the current collection is an atom containing an operator */
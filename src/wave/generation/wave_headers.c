@@ -38,6 +38,7 @@ static const char * const _WAVE_HEADERS_LIST[] =
     "omp.h",
     "wave/common/wave_data.h",
     "wave/common/wave_garbage.h",
+    "wave/common/wave_input.h",
     NULL,
 };
 
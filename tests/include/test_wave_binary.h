@@ -0,0 +1,109 @@
+/**
+ * \file test_wave_binary.h
+ * \brief Wave binary format tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __TEST_WAVE_BINARY_H__
+#define __TEST_WAVE_BINARY_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <CUnit/CUnit.h>
+
+#include "wave/common/wave_binary.h"
+#include "wave/common/wave_kernels.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief wave_binary test suite initialization.
+ * \return Success or error code.
+ */
+int test_wave_binary_suite_init (void);
+
+/**
+ * \brief wave_binary test suite cleaning.
+ * \return Success or error code.
+ */
+int test_wave_binary_suite_clean (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Round trip tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test writing and decoding atoms.
+ * \test wave_data_write_binary()
+ * \test wave_data_from_binary()
+ */
+void test_wave_binary_atoms (void);
+
+/**
+ * \brief Test writing and decoding nested collections.
+ * \test wave_data_write_binary()
+ * \test wave_data_from_binary()
+ * \test wave_binary_size()
+ */
+void test_wave_binary_collections (void);
+
+/**
+ * \brief Test decoding from memory which is not aligned.
+ * \test wave_data_from_binary()
+ */
+void test_wave_binary_unaligned (void);
+
+/**
+ * \brief Test wave_data_map_binary().
+ * \test wave_data_map_binary()
+ */
+void test_wave_binary_map (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Validation tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test the rejection of invalid headers.
+ * \test wave_binary_size()
+ * \test wave_data_from_binary()
+ */
+void test_wave_binary_invalid_header (void);
+
+/**
+ * \brief Test the rejection of invalid nodes.
+ * \test wave_data_from_binary()
+ */
+void test_wave_binary_invalid_nodes (void);
+
+#endif /* __TEST_WAVE_BINARY_H__ */
@@ -31,9 +31,16 @@
 #define __TEST_WAVE_COLLECTION_H__
 
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <CUnit/CUnit.h>
 
 #include "wave/ast/wave_collection.h"
+#include "wave/ast/wave_coordinate.h"
+#include "wave/ast/wave_int_list.h"
+#include "wave/ast/wave_path.h"
+#include "wave/common/wave_operator.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Suite related functions.
@@ -198,4 +205,72 @@ void test_wave_collection_set_cyclic_list (void);
  */
 void test_wave_collection_set_cyclic_cycle (void);
 
+////////////////////////////////////////////////////////////////////////////////
+// Repetitions tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test wave_collection_set_repetition_seq_times() and wave_collection_set_repetition_par_times().
+ * \test wave_collection_set_repetition_seq_times()
+ * \test wave_collection_set_repetition_par_times()
+ */
+void test_wave_collection_repetition_times (void);
+
+/**
+ * \brief Test the expansion of the constant repetitions.
+ * \test wave_collection_unroll_path()
+ */
+void test_wave_collection_unroll (void);
+
+/**
+ * \brief Test the coordinates of the elements of a loop, and of the following ones.
+ * \test wave_collection_get_repetition_iterator()
+ * \test wave_collection_compute_length_and_coords()
+ */
+void test_wave_collection_repetition_coordinates (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Coordinates tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test freeing binary coordinates holding variables.
+ * \test wave_coordinate_free()
+ */
+void test_wave_collection_coordinate_free (void);
+
+/**
+ * \brief Test printing products and variables.
+ * \test wave_coordinate_fprint()
+ */
+void test_wave_collection_coordinate_print (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Types tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test the types inferred through the unary and binary operators.
+ * \test wave_collection_compute_types()
+ */
+void test_wave_collection_types_operators (void);
+
+/**
+ * \brief Test the types inferred through print, stop, atom and read.
+ * \test wave_collection_compute_types()
+ */
+void test_wave_collection_types_specific (void);
+
+/**
+ * \brief Test the types of replaced and remaining paths.
+ * \test wave_collection_compute_types()
+ */
+void test_wave_collection_types_paths (void);
+
+/**
+ * \brief Test the types of the sequences ended by a cut.
+ * \test wave_collection_compute_types()
+ */
+void test_wave_collection_types_cut (void);
+
 #endif /* __TEST_WAVE_COLLECTION_H__ */
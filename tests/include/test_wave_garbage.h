@@ -0,0 +1,124 @@
+/**
+ * \file test_wave_garbage.h
+ * \brief Wave garbage collector tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __TEST_WAVE_GARBAGE_H__
+#define __TEST_WAVE_GARBAGE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/CUnit.h>
+
+#include "wave/common/wave_garbage.h"
+#include "wave/common/wave_data.h"
+#include "wave/common/wave_kernels.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief wave_garbage test suite initialization.
+ * \return Success or error code.
+ */
+int test_wave_garbage_suite_init (void);
+
+/**
+ * \brief wave_garbage test suite cleaning.
+ * \return Success or error code.
+ */
+int test_wave_garbage_suite_clean (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Checkpoints tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test nested checkpoints.
+ * \test wave_garbage_mark()
+ * \test wave_garbage_is_released()
+ */
+void test_wave_garbage_mark (void);
+
+/**
+ * \brief Test wave_garbage_release_to().
+ * \test wave_garbage_release_to()
+ * \test wave_garbage_is_released()
+ */
+void test_wave_garbage_release_to (void);
+
+/**
+ * \brief Test wave_garbage_retain().
+ * \test wave_garbage_retain()
+ */
+void test_wave_garbage_retain (void);
+
+/**
+ * \brief Test the memory given to the GC after a release.
+ * \test wave_garbage_alloc_detached()
+ * \test wave_garbage_attach()
+ */
+void test_wave_garbage_attach (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Carried values tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test carrying strings over a release.
+ * \test wave_data_release_to()
+ */
+void test_wave_garbage_carry_strings (void);
+
+/**
+ * \brief Test carrying strings lying in buffers over a release.
+ * \test wave_data_release_to()
+ */
+void test_wave_garbage_carry_string_buffers (void);
+
+/**
+ * \brief Test carrying boxed and unboxed collections over a release.
+ * \test wave_data_release_to()
+ */
+void test_wave_garbage_carry_tabs (void);
+
+/**
+ * \brief Test carrying a long string, whose buffer is retained, over releases.
+ * \test wave_data_release_to()
+ */
+void test_wave_garbage_carry_retained (void);
+
+/**
+ * \brief Test carrying values over releases to nested checkpoints.
+ * \test wave_data_release_to()
+ */
+void test_wave_garbage_carry_nested (void);
+
+#endif /* __TEST_WAVE_GARBAGE_H__ */
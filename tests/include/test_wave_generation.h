@@ -0,0 +1,124 @@
+/**
+ * \file test_wave_generation.h
+ * \brief Wave code generation tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __TEST_WAVE_GENERATION_H__
+#define __TEST_WAVE_GENERATION_H__
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/CUnit.h>
+
+#include "wave/ast/wave_collection.h"
+#include "wave/ast/wave_path.h"
+#include "wave/common/wave_data.h"
+#include "wave/common/wave_operator.h"
+#include "wave/generation/wave_generation_operators.h"
+#include "wave/generation/wave_generation_fold.h"
+
+/**
+ * \brief Folding budget of the tests, in atoms per element.
+ */
+#define WAVE_GENERATION_FOLD_BUDGET 8
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief wave_generation test suite initialization.
+ * \return Success or error code.
+ */
+int test_wave_generation_suite_init (void);
+
+/**
+ * \brief wave_generation test suite cleaning.
+ * \return Success or error code.
+ */
+int test_wave_generation_suite_clean (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar elements tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test the elements stored in local variables.
+ * \test wave_code_generation_is_scalar()
+ */
+void test_wave_generation_scalar_accepted (void);
+
+/**
+ * \brief Test the elements which must stay in the tab of their collection.
+ * \test wave_code_generation_is_scalar()
+ */
+void test_wave_generation_scalar_rejected (void);
+
+/**
+ * \brief Test the elements of nested collections, repetitions and phrases containing paths.
+ * \test wave_code_generation_is_scalar()
+ */
+void test_wave_generation_scalar_collections (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Folding tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test the values of the operators, against wave_data_unary() and wave_data_binary().
+ * \test wave_code_generation_fold_list()
+ */
+void test_wave_generation_fold_operations (void);
+
+/**
+ * \brief Test the number of atoms computed for each element.
+ * \test wave_code_generation_fold_list()
+ */
+void test_wave_generation_fold_budget (void);
+
+/**
+ * \brief Test the values of the collections ended by a stop or a cut.
+ * \test wave_code_generation_fold_list()
+ */
+void test_wave_generation_fold_stop_cut (void);
+
+/**
+ * \brief Test the operations left to the generated code.
+ * \test wave_code_generation_fold_list()
+ */
+void test_wave_generation_fold_unknown (void);
+
+/**
+ * \brief Test the code initializing the folded values.
+ * \test wave_code_generation_fold_collection()
+ */
+void test_wave_generation_fold_initializers (void);
+
+#endif /* __TEST_WAVE_GENERATION_H__ */
@@ -0,0 +1,110 @@
+/**
+ * \file test_wave_input.h
+ * \brief Wave input tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __TEST_WAVE_INPUT_H__
+#define __TEST_WAVE_INPUT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sysexits.h>
+#include <sys/wait.h>
+#include <CUnit/CUnit.h>
+
+#include "wave/common/wave_input.h"
+#include "wave/common/wave_binary.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief wave_input test suite initialization.
+ * \return Success or error code.
+ */
+int test_wave_input_suite_init (void);
+
+/**
+ * \brief wave_input test suite cleaning.
+ * \return Success or error code.
+ */
+int test_wave_input_suite_clean (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test reading every kind of literal.
+ * \test wave_input_open_memory()
+ * \test wave_input_read()
+ * \test wave_input_next()
+ */
+void test_wave_input_literals (void);
+
+/**
+ * \brief Test reading nested sequential and parallel collections.
+ * \test wave_input_read()
+ */
+void test_wave_input_collections (void);
+
+/**
+ * \brief Test reading parallel collections of numbers, stored unboxed.
+ * \test wave_input_read()
+ */
+void test_wave_input_unboxed (void);
+
+/**
+ * \brief Test reading values in the binary format among text values.
+ * \test wave_input_read()
+ */
+void test_wave_input_binary (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Errors tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test the exit on malformed or missing input.
+ * \test wave_input_read()
+ */
+void test_wave_input_errors (void);
+
+/**
+ * \brief Test the limit of the number of elements of the collections.
+ * \test wave_input_set_collection_max()
+ * \test wave_input_read()
+ */
+void test_wave_input_collection_max (void);
+
+#endif /* __TEST_WAVE_INPUT_H__ */
@@ -0,0 +1,158 @@
+/**
+ * \file test_wave_kernels.h
+ * \brief Wave kernels tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __TEST_WAVE_KERNELS_H__
+#define __TEST_WAVE_KERNELS_H__
+
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <CUnit/CUnit.h>
+
+#include "wave/common/wave_kernels.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief wave_kernels test suite initialization.
+ * \return Success or error code.
+ */
+int test_wave_kernels_suite_init (void);
+
+/**
+ * \brief wave_kernels test suite cleaning.
+ * \return Success or error code.
+ */
+int test_wave_kernels_suite_clean (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Instruction set selection tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test wave_kernels_set_level().
+ * \test wave_kernels_set_level()
+ */
+void test_wave_kernels_set_level (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernels tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test wave_kernels_int_unary().
+ * \test wave_kernels_int_unary()
+ */
+void test_wave_kernels_int_unary (void);
+
+/**
+ * \brief Test wave_kernels_float_unary().
+ * \test wave_kernels_float_unary()
+ */
+void test_wave_kernels_float_unary (void);
+
+/**
+ * \brief Test the transcendental functions of wave_kernels_float_unary().
+ * \test wave_kernels_float_unary()
+ */
+void test_wave_kernels_float_transcendental (void);
+
+/**
+ * \brief Test the sine and cosine of wave_kernels_float_unary() over the whole range of their reduction.
+ * \test wave_kernels_float_unary()
+ */
+void test_wave_kernels_float_reduction (void);
+
+/**
+ * \brief Test wave_kernels_int_binary().
+ * \test wave_kernels_int_binary()
+ */
+void test_wave_kernels_int_binary (void);
+
+/**
+ * \brief Test wave_kernels_float_binary().
+ * \test wave_kernels_float_binary()
+ */
+void test_wave_kernels_float_binary (void);
+
+/**
+ * \brief Test wave_kernels_int_test().
+ * \test wave_kernels_int_test()
+ */
+void test_wave_kernels_int_test (void);
+
+/**
+ * \brief Test wave_kernels_float_test().
+ * \test wave_kernels_float_test()
+ */
+void test_wave_kernels_float_test (void);
+
+/**
+ * \brief Test the wave_int broadcast kernels.
+ * \test wave_kernels_int_broadcast_left()
+ * \test wave_kernels_int_broadcast_right()
+ * \test wave_kernels_int_test_broadcast_left()
+ * \test wave_kernels_int_test_broadcast_right()
+ */
+void test_wave_kernels_int_broadcast (void);
+
+/**
+ * \brief Test the wave_float broadcast kernels.
+ * \test wave_kernels_float_broadcast_left()
+ * \test wave_kernels_float_broadcast_right()
+ * \test wave_kernels_float_test_broadcast_left()
+ * \test wave_kernels_float_test_broadcast_right()
+ */
+void test_wave_kernels_float_broadcast (void);
+
+/**
+ * \brief Test the test kernels giving bitsets.
+ * \test wave_kernels_int_test_bits()
+ * \test wave_kernels_float_test_bits()
+ * \test wave_kernels_int_test_bits_broadcast_left()
+ * \test wave_kernels_int_test_bits_broadcast_right()
+ * \test wave_kernels_float_test_bits_broadcast_left()
+ * \test wave_kernels_float_test_bits_broadcast_right()
+ */
+void test_wave_kernels_test_bits (void);
+
+/**
+ * \brief Test the kernels on bitsets.
+ * \test wave_kernels_bool_not()
+ * \test wave_kernels_bool_binary()
+ * \test wave_kernels_bool_broadcast_left()
+ * \test wave_kernels_bool_broadcast_right()
+ */
+void test_wave_kernels_bool (void);
+
+#endif /* __TEST_WAVE_KERNELS_H__ */
@@ -0,0 +1,82 @@
+/**
+ * \file test_wave_output.h
+ * \brief Wave output engine tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __TEST_WAVE_OUTPUT_H__
+#define __TEST_WAVE_OUTPUT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <omp.h>
+#include <CUnit/CUnit.h>
+
+#include "wave/common/wave_output.h"
+#include "wave/common/wave_kernels.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief wave_output test suite initialization.
+ * \return Success or error code.
+ */
+int test_wave_output_suite_init (void);
+
+/**
+ * \brief wave_output test suite cleaning.
+ * \return Success or error code.
+ */
+int test_wave_output_suite_clean (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Ordering tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test that the values printed by several threads keep their order.
+ * \test wave_output_print()
+ */
+void test_wave_output_thread_order (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Chunks tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test that large collections printed by chunks have the text of wave_data_fprint(),
+ * after the text printed before by other threads.
+ * \test wave_output_print()
+ */
+void test_wave_output_chunks (void);
+
+#endif /* __TEST_WAVE_OUTPUT_H__ */
@@ -0,0 +1,99 @@
+/**
+ * \file test_wave_types.h
+ * \brief Wave types tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __TEST_WAVE_TYPES_H__
+#define __TEST_WAVE_TYPES_H__
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/CUnit.h>
+
+#include "wave/common/wave_types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief wave_types test suite initialization.
+ * \return Success or error code.
+ */
+int test_wave_types_suite_init (void);
+
+/**
+ * \brief wave_types test suite cleaning.
+ * \return Success or error code.
+ */
+int test_wave_types_suite_clean (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// wave_int tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test wave_int_parse().
+ * \test wave_int_parse()
+ */
+void test_wave_types_int_parse (void);
+
+/**
+ * \brief Test wave_int_to_chars().
+ * \test wave_int_to_chars()
+ */
+void test_wave_types_int_to_chars (void);
+
+////////////////////////////////////////////////////////////////////////////////
+// wave_float tests.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Test wave_float_parse() against \c strtod.
+ * \test wave_float_parse()
+ */
+void test_wave_types_float_parse (void);
+
+/**
+ * \brief Test wave_float_to_chars() against \c printf ("%f").
+ * \test wave_float_to_chars()
+ */
+void test_wave_types_float_to_chars (void);
+
+/**
+ * \brief Test wave_float_to_chars_shortest().
+ * \test wave_float_to_chars_shortest()
+ */
+void test_wave_types_float_to_chars_shortest (void);
+
+#endif /* __TEST_WAVE_TYPES_H__ */
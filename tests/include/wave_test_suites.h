@@ -36,6 +36,13 @@
 #include "test_wave_path.h"
 #include "test_wave_atom.h"
 #include "test_wave_collection.h"
+#include "test_wave_kernels.h"
+#include "test_wave_garbage.h"
+#include "test_wave_binary.h"
+#include "test_wave_input.h"
+#include "test_wave_types.h"
+#include "test_wave_output.h"
+#include "test_wave_generation.h"
 
 /**
  * \brief Test suite for wave_path.
@@ -111,6 +118,120 @@ static CU_TestInfo test_wave_collection_info [] =
     { "Test wave_collection_set_repetition_path",   test_wave_collection_set_repetition_path  },
     { "Test wave_collection_set_cyclic_list",       test_wave_collection_set_cyclic_list      },
     { "Test wave_collection_set_cyclic_cycle",      test_wave_collection_set_cyclic_cycle     },
+    { "Test constant repetitions",                  test_wave_collection_repetition_times     },
+    { "Test expanding repetitions",                 test_wave_collection_unroll               },
+    { "Test coordinates in loops",                  test_wave_collection_repetition_coordinates },
+    { "Test freeing coordinates",                   test_wave_collection_coordinate_free      },
+    { "Test printing coordinates",                  test_wave_collection_coordinate_print     },
+    { "Test types through operators",               test_wave_collection_types_operators      },
+    { "Test types through specific operators",      test_wave_collection_types_specific       },
+    { "Test types of paths",                        test_wave_collection_types_paths          },
+    { "Test types of cut sequences",                test_wave_collection_types_cut            },
+    CU_TEST_INFO_NULL,
+};
+
+/**
+ * \brief Test suite for wave_kernels.
+ */
+static CU_TestInfo test_wave_kernels_info [] =
+{
+    { "Test wave_kernels_set_level",            test_wave_kernels_set_level            },
+    { "Test wave_kernels_int_unary",            test_wave_kernels_int_unary            },
+    { "Test wave_kernels_float_unary",          test_wave_kernels_float_unary          },
+    { "Test wave_kernels_float_transcendental", test_wave_kernels_float_transcendental },
+    { "Test wave_kernels_float_reduction",      test_wave_kernels_float_reduction      },
+    { "Test wave_kernels_int_binary",           test_wave_kernels_int_binary           },
+    { "Test wave_kernels_float_binary",         test_wave_kernels_float_binary         },
+    { "Test wave_kernels_int_test",             test_wave_kernels_int_test             },
+    { "Test wave_kernels_float_test",           test_wave_kernels_float_test           },
+    { "Test wave_kernels_int_broadcast",        test_wave_kernels_int_broadcast        },
+    { "Test wave_kernels_float_broadcast",      test_wave_kernels_float_broadcast      },
+    { "Test wave_kernels_test_bits",            test_wave_kernels_test_bits            },
+    { "Test wave_kernels_bool",                 test_wave_kernels_bool                 },
+    CU_TEST_INFO_NULL,
+};
+
+/**
+ * \brief Test suite for wave_garbage.
+ */
+static CU_TestInfo test_wave_garbage_info [] =
+{
+    { "Test wave_garbage_mark",                 test_wave_garbage_mark                 },
+    { "Test wave_garbage_release_to",           test_wave_garbage_release_to           },
+    { "Test wave_garbage_retain",               test_wave_garbage_retain               },
+    { "Test wave_garbage_attach",               test_wave_garbage_attach               },
+    { "Test carrying strings",                  test_wave_garbage_carry_strings        },
+    { "Test carrying string buffers",           test_wave_garbage_carry_string_buffers },
+    { "Test carrying collections",              test_wave_garbage_carry_tabs           },
+    { "Test carrying a retained string buffer", test_wave_garbage_carry_retained       },
+    { "Test carrying over nested checkpoints",  test_wave_garbage_carry_nested         },
+    CU_TEST_INFO_NULL,
+};
+
+/**
+ * \brief Test suite for wave_binary.
+ */
+static CU_TestInfo test_wave_binary_info [] =
+{
+    { "Test wave_binary atoms",             test_wave_binary_atoms           },
+    { "Test wave_binary collections",       test_wave_binary_collections     },
+    { "Test wave_binary unaligned memory",  test_wave_binary_unaligned       },
+    { "Test wave_data_map_binary",          test_wave_binary_map             },
+    { "Test wave_binary invalid headers",   test_wave_binary_invalid_header  },
+    { "Test wave_binary invalid nodes",     test_wave_binary_invalid_nodes   },
+    CU_TEST_INFO_NULL,
+};
+
+/**
+ * \brief Test suite for wave_input.
+ */
+static CU_TestInfo test_wave_input_info [] =
+{
+    { "Test wave_input literals",           test_wave_input_literals        },
+    { "Test wave_input collections",        test_wave_input_collections     },
+    { "Test wave_input unboxed collections", test_wave_input_unboxed        },
+    { "Test wave_input binary values",      test_wave_input_binary          },
+    { "Test wave_input errors",             test_wave_input_errors          },
+    { "Test wave_input_set_collection_max", test_wave_input_collection_max  },
+    CU_TEST_INFO_NULL,
+};
+
+/**
+ * \brief Test suite for wave_types.
+ */
+static CU_TestInfo test_wave_types_info [] =
+{
+    { "Test wave_int_parse",                    test_wave_types_int_parse               },
+    { "Test wave_int_to_chars",                 test_wave_types_int_to_chars            },
+    { "Test wave_float_parse",                  test_wave_types_float_parse             },
+    { "Test wave_float_to_chars",               test_wave_types_float_to_chars          },
+    { "Test wave_float_to_chars_shortest",      test_wave_types_float_to_chars_shortest },
+    CU_TEST_INFO_NULL,
+};
+
+/**
+ * \brief Test suite for wave_output.
+ */
+static CU_TestInfo test_wave_output_info [] =
+{
+    { "Test printing from several threads",     test_wave_output_thread_order           },
+    { "Test printing large collections",        test_wave_output_chunks                 },
+    CU_TEST_INFO_NULL,
+};
+
+/**
+ * \brief Test suite for the code generation.
+ */
+static CU_TestInfo test_wave_generation_info [] =
+{
+    { "Test scalar elements",                   test_wave_generation_scalar_accepted    },
+    { "Test elements stored in tabs",           test_wave_generation_scalar_rejected    },
+    { "Test scalar elements of collections",    test_wave_generation_scalar_collections },
+    { "Test folded operations",                 test_wave_generation_fold_operations    },
+    { "Test folding budget",                    test_wave_generation_fold_budget        },
+    { "Test folded stops and cuts",             test_wave_generation_fold_stop_cut      },
+    { "Test unfolded operations",               test_wave_generation_fold_unknown       },
+    { "Test folded initializers",               test_wave_generation_fold_initializers  },
     CU_TEST_INFO_NULL,
 };
 
@@ -122,6 +243,13 @@ static CU_SuiteInfo wave_test_suites [] =
     { "Test wave_path", test_wave_path_suite_init, test_wave_path_suite_clean, test_wave_path_suite_test_setup, test_wave_path_suite_test_teardown, test_wave_path_info },
     { "Test wave_atom", test_wave_atom_suite_init, test_wave_atom_suite_clean, NULL, NULL, test_wave_atom_info },
     { "Test wave_collection", test_wave_collection_suite_init, test_wave_collection_suite_clean, NULL, NULL, test_wave_collection_info },
+    { "Test wave_kernels", test_wave_kernels_suite_init, test_wave_kernels_suite_clean, NULL, NULL, test_wave_kernels_info },
+    { "Test wave_garbage", test_wave_garbage_suite_init, test_wave_garbage_suite_clean, NULL, NULL, test_wave_garbage_info },
+    { "Test wave_binary", test_wave_binary_suite_init, test_wave_binary_suite_clean, NULL, NULL, test_wave_binary_info },
+    { "Test wave_input", test_wave_input_suite_init, test_wave_input_suite_clean, NULL, NULL, test_wave_input_info },
+    { "Test wave_types", test_wave_types_suite_init, test_wave_types_suite_clean, NULL, NULL, test_wave_types_info },
+    { "Test wave_output", test_wave_output_suite_init, test_wave_output_suite_clean, NULL, NULL, test_wave_output_info },
+    { "Test wave_generation", test_wave_generation_suite_init, test_wave_generation_suite_clean, NULL, NULL, test_wave_generation_info },
     CU_SUITE_INFO_NULL,
 };
 
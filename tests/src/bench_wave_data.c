@@ -0,0 +1,135 @@
+/**
+ * \file bench_wave_data.c
+ * \brief wave_data operations microbenchmark.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "wave/common/wave_data.h"
+#include "wave/common/wave_garbage.h"
+
+/**
+ * \brief Default number of iterations of each case.
+ */
+#define _ITERATIONS 2000000
+
+/**
+ * \brief Number of elements of the boxed collections.
+ */
+#define _PAR_SIZE 64
+
+/**
+ * \brief A benchmarked operation.
+ */
+typedef struct _bench_case
+{
+    const char * _name;     /**< Name of the case. */
+    wave_data _left;        /**< Left operand. */
+    wave_data _right;       /**< Right operand. */
+    wave_operator _op;      /**< Operation. */
+} _bench_case;
+
+static wave_data _left_tab[_PAR_SIZE];
+static wave_data _right_tab[_PAR_SIZE];
+
+static double _now (void)
+{
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, & t);
+    return (double) t.tv_sec + (double) t.tv_nsec * 1.0e-9;
+}
+
+static void _set_par (wave_data * data, wave_data * tab)
+{
+    data->_type = WAVE_DATA_PAR;
+    data->_content._collection._tab = tab;
+    data->_content._collection._size = _PAR_SIZE;
+}
+
+static void _run (const _bench_case * bench, unsigned long iterations)
+{
+    wave_data result;
+    double start = _now ();
+    for (unsigned long i = 0; i < iterations; ++i)
+    {
+        wave_data_binary (& bench->_left, & bench->_right, & result, bench->_op);
+        /* Keep the garbage collector small, as generated code does. */
+        if (i % 1024 == 0)
+            wave_garbage_clean ();
+    }
+    double elapsed = _now () - start;
+    wave_garbage_clean ();
+
+    printf ("%-28s %8.1f ns/op\n", bench->_name, elapsed * 1.0e9 / (double) iterations);
+}
+
+int main (int argc, char ** argv)
+{
+    unsigned long iterations = argc > 1 ? strtoul (argv[1], NULL, 10) : _ITERATIONS;
+
+    static _bench_case cases[] =
+    {
+        { ._name = "int + int", ._op = WAVE_OP_BINARY_PLUS },
+        { ._name = "int < int", ._op = WAVE_OP_BINARY_LESSER },
+        { ._name = "float * int", ._op = WAVE_OP_BINARY_TIMES },
+        { ._name = "float = float", ._op = WAVE_OP_BINARY_EQUALS },
+        { ._name = "bool and bool", ._op = WAVE_OP_BINARY_AND },
+        { ._name = "char max char", ._op = WAVE_OP_BINARY_MAX },
+        { ._name = "string = string", ._op = WAVE_OP_BINARY_EQUALS },
+        { ._name = "par + par (64 ints)", ._op = WAVE_OP_BINARY_PLUS },
+    };
+
+    wave_data_set_int (& cases[0]._left, 42);
+    wave_data_set_int (& cases[0]._right, 17);
+    wave_data_set_int (& cases[1]._left, 42);
+    wave_data_set_int (& cases[1]._right, 17);
+    wave_data_set_float (& cases[2]._left, 4.2);
+    wave_data_set_int (& cases[2]._right, 17);
+    wave_data_set_float (& cases[3]._left, 4.2);
+    wave_data_set_float (& cases[3]._right, 1.7);
+    wave_data_set_bool (& cases[4]._left, true);
+    wave_data_set_bool (& cases[4]._right, false);
+    wave_data_set_char (& cases[5]._left, 'a');
+    wave_data_set_char (& cases[5]._right, 'z');
+    wave_data_set_string (& cases[6]._left, "wave");
+    wave_data_set_string (& cases[6]._right, "wavec");
+    for (unsigned int i = 0; i < _PAR_SIZE; ++i)
+    {
+        wave_data_set_int (& _left_tab[i], (wave_int) i);
+        wave_data_set_int (& _right_tab[i], (wave_int) (2 * i));
+    }
+    _set_par (& cases[7]._left, _left_tab);
+    _set_par (& cases[7]._right, _right_tab);
+
+    for (unsigned int i = 0; i < sizeof cases / sizeof cases[0]; ++i)
+        _run (& cases[i], i == 7 ? iterations / _PAR_SIZE : iterations);
+
+    wave_garbage_destroy ();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+/**
+ * \file bench_wave_garbage.c
+ * \brief wave_garbage multithreaded allocation stress benchmark.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+#include "wave/common/wave_garbage.h"
+
+/**
+ * \brief Default number of allocations of each thread per round.
+ */
+#define _ALLOCATIONS 100000
+
+/**
+ * \brief Number of rounds.
+ */
+#define _ROUNDS 20
+
+int main (int argc, char ** argv)
+{
+    long long int allocations = argc > 1 ? strtoll (argv[1], NULL, 10) : _ALLOCATIONS;
+    int threads = omp_get_max_threads ();
+    double alloc_time = 0;
+    double clean_time = 0;
+
+    for (unsigned int round = 0; round < _ROUNDS; ++round)
+    {
+        double start = omp_get_wtime ();
+        #pragma omp parallel
+        {
+            for (long long int i = 0; i < allocations; ++i)
+            {
+                /* Small blocks of various sizes, as strings would be. */
+                char * block = wave_garbage_alloc ((size_t) (8 + i % 24));
+                block[0] = (char) i;
+            }
+        }
+        double middle = omp_get_wtime ();
+        wave_garbage_clean ();
+        double end = omp_get_wtime ();
+
+        alloc_time += middle - start;
+        clean_time += end - middle;
+    }
+    wave_garbage_destroy ();
+
+    double total = (double) allocations * (double) threads * _ROUNDS;
+    printf ("threads: %d, allocations: %.0f\n", threads, total);
+    printf ("alloc: %8.1f ns/allocation\n", alloc_time * 1.0e9 / total);
+    printf ("clean: %8.1f ns/allocation\n", clean_time * 1.0e9 / total);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,583 @@
+/**
+ * \file test_wave_binary.c
+ * \brief Wave binary format tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test_wave_binary.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static variables.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of values of the unboxed collections.
+ *
+ * The bitsets have a whole word and a partial one.
+ */
+#define WAVE_BINARY_TAB_SIZE 70
+
+/**
+ * \brief String too long to be stored in a data.
+ */
+static const char * const heap_string = "a string stored in the heap";
+
+static wave_int ints[WAVE_BINARY_TAB_SIZE];
+static wave_float floats[WAVE_BINARY_TAB_SIZE];
+static uint64_t bits[WAVE_KERNELS_WORDS (WAVE_BINARY_TAB_SIZE)];
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Store a collection inside a data.
+ */
+static void _set_collection (wave_data * data, wave_data_type type, wave_data * tab, size_t size)
+{
+    data->_type = (uint8_t) type;
+    data->_flags = WAVE_DATA_FLAG_NONE;
+    data->_content._collection._tab = tab;
+    data->_content._collection._size = (uint32_t) size;
+}
+
+/**
+ * \brief Determine whether two data hold the same values, the floating point
+ * ones being compared bit by bit.
+ */
+static bool _same_data (const wave_data * a, const wave_data * b)
+{
+    wave_data_type t = wave_data_get_type (a);
+    if (t != wave_data_get_type (b))
+        return false;
+
+    switch (t)
+    {
+        case WAVE_DATA_INT:
+            return wave_data_get_int (a) == wave_data_get_int (b);
+        case WAVE_DATA_FLOAT:
+        {
+            wave_float fa = wave_data_get_float (a);
+            wave_float fb = wave_data_get_float (b);
+            return memcmp (& fa, & fb, sizeof fa) == 0;
+        }
+        case WAVE_DATA_CHAR:
+            return wave_data_get_char (a) == wave_data_get_char (b);
+        case WAVE_DATA_BOOL:
+            return wave_data_get_bool (a) == wave_data_get_bool (b);
+        case WAVE_DATA_STRING:
+        {
+            size_t la, lb;
+            const wave_char * ca = wave_data_get_characters (a, & la);
+            const wave_char * cb = wave_data_get_characters (b, & lb);
+            return la == lb && memcmp (ca, cb, la) == 0;
+        }
+        case WAVE_DATA_SEQ:
+        case WAVE_DATA_PAR:
+        {
+            bool same = a->_content._collection._size == b->_content._collection._size;
+            for (uint32_t i = 0; same && i < a->_content._collection._size; ++i)
+                same = _same_data (& a->_content._collection._tab[i], & b->_content._collection._tab[i]);
+            return same;
+        }
+        case WAVE_DATA_PAR_INT:
+            return a->_content._packed._size == b->_content._packed._size
+                && memcmp (a->_content._packed._tab._ints, b->_content._packed._tab._ints, a->_content._packed._size * sizeof (wave_int)) == 0;
+        case WAVE_DATA_PAR_FLOAT:
+            return a->_content._packed._size == b->_content._packed._size
+                && memcmp (a->_content._packed._tab._floats, b->_content._packed._tab._floats, a->_content._packed._size * sizeof (wave_float)) == 0;
+        case WAVE_DATA_PAR_BOOL:
+            return a->_content._packed._size == b->_content._packed._size
+                && memcmp (a->_content._packed._tab._bits, b->_content._packed._tab._bits, WAVE_KERNELS_WORDS (a->_content._packed._size) * sizeof (uint64_t)) == 0;
+        default:
+            return false;
+    }
+}
+
+/**
+ * \brief Write a data in the binary format to memory.
+ * \return The memory, to be freed, or \c NULL in case of failure.
+ */
+static unsigned char * _write (const wave_data * data, size_t * size)
+{
+    char * buffer = NULL;
+    FILE * stream = open_memstream (& buffer, size);
+    if (stream == NULL)
+        return NULL;
+    bool success = wave_data_write_binary (stream, data);
+    fclose (stream);
+    if (! success)
+    {
+        free (buffer);
+        buffer = NULL;
+    }
+    return (unsigned char *) buffer;
+}
+
+/**
+ * \brief Determine whether a data is decoded as itself once written.
+ */
+static bool _round_trip (const wave_data * data)
+{
+    size_t size;
+    unsigned char * buffer = _write (data, & size);
+    wave_data decoded;
+    bool same = buffer != NULL && wave_data_from_binary (buffer, size, & decoded) == size && _same_data (data, & decoded);
+    free (buffer);
+    return same;
+}
+
+/**
+ * \brief Build the nested collection used by the tests.
+ *
+ * The nodes are, in breadth-first order:
+ * 0. seq: string, par;
+ * 1. string;
+ * 2. par: par_int, par_bool;
+ * 3. par_int;
+ * 4. par_bool.
+ */
+static void _nested (wave_data * root, wave_data seq[2], wave_data par[2])
+{
+    wave_data_set_string_copy (& seq[0], heap_string, strlen (heap_string));
+    _set_collection (& seq[1], WAVE_DATA_PAR, par, 2);
+    wave_data_set_par_int (& par[0], ints, 3);
+    wave_data_set_par_bool (& par[1], bits, WAVE_BINARY_TAB_SIZE);
+    _set_collection (root, WAVE_DATA_SEQ, seq, 2);
+}
+
+/**
+ * \brief Get the header of a data in the binary format.
+ */
+static wave_binary_header _get_header (const unsigned char * buffer)
+{
+    wave_binary_header header;
+    memcpy (& header, buffer, sizeof header);
+    return header;
+}
+
+/**
+ * \brief Get a node of a data in the binary format.
+ */
+static wave_binary_node _get_node (const unsigned char * buffer, size_t index)
+{
+    wave_binary_node node;
+    memcpy (& node, buffer + sizeof (wave_binary_header) + index * sizeof node, sizeof node);
+    return node;
+}
+
+/**
+ * \brief Determine whether a data is rejected once a field of its header is changed.
+ */
+static bool _rejects_header (const unsigned char * buffer, size_t size, size_t offset, const void * field, size_t field_size)
+{
+    unsigned char * copy = malloc (size);
+    memcpy (copy, buffer, size);
+    memcpy (copy + offset, field, field_size);
+    wave_data decoded;
+    bool rejected = wave_binary_size (copy, size) == 0 && wave_data_from_binary (copy, size, & decoded) == 0;
+    free (copy);
+    return rejected;
+}
+
+/**
+ * \brief Determine whether a data is rejected once one of its nodes is changed.
+ */
+static bool _rejects_node (const unsigned char * buffer, size_t size, size_t index, wave_binary_node node)
+{
+    unsigned char * copy = malloc (size);
+    memcpy (copy, buffer, size);
+    memcpy (copy + sizeof (wave_binary_header) + index * sizeof node, & node, sizeof node);
+    wave_data decoded;
+    bool rejected = wave_data_from_binary (copy, size, & decoded) == 0;
+    free (copy);
+    return rejected;
+}
+
+/**
+ * \brief Write bytes to a new temporary file.
+ * \return The path of the file, to be freed and unlinked, or \c NULL in case of failure.
+ */
+static char * _temporary_file (const void * bytes, size_t size)
+{
+    char * path = strdup ("/tmp/test_wave_binary_XXXXXX");
+    int fd = path != NULL ? mkstemp (path) : -1;
+    if (fd < 0)
+    {
+        free (path);
+        return NULL;
+    }
+    bool success = write (fd, bytes, size) == (ssize_t) size;
+    close (fd);
+    if (! success)
+    {
+        unlink (path);
+        free (path);
+        path = NULL;
+    }
+    return path;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+int test_wave_binary_suite_init (void)
+{
+    for (int i = 0; i < WAVE_BINARY_TAB_SIZE; ++i)
+    {
+        ints[i] = i * 1000 - 35000;
+        floats[i] = i / 8.0 - 4.0;
+    }
+    bits[0] = UINT64_C (0x8000000000000001);
+    bits[1] = UINT64_C (0x25);
+    return 0;
+}
+
+int test_wave_binary_suite_clean (void)
+{
+    wave_garbage_clean ();
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Round trip tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_binary_atoms (void)
+{
+    wave_data data;
+
+    wave_data_set_int (& data, -123456789);
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_int (& data, INT32_MIN);
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_float (& data, 0.1);
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_float (& data, -0.0);
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_float (& data, NAN);
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_char (& data, '\xe9');
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_bool (& data, true);
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_bool (& data, false);
+    CU_ASSERT_TRUE (_round_trip (& data));
+
+    /* Strings stored in the data, in the heap, and empty. */
+    wave_data_set_string_copy (& data, "inline", 6);
+    CU_ASSERT_TRUE (wave_data_is_small_string (& data));
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_string_copy (& data, heap_string, strlen (heap_string));
+    CU_ASSERT_FALSE (wave_data_is_small_string (& data));
+    CU_ASSERT_TRUE (_round_trip (& data));
+    wave_data_set_string_copy (& data, "", 0);
+    CU_ASSERT_TRUE (_round_trip (& data));
+
+    /* A string lying in a buffer, which is not its longest string. */
+    wave_data left, right, longest;
+    wave_data_set_string_copy (& left, heap_string, strlen (heap_string));
+    wave_data_set_string_copy (& right, "!", 1);
+    wave_data_binary (& left, & right, & data, WAVE_OP_BINARY_PLUS);
+    wave_data_binary (& data, & right, & longest, WAVE_OP_BINARY_PLUS);
+    CU_ASSERT_TRUE (_round_trip (& data));
+    CU_ASSERT_TRUE (_round_trip (& longest));
+}
+
+void test_wave_binary_collections (void)
+{
+    wave_data unboxed[3];
+    wave_data_set_par_int (& unboxed[0], ints, WAVE_BINARY_TAB_SIZE);
+    wave_data_set_par_float (& unboxed[1], floats, WAVE_BINARY_TAB_SIZE);
+    wave_data_set_par_bool (& unboxed[2], bits, WAVE_BINARY_TAB_SIZE);
+    for (int i = 0; i < 3; ++i)
+        CU_ASSERT_TRUE (_round_trip (& unboxed[i]));
+
+    /* Collections nested in both orders, and every kind of element. */
+    wave_data inner_seq[2], inner_par[3], outer[8], root;
+    wave_data_set_int (& inner_seq[0], -1);
+    wave_data_set_string_copy (& inner_seq[1], "in a seq", 8);
+    wave_data_set_float (& inner_par[0], 2.5);
+    _set_collection (& inner_par[1], WAVE_DATA_SEQ, inner_seq, 2);
+    inner_par[2] = unboxed[2];
+    wave_data_set_int (& outer[0], 42);
+    wave_data_set_float (& outer[1], -1.5);
+    wave_data_set_bool (& outer[2], true);
+    wave_data_set_char (& outer[3], 'c');
+    wave_data_set_string_copy (& outer[4], heap_string, strlen (heap_string));
+    _set_collection (& outer[5], WAVE_DATA_PAR, inner_par, 3);
+    outer[6] = unboxed[0];
+    outer[7] = unboxed[1];
+    _set_collection (& root, WAVE_DATA_SEQ, outer, 8);
+    CU_ASSERT_TRUE (_round_trip (& root));
+
+    size_t size;
+    unsigned char * buffer = _write (& root, & size);
+    CU_ASSERT_PTR_NOT_NULL (buffer);
+    if (buffer == NULL)
+        return;
+
+    /* The nodes are in breadth-first order, the payload items aligned. */
+    wave_binary_header header = _get_header (buffer);
+    CU_ASSERT_EQUAL (header._node_count, 14);
+    CU_ASSERT_EQUAL (wave_binary_size (buffer, size), size);
+    CU_ASSERT_EQUAL (_get_node (buffer, 0)._tag, WAVE_BINARY_SEQ);
+    CU_ASSERT_EQUAL (_get_node (buffer, 0)._first, 1);
+    CU_ASSERT_EQUAL (_get_node (buffer, 6)._tag, WAVE_BINARY_PAR);
+    CU_ASSERT_EQUAL (_get_node (buffer, 6)._first, 9);
+    CU_ASSERT_EQUAL (_get_node (buffer, 10)._tag, WAVE_BINARY_SEQ);
+    CU_ASSERT_EQUAL (_get_node (buffer, 10)._first, 12);
+    for (size_t i = 0; i < header._node_count; ++i)
+        if (_get_node (buffer, i)._tag >= WAVE_BINARY_PAR_INT)
+            CU_ASSERT_EQUAL (_get_node (buffer, i)._first % 8, 0);
+
+    /* The unboxed values are used in place. */
+    wave_data decoded;
+    CU_ASSERT_EQUAL (wave_data_from_binary (buffer, size, & decoded), size);
+    const unsigned char * values = (const unsigned char *) decoded._content._collection._tab[6]._content._packed._tab._ints;
+    CU_ASSERT_TRUE (values > buffer && values < buffer + size);
+
+    free (buffer);
+}
+
+void test_wave_binary_unaligned (void)
+{
+    wave_data seq[2], par[2], root;
+    _nested (& root, seq, par);
+
+    size_t size;
+    unsigned char * buffer = _write (& root, & size);
+    unsigned char * unaligned = malloc (size + 1);
+    CU_ASSERT_PTR_NOT_NULL (buffer);
+    CU_ASSERT_PTR_NOT_NULL (unaligned);
+    if (buffer == NULL || unaligned == NULL)
+    {
+        free (buffer);
+        free (unaligned);
+        return;
+    }
+
+    /* The payload is copied, so that the unboxed values are aligned. */
+    memcpy (unaligned + 1, buffer, size);
+    wave_data decoded;
+    CU_ASSERT_EQUAL (wave_data_from_binary (unaligned + 1, size, & decoded), size);
+    CU_ASSERT_TRUE (_same_data (& root, & decoded));
+    const wave_int * values = decoded._content._collection._tab[1]._content._collection._tab[0]._content._packed._tab._ints;
+    CU_ASSERT_EQUAL ((uintptr_t) values % sizeof (wave_int), 0);
+    CU_ASSERT_FALSE ((const unsigned char *) values > unaligned && (const unsigned char *) values < unaligned + size + 1);
+
+    free (unaligned);
+    free (buffer);
+}
+
+void test_wave_binary_map (void)
+{
+    wave_data seq[2], par[2], root;
+    _nested (& root, seq, par);
+
+    size_t size;
+    unsigned char * buffer = _write (& root, & size);
+    CU_ASSERT_PTR_NOT_NULL (buffer);
+    if (buffer == NULL)
+        return;
+
+    /* The mapping outlives the file. */
+    wave_data decoded;
+    char * path = _temporary_file (buffer, size);
+    CU_ASSERT_PTR_NOT_NULL (path);
+    if (path != NULL)
+    {
+        CU_ASSERT_TRUE (wave_data_map_binary (path, & decoded));
+        unlink (path);
+        CU_ASSERT_TRUE (_same_data (& root, & decoded));
+        CU_ASSERT_FALSE (wave_data_map_binary (path, & decoded));
+        free (path);
+    }
+
+    /* Empty, truncated and invalid files. */
+    const char magic[] = "NOTWAVE!";
+    const void * const contents[] = { buffer, buffer, magic };
+    const size_t sizes[] = { 0, size - 1, sizeof magic };
+    for (size_t i = 0; i < 3; ++i)
+    {
+        path = _temporary_file (contents[i], sizes[i]);
+        CU_ASSERT_PTR_NOT_NULL (path);
+        if (path != NULL)
+        {
+            CU_ASSERT_FALSE (wave_data_map_binary (path, & decoded));
+            unlink (path);
+            free (path);
+        }
+    }
+
+    free (buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Validation tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_binary_invalid_header (void)
+{
+    wave_data seq[2], par[2], root;
+    _nested (& root, seq, par);
+
+    size_t size;
+    unsigned char * buffer = _write (& root, & size);
+    CU_ASSERT_PTR_NOT_NULL (buffer);
+    if (buffer == NULL)
+        return;
+
+    wave_data decoded;
+    CU_ASSERT_EQUAL (wave_binary_size (buffer, size), size);
+    CU_ASSERT_EQUAL (wave_data_from_binary (buffer, size, & decoded), size);
+
+    /* Truncated header and data. */
+    CU_ASSERT_EQUAL (wave_binary_size (buffer, sizeof (wave_binary_header) - 1), 0);
+    CU_ASSERT_EQUAL (wave_data_from_binary (buffer, sizeof (wave_binary_header) - 1, & decoded), 0);
+    CU_ASSERT_EQUAL (wave_binary_size (buffer, sizeof (wave_binary_header)), size);
+    CU_ASSERT_EQUAL (wave_data_from_binary (buffer, size - 1, & decoded), 0);
+
+    wave_binary_header header = _get_header (buffer);
+    const char magic[WAVE_BINARY_MAGIC_SIZE] = "WAVEBIN2";
+    const uint32_t byte_order = 0x04030201;
+    const uint32_t version = 2;
+    const uint64_t no_nodes = 0;
+    const size_t node_size = sizeof (wave_binary_node);
+    const uint64_t too_many_nodes = (SIZE_MAX - sizeof header) / node_size + 1;
+    const uint64_t wrapping_nodes = UINT64_C (1) << 61;
+    const uint64_t too_large_payload = SIZE_MAX - sizeof header - header._node_count * node_size + 1;
+
+    CU_ASSERT_TRUE (_rejects_header (buffer, size, offsetof (wave_binary_header, _magic), magic, sizeof magic));
+    CU_ASSERT_TRUE (_rejects_header (buffer, size, offsetof (wave_binary_header, _byte_order), & byte_order, sizeof byte_order));
+    CU_ASSERT_TRUE (_rejects_header (buffer, size, offsetof (wave_binary_header, _version), & version, sizeof version));
+    CU_ASSERT_TRUE (_rejects_header (buffer, size, offsetof (wave_binary_header, _node_count), & no_nodes, sizeof no_nodes));
+    CU_ASSERT_TRUE (_rejects_header (buffer, size, offsetof (wave_binary_header, _node_count), & too_many_nodes, sizeof too_many_nodes));
+    CU_ASSERT_TRUE (_rejects_header (buffer, size, offsetof (wave_binary_header, _node_count), & wrapping_nodes, sizeof wrapping_nodes));
+    CU_ASSERT_TRUE (_rejects_header (buffer, size, offsetof (wave_binary_header, _payload_size), & too_large_payload, sizeof too_large_payload));
+
+    /* More nodes or payload than the memory holds. */
+    const uint64_t more_nodes = header._node_count + 1;
+    const uint64_t more_payload = header._payload_size + 8;
+    unsigned char * copy = malloc (size);
+    memcpy (copy, buffer, size);
+    memcpy (copy + offsetof (wave_binary_header, _node_count), & more_nodes, sizeof more_nodes);
+    CU_ASSERT_EQUAL (wave_data_from_binary (copy, size, & decoded), 0);
+    memcpy (copy, buffer, size);
+    memcpy (copy + offsetof (wave_binary_header, _payload_size), & more_payload, sizeof more_payload);
+    CU_ASSERT_EQUAL (wave_data_from_binary (copy, size, & decoded), 0);
+    free (copy);
+
+    free (buffer);
+}
+
+void test_wave_binary_invalid_nodes (void)
+{
+    wave_data seq[2], par[2], root;
+    _nested (& root, seq, par);
+
+    size_t size;
+    unsigned char * buffer = _write (& root, & size);
+    CU_ASSERT_PTR_NOT_NULL (buffer);
+    if (buffer == NULL)
+        return;
+
+    uint64_t payload_size = _get_header (buffer)._payload_size;
+    uint64_t count = _get_header (buffer)._node_count;
+    CU_ASSERT_EQUAL (count, 5);
+    wave_binary_node node;
+
+    /* Unknown tags. */
+    node = _get_node (buffer, 1);
+    node._tag = 0;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 1, node));
+    node._tag = WAVE_BINARY_PAR_BOOL + 1;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 1, node));
+
+    /* Strings out of the payload, or not terminated. */
+    node = _get_node (buffer, 1);
+    CU_ASSERT_EQUAL (node._tag, WAVE_BINARY_STRING);
+    node._first = payload_size + 1;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 1, node));
+    node._first = payload_size;
+    node._size = 0;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 1, node));
+    node = _get_node (buffer, 1);
+    node._size = payload_size;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 1, node));
+    node._size = UINT64_MAX;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 1, node));
+    node._size = strlen (heap_string) - 1;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 1, node));
+
+    /* Children before their parent, out of the table, or missing. */
+    node = _get_node (buffer, 2);
+    CU_ASSERT_EQUAL (node._tag, WAVE_BINARY_PAR);
+    node._first = 2;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 2, node));
+    node._first = 0;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 2, node));
+    node._first = count + 1;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 2, node));
+    node = _get_node (buffer, 2);
+    node._size = count - node._first + 1;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 2, node));
+    node._size = UINT64_MAX;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 2, node));
+    node._size = 0;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 2, node));
+
+    /* Unboxed values out of the payload, or not aligned. */
+    node = _get_node (buffer, 3);
+    CU_ASSERT_EQUAL (node._tag, WAVE_BINARY_PAR_INT);
+    node._first += 4;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 3, node));
+    node._first = payload_size + 8;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 3, node));
+    node = _get_node (buffer, 3);
+    node._size = (payload_size - node._first) / sizeof (wave_int) + 1;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 3, node));
+    node._size = UINT64_MAX / sizeof (wave_int) + 1;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 3, node));
+    node._tag = WAVE_BINARY_PAR_FLOAT;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 3, node));
+
+    /* Bitsets out of the payload, or with bits set past the last value. */
+    node = _get_node (buffer, 4);
+    CU_ASSERT_EQUAL (node._tag, WAVE_BINARY_PAR_BOOL);
+    node._size = 3 * WAVE_KERNELS_WORD_BITS;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 4, node));
+    node._size = UINT64_MAX;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 4, node));
+    node = _get_node (buffer, 4);
+    node._size = WAVE_BINARY_TAB_SIZE - 2;
+    CU_ASSERT_TRUE (_rejects_node (buffer, size, 4, node));
+    node._size = 2 * WAVE_KERNELS_WORD_BITS;
+    CU_ASSERT_FALSE (_rejects_node (buffer, size, 4, node));
+
+    free (buffer);
+}
@@ -29,10 +29,291 @@
  */
 #include "test_wave_collection.h"
 
+#include <stdarg.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 // Static variables.
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * \brief Greatest number of elements of a repetition which is expanded.
+ */
+#define WAVE_COLLECTION_UNROLL_MAX_LENGTH 64
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create an integer atom collection.
+ */
+static wave_collection * _int (wave_int i)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_int (a, i);
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_atom (c, a);
+    return c;
+}
+
+/**
+ * \brief Create a floating point atom collection.
+ */
+static wave_collection * _float (wave_float f)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_float (a, f);
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_atom (c, a);
+    return c;
+}
+
+/**
+ * \brief Create a boolean atom collection.
+ */
+static wave_collection * _bool (wave_bool b)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_bool (a, b);
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_atom (c, a);
+    return c;
+}
+
+/**
+ * \brief Create a character atom collection.
+ */
+static wave_collection * _char (wave_char character)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_char (a, character);
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_atom (c, a);
+    return c;
+}
+
+/**
+ * \brief Create a string atom collection.
+ */
+static wave_collection * _string (const_wave_string string)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_string (a, string);
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_atom (c, a);
+    return c;
+}
+
+/**
+ * \brief Create a path atom collection, made of a single move.
+ */
+static wave_collection * _path (wave_move_type move)
+{
+    wave_path * p = wave_path_alloc ();
+    wave_path_set_move (p, move);
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_path (a, p);
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_atom (c, a);
+    return c;
+}
+
+/**
+ * \brief Create an operator atom collection.
+ */
+static wave_collection * _operator (wave_operator op)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_operator (a, op);
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_atom (c, a);
+    return c;
+}
+
+/**
+ * \brief Append a collection to a list, and return the list.
+ */
+static wave_collection * _append (wave_collection * list, wave_collection * c)
+{
+    wave_collection_add_collection (list, c);
+    return list;
+}
+
+/**
+ * \brief Create a list from collections, terminated by \c NULL.
+ */
+static wave_collection * _list (wave_collection * first, ...)
+{
+    va_list collections;
+    va_start (collections, first);
+    wave_collection * last = first;
+    for (wave_collection * c = va_arg (collections, wave_collection *); c != NULL; c = va_arg (collections, wave_collection *))
+    {
+        wave_collection_add_collection (last, c);
+        last = c;
+    }
+    va_end (collections);
+    return first;
+}
+
+/**
+ * \brief Get a collection of a list.
+ */
+static wave_collection * _at (wave_collection * list, int index)
+{
+    for (int i = 0; i < index && list != NULL; ++i)
+        list = wave_collection_get_next (list);
+    return list;
+}
+
+/**
+ * \brief Create a parallel collection.
+ */
+static wave_collection * _par (wave_collection * list)
+{
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_par_list (c, list);
+    return c;
+}
+
+/**
+ * \brief Create a sequential constant repetition.
+ */
+static wave_collection * _repetition (wave_collection * list, int times)
+{
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_repetition_seq_times (c, list, times);
+    return c;
+}
+
+/**
+ * \brief Create the sequential collection of a phrase.
+ */
+static wave_collection * _phrase (wave_collection * list)
+{
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_seq_list (c, list);
+    return c;
+}
+
+/**
+ * \brief Count the collections of a list.
+ */
+static int _count (const wave_collection * list)
+{
+    int count = 0;
+    for (const wave_collection * current = list; current != NULL; current = wave_collection_get_next (current))
+        ++count;
+    return count;
+}
+
+/**
+ * \brief Count the repetitions of a list.
+ */
+static int _count_repetitions (const wave_collection * list)
+{
+    int count = 0;
+    for (const wave_collection * current = list; current != NULL; current = wave_collection_get_next (current))
+    {
+        wave_collection_type t = wave_collection_get_type (current);
+        count += t == WAVE_COLLECTION_REP_SEQ || t == WAVE_COLLECTION_REP_PAR;
+    }
+    return count;
+}
+
+/**
+ * \brief Infer the types of a phrase, after its paths are replaced, and free it.
+ * \param c Collection of the phrase.
+ * \param types Expected types of the elements of the phrase.
+ * \param count Number of elements.
+ * \retval true if the elements have the expected types.
+ * \retval false otherwise.
+ */
+static bool _has_types (wave_collection * c, const wave_atom_type types[], int count)
+{
+    wave_collection_compute_indexes (c);
+    wave_collection_replace_path (c);
+    wave_collection_compute_types (c);
+
+    wave_collection * list = wave_collection_get_list (c);
+    bool same = _count (list) == count;
+    for (int i = 0; same && i < count; ++i)
+    {
+        same = wave_collection_get_inferred_type (_at (list, i)) == types[i];
+        if (! same)
+            fprintf (stderr, "Element %d has type %d instead of %d\n", i, wave_collection_get_inferred_type (_at (list, i)), types[i]);
+    }
+    wave_collection_free (c);
+    return same;
+}
+
+/**
+ * \brief Infer the type of the result of an operator applied to two atoms.
+ */
+static wave_atom_type _binary_type (wave_collection * left, wave_collection * right, wave_operator op)
+{
+    wave_collection * c = _phrase (_list (left, right, _operator (op), NULL));
+    wave_collection_compute_indexes (c);
+    wave_collection_compute_types (c);
+    wave_atom_type t = wave_collection_get_inferred_type (_at (wave_collection_get_list (c), 2));
+    wave_collection_free (c);
+    return t;
+}
+
+/**
+ * \brief Infer the type of the result of an operator applied to an atom.
+ */
+static wave_atom_type _unary_type (wave_collection * operand, wave_operator op)
+{
+    wave_collection * c = _phrase (_list (operand, _operator (op), NULL));
+    wave_collection_compute_indexes (c);
+    wave_collection_compute_types (c);
+    wave_atom_type t = wave_collection_get_inferred_type (_at (wave_collection_get_list (c), 1));
+    wave_collection_free (c);
+    return t;
+}
+
+/**
+ * \brief Determine whether a coordinate prints as a given text.
+ */
+static bool _prints_as (const wave_coordinate * c, const char * expected)
+{
+    char * text = NULL;
+    size_t size = 0;
+    FILE * stream = open_memstream (& text, & size);
+    wave_coordinate_fprint (stream, c);
+    fclose (stream);
+
+    bool same = strcmp (text, expected) == 0;
+    if (! same)
+        fprintf (stderr, "Coordinate \"%s\" instead of \"%s\"\n", text, expected);
+    free (text);
+    return same;
+}
+
+/**
+ * \brief Create a variable coordinate.
+ */
+static wave_coordinate * _var (int first, int second)
+{
+    wave_int_list * list = wave_int_list_alloc ();
+    wave_int_list_push_back (list, first);
+    wave_int_list_push_back (list, second);
+    wave_coordinate * c = wave_coordinate_alloc ();
+    wave_coordinate_set_list (c, list);
+    return c;
+}
+
+/**
+ * \brief Create a constant coordinate.
+ */
+static wave_coordinate * _constant (int constant)
+{
+    wave_coordinate * c = wave_coordinate_alloc ();
+    wave_coordinate_set_constant (c, constant);
+    return c;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Suite related functions.
 ////////////////////////////////////////////////////////////////////////////////
@@ -135,3 +416,266 @@ void test_wave_collection_set_cyclic_list (void)
 void test_wave_collection_set_cyclic_cycle (void)
 {
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Repetitions tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_collection_repetition_times (void)
+{
+    wave_collection * list = _append (_int (1), _int (2));
+    wave_collection * c = _repetition (list, 1000);
+    CU_ASSERT_EQUAL (wave_collection_get_type (c), WAVE_COLLECTION_REP_SEQ);
+    CU_ASSERT_EQUAL (wave_collection_get_repetition_type (c), WAVE_COLLECTION_REPETITION_CONSTANT);
+    CU_ASSERT_EQUAL (wave_collection_get_repetition_times (c), 1000);
+    CU_ASSERT_PTR_EQUAL (wave_collection_get_repetition_list (c), list);
+    CU_ASSERT_PTR_EQUAL (wave_collection_get_parent (list), c);
+    CU_ASSERT_EQUAL (_count (list), 2);
+
+    /* Copies keep the count, and own their list. */
+    wave_collection * copy = wave_collection_copy (c);
+    wave_collection * copied_list = wave_collection_get_repetition_list (copy);
+    CU_ASSERT_EQUAL (wave_collection_get_type (copy), WAVE_COLLECTION_REP_SEQ);
+    CU_ASSERT_EQUAL (wave_collection_get_repetition_times (copy), 1000);
+    CU_ASSERT_PTR_NOT_EQUAL (copied_list, list);
+    CU_ASSERT_PTR_EQUAL (wave_collection_get_parent (copied_list), copy);
+    CU_ASSERT_EQUAL (_count (copied_list), 2);
+    wave_collection_free (copy);
+    wave_collection_free (c);
+
+    c = wave_collection_alloc ();
+    list = _int (3);
+    wave_collection_set_repetition_par_times (c, list, 7);
+    CU_ASSERT_EQUAL (wave_collection_get_type (c), WAVE_COLLECTION_REP_PAR);
+    CU_ASSERT_EQUAL (wave_collection_get_repetition_type (c), WAVE_COLLECTION_REPETITION_CONSTANT);
+    CU_ASSERT_EQUAL (wave_collection_get_repetition_times (c), 7);
+    CU_ASSERT_PTR_EQUAL (wave_collection_get_repetition_list (c), list);
+    wave_collection_free (c);
+}
+
+void test_wave_collection_unroll (void)
+{
+    /* 1 {2;3}32: 64 elements are expanded. */
+    int times = WAVE_COLLECTION_UNROLL_MAX_LENGTH / 2;
+    wave_collection * c = _phrase (_append (_int (1), _repetition (_append (_int (2), _int (3)), times)));
+    wave_collection_unroll_path (c);
+    wave_collection * list = wave_collection_get_list (c);
+    CU_ASSERT_EQUAL (_count (list), 1 + 2 * times);
+    CU_ASSERT_EQUAL (_count_repetitions (list), 0);
+    CU_ASSERT_PTR_EQUAL (wave_collection_get_parent (wave_collection_get_last (list)), c);
+    wave_collection_free (c);
+
+    /* 1 {2;3}33: 66 elements are kept in a loop. */
+    times = WAVE_COLLECTION_UNROLL_MAX_LENGTH / 2 + 1;
+    c = _phrase (_append (_int (1), _repetition (_append (_int (2), _int (3)), times)));
+    wave_collection_unroll_path (c);
+    list = wave_collection_get_list (c);
+    CU_ASSERT_EQUAL (_count (list), 2);
+    CU_ASSERT_EQUAL (_count_repetitions (list), 1);
+    CU_ASSERT_EQUAL (wave_collection_get_repetition_times (wave_collection_get_next (list)), times);
+    wave_collection_free (c);
+
+    /* 1 {+;2}100: operators are kept in a loop. */
+    c = _phrase (_append (_int (1), _repetition (_append (_operator (WAVE_OP_BINARY_PLUS), _int (2)), 100)));
+    wave_collection_unroll_path (c);
+    CU_ASSERT_EQUAL (_count_repetitions (wave_collection_get_list (c)), 1);
+    wave_collection_free (c);
+
+    /* 1 {(2)}100: the repetitions of collections are expanded. */
+    c = _phrase (_append (_int (1), _repetition (_phrase (_int (2)), 100)));
+    wave_collection_unroll_path (c);
+    list = wave_collection_get_list (c);
+    CU_ASSERT_EQUAL (_count (list), 101);
+    CU_ASSERT_EQUAL (_count_repetitions (list), 0);
+    CU_ASSERT_EQUAL (wave_collection_get_type (wave_collection_get_last (list)), WAVE_COLLECTION_SEQ);
+    wave_collection_free (c);
+
+    /* 1 {2;{3}100}2: the outer repetition is short, the inner one is long. */
+    c = _phrase (_append (_int (1), _repetition (_append (_int (2), _repetition (_int (3), 100)), 2)));
+    wave_collection_unroll_path (c);
+    list = wave_collection_get_list (c);
+    CU_ASSERT_EQUAL (_count (list), 5);
+    CU_ASSERT_EQUAL (_count_repetitions (list), 2);
+    wave_collection_free (c);
+}
+
+void test_wave_collection_repetition_coordinates (void)
+{
+    /* 1 {2;3}40 4. */
+    wave_collection * repetition = _repetition (_append (_int (2), _int (3)), 40);
+    wave_collection * c = _phrase (_append (_append (_int (1), repetition), _int (4)));
+    wave_collection_unroll_path (c);
+    wave_collection_compute_indexes (c);
+    wave_collection_compute_length_and_coords (c);
+
+    wave_coordinate * iterator = wave_collection_get_repetition_iterator (repetition);
+    CU_ASSERT_TRUE (wave_coordinate_is_var (iterator));
+    CU_ASSERT_TRUE (_prints_as (iterator, "wave_var_0_1"));
+    wave_coordinate_free (iterator);
+
+    wave_collection * list = wave_collection_get_repetition_list (repetition);
+    CU_ASSERT_TRUE (_prints_as (wave_collection_get_coordinate (repetition), "1"));
+    CU_ASSERT_TRUE (_prints_as (wave_collection_get_length (repetition), "80"));
+    CU_ASSERT_TRUE (_prints_as (wave_collection_get_coordinate (list), "((wave_var_0_1) * (2)) + 1"));
+    CU_ASSERT_TRUE (_prints_as (wave_collection_get_coordinate (wave_collection_get_next (list)), "((wave_var_0_1) * (2)) + 2"));
+
+    /* The element after the loop is after all the iterations. */
+    CU_ASSERT_TRUE (_prints_as (wave_collection_get_coordinate (wave_collection_get_next (repetition)), "81"));
+    wave_collection_free (c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Coordinates tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_collection_coordinate_free (void)
+{
+    /* Each variable of a binary coordinate is freed once. */
+    wave_coordinate * times = wave_coordinate_alloc ();
+    wave_coordinate_set_times (times, _var (0, 1), _constant (2));
+    wave_coordinate * plus = wave_coordinate_alloc ();
+    wave_coordinate_set_plus (plus, times, _var (0, 2));
+    CU_ASSERT_TRUE (wave_coordinate_is_plus (plus));
+
+    wave_coordinate * copy = wave_coordinate_copy (plus);
+    CU_ASSERT_TRUE (wave_coordinate_is_plus (copy));
+    wave_coordinate_free (plus);
+    CU_ASSERT_TRUE (_prints_as (copy, "((wave_var_0_1) * (2)) + wave_var_0_2"));
+    wave_coordinate_free (copy);
+
+    wave_coordinate * var = _var (3, 4);
+    wave_coordinate_free (var);
+}
+
+void test_wave_collection_coordinate_print (void)
+{
+    wave_coordinate * c = wave_coordinate_alloc ();
+    wave_coordinate_set_times (c, _constant (2), _var (0, 1));
+    CU_ASSERT_TRUE (wave_coordinate_is_times (c));
+    CU_ASSERT_TRUE (_prints_as (c, "((2) * (wave_var_0_1))"));
+    wave_coordinate_free (c);
+
+    /* Constant products are computed. */
+    c = wave_coordinate_alloc ();
+    wave_coordinate_set_times (c, _constant (2), _constant (3));
+    CU_ASSERT_TRUE (_prints_as (c, "6"));
+    wave_coordinate_free (c);
+
+    /* Nested products print as valid C. */
+    wave_coordinate * inner = wave_coordinate_alloc ();
+    wave_coordinate_set_plus (inner, _var (1, 2), _constant (1));
+    c = wave_coordinate_alloc ();
+    wave_coordinate_set_times (c, inner, _var (3, 4));
+    CU_ASSERT_TRUE (_prints_as (c, "((wave_var_1_2 + 1) * (wave_var_3_4))"));
+    wave_coordinate_free (c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Types tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_collection_types_operators (void)
+{
+    /* The types of the results, not of the operands. */
+    CU_ASSERT_EQUAL (_binary_type (_int (1), _int (1), WAVE_OP_BINARY_EQUALS), WAVE_ATOM_LITERAL_BOOL);
+    CU_ASSERT_EQUAL (_binary_type (_float (1.5), _int (1), WAVE_OP_BINARY_LESSER), WAVE_ATOM_LITERAL_BOOL);
+    CU_ASSERT_EQUAL (_binary_type (_char ('a'), _string ("b"), WAVE_OP_BINARY_DIFFERS), WAVE_ATOM_LITERAL_BOOL);
+    CU_ASSERT_EQUAL (_unary_type (_int (2), WAVE_OP_UNARY_SQRT), WAVE_ATOM_LITERAL_FLOAT);
+    CU_ASSERT_EQUAL (_unary_type (_int (2), WAVE_OP_UNARY_SIN), WAVE_ATOM_LITERAL_FLOAT);
+
+    CU_ASSERT_EQUAL (_binary_type (_int (1), _int (2), WAVE_OP_BINARY_PLUS), WAVE_ATOM_LITERAL_INT);
+    CU_ASSERT_EQUAL (_binary_type (_int (1), _int (2), WAVE_OP_BINARY_DIVIDE), WAVE_ATOM_LITERAL_INT);
+    CU_ASSERT_EQUAL (_binary_type (_int (1), _float (2.0), WAVE_OP_BINARY_TIMES), WAVE_ATOM_LITERAL_FLOAT);
+    CU_ASSERT_EQUAL (_binary_type (_char ('a'), _string ("b"), WAVE_OP_BINARY_PLUS), WAVE_ATOM_LITERAL_STRING);
+    CU_ASSERT_EQUAL (_binary_type (_char ('a'), _char ('b'), WAVE_OP_BINARY_MIN), WAVE_ATOM_LITERAL_CHAR);
+    CU_ASSERT_EQUAL (_binary_type (_char ('a'), _string ("b"), WAVE_OP_BINARY_MAX), WAVE_ATOM_LITERAL_STRING);
+    CU_ASSERT_EQUAL (_binary_type (_string ("ab"), _int (1), WAVE_OP_BINARY_GET), WAVE_ATOM_LITERAL_CHAR);
+    CU_ASSERT_EQUAL (_binary_type (_bool (true), _bool (false), WAVE_OP_BINARY_AND), WAVE_ATOM_LITERAL_BOOL);
+    CU_ASSERT_EQUAL (_unary_type (_int (65), WAVE_OP_UNARY_CHR), WAVE_ATOM_LITERAL_CHAR);
+    CU_ASSERT_EQUAL (_unary_type (_char ('a'), WAVE_OP_UNARY_CODE), WAVE_ATOM_LITERAL_INT);
+    CU_ASSERT_EQUAL (_unary_type (_int (1), WAVE_OP_UNARY_MINUS), WAVE_ATOM_LITERAL_INT);
+    CU_ASSERT_EQUAL (_unary_type (_float (1.5), WAVE_OP_UNARY_FLOOR), WAVE_ATOM_LITERAL_FLOAT);
+    CU_ASSERT_EQUAL (_unary_type (_bool (true), WAVE_OP_UNARY_NOT), WAVE_ATOM_LITERAL_BOOL);
+
+    /* The operations rejected at runtime have no type. */
+    CU_ASSERT_EQUAL (_binary_type (_bool (true), _bool (false), WAVE_OP_BINARY_MIN), WAVE_ATOM_UNKNOWN);
+    CU_ASSERT_EQUAL (_binary_type (_int (1), _bool (true), WAVE_OP_BINARY_PLUS), WAVE_ATOM_UNKNOWN);
+    CU_ASSERT_EQUAL (_binary_type (_int (1), _int (2), WAVE_OP_BINARY_AND), WAVE_ATOM_UNKNOWN);
+    CU_ASSERT_EQUAL (_binary_type (_string ("ab"), _float (1.0), WAVE_OP_BINARY_GET), WAVE_ATOM_UNKNOWN);
+    CU_ASSERT_EQUAL (_binary_type (_string ("a"), _string ("b"), WAVE_OP_BINARY_MINUS), WAVE_ATOM_UNKNOWN);
+    CU_ASSERT_EQUAL (_unary_type (_int (1), WAVE_OP_UNARY_NOT), WAVE_ATOM_UNKNOWN);
+    CU_ASSERT_EQUAL (_unary_type (_string ("a"), WAVE_OP_UNARY_SQRT), WAVE_ATOM_UNKNOWN);
+
+    /* Operands which are results: 1;2;+;2.5;*;-. */
+    static const wave_atom_type chain[] =
+    {
+        WAVE_ATOM_LITERAL_INT, WAVE_ATOM_LITERAL_INT, WAVE_ATOM_LITERAL_INT,
+        WAVE_ATOM_LITERAL_FLOAT, WAVE_ATOM_LITERAL_FLOAT, WAVE_ATOM_LITERAL_FLOAT,
+    };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _float (2.5),
+        _operator (WAVE_OP_BINARY_TIMES), _operator (WAVE_OP_UNARY_MINUS), NULL)), chain, 6));
+
+    /* Missing operands: +;1;+. */
+    static const wave_atom_type missing[] = { WAVE_ATOM_UNKNOWN, WAVE_ATOM_LITERAL_INT, WAVE_ATOM_UNKNOWN };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_operator (WAVE_OP_BINARY_PLUS), _int (1), _operator (WAVE_OP_BINARY_PLUS), NULL)), missing, 3));
+}
+
+void test_wave_collection_types_specific (void)
+{
+    /* 1.5;print;1;1;<;stop;atom;read. */
+    static const wave_atom_type types[] =
+    {
+        WAVE_ATOM_LITERAL_FLOAT, WAVE_ATOM_LITERAL_FLOAT, WAVE_ATOM_LITERAL_INT, WAVE_ATOM_LITERAL_INT,
+        WAVE_ATOM_LITERAL_BOOL, WAVE_ATOM_LITERAL_BOOL, WAVE_ATOM_LITERAL_BOOL, WAVE_ATOM_UNKNOWN,
+    };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_float (1.5), _operator (WAVE_OP_SPECIFIC_PRINT), _int (1), _int (1),
+        _operator (WAVE_OP_BINARY_LESSER), _operator (WAVE_OP_SPECIFIC_STOP), _operator (WAVE_OP_SPECIFIC_ATOM),
+        _operator (WAVE_OP_SPECIFIC_READ), NULL)), types, 8));
+
+    /* Without a previous element: atom;print;stop. */
+    static const wave_atom_type first[] = { WAVE_ATOM_UNKNOWN, WAVE_ATOM_UNKNOWN, WAVE_ATOM_UNKNOWN };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_operator (WAVE_OP_SPECIFIC_ATOM), _operator (WAVE_OP_SPECIFIC_PRINT),
+        _operator (WAVE_OP_SPECIFIC_STOP), NULL)), first, 3));
+
+    /* Collections have no type: (1);print. */
+    static const wave_atom_type collection[] = { WAVE_ATOM_UNKNOWN, WAVE_ATOM_UNKNOWN };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_par (_int (1)), _operator (WAVE_OP_SPECIFIC_PRINT), NULL)), collection, 2));
+}
+
+void test_wave_collection_types_paths (void)
+{
+    /* 2.5;p;+: the path is replaced by a copy of 2.5. */
+    static const wave_atom_type replaced[] = { WAVE_ATOM_LITERAL_FLOAT, WAVE_ATOM_LITERAL_FLOAT, WAVE_ATOM_LITERAL_FLOAT };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_float (2.5), _path (WAVE_MOVE_PRE), _operator (WAVE_OP_BINARY_PLUS), NULL)), replaced, 3));
+
+    /* 'a';s;=: the path is replaced by a copy of the operator, which lacks an operand. */
+    static const wave_atom_type next[] = { WAVE_ATOM_LITERAL_CHAR, WAVE_ATOM_UNKNOWN, WAVE_ATOM_UNKNOWN };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_char ('a'), _path (WAVE_MOVE_SUC), _operator (WAVE_OP_BINARY_EQUALS), NULL)), next, 3));
+
+    /* p;1;+: the path points to nothing, and is kept. */
+    static const wave_atom_type kept[] = { WAVE_ATOM_UNKNOWN, WAVE_ATOM_LITERAL_INT, WAVE_ATOM_UNKNOWN };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_path (WAVE_MOVE_PRE), _int (1), _operator (WAVE_OP_BINARY_PLUS), NULL)), kept, 3));
+}
+
+void test_wave_collection_types_cut (void)
+{
+    /* (1;2;!);3;+: the value of the sequence is 2. */
+    static const wave_atom_type cut[] = { WAVE_ATOM_LITERAL_INT, WAVE_ATOM_LITERAL_INT, WAVE_ATOM_LITERAL_INT };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_phrase (_list (_int (1), _int (2), _operator (WAVE_OP_SPECIFIC_CUT), NULL)),
+        _int (3), _operator (WAVE_OP_BINARY_PLUS), NULL)), cut, 3));
+
+    /* (true;stop;false;!): a stop gives the value of the same type. */
+    static const wave_atom_type same_stop[] = { WAVE_ATOM_LITERAL_BOOL };
+    CU_ASSERT_TRUE (_has_types (_phrase (_phrase (_list (_bool (true), _operator (WAVE_OP_SPECIFIC_STOP), _bool (false),
+        _operator (WAVE_OP_SPECIFIC_CUT), NULL))), same_stop, 1));
+
+    /* (1.5;stop;2;!): a stop gives a value of another type. */
+    static const wave_atom_type other_stop[] = { WAVE_ATOM_UNKNOWN };
+    CU_ASSERT_TRUE (_has_types (_phrase (_phrase (_list (_float (1.5), _operator (WAVE_OP_SPECIFIC_STOP), _int (2),
+        _operator (WAVE_OP_SPECIFIC_CUT), NULL))), other_stop, 1));
+
+    /* (1;2) and (1||!): no cut ends the sequence, or it is not a sequence. */
+    static const wave_atom_type no_cut[] = { WAVE_ATOM_UNKNOWN, WAVE_ATOM_UNKNOWN };
+    CU_ASSERT_TRUE (_has_types (_phrase (_list (_phrase (_list (_int (1), _int (2), NULL)),
+        _par (_list (_int (1), _operator (WAVE_OP_SPECIFIC_CUT), NULL)), NULL)), no_cut, 2));
+}
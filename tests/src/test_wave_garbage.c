@@ -0,0 +1,504 @@
+/**
+ * \file test_wave_garbage.c
+ * \brief Wave garbage collector tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test_wave_garbage.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static variables.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of iterations of the simulated loops.
+ */
+#define WAVE_GARBAGE_ITERATIONS 8
+
+/**
+ * \brief Length of the long strings, whose buffers are retained.
+ */
+#define WAVE_GARBAGE_LONG_LENGTH 1500
+
+/**
+ * \brief Number of elements of the unboxed collections.
+ *
+ * The bitsets have a whole word and a partial one.
+ */
+#define WAVE_GARBAGE_TAB_SIZE 70
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Store a copy of a null terminated string inside a data.
+ */
+static void _set_string (wave_data * data, const char * s)
+{
+    wave_data_set_string_copy (data, s, strlen (s));
+}
+
+/**
+ * \brief Determine whether a data holds a given string.
+ */
+static bool _has_string (const wave_data * data, const char * s)
+{
+    size_t length;
+    const wave_char * chars = wave_data_get_characters (data, & length);
+    return wave_data_get_type (data) == WAVE_DATA_STRING && length == strlen (s) && memcmp (chars, s, length) == 0;
+}
+
+/**
+ * \brief Append a string to a data, as the generated code does.
+ */
+static void _concat (wave_data * data, const char * s)
+{
+    wave_data right, result;
+    _set_string (& right, s);
+    wave_data_binary (data, & right, & result, WAVE_OP_BINARY_PLUS);
+    * data = result;
+}
+
+/**
+ * \brief Determine whether a data holds a string lying in a buffer.
+ */
+static bool _is_buffered (const wave_data * data)
+{
+    return data->_type == WAVE_DATA_STRING && (data->_flags & WAVE_DATA_FLAG_STRING_BUFFER) != 0;
+}
+
+/**
+ * \brief Allocate temporaries, as an iteration of a loop does.
+ */
+static void _alloc_temporaries (void)
+{
+    for (int i = 0; i < 16; ++i)
+        memset (wave_garbage_alloc (48), 0xab, 48);
+    memset (wave_garbage_alloc (256 * 1024), 0xab, 256 * 1024);
+}
+
+/**
+ * \brief Release the temporaries since a checkpoint, carrying a single data.
+ */
+static void _release_carrying (wave_garbage_checkpoint mark, wave_data * data)
+{
+    wave_data * const roots[] = { data };
+    const size_t sizes[] = { 1 };
+    wave_data_release_to (mark, roots, sizes, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+int test_wave_garbage_suite_init (void)
+{
+    wave_garbage_clean ();
+    return 0;
+}
+
+int test_wave_garbage_suite_clean (void)
+{
+    wave_garbage_destroy ();
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Checkpoints tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_garbage_mark (void)
+{
+    unsigned char * before = wave_garbage_alloc (32);
+    wave_garbage_checkpoint outer = wave_garbage_mark ();
+    unsigned char * between = wave_garbage_alloc (32);
+    wave_garbage_checkpoint inner = wave_garbage_mark ();
+    unsigned char * after = wave_garbage_alloc (32);
+    unsigned char * large = wave_garbage_alloc (1024 * 1024);
+    void * registered = malloc (16);
+    wave_garbage_register (registered);
+
+    CU_ASSERT_EQUAL (inner, outer + 1);
+
+    CU_ASSERT_FALSE (wave_garbage_is_released (outer, before));
+    CU_ASSERT_TRUE (wave_garbage_is_released (outer, between));
+    CU_ASSERT_TRUE (wave_garbage_is_released (outer, after));
+    CU_ASSERT_TRUE (wave_garbage_is_released (outer, registered));
+
+    CU_ASSERT_FALSE (wave_garbage_is_released (inner, before));
+    CU_ASSERT_FALSE (wave_garbage_is_released (inner, between));
+    CU_ASSERT_TRUE (wave_garbage_is_released (inner, after));
+    CU_ASSERT_TRUE (wave_garbage_is_released (inner, after + 31));
+    CU_ASSERT_TRUE (wave_garbage_is_released (inner, large + 512 * 1024));
+    CU_ASSERT_TRUE (wave_garbage_is_released (inner, registered));
+
+    /* Beyond the maximal depth, the checkpoints are ignored. */
+    wave_garbage_checkpoint mark = inner;
+    while (mark < WAVE_GARBAGE_MARKS_MAX)
+        mark = wave_garbage_mark ();
+    wave_garbage_release_to (mark);
+    CU_ASSERT_FALSE (wave_garbage_is_released (mark, after));
+    CU_ASSERT_TRUE (wave_garbage_is_released (inner, after));
+
+    wave_garbage_clean ();
+}
+
+void test_wave_garbage_release_to (void)
+{
+    unsigned char * before = wave_garbage_alloc (32);
+    wave_garbage_checkpoint outer = wave_garbage_mark ();
+    wave_garbage_checkpoint inner = wave_garbage_mark ();
+
+    for (int i = 0; i < WAVE_GARBAGE_ITERATIONS; ++i)
+    {
+        /* The registered pointers are given in both orders, so that the
+         * pointers sorted by a previous iteration are not mistaken for them.
+         */
+        void * first = malloc (16);
+        void * second = malloc (16);
+        bool ascending = ((uintptr_t) first < (uintptr_t) second) == (i % 2 == 0);
+        wave_garbage_register (ascending ? first : second);
+        wave_garbage_register (ascending ? second : first);
+        unsigned char * large = wave_garbage_alloc (1024 * 1024);
+        _alloc_temporaries ();
+
+        CU_ASSERT_TRUE (wave_garbage_is_released (inner, first));
+        CU_ASSERT_TRUE (wave_garbage_is_released (inner, second));
+        CU_ASSERT_TRUE (wave_garbage_is_released (inner, large));
+        CU_ASSERT_FALSE (wave_garbage_is_released (inner, before));
+
+        wave_garbage_release_to (inner);
+    }
+
+    /* Releasing to the outer checkpoint drops the inner one. */
+    wave_garbage_release_to (outer);
+    CU_ASSERT_FALSE (wave_garbage_is_released (inner, wave_garbage_alloc (32)));
+    CU_ASSERT_EQUAL (wave_garbage_mark (), outer + 1);
+
+    wave_garbage_clean ();
+}
+
+void test_wave_garbage_retain (void)
+{
+    wave_garbage_checkpoint mark = wave_garbage_mark ();
+    _alloc_temporaries ();
+    wave_garbage_release_to (mark);
+
+    unsigned char * kept = malloc (16);
+    wave_garbage_retain (mark, kept);
+    CU_ASSERT_FALSE (wave_garbage_is_released (mark, kept));
+
+    _alloc_temporaries ();
+    wave_garbage_release_to (mark);
+    memset (kept, 0, 16);
+    CU_ASSERT_FALSE (wave_garbage_is_released (mark, kept));
+
+    /* Once a pointer is registered since the checkpoint, nothing is retained. */
+    void * registered = malloc (16);
+    wave_garbage_register (registered);
+    void * refused = malloc (16);
+    wave_garbage_retain (mark, refused);
+    CU_ASSERT_TRUE (wave_garbage_is_released (mark, registered));
+    CU_ASSERT_FALSE (wave_garbage_is_released (mark, refused));
+    wave_garbage_release_to (mark);
+    free (refused);
+
+    wave_garbage_clean ();
+}
+
+void test_wave_garbage_attach (void)
+{
+    wave_garbage_checkpoint mark = wave_garbage_mark ();
+    unsigned char * detached = wave_garbage_alloc_detached (100);
+    CU_ASSERT_PTR_NOT_NULL (detached);
+    CU_ASSERT_EQUAL ((uintptr_t) detached % 16, 0);
+    CU_ASSERT_FALSE (wave_garbage_is_released (mark, detached));
+
+    _alloc_temporaries ();
+    wave_garbage_release_to (mark);
+    memset (detached, 0, 100);
+
+    /* Once attached, the memory is owned as if allocated since the checkpoint. */
+    wave_garbage_attach (detached);
+    CU_ASSERT_TRUE (wave_garbage_is_released (mark, detached));
+    CU_ASSERT_TRUE (wave_garbage_is_released (mark, detached + 99));
+
+    wave_garbage_checkpoint inner = wave_garbage_mark ();
+    CU_ASSERT_FALSE (wave_garbage_is_released (inner, detached + 50));
+    _alloc_temporaries ();
+    wave_garbage_release_to (inner);
+    memset (detached, 0, 100);
+    CU_ASSERT_TRUE (wave_garbage_is_released (mark, detached + 50));
+
+    wave_garbage_release_to (mark);
+    wave_garbage_clean ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Carried values tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_garbage_carry_strings (void)
+{
+    static const char * const outer_value = "a string allocated before the checkpoint";
+    static const char * const carried_value = "a string allocated after the checkpoint";
+
+    wave_data outer;
+    _set_string (& outer, outer_value);
+    const wave_char * outer_chars = outer._content._string;
+    wave_garbage_checkpoint mark = wave_garbage_mark ();
+
+    wave_data carried, small;
+    _set_string (& carried, carried_value);
+    _set_string (& small, "small");
+    CU_ASSERT_TRUE (wave_garbage_is_released (mark, carried._content._string));
+
+    for (int i = 0; i < WAVE_GARBAGE_ITERATIONS; ++i)
+    {
+        const wave_char * previous = carried._content._string;
+        _alloc_temporaries ();
+
+        wave_data * const roots[] = { & outer, & carried, & small };
+        const size_t sizes[] = { 1, 1, 1 };
+        wave_data_release_to (mark, roots, sizes, 3);
+
+        CU_ASSERT_PTR_EQUAL (outer._content._string, outer_chars);
+        CU_ASSERT_TRUE (_has_string (& outer, outer_value));
+        CU_ASSERT_PTR_NOT_EQUAL (carried._content._string, previous);
+        CU_ASSERT_TRUE (wave_garbage_is_released (mark, carried._content._string));
+        CU_ASSERT_TRUE (_has_string (& carried, carried_value));
+        CU_ASSERT_TRUE (wave_data_is_small_string (& small));
+        CU_ASSERT_TRUE (_has_string (& small, "small"));
+    }
+
+    wave_garbage_release_to (mark);
+    wave_garbage_clean ();
+}
+
+void test_wave_garbage_carry_string_buffers (void)
+{
+    char expected[128] = "0123456789abcdef";
+    wave_garbage_checkpoint mark = wave_garbage_mark ();
+
+    wave_data longest, prefix;
+    _set_string (& longest, expected);
+
+    for (int i = 0; i < WAVE_GARBAGE_ITERATIONS; ++i)
+    {
+        _concat (& longest, "xyz");
+        prefix = longest;
+        size_t prefix_length = strlen (expected) + 3;
+        _concat (& longest, "uvw");
+        strcat (expected, "xyzuvw");
+        CU_ASSERT_TRUE (_is_buffered (& longest));
+        CU_ASSERT_TRUE (_is_buffered (& prefix));
+        _alloc_temporaries ();
+
+        /* Both strings lie in the same buffer, which is not terminated after the prefix. */
+        wave_data * const roots[] = { & longest, & prefix };
+        const size_t sizes[] = { 1, 1 };
+        wave_data_release_to (mark, roots, sizes, 2);
+
+        CU_ASSERT_TRUE (_is_buffered (& longest));
+        CU_ASSERT_TRUE (_has_string (& longest, expected));
+        CU_ASSERT_TRUE (wave_garbage_is_released (mark, longest._content._buffered._buffer));
+
+        char prefix_expected[128];
+        memcpy (prefix_expected, expected, prefix_length);
+        prefix_expected[prefix_length] = '\0';
+        CU_ASSERT_TRUE (_has_string (& prefix, prefix_expected));
+    }
+
+    wave_garbage_release_to (mark);
+    wave_garbage_clean ();
+}
+
+void test_wave_garbage_carry_tabs (void)
+{
+    static const char * const string_value = "a string inside a sequence";
+
+    wave_int * kept_ints = wave_garbage_alloc (WAVE_GARBAGE_TAB_SIZE * sizeof (wave_int));
+    for (int i = 0; i < WAVE_GARBAGE_TAB_SIZE; ++i)
+        kept_ints[i] = -i;
+    wave_garbage_checkpoint mark = wave_garbage_mark ();
+
+    wave_data * elements = wave_garbage_alloc (3 * sizeof (wave_data));
+    wave_int * ints = wave_garbage_alloc (WAVE_GARBAGE_TAB_SIZE * sizeof (wave_int));
+    wave_float * floats = wave_garbage_alloc (WAVE_GARBAGE_TAB_SIZE * sizeof (wave_float));
+    uint64_t * bits = wave_garbage_alloc (WAVE_KERNELS_WORDS (WAVE_GARBAGE_TAB_SIZE) * sizeof (uint64_t));
+    wave_float expected_floats[WAVE_GARBAGE_TAB_SIZE];
+    for (int i = 0; i < WAVE_GARBAGE_TAB_SIZE; ++i)
+    {
+        ints[i] = i;
+        floats[i] = expected_floats[i] = i / 4.0;
+    }
+    bits[0] = UINT64_C (0x5555555555555555);
+    bits[1] = UINT64_C (0x2a);
+
+    _set_string (& elements[0], string_value);
+    wave_data_set_int (& elements[1], 7);
+    wave_data_set_par_int (& elements[2], ints, WAVE_GARBAGE_TAB_SIZE);
+
+    wave_data roots_tab[4];
+    roots_tab[0] = (wave_data) { ._type = WAVE_DATA_SEQ, ._flags = 0 };
+    roots_tab[0]._content._collection._tab = elements;
+    roots_tab[0]._content._collection._size = 3;
+    wave_data_set_par_float (& roots_tab[1], floats, WAVE_GARBAGE_TAB_SIZE);
+    wave_data_set_par_bool (& roots_tab[2], bits, WAVE_GARBAGE_TAB_SIZE);
+    wave_data_set_par_int (& roots_tab[3], kept_ints, WAVE_GARBAGE_TAB_SIZE);
+
+    for (int i = 0; i < WAVE_GARBAGE_ITERATIONS; ++i)
+    {
+        const wave_data * previous = roots_tab[0]._content._collection._tab;
+        _alloc_temporaries ();
+
+        wave_data * const roots[] = { roots_tab };
+        const size_t sizes[] = { 4 };
+        wave_data_release_to (mark, roots, sizes, 1);
+
+        const wave_data * seq = roots_tab[0]._content._collection._tab;
+        CU_ASSERT_EQUAL (roots_tab[0]._type, WAVE_DATA_SEQ);
+        CU_ASSERT_EQUAL (roots_tab[0]._content._collection._size, 3);
+        CU_ASSERT_PTR_NOT_EQUAL (seq, previous);
+        CU_ASSERT_TRUE (wave_garbage_is_released (mark, seq));
+        CU_ASSERT_TRUE (_has_string (& seq[0], string_value));
+        CU_ASSERT_TRUE (wave_garbage_is_released (mark, seq[0]._content._string));
+        CU_ASSERT_EQUAL (wave_data_get_int (& seq[1]), 7);
+        CU_ASSERT_EQUAL (wave_data_get_type (& seq[2]), WAVE_DATA_PAR_INT);
+        CU_ASSERT_EQUAL (wave_data_get_type (& roots_tab[1]), WAVE_DATA_PAR_FLOAT);
+        CU_ASSERT_EQUAL (wave_data_get_type (& roots_tab[2]), WAVE_DATA_PAR_BOOL);
+        CU_ASSERT_EQUAL (wave_data_get_par_size (& roots_tab[2]), WAVE_GARBAGE_TAB_SIZE);
+
+        const wave_int * carried_ints = seq[2]._content._packed._tab._ints;
+        const wave_float * carried_floats = roots_tab[1]._content._packed._tab._floats;
+        const uint64_t * carried_bits = roots_tab[2]._content._packed._tab._bits;
+        CU_ASSERT_TRUE (wave_garbage_is_released (mark, carried_ints));
+        CU_ASSERT_TRUE (wave_garbage_is_released (mark, carried_floats));
+        CU_ASSERT_TRUE (wave_garbage_is_released (mark, carried_bits));
+        CU_ASSERT_PTR_EQUAL (roots_tab[3]._content._packed._tab._ints, kept_ints);
+
+        bool same = true;
+        for (int j = 0; j < WAVE_GARBAGE_TAB_SIZE; ++j)
+            same = same && carried_ints[j] == j && kept_ints[j] == -j;
+        CU_ASSERT_TRUE (same);
+        CU_ASSERT_EQUAL (memcmp (carried_floats, expected_floats, sizeof expected_floats), 0);
+        CU_ASSERT_EQUAL (carried_bits[0], UINT64_C (0x5555555555555555));
+        CU_ASSERT_EQUAL (carried_bits[1], UINT64_C (0x2a));
+    }
+
+    wave_garbage_release_to (mark);
+    wave_garbage_clean ();
+}
+
+void test_wave_garbage_carry_retained (void)
+{
+    static char half[WAVE_GARBAGE_LONG_LENGTH / 2 + 1];
+    static char expected[4 * WAVE_GARBAGE_LONG_LENGTH];
+    memset (half, 'a', WAVE_GARBAGE_LONG_LENGTH / 2);
+    memset (expected, 'a', WAVE_GARBAGE_LONG_LENGTH);
+
+    wave_garbage_checkpoint mark = wave_garbage_mark ();
+    wave_data s;
+    _set_string (& s, half);
+    _concat (& s, half);
+    _release_carrying (mark, & s);
+
+    /* The buffer of a long string is kept, with room for the next iterations. */
+    wave_string_buffer * buffer = s._content._buffered._buffer;
+    CU_ASSERT_TRUE (_is_buffered (& s));
+    CU_ASSERT_TRUE (_has_string (& s, expected));
+    CU_ASSERT_FALSE (wave_garbage_is_released (mark, buffer));
+    CU_ASSERT_EQUAL (buffer->_capacity, 2 * WAVE_GARBAGE_LONG_LENGTH);
+
+    for (int i = 0; i < WAVE_GARBAGE_ITERATIONS; ++i)
+    {
+        _concat (& s, "tail");
+        strcat (expected, "tail");
+        _alloc_temporaries ();
+        _release_carrying (mark, & s);
+
+        CU_ASSERT_PTR_EQUAL (s._content._buffered._buffer, buffer);
+        CU_ASSERT_TRUE (_has_string (& s, expected));
+    }
+
+    /* Once the buffer is full, the string moves to a new retained buffer. */
+    size_t length = strlen (expected);
+    char * rest = expected + length;
+    memset (rest, 'b', 2 * WAVE_GARBAGE_LONG_LENGTH - length + 1);
+    rest[2 * WAVE_GARBAGE_LONG_LENGTH - length + 1] = '\0';
+    _concat (& s, rest);
+    _alloc_temporaries ();
+    _release_carrying (mark, & s);
+
+    CU_ASSERT_PTR_NOT_EQUAL (s._content._buffered._buffer, buffer);
+    CU_ASSERT_FALSE (wave_garbage_is_released (mark, s._content._buffered._buffer));
+    CU_ASSERT_TRUE (_has_string (& s, expected));
+
+    wave_garbage_release_to (mark);
+    wave_garbage_clean ();
+}
+
+void test_wave_garbage_carry_nested (void)
+{
+    static const char * const outer_value = "a string carried by the outer loop";
+    static const char * const inner_value = "a string carried by the inner loop";
+
+    wave_garbage_checkpoint outer_mark = wave_garbage_mark ();
+    wave_data outer;
+    _set_string (& outer, outer_value);
+    const wave_char * outer_chars = outer._content._string;
+
+    for (int i = 0; i < WAVE_GARBAGE_ITERATIONS; ++i)
+    {
+        wave_garbage_checkpoint inner_mark = wave_garbage_mark ();
+        CU_ASSERT_EQUAL (inner_mark, outer_mark + 1);
+
+        wave_data inner;
+        _set_string (& inner, inner_value);
+        for (int j = 0; j < WAVE_GARBAGE_ITERATIONS; ++j)
+        {
+            _alloc_temporaries ();
+            _release_carrying (inner_mark, & inner);
+            CU_ASSERT_TRUE (_has_string (& inner, inner_value));
+            CU_ASSERT_TRUE (wave_garbage_is_released (inner_mark, inner._content._string));
+            CU_ASSERT_PTR_EQUAL (outer._content._string, outer_chars);
+        }
+
+        wave_data * const roots[] = { & outer, & inner };
+        const size_t sizes[] = { 1, 1 };
+        wave_data_release_to (outer_mark, roots, sizes, 2);
+        outer_chars = outer._content._string;
+
+        CU_ASSERT_TRUE (_has_string (& outer, outer_value));
+        CU_ASSERT_TRUE (_has_string (& inner, inner_value));
+        CU_ASSERT_TRUE (wave_garbage_is_released (outer_mark, outer._content._string));
+        CU_ASSERT_TRUE (wave_garbage_is_released (outer_mark, inner._content._string));
+    }
+
+    wave_garbage_release_to (outer_mark);
+    wave_garbage_clean ();
+}
@@ -0,0 +1,734 @@
+/**
+ * \file test_wave_generation.c
+ * \brief Wave code generation tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test_wave_generation.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a collection holding an atom.
+ */
+static wave_collection * _atom (wave_atom * a)
+{
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_atom (c, a);
+    return c;
+}
+
+/**
+ * \brief Create an integer atom collection.
+ */
+static wave_collection * _int (wave_int i)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_int (a, i);
+    return _atom (a);
+}
+
+/**
+ * \brief Create a floating point atom collection.
+ */
+static wave_collection * _float (wave_float f)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_float (a, f);
+    return _atom (a);
+}
+
+/**
+ * \brief Create a boolean atom collection.
+ */
+static wave_collection * _bool (wave_bool b)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_bool (a, b);
+    return _atom (a);
+}
+
+/**
+ * \brief Create a string atom collection.
+ */
+static wave_collection * _string (const_wave_string string)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_string (a, string);
+    return _atom (a);
+}
+
+/**
+ * \brief Create an operator atom collection.
+ */
+static wave_collection * _operator (wave_operator op)
+{
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_operator (a, op);
+    return _atom (a);
+}
+
+/**
+ * \brief Create a path atom collection, made of a single move.
+ */
+static wave_collection * _path (wave_move_type move)
+{
+    wave_path * p = wave_path_alloc ();
+    wave_path_set_move (p, move);
+    wave_atom * a = wave_atom_alloc ();
+    wave_atom_set_path (a, p);
+    return _atom (a);
+}
+
+/**
+ * \brief Create a list from collections, terminated by \c NULL.
+ */
+static wave_collection * _list (wave_collection * first, ...)
+{
+    va_list collections;
+    va_start (collections, first);
+    wave_collection * last = first;
+    for (wave_collection * c = va_arg (collections, wave_collection *); c != NULL; c = va_arg (collections, wave_collection *))
+    {
+        wave_collection_add_collection (last, c);
+        last = c;
+    }
+    va_end (collections);
+    return first;
+}
+
+/**
+ * \brief Get a collection of a list.
+ */
+static wave_collection * _at (wave_collection * list, int index)
+{
+    for (int i = 0; i < index && list != NULL; ++i)
+        list = wave_collection_get_next (list);
+    return list;
+}
+
+/**
+ * \brief Create a sequential collection.
+ */
+static wave_collection * _seq (wave_collection * list)
+{
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_seq_list (c, list);
+    return c;
+}
+
+/**
+ * \brief Create a parallel collection.
+ */
+static wave_collection * _par (wave_collection * list)
+{
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_par_list (c, list);
+    return c;
+}
+
+/**
+ * \brief Create a sequential constant repetition.
+ */
+static wave_collection * _repetition (wave_collection * list, int times)
+{
+    wave_collection * c = wave_collection_alloc ();
+    wave_collection_set_repetition_seq_times (c, list, times);
+    return c;
+}
+
+/**
+ * \brief Mark a value as unknown.
+ */
+static void _set_unknown_value (wave_data * value)
+{
+    value->_type = WAVE_DATA_UNKNOWN;
+    value->_flags = WAVE_DATA_FLAG_NONE;
+}
+
+/**
+ * \brief Run the passes preceding the generation of a phrase, as wave_code_generation does.
+ * \param list Elements of the phrase.
+ * \return The collection of the phrase.
+ */
+static wave_collection * _prepare (wave_collection * list)
+{
+    wave_collection * c = _seq (list);
+    wave_collection_unroll_path (c);
+    wave_collection_compute_indexes (c);
+    wave_collection_replace_path (c);
+    wave_collection_compute_types (c);
+    wave_code_generation_prepare_operators (c);
+    wave_collection_compute_length_and_coords (c);
+    return c;
+}
+
+/**
+ * \brief Determine which elements of a list are stored in local variables.
+ * \param list Elements.
+ * \param expected Whether each element is expected to be stored in a local variable.
+ * \param count Number of elements.
+ */
+static bool _are_scalars (wave_collection * list, const bool expected[], int count)
+{
+    bool same = true;
+    for (int i = 0; i < count; ++i)
+    {
+        wave_collection * element = _at (list, i);
+        bool is_scalar = element != NULL && wave_code_generation_is_scalar (element);
+        if (is_scalar != expected[i])
+        {
+            fprintf (stderr, "Element %d is%s scalar\n", i, is_scalar ? "" : " not");
+            same = false;
+        }
+    }
+    return same && _at (list, count) == NULL;
+}
+
+/**
+ * \brief Determine which elements of a phrase are stored in local variables, and free it.
+ * \param list Elements of the phrase.
+ * \param expected Whether each element is expected to be stored in a local variable.
+ * \param count Number of elements.
+ */
+static bool _phrase_scalars (wave_collection * list, const bool expected[], int count)
+{
+    wave_collection * c = _prepare (list);
+    bool same = _are_scalars (wave_collection_get_list (c), expected, count);
+    wave_collection_free (c);
+    return same;
+}
+
+/**
+ * \brief Print a value in a string.
+ * \param value Value.
+ * \return The text of the value, to be freed.
+ */
+static char * _text (const wave_data * value)
+{
+    char * text = NULL;
+    size_t size = 0;
+    FILE * stream = open_memstream (& text, & size);
+    if (stream != NULL)
+    {
+        wave_data_fprint (stream, value);
+        fclose (stream);
+    }
+    return text;
+}
+
+/**
+ * \brief Determine whether a value has a type and a text.
+ * \param value Value.
+ * \param type Expected type.
+ * \param expected Expected text, or \c NULL to skip the comparison.
+ */
+static bool _is_value (const wave_data * value, wave_data_type type, const char * expected)
+{
+    bool same = value != NULL && wave_data_get_type (value) == type;
+    if (same && expected != NULL)
+    {
+        char * text = _text (value);
+        same = text != NULL && strcmp (text, expected) == 0;
+        if (! same)
+            fprintf (stderr, "Value %s instead of %s\n", text, expected);
+        free (text);
+    }
+    return same;
+}
+
+/**
+ * \brief Determine whether two values are the same.
+ */
+static bool _same_values (const wave_data * value, const wave_data * expected)
+{
+    char * text = _text (expected);
+    bool same = _is_value (value, wave_data_get_type (expected), text);
+    free (text);
+    return same;
+}
+
+/**
+ * \brief Compute the value of the last element of a phrase.
+ * \param list Elements of the phrase, freed.
+ * \param value Storage for the value.
+ * \retval true if the value is known.
+ * \retval false otherwise.
+ *
+ * The values are released by wave_code_generation_clean_fold().
+ */
+static bool _fold_last (wave_collection * list, wave_data * value)
+{
+    wave_collection * c = _prepare (list);
+    list = wave_collection_get_list (c);
+    wave_code_generation_prepare_fold (c);
+    const wave_data * values = wave_code_generation_fold_list (list);
+    size_t last = 0;
+    while (wave_collection_get_next (_at (list, (int) last)) != NULL)
+        ++last;
+
+    _set_unknown_value (value);
+    if (values != NULL)
+        * value = values[last];
+    wave_collection_free (c);
+    return wave_data_get_type (value) != WAVE_DATA_UNKNOWN;
+}
+
+/**
+ * \brief Compare the folding of an unary operator with wave_data_unary().
+ * \param operand Operand, freed.
+ * \param op Operator.
+ */
+static bool _folds_unary (wave_collection * operand, wave_operator op)
+{
+    wave_data values[2], expected;
+    bool same = _fold_last (_list (wave_collection_copy (operand), NULL), & values[0])
+        && _fold_last (_list (operand, _operator (op), NULL), & values[1])
+        && wave_data_unary_is_defined (& values[0], op);
+    if (same)
+    {
+        wave_data_unary (& values[0], & expected, op);
+        same = _same_values (& values[1], & expected);
+    }
+    wave_code_generation_clean_fold ();
+    return same;
+}
+
+/**
+ * \brief Compare the folding of a binary operator with wave_data_binary().
+ * \param left Left operand, freed.
+ * \param right Right operand, freed.
+ * \param op Operator.
+ */
+static bool _folds_binary (wave_collection * left, wave_collection * right, wave_operator op)
+{
+    wave_data values[3], expected;
+    bool same = _fold_last (_list (wave_collection_copy (left), NULL), & values[0])
+        && _fold_last (_list (wave_collection_copy (right), NULL), & values[1])
+        && _fold_last (_list (left, right, _operator (op), NULL), & values[2])
+        && wave_data_binary_is_defined (& values[0], & values[1], op);
+    if (same)
+    {
+        wave_data_binary (& values[0], & values[1], & expected, op);
+        same = _same_values (& values[2], & expected);
+    }
+    wave_code_generation_clean_fold ();
+    return same;
+}
+
+/**
+ * \brief Determine whether the last element of a phrase has a folded value.
+ * \param list Elements of the phrase, freed.
+ * \param type Expected type.
+ * \param expected Expected text, or \c NULL to skip the comparison.
+ */
+static bool _folds_to (wave_collection * list, wave_data_type type, const char * expected)
+{
+    wave_data value;
+    _fold_last (list, & value);
+    bool same = _is_value (& value, type, expected);
+    wave_code_generation_clean_fold ();
+    return same;
+}
+
+/**
+ * \brief Generate the code of an element of a phrase.
+ * \param list Elements of the phrase, freed.
+ * \param index Index of the element, or -1 for the last one.
+ * \param code Storage for the code, to be freed.
+ * \param alloc Storage for the allocations, to be freed.
+ * \return Whether the element was folded.
+ */
+static bool _fold_code (wave_collection * list, int index, char ** code, char ** alloc)
+{
+    size_t code_size = 0, alloc_size = 0;
+    FILE * code_file = open_memstream (code, & code_size);
+    FILE * alloc_file = open_memstream (alloc, & alloc_size);
+    bool is_folded = false;
+    if (code_file != NULL && alloc_file != NULL)
+    {
+        wave_collection * c = _prepare (list);
+        list = wave_collection_get_list (c);
+        wave_code_generation_prepare_fold (c);
+        const wave_data * values = wave_code_generation_fold_list (list);
+        if (index < 0)
+            for (index = 0; wave_collection_get_next (_at (list, index)) != NULL; ++index)
+                continue;
+
+        is_folded = values != NULL && wave_code_generation_fold_collection (code_file, alloc_file, _at (list, index), & values[index]);
+        wave_code_generation_clean_fold ();
+        wave_collection_free (c);
+    }
+    if (code_file != NULL)
+        fclose (code_file);
+    if (alloc_file != NULL)
+        fclose (alloc_file);
+    return is_folded;
+}
+
+/**
+ * \brief Get the number of the last static tab of some code.
+ * \param code Code.
+ * \return The number, zero if the code has no static tab.
+ */
+static unsigned long int _storage (const char * code)
+{
+    const char * name = strstr (code, "wave_fold_");
+    unsigned long int storage = 0;
+    if (name != NULL)
+        sscanf (name, "wave_fold_%lu", & storage);
+    return storage;
+}
+
+/**
+ * \brief Compare generated code with the expected one.
+ * \param code Code, freed.
+ * \param expected Expected code.
+ */
+static bool _is_code (char * code, const char * expected)
+{
+    bool same = code != NULL && strcmp (code, expected) == 0;
+    if (! same)
+        fprintf (stderr, "Code:\n%s\ninstead of:\n%s\n", code, expected);
+    free (code);
+    return same;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+int test_wave_generation_suite_init (void)
+{
+    char budget[32];
+    snprintf (budget, sizeof budget, "%d", WAVE_GENERATION_FOLD_BUDGET);
+    return setenv ("WAVE2C_FOLD_BUDGET", budget, 1);
+}
+
+int test_wave_generation_suite_clean (void)
+{
+    return unsetenv ("WAVE2C_FOLD_BUDGET");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar elements tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_generation_scalar_accepted (void)
+{
+    /* 1;2;+: the first operand is read by the binary operator two elements later. */
+    static const bool binary[] = { true, true, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), NULL), binary, 3));
+
+    /* 1;2;+;3.5;*;sqrt: results read by the following operators. */
+    static const bool chain[] = { true, true, true, true, true, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _float (3.5),
+        _operator (WAVE_OP_BINARY_TIMES), _operator (WAVE_OP_UNARY_SQRT), NULL), chain, 6));
+
+    /* 2;-;3: an unary operator, then an element read by nothing. */
+    static const bool unary[] = { true, false, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (2), _operator (WAVE_OP_UNARY_MINUS), _int (3), NULL), unary, 3));
+
+    /* 1;{+;1}2: a short repetition is expanded into 1;+;1;+;1. */
+    static const bool expanded[] = { true, false, true, false, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _repetition (_list (_operator (WAVE_OP_UNARY_INCREMENT), _int (1), NULL), 2), NULL),
+        expanded, 5));
+}
+
+void test_wave_generation_scalar_rejected (void)
+{
+    /* 1;print and 1;2;stop: print and stop read the tab. */
+    static const bool print[] = { false, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _operator (WAVE_OP_SPECIFIC_PRINT), NULL), print, 2));
+    static const bool stop[] = { false, false, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _int (2), _operator (WAVE_OP_SPECIFIC_STOP), NULL), stop, 3));
+
+    /* 1;2;+;print: the result is read by print. */
+    static const bool result_print[] = { true, true, false, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _operator (WAVE_OP_SPECIFIC_PRINT), NULL),
+        result_print, 4));
+
+    /* 1;2;<: the operator is direct, but its result is a boolean. */
+    static const bool comparison[] = { true, true, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_LESSER), NULL), comparison, 3));
+
+    /* 1;"a";+: an operator on a string is computed at runtime. */
+    static const bool dynamic[] = { false, false, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _string ("a"), _operator (WAVE_OP_BINARY_PLUS), NULL), dynamic, 3));
+
+    /* "a";1;get: only the index is scalar, the string stays in the tab. */
+    static const bool get[] = { false, true, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_string ("a"), _int (1), _operator (WAVE_OP_BINARY_GET), NULL), get, 3));
+
+    /* 1;2;+;atom: the result is read by atom. */
+    static const bool atom[] = { true, true, false, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _operator (WAVE_OP_SPECIFIC_ATOM), NULL),
+        atom, 4));
+}
+
+void test_wave_generation_scalar_collections (void)
+{
+    /* 3;(1;2;+;!);(1;2;+);(1||2||+): only the elements of the sequence ended by a
+     * cut are private. A cut reads the tab.
+     */
+    wave_collection * c = _prepare (_list (_int (3),
+        _seq (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _operator (WAVE_OP_SPECIFIC_CUT), NULL)),
+        _seq (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), NULL)),
+        _par (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), NULL)), NULL));
+    wave_collection * list = wave_collection_get_list (c);
+    static const bool root[] = { false, false, false, false };
+    CU_ASSERT_TRUE (_are_scalars (list, root, 4));
+    static const bool cut[] = { true, true, false, false };
+    CU_ASSERT_TRUE (_are_scalars (wave_collection_get_list (_at (list, 1)), cut, 4));
+    static const bool other[] = { false, false, false };
+    CU_ASSERT_TRUE (_are_scalars (wave_collection_get_list (_at (list, 2)), other, 3));
+    CU_ASSERT_TRUE (_are_scalars (wave_collection_get_list (_at (list, 3)), other, 3));
+    wave_collection_free (c);
+
+    /* 1;2;{+;1}100 and 1;2;+;{+;1}100: the elements preceding a loop are read by it. */
+    c = _prepare (_list (_int (1), _int (2), _repetition (_list (_operator (WAVE_OP_BINARY_PLUS), _int (1), NULL), 100), NULL));
+    list = wave_collection_get_list (c);
+    CU_ASSERT_EQUAL (wave_collection_get_type (_at (list, 2)), WAVE_COLLECTION_REP_SEQ);
+    static const bool loop[] = { false, false, false };
+    CU_ASSERT_TRUE (_are_scalars (list, loop, 3));
+    static const bool repeated[] = { false, false };
+    CU_ASSERT_TRUE (_are_scalars (wave_collection_get_repetition_list (_at (list, 2)), repeated, 2));
+    wave_collection_free (c);
+
+    c = _prepare (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS),
+        _repetition (_list (_operator (WAVE_OP_BINARY_PLUS), _int (1), NULL), 100), NULL));
+    list = wave_collection_get_list (c);
+    static const bool before_loop[] = { true, false, false, false };
+    CU_ASSERT_TRUE (_are_scalars (list, before_loop, 4));
+    wave_collection_free (c);
+
+    /* 1;2;+;p: paths may read any element. */
+    static const bool path[] = { false, false, false, false };
+    CU_ASSERT_TRUE (_phrase_scalars (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _path (WAVE_MOVE_UP), NULL), path, 4));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Folding tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_generation_fold_operations (void)
+{
+    CU_ASSERT_TRUE (_folds_unary (_int (3), WAVE_OP_UNARY_MINUS));
+    CU_ASSERT_TRUE (_folds_unary (_int (3), WAVE_OP_UNARY_DECREMENT));
+    CU_ASSERT_TRUE (_folds_unary (_float (2.5), WAVE_OP_UNARY_SQRT));
+    CU_ASSERT_TRUE (_folds_unary (_float (0.5), WAVE_OP_UNARY_COS));
+    CU_ASSERT_TRUE (_folds_unary (_float (-2.7), WAVE_OP_UNARY_FLOOR));
+    CU_ASSERT_TRUE (_folds_unary (_int (65), WAVE_OP_UNARY_CHR));
+    CU_ASSERT_TRUE (_folds_unary (_bool (true), WAVE_OP_UNARY_NOT));
+    CU_ASSERT_TRUE (_folds_unary (_par (_list (_int (1), _int (-2), NULL)), WAVE_OP_UNARY_MINUS));
+
+    CU_ASSERT_TRUE (_folds_binary (_int (7), _int (2), WAVE_OP_BINARY_DIVIDE));
+    CU_ASSERT_TRUE (_folds_binary (_int (-7), _int (3), WAVE_OP_BINARY_MOD));
+    CU_ASSERT_TRUE (_folds_binary (_float (2.5), _int (4), WAVE_OP_BINARY_TIMES));
+    CU_ASSERT_TRUE (_folds_binary (_int (1), _float (2.5), WAVE_OP_BINARY_LESSER));
+    CU_ASSERT_TRUE (_folds_binary (_bool (true), _bool (false), WAVE_OP_BINARY_OR));
+    CU_ASSERT_TRUE (_folds_binary (_string ("ab"), _string ("cd"), WAVE_OP_BINARY_PLUS));
+    CU_ASSERT_TRUE (_folds_binary (_par (_list (_int (1), _int (2), NULL)), _int (1), WAVE_OP_BINARY_PLUS));
+    CU_ASSERT_TRUE (_folds_binary (_par (_list (_float (1.5), _float (2), NULL)), _int (2), WAVE_OP_BINARY_TIMES));
+
+    /* 1;2;+;3;* and (1;2;+;4||5). */
+    CU_ASSERT_TRUE (_folds_to (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _int (3), _operator (WAVE_OP_BINARY_TIMES), NULL),
+        WAVE_DATA_INT, "9"));
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), NULL)), NULL),
+        WAVE_DATA_SEQ, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_par (_list (_int (4), _int (5), NULL)), NULL), WAVE_DATA_PAR_INT, NULL));
+}
+
+void test_wave_generation_fold_budget (void)
+{
+    /* Each element of a collection takes an atom. */
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_int (1), _int (2), _int (3), _int (4), _int (5), _int (6), _int (7), _int (8), NULL)), NULL),
+        WAVE_DATA_SEQ, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_int (1), _int (2), _int (3), _int (4), _int (5), _int (6), _int (7), _int (8), _int (9), NULL)), NULL),
+        WAVE_DATA_UNKNOWN, NULL));
+
+    /* The elements are taken before the results of the operators. */
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _int (4), _int (5), _int (6), _int (7), NULL)), NULL),
+        WAVE_DATA_SEQ, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _int (4), _int (5), _int (6), _int (7), _int (8), NULL)), NULL),
+        WAVE_DATA_UNKNOWN, NULL));
+
+    /* Nested collections share the budget. */
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_seq (_list (_int (1), _int (2), _int (3), NULL)), _seq (_list (_int (4), _int (5), _int (6), NULL)), NULL)), NULL),
+        WAVE_DATA_SEQ, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_seq (_list (_int (1), _int (2), _int (3), NULL)), _seq (_list (_int (4), _int (5), _int (6), _int (7), NULL)), NULL)), NULL),
+        WAVE_DATA_UNKNOWN, NULL));
+
+    /* A string takes an atom per character. */
+    CU_ASSERT_TRUE (_folds_to (_list (_string ("abc"), _string ("defg"), _operator (WAVE_OP_BINARY_PLUS), NULL), WAVE_DATA_STRING, "\"abcdefg\""));
+    CU_ASSERT_TRUE (_folds_to (_list (_string ("abcd"), _string ("efgh"), _operator (WAVE_OP_BINARY_PLUS), NULL), WAVE_DATA_UNKNOWN, NULL));
+
+    /* The budget is given to each element of the phrase, and an unknown operand
+     * leaves the next operators unknown.
+     */
+    CU_ASSERT_TRUE (_folds_to (_list (_string ("abcd"), _string ("efg"), _operator (WAVE_OP_BINARY_PLUS),
+        _string ("x"), _operator (WAVE_OP_BINARY_LESSER), NULL), WAVE_DATA_BOOL, "true"));
+    CU_ASSERT_TRUE (_folds_to (_list (_string ("abcd"), _string ("efgh"), _operator (WAVE_OP_BINARY_PLUS),
+        _string ("a"), _operator (WAVE_OP_BINARY_PLUS), NULL), WAVE_DATA_UNKNOWN, NULL));
+}
+
+void test_wave_generation_fold_stop_cut (void)
+{
+    /* Stop and print share the previous value in the phrase. */
+    CU_ASSERT_TRUE (_folds_to (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _operator (WAVE_OP_SPECIFIC_PRINT), NULL),
+        WAVE_DATA_INT, "3"));
+    CU_ASSERT_TRUE (_folds_to (_list (_bool (true), _int (2), _operator (WAVE_OP_SPECIFIC_STOP), NULL), WAVE_DATA_INT, "2"));
+
+    /* (true;5;stop;1;0;/): the elements following the stop are never computed. */
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_bool (true), _int (5), _operator (WAVE_OP_SPECIFIC_STOP),
+        _int (1), _int (0), _operator (WAVE_OP_BINARY_DIVIDE), NULL)), NULL), WAVE_DATA_INT, "5"));
+
+    /* (false;5;stop;7): the collection goes on. */
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_bool (false), _int (5), _operator (WAVE_OP_SPECIFIC_STOP), _int (7), NULL)), NULL),
+        WAVE_DATA_SEQ, NULL));
+
+    /* (1;5;stop): the condition is not a boolean. */
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_int (1), _int (5), _operator (WAVE_OP_SPECIFIC_STOP), NULL)), NULL), WAVE_DATA_UNKNOWN, NULL));
+
+    /* (1;2;+;!) and (!). */
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _operator (WAVE_OP_SPECIFIC_CUT), NULL)), NULL),
+        WAVE_DATA_INT, "3"));
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_operator (WAVE_OP_SPECIFIC_CUT), NULL)), NULL), WAVE_DATA_UNKNOWN, NULL));
+}
+
+void test_wave_generation_fold_unknown (void)
+{
+    /* Divisions by zero are reported by the generated code. */
+    CU_ASSERT_TRUE (_folds_to (_list (_int (1), _int (0), _operator (WAVE_OP_BINARY_DIVIDE), NULL), WAVE_DATA_UNKNOWN, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_int (1), _int (0), _operator (WAVE_OP_BINARY_MOD), NULL), WAVE_DATA_UNKNOWN, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_seq (_list (_int (1), _int (0), _operator (WAVE_OP_BINARY_DIVIDE), NULL)), NULL), WAVE_DATA_UNKNOWN, NULL));
+
+    /* Get is left to the generated code. */
+    CU_ASSERT_TRUE (_folds_to (_list (_string ("abc"), _int (1), _operator (WAVE_OP_BINARY_GET), NULL), WAVE_DATA_UNKNOWN, NULL));
+
+    /* Infinite and NaN values have no literal. */
+    CU_ASSERT_TRUE (_folds_to (_list (_float (1), _float (0), _operator (WAVE_OP_BINARY_DIVIDE), NULL), WAVE_DATA_UNKNOWN, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_float (1e308), _float (10), _operator (WAVE_OP_BINARY_TIMES), NULL), WAVE_DATA_UNKNOWN, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_float (-1), _operator (WAVE_OP_UNARY_SQRT), NULL), WAVE_DATA_UNKNOWN, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_float (0), _operator (WAVE_OP_UNARY_LOG), NULL), WAVE_DATA_UNKNOWN, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_par (_list (_float (1), _float (2), NULL)), _float (0), _operator (WAVE_OP_BINARY_DIVIDE), NULL),
+        WAVE_DATA_UNKNOWN, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_par (_list (_float (1), _float (2), NULL)), _float (4), _operator (WAVE_OP_BINARY_DIVIDE), NULL),
+        WAVE_DATA_PAR_FLOAT, NULL));
+
+    /* Operands read by paths, and repeated collections. */
+    CU_ASSERT_TRUE (_folds_to (_list (_path (WAVE_MOVE_UP), _seq (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), NULL)), NULL),
+        WAVE_DATA_UNKNOWN, NULL));
+    CU_ASSERT_TRUE (_folds_to (_list (_repetition (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), NULL), 100), NULL),
+        WAVE_DATA_UNKNOWN, NULL));
+
+    wave_collection * c = _prepare (_list (_repetition (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), NULL), 100), NULL));
+    wave_code_generation_prepare_fold (c);
+    CU_ASSERT_PTR_NULL (wave_code_generation_fold_list (wave_collection_get_repetition_list (wave_collection_get_list (c))));
+    wave_code_generation_clean_fold ();
+    wave_collection_free (c);
+}
+
+void test_wave_generation_fold_initializers (void)
+{
+    char * code, * alloc;
+    char expected[512];
+
+    /* 1;2;+;3;*: a scalar, then an element of the tab of the phrase. */
+    CU_ASSERT_TRUE (_fold_code (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _int (3), _operator (WAVE_OP_BINARY_TIMES), NULL), 2, & code, & alloc));
+    CU_ASSERT_TRUE (_is_code (code, "wave_int wave_scalar_0_2 = 3;\n"));
+    CU_ASSERT_TRUE (_is_code (alloc, ""));
+    CU_ASSERT_TRUE (_fold_code (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), _int (3), _operator (WAVE_OP_BINARY_TIMES), NULL), -1, & code, & alloc));
+    CU_ASSERT_TRUE (_is_code (code, "wave_tab_0[4] = (wave_data) { ._content._int = 9, ._type = WAVE_DATA_INT };\n"));
+    CU_ASSERT_TRUE (_is_code (alloc, ""));
+    CU_ASSERT_TRUE (_fold_code (_list (_float (1), _float (2), _operator (WAVE_OP_BINARY_PLUS), _float (0.5), _operator (WAVE_OP_BINARY_TIMES), NULL), 2, & code, & alloc));
+    CU_ASSERT_TRUE (_is_code (code, "wave_float wave_scalar_0_2 = 0x1.8p+1;\n"));
+    free (alloc);
+    CU_ASSERT_TRUE (_fold_code (_list (_float (1), _float (2), _operator (WAVE_OP_BINARY_PLUS), _float (0.5), _operator (WAVE_OP_BINARY_TIMES), NULL), -1, & code, & alloc));
+    CU_ASSERT_TRUE (_is_code (code, "wave_tab_0[4] = (wave_data) { ._content._float = 0x1.8p+0, ._type = WAVE_DATA_FLOAT };\n"));
+    free (alloc);
+
+    /* Literals are generated as usual. */
+    CU_ASSERT_FALSE (_fold_code (_list (_int (1), NULL), -1, & code, & alloc));
+    CU_ASSERT_TRUE (_is_code (code, ""));
+    free (alloc);
+
+    /* 1;0;/ stays unfolded. */
+    CU_ASSERT_FALSE (_fold_code (_list (_int (1), _int (0), _operator (WAVE_OP_BINARY_DIVIDE), NULL), -1, & code, & alloc));
+    CU_ASSERT_TRUE (_is_code (code, ""));
+    CU_ASSERT_TRUE (_is_code (alloc, ""));
+
+    /* "a?";"\"";+: escaped characters. */
+    CU_ASSERT_TRUE (_fold_code (_list (_string ("a?"), _string ("\"\\"), _operator (WAVE_OP_BINARY_PLUS), NULL), -1, & code, & alloc));
+    CU_ASSERT_TRUE (_is_code (code, "wave_tab_0[2] = (wave_data) { ._content._string = \"a\\?\\\"\\\\\", ._type = WAVE_DATA_STRING };\n"));
+    free (alloc);
+
+    /* (1||2);(3||4);+: packed integers. */
+    CU_ASSERT_TRUE (_fold_code (_list (_par (_list (_int (1), _int (2), NULL)), _par (_list (_int (3), _int (4), NULL)),
+        _operator (WAVE_OP_BINARY_PLUS), NULL), -1, & code, & alloc));
+    unsigned long int storage = _storage (code);
+    snprintf (expected, sizeof expected, "wave_tab_0[2] = (wave_data) { ._content._packed = { { ._ints = wave_fold_%lu }, 2 }, ._type = WAVE_DATA_PAR_INT };\n", storage);
+    CU_ASSERT_TRUE (_is_code (code, expected));
+    snprintf (expected, sizeof expected, "static wave_int wave_fold_%lu[2] = { 4, 6 };\n", storage);
+    CU_ASSERT_TRUE (_is_code (alloc, expected));
+
+    /* (0.5||1.5);2;*: packed floating point values. */
+    CU_ASSERT_TRUE (_fold_code (_list (_par (_list (_float (0.5), _float (1.5), NULL)), _float (2), _operator (WAVE_OP_BINARY_TIMES), NULL), -1, & code, & alloc));
+    storage = _storage (code);
+    snprintf (expected, sizeof expected, "wave_tab_0[2] = (wave_data) { ._content._packed = { { ._floats = wave_fold_%lu }, 2 }, ._type = WAVE_DATA_PAR_FLOAT };\n", storage);
+    CU_ASSERT_TRUE (_is_code (code, expected));
+    snprintf (expected, sizeof expected, "static wave_float wave_fold_%lu[2] = { 0x1p+0, 0x1.8p+1 };\n", storage);
+    CU_ASSERT_TRUE (_is_code (alloc, expected));
+
+    /* (1||2||3);2;<: a bitset. */
+    CU_ASSERT_TRUE (_fold_code (_list (_par (_list (_int (1), _int (2), _int (3), NULL)), _int (2), _operator (WAVE_OP_BINARY_LESSER), NULL), -1, & code, & alloc));
+    storage = _storage (code);
+    snprintf (expected, sizeof expected, "wave_tab_0[2] = (wave_data) { ._content._packed = { { ._bits = wave_fold_%lu }, 3 }, ._type = WAVE_DATA_PAR_BOOL };\n", storage);
+    CU_ASSERT_TRUE (_is_code (code, expected));
+    snprintf (expected, sizeof expected, "static uint64_t wave_fold_%lu[1] = { UINT64_C (0x1) };\n", storage);
+    CU_ASSERT_TRUE (_is_code (alloc, expected));
+
+    /* ((1||2);(1;2;+)): the tabs of the elements come first. */
+    CU_ASSERT_TRUE (_fold_code (_list (_seq (_list (_par (_list (_int (1), _int (2), NULL)),
+        _seq (_list (_int (1), _int (2), _operator (WAVE_OP_BINARY_PLUS), NULL)), NULL)), NULL), -1, & code, & alloc));
+    storage = _storage (code);
+    snprintf (expected, sizeof expected, "wave_tab_0[0] = (wave_data) { ._content._collection = { wave_fold_%lu, 2 }, ._type = WAVE_DATA_SEQ };\n", storage);
+    CU_ASSERT_TRUE (_is_code (code, expected));
+    snprintf (expected, sizeof expected,
+        "static wave_int wave_fold_%lu[2] = { 1, 2 };\n"
+        "static wave_data wave_fold_%lu[3] =\n{\n"
+        "{ ._content._int = 1, ._type = WAVE_DATA_INT },\n"
+        "{ ._content._int = 2, ._type = WAVE_DATA_INT },\n"
+        "{ ._content._int = 3, ._type = WAVE_DATA_INT },\n"
+        "};\n"
+        "static wave_data wave_fold_%lu[2] =\n{\n"
+        "{ ._content._packed = { { ._ints = wave_fold_%lu }, 2 }, ._type = WAVE_DATA_PAR_INT },\n"
+        "{ ._content._collection = { wave_fold_%lu, 3 }, ._type = WAVE_DATA_SEQ },\n"
+        "};\n", storage - 2, storage - 1, storage, storage - 2, storage - 1);
+    CU_ASSERT_TRUE (_is_code (alloc, expected));
+}
@@ -0,0 +1,405 @@
+/**
+ * \file test_wave_input.c
+ * \brief Wave input tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test_wave_input.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Read the first value of a text.
+ */
+static void _read_text (const char * text, wave_data * data)
+{
+    wave_input_open_memory (text, strlen (text));
+    wave_input_read (data);
+}
+
+/**
+ * \brief Get the exit status of a process reading values.
+ * \param input Input.
+ * \param size Size of the input.
+ * \param count Number of values to read.
+ * \return The exit status, 0 if the process did not exit by itself, or -1 if it could not be run.
+ */
+static int _read_bytes_status (const void * input, size_t size, int count)
+{
+    fflush (NULL);
+    pid_t pid = fork ();
+    if (pid < 0)
+        return -1;
+
+    if (pid == 0)
+    {
+        /* The error messages are expected. */
+        int null = open ("/dev/null", O_WRONLY);
+        if (null >= 0)
+            dup2 (null, STDERR_FILENO);
+
+        wave_data data;
+        wave_input_open_memory (input, size);
+        for (int i = 0; i < count; ++i)
+            wave_input_read (& data);
+        _exit (0);
+    }
+
+    int status;
+    if (waitpid (pid, & status, 0) != pid || ! WIFEXITED (status))
+        return -1;
+    return WEXITSTATUS (status);
+}
+
+/**
+ * \brief Get the exit status of a process reading the values of a text.
+ */
+static int _read_status (const char * text, int count)
+{
+    return _read_bytes_status (text, strlen (text), count);
+}
+
+/**
+ * \brief Determine whether a data holds a given integer.
+ */
+static bool _is_int (const wave_data * data, wave_int i)
+{
+    return wave_data_get_type (data) == WAVE_DATA_INT && wave_data_get_int (data) == i;
+}
+
+/**
+ * \brief Determine whether a data holds a given floating point value, bit by bit.
+ */
+static bool _is_float (const wave_data * data, wave_float f)
+{
+    wave_float value = wave_data_get_float (data);
+    return wave_data_get_type (data) == WAVE_DATA_FLOAT && memcmp (& value, & f, sizeof f) == 0;
+}
+
+/**
+ * \brief Determine whether a data holds a given string.
+ */
+static bool _is_string (const wave_data * data, const char * s)
+{
+    if (wave_data_get_type (data) != WAVE_DATA_STRING)
+        return false;
+    size_t length;
+    const wave_char * chars = wave_data_get_characters (data, & length);
+    return length == strlen (s) && memcmp (chars, s, length) == 0;
+}
+
+/**
+ * \brief Determine whether a data holds a boxed collection of a given type and size.
+ */
+static bool _is_collection (const wave_data * data, wave_data_type type, size_t size)
+{
+    return wave_data_get_type (data) == type && data->_content._collection._size == size;
+}
+
+/**
+ * \brief Get an element of a boxed collection.
+ */
+static const wave_data * _element (const wave_data * data, size_t i)
+{
+    return & data->_content._collection._tab[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+int test_wave_input_suite_init (void)
+{
+    return 0;
+}
+
+int test_wave_input_suite_clean (void)
+{
+    wave_input_close ();
+    wave_garbage_clean ();
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_input_literals (void)
+{
+    static const char text[] =
+        "42 -7\t2147483647\n-2147483648 0 1.5 -2e3 .25 1E-2 -0.0 "
+        "'c' ' ' \"\" \"small\" \"a string longer than a small one\" true false";
+
+    wave_data data;
+    wave_input_open_memory (text, strlen (text));
+
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_int (& data, 42));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_int (& data, -7));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_int (& data, INT32_MAX));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_int (& data, INT32_MIN));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_int (& data, 0));
+
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_float (& data, 1.5));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_float (& data, -2000.0));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_float (& data, 0.25));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_float (& data, 0.01));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_float (& data, -0.0));
+
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (wave_data_get_type (& data) == WAVE_DATA_CHAR && wave_data_get_char (& data) == 'c');
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (wave_data_get_type (& data) == WAVE_DATA_CHAR && wave_data_get_char (& data) == ' ');
+
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_string (& data, ""));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_string (& data, "small"));
+    CU_ASSERT_TRUE (wave_data_is_small_string (& data));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_string (& data, "a string longer than a small one"));
+    CU_ASSERT_FALSE (wave_data_is_small_string (& data));
+
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (wave_data_get_type (& data) == WAVE_DATA_BOOL && wave_data_get_bool (& data));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (wave_data_get_type (& data) == WAVE_DATA_BOOL && ! wave_data_get_bool (& data));
+
+    CU_ASSERT_FALSE (wave_input_next (& data));
+    wave_input_close ();
+}
+
+void test_wave_input_collections (void)
+{
+    wave_data data;
+
+    _read_text ("(1;2;3)", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_SEQ, 3));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 0), 1));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 2), 3));
+
+    _read_text ("( 5 )", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_SEQ, 1));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 0), 5));
+
+    _read_text ("(\"a\" || 'b' || true)", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_PAR, 3));
+    CU_ASSERT_TRUE (_is_string (_element (& data, 0), "a"));
+    CU_ASSERT_EQUAL (wave_data_get_char (_element (& data, 1)), 'b');
+    CU_ASSERT_TRUE (wave_data_get_bool (_element (& data, 2)));
+
+    /* Collections nested in both orders, numbers after a boxed element. */
+    _read_text ("((1;2)||(\"x\";(3||4);5.5)||6)", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_PAR, 3));
+    const wave_data * first = _element (& data, 0);
+    const wave_data * second = _element (& data, 1);
+    CU_ASSERT_TRUE (_is_collection (first, WAVE_DATA_SEQ, 2));
+    CU_ASSERT_TRUE (_is_int (_element (first, 1), 2));
+    CU_ASSERT_TRUE (_is_collection (second, WAVE_DATA_SEQ, 3));
+    CU_ASSERT_TRUE (_is_string (_element (second, 0), "x"));
+    CU_ASSERT_EQUAL (wave_data_get_type (_element (second, 1)), WAVE_DATA_PAR_INT);
+    CU_ASSERT_TRUE (_is_float (_element (second, 2), 5.5));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 2), 6));
+
+    /* A collection of numbers followed by a nested one is boxed. */
+    _read_text ("(1;2;(3;4))", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_SEQ, 3));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 1), 2));
+    CU_ASSERT_TRUE (_is_collection (_element (& data, 2), WAVE_DATA_SEQ, 2));
+
+    wave_input_close ();
+}
+
+void test_wave_input_unboxed (void)
+{
+    wave_data data;
+
+    _read_text ("(1||-2||3)", & data);
+    CU_ASSERT_EQUAL (wave_data_get_type (& data), WAVE_DATA_PAR_INT);
+    CU_ASSERT_EQUAL (wave_data_get_par_size (& data), 3);
+    CU_ASSERT_EQUAL (data._content._packed._tab._ints[1], -2);
+    CU_ASSERT_EQUAL (data._content._packed._tab._ints[2], 3);
+
+    _read_text ("(1.5||-2e1||.5)", & data);
+    CU_ASSERT_EQUAL (wave_data_get_type (& data), WAVE_DATA_PAR_FLOAT);
+    CU_ASSERT_EQUAL (wave_data_get_par_size (& data), 3);
+    CU_ASSERT_EQUAL (memcmp (data._content._packed._tab._floats, (const wave_float []) { 1.5, -20.0, 0.5 }, 3 * sizeof (wave_float)), 0);
+
+    /* Mixing integers and floating point values boxes them. */
+    _read_text ("(1||2||2.5)", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_PAR, 3));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 1), 2));
+    CU_ASSERT_TRUE (_is_float (_element (& data, 2), 2.5));
+    _read_text ("(0.5||2)", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_PAR, 2));
+    CU_ASSERT_TRUE (_is_float (_element (& data, 0), 0.5));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 1), 2));
+
+    /* Sequences of numbers are boxed, the parallel collections they hold are not. */
+    _read_text ("((1||2);(3.0||4.0))", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_SEQ, 2));
+    CU_ASSERT_EQUAL (wave_data_get_type (_element (& data, 0)), WAVE_DATA_PAR_INT);
+    CU_ASSERT_EQUAL (wave_data_get_type (_element (& data, 1)), WAVE_DATA_PAR_FLOAT);
+
+    /* A large collection grows the stacks. */
+    size_t count = 5000;
+    char * text = malloc (count * 8 + 3);
+    size_t length = 0;
+    text[length++] = '(';
+    for (size_t i = 0; i < count; ++i)
+        length += (size_t) sprintf (text + length, i == 0 ? "%zu" : "||%zu", i);
+    text[length++] = ')';
+    text[length] = '\0';
+    _read_text (text, & data);
+    CU_ASSERT_EQUAL (wave_data_get_type (& data), WAVE_DATA_PAR_INT);
+    CU_ASSERT_EQUAL (wave_data_get_par_size (& data), count);
+    CU_ASSERT_EQUAL (data._content._packed._tab._ints[count - 1], (wave_int) (count - 1));
+    wave_input_close ();
+    free (text);
+}
+
+void test_wave_input_binary (void)
+{
+    wave_data elements[2], value;
+    wave_data_set_int (& elements[0], 7);
+    wave_data_set_string_copy (& elements[1], "binary", 6);
+    value._type = WAVE_DATA_PAR;
+    value._flags = WAVE_DATA_FLAG_NONE;
+    value._content._collection._tab = elements;
+    value._content._collection._size = 2;
+
+    char * binary = NULL;
+    size_t binary_size;
+    FILE * stream = open_memstream (& binary, & binary_size);
+    CU_ASSERT_PTR_NOT_NULL (stream);
+    if (stream == NULL)
+        return;
+    bool written = wave_data_write_binary (stream, & value);
+    fclose (stream);
+    CU_ASSERT_TRUE (written);
+
+    /* The binary value is read alone, after a text value, and inside a collection. */
+    size_t size = 2 * binary_size + 8;
+    char * text = malloc (size);
+    memcpy (text, binary, binary_size);
+    memcpy (text + binary_size, " 1 (", 4);
+    memcpy (text + binary_size + 4, binary, binary_size);
+    memcpy (text + 2 * binary_size + 4, ";2)", 3);
+
+    wave_data data;
+    wave_input_open_memory (text, size - 1);
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_PAR, 2));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 0), 7));
+    CU_ASSERT_TRUE (_is_string (_element (& data, 1), "binary"));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_int (& data, 1));
+    wave_input_read (& data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_SEQ, 2));
+    CU_ASSERT_TRUE (_is_collection (_element (& data, 0), WAVE_DATA_PAR, 2));
+    CU_ASSERT_TRUE (_is_string (_element (_element (& data, 0), 1), "binary"));
+    CU_ASSERT_TRUE (_is_int (_element (& data, 1), 2));
+    CU_ASSERT_FALSE (wave_input_next (& data));
+    wave_input_close ();
+
+    /* Truncated binary values, and strings which are not terminated, are errors. */
+    CU_ASSERT_EQUAL (_read_bytes_status (text, binary_size - 1, 1), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_bytes_status (text, 16, 1), EX_DATAERR);
+    text[binary_size - 2] = 'x';
+    CU_ASSERT_EQUAL (_read_bytes_status (text, size - 1, 1), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_status ("WAVEBIN2", 1), EX_DATAERR);
+
+    free (text);
+    free (binary);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Errors tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_input_errors (void)
+{
+    static const char * const malformed[] =
+    {
+        "(1;2||3)", "(1||2;3)", "(\"a\";'b'||true)",   /* Mixed separators. */
+        "(1;2", "((1;2)", "(", "(1||",                  /* Unclosed collections. */
+        "maybe", "tru", "truest", "(1;yes)",            /* Unknown words. */
+        "(1 2)", "(1|2)", "()", "(;1)",                 /* Missing elements or separators. */
+        "\"abc", "'a", "'",                             /* Unterminated strings and characters. */
+        "-", "1e", "1.5.5", "--1",                      /* Bad numbers. */
+        "@", ")",                                       /* Unexpected characters. */
+    };
+
+    for (size_t i = 0; i < sizeof malformed / sizeof malformed[0]; ++i)
+        CU_ASSERT_EQUAL (_read_status (malformed[i], 1), EX_DATAERR);
+
+    /* Numbers too long to be read. */
+    char long_number[600];
+    memset (long_number, '1', sizeof long_number - 1);
+    long_number[sizeof long_number - 1] = '\0';
+    CU_ASSERT_EQUAL (_read_status (long_number, 1), EX_DATAERR);
+
+    /* No value left. */
+    CU_ASSERT_EQUAL (_read_status ("", 1), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_status (" \n\t ", 1), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_status ("1 2", 3), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_status ("1 2", 2), 0);
+}
+
+void test_wave_input_collection_max (void)
+{
+    wave_data data;
+    wave_input_set_collection_max (4);
+
+    _read_text ("(1||2||3||4)", & data);
+    CU_ASSERT_EQUAL (wave_data_get_par_size (& data), 4);
+    _read_text ("((1;2;3;4);(5.0||6.0||7.0||8.0);\"a\";'b')", & data);
+    CU_ASSERT_TRUE (_is_collection (& data, WAVE_DATA_SEQ, 4));
+
+    /* Unboxed, boxed, and nested collections, and numbers boxed on the way. */
+    CU_ASSERT_EQUAL (_read_status ("(1||2||3||4||5)", 1), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_status ("(1;2;3;4;5)", 1), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_status ("(\"a\";\"b\";\"c\";\"d\";\"e\")", 1), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_status ("(1;(1;2;3;4;5))", 1), EX_DATAERR);
+    CU_ASSERT_EQUAL (_read_status ("(1||2||3||4.0||5)", 1), EX_DATAERR);
+
+    /* The limit never exceeds the size of a data. */
+    wave_input_set_collection_max (SIZE_MAX);
+    _read_text ("(1||2||3||4||5)", & data);
+    CU_ASSERT_EQUAL (wave_data_get_par_size (& data), 5);
+    wave_input_close ();
+}
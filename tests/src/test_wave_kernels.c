@@ -0,0 +1,612 @@
+/**
+ * \file test_wave_kernels.c
+ * \brief Wave kernels tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test_wave_kernels.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static variables.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of elements of the tabs.
+ *
+ * The number is odd and big enough so that every instruction set processes
+ * whole vectors and a tail.
+ */
+#define WAVE_KERNELS_SIZE 37
+
+/**
+ * \brief Number of operands of the transcendental functions tests.
+ */
+#define WAVE_KERNELS_TRANSCENDENTAL_SIZE 1021
+
+/**
+ * \brief Number of operands of the sine and cosine reduction tests.
+ */
+#define WAVE_KERNELS_REDUCTION_SIZE 65536
+
+/**
+ * \brief Largest operand of the sine and cosine reduction, 2^19 pi/2.
+ */
+#define WAVE_KERNELS_REDUCTION_LIMIT 0x1.921fb54442d18p19
+
+/**
+ * \brief Number of elements of the bitset tests.
+ *
+ * The bitsets have two whole words and a partial one.
+ */
+#define WAVE_KERNELS_BITS_SIZE 157
+
+static wave_int int_left[WAVE_KERNELS_SIZE];
+static wave_int int_right[WAVE_KERNELS_SIZE];
+static wave_float float_left[WAVE_KERNELS_SIZE];
+static wave_float float_right[WAVE_KERNELS_SIZE];
+static wave_float reduction_operand[WAVE_KERNELS_REDUCTION_SIZE];
+static wave_float reduction_result[WAVE_KERNELS_REDUCTION_SIZE];
+
+static wave_int (* const unary_int []) (wave_int) =
+{
+    [WAVE_OP_UNARY_PLUS] = wave_int_unary_plus,
+    [WAVE_OP_UNARY_MINUS] = wave_int_unary_minus,
+    [WAVE_OP_UNARY_INCREMENT] = wave_int_increment,
+    [WAVE_OP_UNARY_DECREMENT] = wave_int_decrement,
+};
+
+static wave_float (* const unary_float []) (wave_float) =
+{
+    [WAVE_OP_UNARY_PLUS] = wave_float_unary_plus,
+    [WAVE_OP_UNARY_MINUS] = wave_float_unary_minus,
+    [WAVE_OP_UNARY_INCREMENT] = wave_float_increment,
+    [WAVE_OP_UNARY_DECREMENT] = wave_float_decrement,
+};
+
+static wave_float (* const unary_transcendental []) (wave_float) =
+{
+    [WAVE_OP_UNARY_SQRT] = wave_float_sqrt,
+    [WAVE_OP_UNARY_SIN] = wave_float_sin,
+    [WAVE_OP_UNARY_COS] = wave_float_cos,
+    [WAVE_OP_UNARY_LOG] = wave_float_log,
+    [WAVE_OP_UNARY_EXP] = wave_float_exp,
+};
+
+static wave_int (* const binary_int []) (wave_int, wave_int) =
+{
+    [WAVE_OP_BINARY_PLUS] = wave_int_binary_plus,
+    [WAVE_OP_BINARY_MINUS] = wave_int_binary_minus,
+    [WAVE_OP_BINARY_MIN] = wave_int_min,
+    [WAVE_OP_BINARY_MAX] = wave_int_max,
+    [WAVE_OP_BINARY_TIMES] = wave_int_times,
+    [WAVE_OP_BINARY_DIVIDE] = wave_int_divide,
+    [WAVE_OP_BINARY_MOD] = wave_int_mod,
+};
+
+static wave_bool (* const binary_int_to_bool []) (wave_int, wave_int) =
+{
+    [WAVE_OP_BINARY_EQUALS] = wave_int_equals,
+    [WAVE_OP_BINARY_DIFFERS] = wave_int_differs,
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = wave_int_lesser_or_equals,
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = wave_int_greater_or_equals,
+    [WAVE_OP_BINARY_GREATER] = wave_int_greater,
+    [WAVE_OP_BINARY_LESSER] = wave_int_lesser,
+};
+
+static wave_float (* const binary_float []) (wave_float, wave_float) =
+{
+    [WAVE_OP_BINARY_PLUS] = wave_float_binary_plus,
+    [WAVE_OP_BINARY_MINUS] = wave_float_binary_minus,
+    [WAVE_OP_BINARY_MIN] = wave_float_min,
+    [WAVE_OP_BINARY_MAX] = wave_float_max,
+    [WAVE_OP_BINARY_TIMES] = wave_float_times,
+    [WAVE_OP_BINARY_DIVIDE] = wave_float_divide,
+    [WAVE_OP_BINARY_MOD] = wave_float_mod,
+};
+
+static wave_bool (* const binary_float_to_bool []) (wave_float, wave_float) =
+{
+    [WAVE_OP_BINARY_EQUALS] = wave_float_equals,
+    [WAVE_OP_BINARY_DIFFERS] = wave_float_differs,
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = wave_float_lesser_or_equals,
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = wave_float_greater_or_equals,
+    [WAVE_OP_BINARY_GREATER] = wave_float_greater,
+    [WAVE_OP_BINARY_LESSER] = wave_float_lesser,
+};
+
+static wave_bool (* const binary_bool []) (wave_bool, wave_bool) =
+{
+    [WAVE_OP_BINARY_EQUALS] = wave_bool_equals,
+    [WAVE_OP_BINARY_DIFFERS] = wave_bool_differs,
+    [WAVE_OP_BINARY_LESSER_OR_EQUALS] = wave_bool_lesser_or_equals,
+    [WAVE_OP_BINARY_GREATER_OR_EQUALS] = wave_bool_greater_or_equals,
+    [WAVE_OP_BINARY_GREATER] = wave_bool_greater,
+    [WAVE_OP_BINARY_LESSER] = wave_bool_lesser,
+    [WAVE_OP_BINARY_AND] = wave_bool_and,
+    [WAVE_OP_BINARY_OR] = wave_bool_or,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Compare two floats, NaN being equal to NaN.
+ */
+static bool _same_float (wave_float a, wave_float b)
+{
+    return (isnan (a) && isnan (b)) || (! isunordered (a, b) && ! islessgreater (a, b));
+}
+
+/**
+ * \brief Compare two floats, allowing one unit in the last place of difference.
+ *
+ * NaN is equal to NaN, and zeros must have the same sign.
+ */
+static bool _close_float (wave_float a, wave_float b)
+{
+    if (isnan (a) || isnan (b))
+        return isnan (a) && isnan (b);
+
+    int64_t i, j;
+    memcpy (& i, & a, sizeof i);
+    memcpy (& j, & b, sizeof j);
+    i = i < 0 ? INT64_MIN - i : i;
+    j = j < 0 ? INT64_MIN - j : j;
+    return signbit (a) == signbit (b) && (i > j ? i - j : j - i) <= 1;
+}
+
+/**
+ * \brief Get the distance between a float and an exact value, in units in the last place.
+ */
+static double _ulp_error (wave_float a, long double exact)
+{
+    wave_float rounded = fabs ((wave_float) exact);
+    return (double) fabsl ((a - exact) / (nextafter (rounded, INFINITY) - rounded));
+}
+
+/**
+ * \brief Get a value of a bitset.
+ */
+static bool _bit (const uint64_t * bits, unsigned int i)
+{
+    return (bits[i / WAVE_KERNELS_WORD_BITS] >> (i % WAVE_KERNELS_WORD_BITS) & 1) != 0;
+}
+
+/**
+ * \brief Determine whether the bits past the last value of a bitset are cleared.
+ */
+static bool _padding_cleared (const uint64_t * bits, unsigned int size)
+{
+    return size % WAVE_KERNELS_WORD_BITS == 0 || bits[size / WAVE_KERNELS_WORD_BITS] >> (size % WAVE_KERNELS_WORD_BITS) == 0;
+}
+
+/**
+ * \brief Run a test for each supported instruction set.
+ */
+static void _for_each_level (void (* test) (void))
+{
+    wave_kernels_level best = wave_kernels_get_best_level ();
+    for (wave_kernels_level level = WAVE_KERNELS_SCALAR; level <= best; ++level)
+    {
+        wave_kernels_set_level (level);
+        test ();
+    }
+    wave_kernels_set_level (best);
+}
+
+static void _int_unary (void)
+{
+    wave_int result[WAVE_KERNELS_SIZE];
+    for (wave_operator op = WAVE_OP_UNARY_PLUS; op <= WAVE_OP_UNARY_DECREMENT; ++op)
+    {
+        CU_ASSERT_TRUE (wave_kernels_has_int_unary (op));
+        wave_kernels_int_unary (op, int_left, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (result[i], unary_int[op] (int_left[i]));
+    }
+}
+
+static void _float_unary (void)
+{
+    wave_float result[WAVE_KERNELS_SIZE];
+    for (wave_operator op = WAVE_OP_UNARY_PLUS; op <= WAVE_OP_UNARY_DECREMENT; ++op)
+    {
+        CU_ASSERT_TRUE (wave_kernels_has_float_unary (op));
+        wave_kernels_float_unary (op, float_left, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_TRUE (_same_float (result[i], unary_float[op] (float_left[i])));
+    }
+}
+
+static void _float_transcendental (void)
+{
+    static const wave_float special[] =
+    {
+        0.0, -0.0, INFINITY, -INFINITY, NAN, -1.0, 1.0, 0x1p-1074, 0x1p-1022, 0x1.fffffffffffffp1023,
+        709.78, 709.79, -708.5, -745.13, -745.14, 1.5707963267948966, 3.141592653589793, 1.0e6, -1.0e22,
+    };
+    const unsigned int special_count = sizeof special / sizeof special[0];
+
+    wave_float operand[WAVE_KERNELS_TRANSCENDENTAL_SIZE];
+    wave_float result[WAVE_KERNELS_TRANSCENDENTAL_SIZE];
+    for (unsigned int i = 0; i < WAVE_KERNELS_TRANSCENDENTAL_SIZE; ++i)
+    {
+        wave_float magnitude = ldexp (1.0 + i / 97.0, (int) (i % 41) - 20);
+        operand[i] = i < special_count ? special[i] : (i % 2 ? - magnitude : magnitude);
+    }
+
+    for (wave_operator op = WAVE_OP_UNARY_SQRT; op <= WAVE_OP_UNARY_EXP; ++op)
+    {
+        if (op == WAVE_OP_UNARY_NOT)
+            continue;
+
+        CU_ASSERT_TRUE (wave_kernels_has_float_unary (op));
+        wave_kernels_float_unary (op, operand, result, WAVE_KERNELS_TRANSCENDENTAL_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_TRANSCENDENTAL_SIZE; ++i)
+            CU_ASSERT_TRUE (_close_float (result[i], unary_transcendental[op] (operand[i])));
+    }
+}
+
+static void _float_reduction (void)
+{
+    for (wave_operator op = WAVE_OP_UNARY_SIN; op <= WAVE_OP_UNARY_COS; ++op)
+    {
+        wave_kernels_float_unary (op, reduction_operand, reduction_result, WAVE_KERNELS_REDUCTION_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_REDUCTION_SIZE; ++i)
+        {
+            wave_float x = reduction_operand[i];
+            CU_ASSERT_TRUE (_close_float (reduction_result[i], unary_transcendental[op] (x)));
+            /* The C library is within 0.52 ULP of the exact values, so that a
+             * result more than 1 ULP away from them may still be close to it.
+             */
+            if (LDBL_MANT_DIG > DBL_MANT_DIG)
+                CU_ASSERT_TRUE (_ulp_error (reduction_result[i], op == WAVE_OP_UNARY_SIN ? sinl (x) : cosl (x)) < 1.0);
+        }
+    }
+}
+
+static void _int_binary (void)
+{
+    wave_int result[WAVE_KERNELS_SIZE];
+    for (wave_operator op = WAVE_OP_BINARY_PLUS; op <= WAVE_OP_BINARY_MOD; ++op)
+    {
+        CU_ASSERT_TRUE (wave_kernels_has_int_binary (op));
+        wave_kernels_int_binary (op, int_left, int_right, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (result[i], binary_int[op] (int_left[i], int_right[i]));
+    }
+}
+
+static void _float_binary (void)
+{
+    wave_float result[WAVE_KERNELS_SIZE];
+    /* wave_float_mod() goes through wave_int: the special values do not suit it. */
+    for (wave_operator op = WAVE_OP_BINARY_PLUS; op <= WAVE_OP_BINARY_DIVIDE; ++op)
+    {
+        CU_ASSERT_TRUE (wave_kernels_has_float_binary (op));
+        wave_kernels_float_binary (op, float_left, float_right, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_TRUE (_same_float (result[i], binary_float[op] (float_left[i], float_right[i])));
+    }
+}
+
+static void _int_test (void)
+{
+    wave_bool result[WAVE_KERNELS_SIZE];
+    for (wave_operator op = WAVE_OP_BINARY_EQUALS; op <= WAVE_OP_BINARY_LESSER; ++op)
+    {
+        CU_ASSERT_TRUE (wave_kernels_has_int_binary (op));
+        wave_kernels_int_test (op, int_left, int_right, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (result[i], binary_int_to_bool[op] (int_left[i], int_right[i]));
+    }
+}
+
+static void _float_test (void)
+{
+    wave_bool result[WAVE_KERNELS_SIZE];
+    for (wave_operator op = WAVE_OP_BINARY_EQUALS; op <= WAVE_OP_BINARY_LESSER; ++op)
+    {
+        CU_ASSERT_TRUE (wave_kernels_has_float_binary (op));
+        wave_kernels_float_test (op, float_left, float_right, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (result[i], binary_float_to_bool[op] (float_left[i], float_right[i]));
+    }
+}
+
+static void _int_broadcast (void)
+{
+    wave_int result[WAVE_KERNELS_SIZE];
+    wave_bool bools[WAVE_KERNELS_SIZE];
+    const wave_int value = int_right[0];
+    for (wave_operator op = WAVE_OP_BINARY_PLUS; op <= WAVE_OP_BINARY_MOD; ++op)
+    {
+        wave_kernels_int_broadcast_left (op, value, int_right, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (result[i], binary_int[op] (value, int_right[i]));
+
+        wave_kernels_int_broadcast_right (op, int_left, value, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (result[i], binary_int[op] (int_left[i], value));
+    }
+    for (wave_operator op = WAVE_OP_BINARY_EQUALS; op <= WAVE_OP_BINARY_LESSER; ++op)
+    {
+        wave_kernels_int_test_broadcast_left (op, value, int_right, bools, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (bools[i], binary_int_to_bool[op] (value, int_right[i]));
+
+        wave_kernels_int_test_broadcast_right (op, int_left, value, bools, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (bools[i], binary_int_to_bool[op] (int_left[i], value));
+    }
+}
+
+static void _float_broadcast (void)
+{
+    wave_float result[WAVE_KERNELS_SIZE];
+    wave_bool bools[WAVE_KERNELS_SIZE];
+    const wave_float value = -2.25;
+    for (wave_operator op = WAVE_OP_BINARY_PLUS; op <= WAVE_OP_BINARY_DIVIDE; ++op)
+    {
+        wave_kernels_float_broadcast_left (op, value, float_right, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_TRUE (_same_float (result[i], binary_float[op] (value, float_right[i])));
+
+        wave_kernels_float_broadcast_right (op, float_left, value, result, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_TRUE (_same_float (result[i], binary_float[op] (float_left[i], value)));
+    }
+    for (wave_operator op = WAVE_OP_BINARY_EQUALS; op <= WAVE_OP_BINARY_LESSER; ++op)
+    {
+        wave_kernels_float_test_broadcast_left (op, value, float_right, bools, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (bools[i], binary_float_to_bool[op] (value, float_right[i]));
+
+        wave_kernels_float_test_broadcast_right (op, float_left, value, bools, WAVE_KERNELS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+            CU_ASSERT_EQUAL (bools[i], binary_float_to_bool[op] (float_left[i], value));
+    }
+}
+
+static void _test_bits (void)
+{
+    wave_int ints_left[WAVE_KERNELS_BITS_SIZE];
+    wave_int ints_right[WAVE_KERNELS_BITS_SIZE];
+    wave_float floats_left[WAVE_KERNELS_BITS_SIZE];
+    wave_float floats_right[WAVE_KERNELS_BITS_SIZE];
+    uint64_t bits[WAVE_KERNELS_WORDS (WAVE_KERNELS_BITS_SIZE)];
+    for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+    {
+        ints_left[i] = int_left[i % WAVE_KERNELS_SIZE];
+        ints_right[i] = int_right[i * 3 % WAVE_KERNELS_SIZE];
+        floats_left[i] = float_left[i % WAVE_KERNELS_SIZE];
+        floats_right[i] = float_right[i * 3 % WAVE_KERNELS_SIZE];
+    }
+
+    for (wave_operator op = WAVE_OP_BINARY_EQUALS; op <= WAVE_OP_BINARY_LESSER; ++op)
+    {
+        memset (bits, 0xff, sizeof bits);
+        wave_kernels_int_test_bits (op, ints_left, ints_right, bits, WAVE_KERNELS_BITS_SIZE);
+        CU_ASSERT_TRUE (_padding_cleared (bits, WAVE_KERNELS_BITS_SIZE));
+        for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+            CU_ASSERT_EQUAL (_bit (bits, i), binary_int_to_bool[op] (ints_left[i], ints_right[i]));
+
+        wave_kernels_int_test_bits_broadcast_left (op, ints_right[0], ints_right, bits, WAVE_KERNELS_BITS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+            CU_ASSERT_EQUAL (_bit (bits, i), binary_int_to_bool[op] (ints_right[0], ints_right[i]));
+
+        wave_kernels_int_test_bits_broadcast_right (op, ints_left, ints_right[0], bits, WAVE_KERNELS_BITS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+            CU_ASSERT_EQUAL (_bit (bits, i), binary_int_to_bool[op] (ints_left[i], ints_right[0]));
+
+        memset (bits, 0xff, sizeof bits);
+        wave_kernels_float_test_bits (op, floats_left, floats_right, bits, WAVE_KERNELS_BITS_SIZE);
+        CU_ASSERT_TRUE (_padding_cleared (bits, WAVE_KERNELS_BITS_SIZE));
+        for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+            CU_ASSERT_EQUAL (_bit (bits, i), binary_float_to_bool[op] (floats_left[i], floats_right[i]));
+
+        wave_kernels_float_test_bits_broadcast_left (op, -2.25, floats_right, bits, WAVE_KERNELS_BITS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+            CU_ASSERT_EQUAL (_bit (bits, i), binary_float_to_bool[op] (-2.25, floats_right[i]));
+
+        wave_kernels_float_test_bits_broadcast_right (op, floats_left, -2.25, bits, WAVE_KERNELS_BITS_SIZE);
+        for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+            CU_ASSERT_EQUAL (_bit (bits, i), binary_float_to_bool[op] (floats_left[i], -2.25));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+int test_wave_kernels_suite_init (void)
+{
+    static const wave_float special[] =
+    {
+        0.0, -0.0, 1.0, 1.0 + 1.0e-6, -1.0, INFINITY, -INFINITY, NAN, 3.5, -2.25,
+    };
+    const unsigned int special_count = sizeof special / sizeof special[0];
+
+    for (unsigned int i = 0; i < WAVE_KERNELS_SIZE; ++i)
+    {
+        int_left[i] = (wave_int) (i * 7 % 23) - 11;
+        int_right[i] = (wave_int) (i * 5 % 19) - 9;
+        if (int_right[i] == 0)
+            int_right[i] = 3;
+
+        float_left[i] = special[i % special_count];
+        float_right[i] = special[(i * 3 + 1) % special_count];
+    }
+
+    return 0;
+}
+
+int test_wave_kernels_suite_clean (void)
+{
+    wave_kernels_set_level (wave_kernels_get_best_level ());
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Instruction set selection tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_kernels_set_level (void)
+{
+    wave_kernels_level best = wave_kernels_get_best_level ();
+
+    wave_kernels_set_level (WAVE_KERNELS_SCALAR);
+    CU_ASSERT_EQUAL (wave_kernels_get_level (), WAVE_KERNELS_SCALAR);
+
+    wave_kernels_set_level (WAVE_KERNELS_AVX512);
+    CU_ASSERT_TRUE (wave_kernels_get_level () <= best);
+
+    wave_kernels_set_level (best);
+    CU_ASSERT_EQUAL (wave_kernels_get_level (), best);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernels tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_kernels_int_unary (void)
+{
+    _for_each_level (_int_unary);
+}
+
+void test_wave_kernels_float_unary (void)
+{
+    _for_each_level (_float_unary);
+}
+
+void test_wave_kernels_float_transcendental (void)
+{
+    _for_each_level (_float_transcendental);
+}
+
+void test_wave_kernels_float_reduction (void)
+{
+    /* Uniform operands, and the doubles around the multiples of pi/2, where the
+     * reduction cancels the most bits.
+     */
+    uint64_t state = 1;
+    reduction_operand[0] = 0x1.82d19ba208b81p17;
+    reduction_operand[1] = WAVE_KERNELS_REDUCTION_LIMIT;
+    for (unsigned int i = 2; i < WAVE_KERNELS_REDUCTION_SIZE; ++i)
+    {
+        state = state * UINT64_C (6364136223846793005) + UINT64_C (1442695040888963407);
+        wave_float uniform = (wave_float) (state >> 11) * 0x1p-53;
+        if (i % 2 == 0)
+            reduction_operand[i] = (2.0 * uniform - 1.0) * WAVE_KERNELS_REDUCTION_LIMIT;
+        else
+        {
+            long double multiple = floorl (uniform * 0x1p19) * 1.5707963267948966192313216916397514L;
+            reduction_operand[i] = (wave_float) (i % 4 == 1 ? - multiple : multiple);
+            for (unsigned int j = 0; j < i % 7; ++j)
+                reduction_operand[i] = nextafter (reduction_operand[i], i % 3 == 0 ? INFINITY : - INFINITY);
+        }
+    }
+
+    _for_each_level (_float_reduction);
+}
+
+void test_wave_kernels_int_binary (void)
+{
+    _for_each_level (_int_binary);
+}
+
+void test_wave_kernels_float_binary (void)
+{
+    _for_each_level (_float_binary);
+}
+
+void test_wave_kernels_int_test (void)
+{
+    _for_each_level (_int_test);
+}
+
+void test_wave_kernels_float_test (void)
+{
+    _for_each_level (_float_test);
+}
+
+void test_wave_kernels_int_broadcast (void)
+{
+    _for_each_level (_int_broadcast);
+}
+
+void test_wave_kernels_float_broadcast (void)
+{
+    _for_each_level (_float_broadcast);
+}
+
+void test_wave_kernels_test_bits (void)
+{
+    _for_each_level (_test_bits);
+}
+
+void test_wave_kernels_bool (void)
+{
+    uint64_t left[WAVE_KERNELS_WORDS (WAVE_KERNELS_BITS_SIZE)];
+    uint64_t right[WAVE_KERNELS_WORDS (WAVE_KERNELS_BITS_SIZE)];
+    uint64_t result[WAVE_KERNELS_WORDS (WAVE_KERNELS_BITS_SIZE)];
+    memset (left, 0, sizeof left);
+    memset (right, 0, sizeof right);
+    for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+    {
+        left[i / WAVE_KERNELS_WORD_BITS] |= (uint64_t) (i * 7 % 5 < 2) << (i % WAVE_KERNELS_WORD_BITS);
+        right[i / WAVE_KERNELS_WORD_BITS] |= (uint64_t) (i % 3 == 0) << (i % WAVE_KERNELS_WORD_BITS);
+    }
+
+    wave_kernels_bool_not (left, result, WAVE_KERNELS_BITS_SIZE);
+    CU_ASSERT_TRUE (_padding_cleared (result, WAVE_KERNELS_BITS_SIZE));
+    for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+        CU_ASSERT_EQUAL (_bit (result, i), wave_bool_not (_bit (left, i)));
+
+    for (wave_operator op = WAVE_OP_BINARY_EQUALS; op <= WAVE_OP_BINARY_OR; ++op)
+    {
+        CU_ASSERT_TRUE (wave_kernels_has_bool_binary (op));
+        wave_kernels_bool_binary (op, left, right, result, WAVE_KERNELS_BITS_SIZE);
+        CU_ASSERT_TRUE (_padding_cleared (result, WAVE_KERNELS_BITS_SIZE));
+        for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+            CU_ASSERT_EQUAL (_bit (result, i), binary_bool[op] (_bit (left, i), _bit (right, i)));
+
+        for (int value = 0; value < 2; ++value)
+        {
+            wave_kernels_bool_broadcast_left (op, value != 0, right, result, WAVE_KERNELS_BITS_SIZE);
+            CU_ASSERT_TRUE (_padding_cleared (result, WAVE_KERNELS_BITS_SIZE));
+            for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+                CU_ASSERT_EQUAL (_bit (result, i), binary_bool[op] (value != 0, _bit (right, i)));
+
+            wave_kernels_bool_broadcast_right (op, left, value != 0, result, WAVE_KERNELS_BITS_SIZE);
+            CU_ASSERT_TRUE (_padding_cleared (result, WAVE_KERNELS_BITS_SIZE));
+            for (unsigned int i = 0; i < WAVE_KERNELS_BITS_SIZE; ++i)
+                CU_ASSERT_EQUAL (_bit (result, i), binary_bool[op] (_bit (left, i), value != 0));
+        }
+    }
+    CU_ASSERT_FALSE (wave_kernels_has_bool_binary (WAVE_OP_BINARY_PLUS));
+}
@@ -0,0 +1,275 @@
+/**
+ * \file test_wave_output.c
+ * \brief Wave output engine tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test_wave_output.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static variables.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of values printed in turn by the threads.
+ */
+#define WAVE_OUTPUT_ORDER_COUNT 1000
+
+/**
+ * \brief Number of threads printing in turn.
+ */
+#define WAVE_OUTPUT_THREADS 4
+
+/**
+ * \brief Number of elements of the chunks formatted in parallel, as in wave_output.c.
+ */
+#define WAVE_OUTPUT_CHUNK (1 << 14)
+
+/**
+ * \brief Descriptor of the standard output while it is captured.
+ */
+static int _saved_stdout = -1;
+
+/**
+ * \brief File receiving the standard output while it is captured.
+ */
+static FILE * _captured = NULL;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Send the standard output to a temporary file.
+ */
+static void _capture_begin (void)
+{
+    fflush (stdout);
+    _captured = tmpfile ();
+    _saved_stdout = dup (STDOUT_FILENO);
+    dup2 (fileno (_captured), STDOUT_FILENO);
+}
+
+/**
+ * \brief Restore the standard output, and get what was written to it.
+ * \param size Storage for the number of bytes.
+ * \return The bytes, followed by a '\0', to be freed by the caller.
+ */
+static char * _capture_end (size_t * size)
+{
+    wave_output_flush ();
+    dup2 (_saved_stdout, STDOUT_FILENO);
+    close (_saved_stdout);
+
+    long length = ftell (_captured);
+    char * text = malloc ((size_t) length + 1);
+    rewind (_captured);
+    * size = fread (text, 1, (size_t) length, _captured);
+    text[* size] = '\0';
+    fclose (_captured);
+    return text;
+}
+
+/**
+ * \brief Print an integer with wave_output_print().
+ */
+static void _print_int (wave_int i)
+{
+    wave_data data;
+    wave_data_set_int (& data, i);
+    wave_output_print (& data);
+}
+
+/**
+ * \brief Store a collection inside a data.
+ */
+static void _set_collection (wave_data * data, wave_data_type type, wave_data * tab, size_t size)
+{
+    data->_type = (uint8_t) type;
+    data->_flags = WAVE_DATA_FLAG_NONE;
+    data->_content._collection._tab = tab;
+    data->_content._collection._size = (uint32_t) size;
+}
+
+/**
+ * \brief Determine whether wave_output_print() prints a data like wave_data_fprint().
+ * \param data Data of interest.
+ * \param before Whether a value is printed by another thread just before.
+ */
+static bool _prints_like_fprint (const wave_data * data, bool before)
+{
+    char * expected = NULL;
+    size_t expected_size = 0;
+    FILE * stream = open_memstream (& expected, & expected_size);
+    if (before)
+        fprintf (stream, "7\n");
+    wave_data_fprint (stream, data);
+    fprintf (stream, "\n");
+    fclose (stream);
+
+    _capture_begin ();
+    if (before)
+    {
+        #pragma omp parallel num_threads (2)
+        {
+            if (omp_get_thread_num () == 1)
+                _print_int (7);
+        }
+    }
+    wave_output_print (data);
+    size_t size;
+    char * text = _capture_end (& size);
+
+    bool same = size == expected_size && memcmp (text, expected, size) == 0;
+    free (text);
+    free (expected);
+    return same;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+int test_wave_output_suite_init (void)
+{
+    /* Large collections are only printed by chunks with several threads. */
+    if (omp_get_max_threads () < WAVE_OUTPUT_THREADS)
+        omp_set_num_threads (WAVE_OUTPUT_THREADS);
+    return 0;
+}
+
+int test_wave_output_suite_clean (void)
+{
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Ordering tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_output_thread_order (void)
+{
+    size_t size;
+
+    /* A phrase printing from the sections of a cyclic parallel collection. */
+    _capture_begin ();
+    _print_int (1);
+    #pragma omp parallel sections num_threads (2)
+    {
+        #pragma omp section
+        _print_int (2);
+        #pragma omp section
+        _print_int (2);
+    }
+    _print_int (3);
+    char * text = _capture_end (& size);
+    CU_ASSERT_STRING_EQUAL (text, "1\n2\n2\n3\n");
+    free (text);
+
+    /* Consecutive values printed by different threads. */
+    _capture_begin ();
+    _print_int (-1);
+    #pragma omp parallel num_threads (WAVE_OUTPUT_THREADS)
+    {
+        #pragma omp for ordered schedule (static, 1)
+        for (int i = 0; i < WAVE_OUTPUT_ORDER_COUNT; ++i)
+        {
+            #pragma omp ordered
+            _print_int (i);
+        }
+    }
+    _print_int (WAVE_OUTPUT_ORDER_COUNT);
+    text = _capture_end (& size);
+
+    char * expected = malloc (16 * (WAVE_OUTPUT_ORDER_COUNT + 2));
+    size_t length = (size_t) sprintf (expected, "-1\n");
+    for (int i = 0; i <= WAVE_OUTPUT_ORDER_COUNT; ++i)
+        length += (size_t) sprintf (expected + length, "%d\n", i);
+    CU_ASSERT_EQUAL (size, length);
+    CU_ASSERT_STRING_EQUAL (text, expected);
+    free (expected);
+    free (text);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Chunks tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_output_chunks (void)
+{
+    /* Too small, a single batch, and several batches of chunks. */
+    static const size_t sizes[] =
+    {
+        1, 2 * WAVE_OUTPUT_CHUNK - 1, 2 * WAVE_OUTPUT_CHUNK, 2 * WAVE_OUTPUT_CHUNK + 1,
+        3 * WAVE_OUTPUT_CHUNK + 17, (4 * WAVE_OUTPUT_THREADS + 1) * WAVE_OUTPUT_CHUNK + 5,
+    };
+    size_t max = sizes[sizeof sizes / sizeof sizes[0] - 1];
+
+    wave_data * tab = malloc (max * sizeof * tab);
+    wave_int * ints = malloc (max * sizeof * ints);
+    wave_float * floats = malloc (max * sizeof * floats);
+    uint64_t * bits = calloc (WAVE_KERNELS_WORDS (max), sizeof * bits);
+    for (size_t i = 0; i < max; ++i)
+    {
+        ints[i] = (wave_int) ((i * 2654435761u) % 2000001) - 1000000;
+        floats[i] = (wave_float) ints[i] / 7.0;
+        if (i % 3 == 0)
+            wave_data_set_int (& tab[i], ints[i]);
+        else if (i % 3 == 1)
+            wave_data_set_float (& tab[i], floats[i]);
+        else
+            wave_data_set_char (& tab[i], (wave_char) ('a' + i % 26));
+    }
+
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; ++s)
+    {
+        size_t size = sizes[s];
+
+        /* The bits past the last value are cleared. */
+        memset (bits, 0, WAVE_KERNELS_WORDS (max) * sizeof * bits);
+        for (size_t i = 0; i < size; ++i)
+            if (ints[i] % 5 < 2)
+                bits[i / WAVE_KERNELS_WORD_BITS] |= (uint64_t) 1 << (i % WAVE_KERNELS_WORD_BITS);
+
+        wave_data data[5];
+        _set_collection (& data[0], WAVE_DATA_SEQ, tab, size);
+        _set_collection (& data[1], WAVE_DATA_PAR, tab, size);
+        wave_data_set_par_int (& data[2], ints, size);
+        wave_data_set_par_float (& data[3], floats, size);
+        wave_data_set_par_bool (& data[4], bits, size);
+
+        for (int d = 0; d < 5; ++d)
+        {
+            CU_ASSERT_TRUE (_prints_like_fprint (& data[d], false));
+            CU_ASSERT_TRUE (_prints_like_fprint (& data[d], true));
+        }
+    }
+
+    free (bits);
+    free (floats);
+    free (ints);
+    free (tab);
+}
@@ -0,0 +1,405 @@
+/**
+ * \file test_wave_types.c
+ * \brief Wave types tests.
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright MIT License
+ */
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Éric VIOLARD, Maxime SCHMITT, Harenome RAZANAJATO RANAIVOARIVONY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test_wave_types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static variables.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of random values of each test.
+ */
+#define WAVE_TYPES_RANDOM_COUNT 100000
+
+/**
+ * \brief State of the pseudo-random generator.
+ */
+static uint64_t random_state;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get a pseudo-random 64 bits value (xorshift64*).
+ */
+static uint64_t _random (void)
+{
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return random_state * UINT64_C (2685821657736338717);
+}
+
+/**
+ * \brief Build a wave_float from its bits.
+ */
+static wave_float _from_bits (uint64_t bits)
+{
+    wave_float f;
+    memcpy (& f, & bits, sizeof f);
+    return f;
+}
+
+/**
+ * \brief Get a pseudo-random finite wave_float whose binary exponent lies in a range.
+ * \param min Minimal biased exponent.
+ * \param max Maximal biased exponent.
+ */
+static wave_float _random_float (unsigned int min, unsigned int max)
+{
+    uint64_t r = _random ();
+    uint64_t exponent = min + _random () % (max - min + 1);
+    return _from_bits ((r & (UINT64_C (1) << 63)) | exponent << 52 | (r & ((UINT64_C (1) << 52) - 1)));
+}
+
+/**
+ * \brief Determine whether two wave_float are the same, bit by bit.
+ */
+static bool _same_bits (wave_float a, wave_float b)
+{
+    return memcmp (& a, & b, sizeof a) == 0;
+}
+
+/**
+ * \brief Determine whether wave_float_parse() gives the value and the end of strtod().
+ */
+static bool _parses_like_strtod (const char * str)
+{
+    char * strtod_end;
+    const char * end;
+    wave_float expected = strtod (str, & strtod_end);
+    wave_float f = wave_float_parse (str, & end);
+    bool same = _same_bits (f, expected) && end == strtod_end;
+    if (! same)
+        fprintf (stderr, "wave_float_parse (\"%s\"): %a, %td characters; strtod: %a, %td characters\n",
+            str, f, end - str, expected, strtod_end - str);
+    return same;
+}
+
+/**
+ * \brief Determine whether wave_float_to_chars() gives the text of printf ("%f").
+ */
+static bool _prints_like_printf (wave_float f)
+{
+    char expected[WAVE_FLOAT_CHARS_MAX];
+    char buffer[WAVE_FLOAT_CHARS_MAX];
+    int expected_length = snprintf (expected, sizeof expected, "%f", f);
+    size_t length = wave_float_to_chars (buffer, f);
+    bool same = (size_t) expected_length == length && memcmp (buffer, expected, length) == 0;
+    if (! same)
+        fprintf (stderr, "wave_float_to_chars (%a): \"%.*s\"; printf: \"%s\"\n", f, (int) length, buffer, expected);
+    return same;
+}
+
+/**
+ * \brief Get the number of significant digits of a decimal text.
+ */
+static int _significant_digits (const char * text, size_t length)
+{
+    int first = -1, last = -1, count = 0;
+    for (size_t i = 0; i < length && text[i] != 'e'; ++i)
+        if (text[i] >= '0' && text[i] <= '9')
+        {
+            if (text[i] != '0')
+            {
+                if (first < 0)
+                    first = count;
+                last = count;
+            }
+            count++;
+        }
+    return first < 0 ? 1 : last - first + 1;
+}
+
+/**
+ * \brief Get the smallest number of significant digits which read back as a value.
+ */
+static int _shortest_digits (wave_float f)
+{
+    char text[64];
+    for (int precision = 1; precision < 17; ++precision)
+    {
+        snprintf (text, sizeof text, "%.*e", precision - 1, f);
+        if (_same_bits (strtod (text, NULL), f))
+            return precision;
+    }
+    return 17;
+}
+
+/**
+ * \brief Determine whether wave_float_to_chars_shortest() gives a text which reads back as a value.
+ * \param f Value.
+ * \param shortest Storage for whether the text has the smallest number of digits, or \c NULL.
+ */
+static bool _reads_back (wave_float f, bool * shortest)
+{
+    char buffer[WAVE_FLOAT_CHARS_MAX + 1];
+    size_t length = wave_float_to_chars_shortest (buffer, f);
+    buffer[length] = '\0';
+    bool valid = _same_bits (strtod (buffer, NULL), f) && (strchr (buffer, '.') != NULL || strchr (buffer, 'e') != NULL)
+        && _significant_digits (buffer, length) <= 17;
+    if (! valid)
+        fprintf (stderr, "wave_float_to_chars_shortest (%a): \"%s\"\n", f, buffer);
+    if (shortest != NULL)
+        * shortest = _significant_digits (buffer, length) <= _shortest_digits (f);
+    return valid;
+}
+
+/**
+ * \brief Determine whether wave_float_to_chars_shortest() gives a given text.
+ */
+static bool _prints_as (wave_float f, const char * expected)
+{
+    char buffer[WAVE_FLOAT_CHARS_MAX];
+    size_t length = wave_float_to_chars_shortest (buffer, f);
+    return length == strlen (expected) && memcmp (buffer, expected, length) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Suite related functions.
+////////////////////////////////////////////////////////////////////////////////
+
+int test_wave_types_suite_init (void)
+{
+    random_state = UINT64_C (0x9e3779b97f4a7c15);
+    return 0;
+}
+
+int test_wave_types_suite_clean (void)
+{
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// wave_int tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_types_int_parse (void)
+{
+    static const struct
+    {
+        const char * str;
+        wave_int value;
+        size_t length;
+    } cases[] =
+    {
+        { "0",                      0,          1  },
+        { "42",                     42,         2  },
+        { "-42",                    -42,        3  },
+        { "+42",                    42,         3  },
+        { " \t\n17x",               17,         5  },
+        { "007",                    7,          3  },
+        { "12.5",                   12,         2  },
+        { "2147483647",             INT_MAX,    10 },
+        { "-2147483647",            -INT_MAX,   11 },
+        { "-2147483648",            INT_MIN,    11 },
+        /* Out of range values wrap around. */
+        { "2147483648",             INT_MIN,    10 },
+        { "-2147483649",            INT_MAX,    11 },
+        { "4294967295",             -1,         10 },
+        { "4294967296",             0,          10 },
+        { "4294967338",             42,         10 },
+        { "-4294967338",            -42,        11 },
+        { "99999999999999999999",   1661992959, 20 },
+        /* No digits. */
+        { "",                       0,          0  },
+        { "-",                      0,          0  },
+        { "+-1",                    0,          0  },
+        { "- 1",                    0,          0  },
+        { "abc",                    0,          0  },
+        { "  x",                    0,          0  },
+    };
+
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; ++i)
+    {
+        const char * end;
+        CU_ASSERT_EQUAL (wave_int_parse (cases[i].str, & end), cases[i].value);
+        CU_ASSERT_EQUAL ((size_t) (end - cases[i].str), cases[i].length);
+        CU_ASSERT_EQUAL (wave_int_parse (cases[i].str, NULL), cases[i].value);
+    }
+}
+
+void test_wave_types_int_to_chars (void)
+{
+    static const wave_int values[] = { 0, 1, -1, 9, 10, 99, 100, -100, 12345, INT_MAX, INT_MIN, INT_MIN + 1 };
+
+    char buffer[WAVE_INT_CHARS_MAX];
+    char expected[WAVE_INT_CHARS_MAX + 1];
+    for (size_t i = 0; i < sizeof values / sizeof values[0] + WAVE_TYPES_RANDOM_COUNT; ++i)
+    {
+        wave_int value = i < sizeof values / sizeof values[0] ? values[i] : (wave_int) (int32_t) (uint32_t) _random ();
+        size_t length = wave_int_to_chars (buffer, value);
+        int expected_length = snprintf (expected, sizeof expected, "%d", value);
+        CU_ASSERT_TRUE ((size_t) expected_length == length && memcmp (buffer, expected, length) == 0);
+
+        const char * end;
+        buffer[length] = '\0';
+        CU_ASSERT_EQUAL (wave_int_parse (buffer, & end), value);
+        CU_ASSERT_PTR_EQUAL (end, buffer + length);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// wave_float tests.
+////////////////////////////////////////////////////////////////////////////////
+
+void test_wave_types_float_parse (void)
+{
+    static const char * const cases[] =
+    {
+        /* Exact values. */
+        "0", "-0", "+0", "1", "1.5", "-1.5", "0.1", "3.14159", ".5", "5.", "1e0",
+        "1e22", "1e-22", "9007199254740992", "4503599627370497.5", "123456789e-22",
+        "0.000000000000000000001", "00000000000000000000000001.5",
+        /* More than 19 significant digits. */
+        "1234567890123456789", "12345678901234567890", "12345678901234567890123",
+        "0.1234567890123456789012345", "9007199254740993", "18446744073709551616",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "10000000000000000000000000000000000000000e-40",
+        "1000000000000000000000.0000000000000000000001",
+        /* Decimal exponents beyond 22. */
+        "1e23", "1e-23", "8.5e23", "123e-30", "1e308", "1.7976931348623157e308",
+        "1.7976931348623159e308", "1e309", "2.2250738585072014e-308", "2.2250738585072011e-308",
+        "4.9e-324", "2.4703282292062328e-324", "2.4703282292062327e-324", "1e-400",
+        "1e100000000", "1e-100000000", "0e999999", "123456789012345678e-40",
+        /* Hexadecimal values, infinite values, NaN. */
+        "0x1p-3", "0X1.8P1", "-0x10", "0x1.fffffffffffffp1023", "0x", "inf", "-Infinity", "nan", "-nan",
+        /* Partial texts. */
+        "12abc", "1.5e3x", "1e", "1e+", "1e-x", "2.5E", ".", "-", "+", "", "  12", "-.5", "..5", "1.2.3", "e5",
+    };
+
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; ++i)
+        CU_ASSERT_TRUE (_parses_like_strtod (cases[i]));
+
+    /* Random values, with all their digits, the shortest ones, and few of them. */
+    char text[64];
+    for (int i = 0; i < WAVE_TYPES_RANDOM_COUNT; ++i)
+    {
+        wave_float f = _random_float (1, 2046);
+        snprintf (text, sizeof text, "%.17g", f);
+        CU_ASSERT_TRUE (_parses_like_strtod (text));
+        snprintf (text, sizeof text, "%.*e", _shortest_digits (f) - 1, f);
+        CU_ASSERT_TRUE (_parses_like_strtod (text));
+        snprintf (text, sizeof text, "%.*g", (int) (_random () % 8) + 1, f);
+        CU_ASSERT_TRUE (_parses_like_strtod (text));
+        snprintf (text, sizeof text, "%.*f", (int) (_random () % 12), _random_float (1000, 1080));
+        CU_ASSERT_TRUE (_parses_like_strtod (text));
+    }
+}
+
+void test_wave_types_float_to_chars (void)
+{
+    static const wave_float cases[] =
+    {
+        0.0, -0.0, 1.0, -1.0, 0.5, 0.1, 2.5, 1e6, 123456.789, 0.0078125, 0.0234375,
+        0.0000005, 0.00000049999999999999999, 0.0000015, 0.0000025, 0.9999995, 0.99999949999999994,
+        9.9999995, 1e15, 1e16, 1e18, 9223372036854774784.0, 9223372036854775808.0, 1e19, 1e300,
+        DBL_MAX, -DBL_MAX, DBL_MIN, 4.9e-324, INFINITY, -INFINITY, NAN,
+        /* Around the limits of the exact computation. */
+        0x1p-21, -0x1p-21, 0x1.fffffffffffffp-22, 0x1p-8, 0x1.fffffffffffffp-9, 0x1.0000000000001p-8,
+        0x1.fffffffffffffp62, -0x1.fffffffffffffp62, 0x1p63, 0x1p-20, 0x1.8p-9,
+    };
+
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; ++i)
+        CU_ASSERT_TRUE (_prints_like_printf (cases[i]));
+
+    /* The exact computation covers [2^-8, 2^63), the other ranges use snprintf(). */
+    for (int i = 0; i < WAVE_TYPES_RANDOM_COUNT; ++i)
+    {
+        CU_ASSERT_TRUE (_prints_like_printf (_random_float (1023 - 8, 1023 + 62)));
+        CU_ASSERT_TRUE (_prints_like_printf (_random_float (1023 - 21, 1023 - 9)));
+        CU_ASSERT_TRUE (_prints_like_printf (_random_float (1023 + 63, 1023 + 70)));
+        CU_ASSERT_TRUE (_prints_like_printf (_random_float (1023 - 40, 1023 - 22)));
+    }
+
+    /* Halfway cases, which round to even. */
+    for (int i = 0; i < WAVE_TYPES_RANDOM_COUNT; ++i)
+    {
+        wave_float f = (wave_float) (_random () % 100000000) / 10000000.0 + 0.00000005;
+        CU_ASSERT_TRUE (_prints_like_printf (f));
+        CU_ASSERT_TRUE (_prints_like_printf ((wave_float) (_random () % 1000000) / 128.0));
+    }
+}
+
+void test_wave_types_float_to_chars_shortest (void)
+{
+    CU_ASSERT_TRUE (_prints_as (0.0, "0.0"));
+    CU_ASSERT_TRUE (_prints_as (-0.0, "-0.0"));
+    CU_ASSERT_TRUE (_prints_as (INFINITY, "inf"));
+    CU_ASSERT_TRUE (_prints_as (-INFINITY, "-inf"));
+    CU_ASSERT_TRUE (_prints_as (NAN, "nan"));
+    CU_ASSERT_TRUE (_prints_as (0.1, "0.1"));
+    CU_ASSERT_TRUE (_prints_as (-2.5, "-2.5"));
+    CU_ASSERT_TRUE (_prints_as (100.0, "100.0"));
+    CU_ASSERT_TRUE (_prints_as (1e20, "100000000000000000000.0"));
+    CU_ASSERT_TRUE (_prints_as (1e21, "1e21"));
+    CU_ASSERT_TRUE (_prints_as (1.5e-7, "1.5e-7"));
+    CU_ASSERT_TRUE (_prints_as (1e-6, "0.000001"));
+    CU_ASSERT_TRUE (_prints_as (1e-7, "1e-7"));
+    CU_ASSERT_TRUE (_prints_as (123456.789, "123456.789"));
+    CU_ASSERT_TRUE (_prints_as (DBL_MAX, "1.7976931348623157e308"));
+    CU_ASSERT_TRUE (_prints_as (DBL_MIN, "2.2250738585072014e-308"));
+    CU_ASSERT_TRUE (_prints_as (4.9e-324, "5e-324"));
+
+    /* Texts lying exactly halfway between two values are not used, such as 1e23. */
+    CU_ASSERT_TRUE (_prints_as (1e23, "9.999999999999999e22"));
+
+    static const wave_float cases[] =
+    {
+        DBL_MIN, -DBL_MIN, DBL_MAX, -DBL_MAX, 4.9e-324, 0x0.fffffffffffffp-1022, 0x0.0000000000001p-1022 * 3,
+        0x0.8p-1022, 0x1.0000000000001p-1022, 1e23, 8.41e21, 5e-310, 9007199254740993.0, 0.3,
+        2.0 / 3.0, 1e-300, 1e300, 0x1p-1022, 0x1p1023, 0x1.fffffffffffffp-1,
+    };
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; ++i)
+        CU_ASSERT_TRUE (_reads_back (cases[i], NULL));
+
+    /* Powers of ten, and random values, normal and denormal. A longer text
+     * than needed is only used in rare cases.
+     */
+    for (int e = -323; e <= 308; ++e)
+    {
+        char text[16];
+        snprintf (text, sizeof text, "1e%d", e);
+        CU_ASSERT_TRUE (_reads_back (strtod (text, NULL), NULL));
+    }
+
+    int longer = 0;
+    for (int i = 0; i < WAVE_TYPES_RANDOM_COUNT; ++i)
+    {
+        bool shortest_normal, shortest_denormal;
+        CU_ASSERT_TRUE (_reads_back (_random_float (1, 2046), & shortest_normal));
+        CU_ASSERT_TRUE (_reads_back (_random_float (0, 0), & shortest_denormal));
+        longer += ! shortest_normal + ! shortest_denormal;
+    }
+    CU_ASSERT_TRUE (longer <= 2 * WAVE_TYPES_RANDOM_COUNT / 1000);
+}